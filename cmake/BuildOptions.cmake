@@ -0,0 +1,82 @@
+# 构建优化选项：LTO、符号可见性、PGO，以及 USDT 探针
+# 顶层和各 libs/*/CMakeLists.txt 都会 include 本文件，单独构建某个库时选项同样可用
+include_guard(GLOBAL)
+
+option(ENABLE_LTO "Link-time optimization for the static libraries and their consumers" OFF)
+option(ENABLE_HIDDEN_VISIBILITY "Compile with -fvisibility=hidden; only *_API symbols are exported" ON)
+set(PGO_MODE "OFF" CACHE STRING "Profile-guided optimization: OFF, GENERATE or USE")
+set_property(CACHE PGO_MODE PROPERTY STRINGS OFF GENERATE USE)
+set(PGO_PROFILE_DIR "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH "Directory holding PGO profile data")
+
+# LTO：只对静态库和链接它们的程序开启（共享库的导出函数无论如何都不能跨边界内联）
+set(BUILD_LTO_ENABLED OFF)
+if(ENABLE_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT lto_supported OUTPUT lto_error LANGUAGES C CXX)
+    if(lto_supported)
+        set(BUILD_LTO_ENABLED ON)
+    else()
+        message(WARNING "ENABLE_LTO requested but not supported by the toolchain: ${lto_error}")
+    endif()
+endif()
+
+function(enable_lto target)
+    if(BUILD_LTO_ENABLED)
+        set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+    endif()
+endfunction()
+
+# USDT 静态探针：找到 sys/sdt.h（systemtap-sdt-dev / systemtap-sdt-devel）时编入 C / C++ 库。
+# 未被跟踪时每个探针只是一条 nop（参数留在寄存器中），可以常驻生产构建；用法见 tools/calc_probes.sh
+option(ENABLE_USDT "Compile USDT probes (sys/sdt.h) into the libraries" ON)
+set(BUILD_USDT_ENABLED OFF)
+if(ENABLE_USDT)
+    include(CheckIncludeFile)
+    check_include_file(sys/sdt.h HAVE_SYS_SDT_H)
+    if(HAVE_SYS_SDT_H)
+        set(BUILD_USDT_ENABLED ON)
+    else()
+        message(STATUS "sys/sdt.h not found; USDT probes are compiled out (install systemtap-sdt-dev)")
+    endif()
+endif()
+
+function(enable_usdt target)
+    if(BUILD_USDT_ENABLED)
+        target_compile_definitions(${target} PRIVATE CALC_HAVE_SDT)
+    endif()
+endfunction()
+
+# 符号可见性：之后创建的所有 C / C++ 目标默认隐藏，公开接口由头文件中的导出宏标记
+# （汇编库的导出由 .asm 中的 global / :hidden 声明决定，不受影响）
+if(ENABLE_HIDDEN_VISIBILITY)
+    set(CMAKE_C_VISIBILITY_PRESET hidden)
+    set(CMAKE_CXX_VISIBILITY_PRESET hidden)
+    set(CMAKE_VISIBILITY_INLINES_HIDDEN ON)
+endif()
+
+# PGO：GENERATE 构建插桩版本，运行 pgo-train 目标采集数据后，在同一构建目录
+# 把 PGO_MODE 改为 USE 重新构建（GCC 按目标文件路径查找 .gcda）
+if(PGO_MODE STREQUAL "GENERATE")
+    set(pgo_flags "-fprofile-generate=${PGO_PROFILE_DIR} -fprofile-update=atomic")
+elseif(PGO_MODE STREQUAL "USE")
+    if(CMAKE_C_COMPILER_ID MATCHES "Clang")
+        set(pgo_flags "-fprofile-use=${PGO_PROFILE_DIR}/default.profdata -Wno-profile-instr-unprofiled")
+    else()
+        # 未被训练覆盖的函数仍按常规优化，而不是当作冷代码；源码改动后的过期数据只警告，不中断构建
+        set(pgo_flags "-fprofile-use=${PGO_PROFILE_DIR} -fprofile-partial-training -Wno-missing-profile -Wno-error=coverage-mismatch")
+    endif()
+elseif(NOT PGO_MODE STREQUAL "OFF")
+    message(FATAL_ERROR "PGO_MODE must be OFF, GENERATE or USE (got '${PGO_MODE}')")
+endif()
+
+if(pgo_flags)
+    if(NOT CMAKE_BUILD_TYPE)
+        message(WARNING "PGO_MODE=${PGO_MODE} without CMAKE_BUILD_TYPE; use Release for meaningful profiles")
+    endif()
+    foreach(lang C CXX)
+        set(CMAKE_${lang}_FLAGS "${CMAKE_${lang}_FLAGS} ${pgo_flags}")
+    endforeach()
+    foreach(kind EXE SHARED MODULE)
+        set(CMAKE_${kind}_LINKER_FLAGS "${CMAKE_${kind}_LINKER_FLAGS} ${pgo_flags}")
+    endforeach()
+endif()
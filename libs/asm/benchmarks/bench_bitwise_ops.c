@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "asm_math_ops/math_ops_asm.h"
+
+// 按位数组运算与普通 C 循环（-O2，编译器可能自动向量化）的对比
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 每个长度至少处理 1GB，返回最好一轮的吞吐量 (GB/s，按输入字节计)
+#define BENCH_GBS(stmt, bytes, result)                                   \
+    do                                                                   \
+    {                                                                    \
+        size_t iters_ = ((size_t)1 << 30) / (bytes) + 1;                 \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t i_ = 0; i_ < iters_; ++i_)                       \
+            {                                                            \
+                __asm__ volatile("" ::: "memory");                       \
+                stmt;                                                    \
+            }                                                            \
+            double s_ = (now_seconds() - start_) / iters_;               \
+            best_ = s_ < best_ ? s_ : best_;                             \
+        }                                                                \
+        (result) = (bytes) / best_ * 1e-9;                               \
+    } while (0)
+
+static void c_and(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] & b[i];
+}
+
+static uint64_t c_popcount(const uint64_t *a, size_t n)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; ++i)
+        total += (uint64_t)__builtin_popcountll(a[i]);
+    return total;
+}
+
+static uint64_t c_reduce_or(const uint64_t *a, size_t n)
+{
+    uint64_t r = 0;
+    for (size_t i = 0; i < n; ++i)
+        r |= a[i];
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    size_t max_words = argc > 1 ? strtoull(argv[1], NULL, 0) : ((size_t)1 << 22);
+    uint64_t *a = malloc(max_words * sizeof(uint64_t));
+    uint64_t *b = malloc(max_words * sizeof(uint64_t));
+    uint64_t *out = malloc(max_words * sizeof(uint64_t));
+    if (!a || !b || !out)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < max_words; ++i)
+    {
+        a[i] = 0x9E3779B97F4A7C15ull * (i + 1);
+        b[i] = a[i] >> 3;
+    }
+    volatile uint64_t sink = 0;
+
+    printf("CPU features: 0x%X (GB/s)\n", asm_cpu_features());
+    printf("%10s %8s %8s %10s %10s %10s %10s\n", "words", "C and", "asm and", "C popcnt", "asm popcnt",
+           "C or-red", "asm or-red");
+
+    for (size_t n = 64; n <= max_words; n *= 8)
+    {
+        size_t bytes = n * sizeof(uint64_t);
+        double c_and_gbs, asm_and_gbs, c_pop_gbs, asm_pop_gbs, c_or_gbs, asm_or_gbs;
+        BENCH_GBS(c_and(a, b, out, n), bytes, c_and_gbs);
+        BENCH_GBS(asm_bitwise_and_u64(a, b, out, n), bytes, asm_and_gbs);
+        BENCH_GBS(sink += c_popcount(a, n), bytes, c_pop_gbs);
+        BENCH_GBS(sink += asm_popcount_u64(a, n), bytes, asm_pop_gbs);
+        BENCH_GBS(sink += c_reduce_or(a, n), bytes, c_or_gbs);
+        BENCH_GBS(sink += asm_reduce_or_u64(a, n), bytes, asm_or_gbs);
+        printf("%10zu %8.1f %8.1f %10.1f %10.1f %10.1f %10.1f\n", n, c_and_gbs, asm_and_gbs, c_pop_gbs,
+               asm_pop_gbs, c_or_gbs, asm_or_gbs);
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    return 0;
+}
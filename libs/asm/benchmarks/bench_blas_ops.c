@@ -0,0 +1,116 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "asm_math_ops/math_ops_asm.h"
+
+// BLAS-1 运算与朴素 C 循环的对比。C 循环的点积是一条串行加法链（不允许重排浮点加法时
+// 编译器无法向量化），axpy / fma 可被自动向量化，差距取决于编译选项和是否使用 FMA
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 至少处理 2^28 个元素，返回最好一轮的每元素耗时 (ns)
+#define BENCH_NS(stmt, n, result)                                        \
+    do                                                                   \
+    {                                                                    \
+        size_t iters_ = ((size_t)1 << 28) / (n) + 1;                     \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t i_ = 0; i_ < iters_; ++i_)                       \
+            {                                                            \
+                __asm__ volatile("" ::: "memory");                       \
+                stmt;                                                    \
+            }                                                            \
+            double ns_ = (now_seconds() - start_) * 1e9 / iters_ / (n);  \
+            best_ = ns_ < best_ ? ns_ : best_;                           \
+        }                                                                \
+        (result) = best_;                                                \
+    } while (0)
+
+static double c_dot(const double *x, const double *y, size_t n)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        sum += x[i] * y[i];
+    return sum;
+}
+
+static void c_axpy(double a, const double *x, double *y, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        y[i] = a * x[i] + y[i];
+}
+
+static void c_fma(const double *a, const double *b, const double *c, double *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] * b[i] + c[i];
+}
+
+static float c_dot_f32(const float *x, const float *y, size_t n)
+{
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i)
+        sum += x[i] * y[i];
+    return sum;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 0) : 4096;
+    double *x = malloc(n * sizeof(double));
+    double *y = malloc(n * sizeof(double));
+    double *out = malloc(n * sizeof(double));
+    float *xf = malloc(n * sizeof(float));
+    float *yf = malloc(n * sizeof(float));
+    if (!x || !y || !out || !xf || !yf)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = (double)(i % 13) * 0.5;
+        y[i] = 1.0 / (double)(i % 7 + 1);
+        xf[i] = (float)x[i];
+        yf[i] = (float)y[i];
+    }
+
+    printf("CPU features: 0x%X, %zu elements (ns/element)\n", asm_cpu_features(), n);
+    printf("%12s %10s %10s\n", "op", "C loop", "asm");
+
+    volatile double sink = 0.0;
+    double t_c, t_asm;
+    BENCH_NS(sink = c_dot(x, y, n), n, t_c);
+    BENCH_NS(sink = asm_dot_f64(x, y, n), n, t_asm);
+    printf("%12s %10.3f %10.3f\n", "dot_f64", t_c, t_asm);
+
+    BENCH_NS(sink = c_dot_f32(xf, yf, n), n, t_c);
+    BENCH_NS(sink = asm_dot_f32(xf, yf, n), n, t_asm);
+    printf("%12s %10.3f %10.3f\n", "dot_f32", t_c, t_asm);
+
+    // axpy 的系数正负交替，y 保持有界
+    BENCH_NS(c_axpy((i_ & 1) ? -0.5 : 0.5, x, out, n), n, t_c);
+    BENCH_NS(asm_axpy_f64((i_ & 1) ? -0.5 : 0.5, x, out, n), n, t_asm);
+    printf("%12s %10.3f %10.3f\n", "axpy_f64", t_c, t_asm);
+
+    BENCH_NS(c_fma(x, y, out, out, n), n, t_c);
+    BENCH_NS(asm_fma_f64(x, y, out, out, n), n, t_asm);
+    printf("%12s %10.3f %10.3f\n", "fma_f64", t_c, t_asm);
+    (void)sink;
+
+    free(x);
+    free(y);
+    free(out);
+    free(xf);
+    free(yf);
+    return 0;
+}
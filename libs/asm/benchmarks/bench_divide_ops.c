@@ -0,0 +1,86 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "asm_math_ops/math_ops_asm.h"
+
+// 不变除数批量除法 / 取模与硬件 idiv 循环的对比（除数运行时给出，编译器无法换成乘法）
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 至少处理 2^28 个元素，返回最好一轮的每元素耗时 (ns)
+#define BENCH_NS(stmt, n, result)                                        \
+    do                                                                   \
+    {                                                                    \
+        size_t iters_ = ((size_t)1 << 28) / (n) + 1;                     \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t i_ = 0; i_ < iters_; ++i_)                       \
+            {                                                            \
+                __asm__ volatile("" ::: "memory");                       \
+                stmt;                                                    \
+            }                                                            \
+            double ns_ = (now_seconds() - start_) * 1e9 / iters_ / (n);  \
+            best_ = ns_ < best_ ? ns_ : best_;                           \
+        }                                                                \
+        (result) = best_;                                                \
+    } while (0)
+
+static void idiv_array(int32_t divisor, const int32_t *in, int32_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = in[i] / divisor;
+}
+
+static void imod_array(int32_t divisor, const int32_t *in, int32_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = in[i] % divisor;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 0) : 4096;
+    int32_t divisors[] = {7, 1000, -641, 1024};
+    int32_t *in = malloc(n * sizeof(int32_t));
+    int32_t *out = malloc(n * sizeof(int32_t));
+    if (!in || !out)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    uint32_t seed = 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        in[i] = (int32_t)seed;
+    }
+
+    printf("CPU features: 0x%X, %zu elements (ns/element)\n", asm_cpu_features(), n);
+    printf("%10s %10s %10s %10s %10s\n", "divisor", "idiv /", "asm div", "idiv %", "asm mod");
+
+    for (size_t k = 0; k < sizeof(divisors) / sizeof(divisors[0]); ++k)
+    {
+        volatile int32_t divisor = divisors[k];
+        asm_int_divider d;
+        asm_int_divider_init(&d, divisor);
+        double t_idiv, t_div, t_imod, t_mod;
+        BENCH_NS(idiv_array(divisor, in, out, n), n, t_idiv);
+        BENCH_NS(asm_div_int_array(&d, in, out, n), n, t_div);
+        BENCH_NS(imod_array(divisor, in, out, n), n, t_imod);
+        BENCH_NS(asm_mod_int_array(&d, in, out, n), n, t_mod);
+        printf("%10d %10.3f %10.3f %10.3f %10.3f\n", divisors[k], t_idiv, t_div, t_imod, t_mod);
+    }
+
+    free(in);
+    free(out);
+    return 0;
+}
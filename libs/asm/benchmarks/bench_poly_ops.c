@@ -0,0 +1,106 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "asm_math_ops/math_ops_asm.h"
+
+// 多项式求值：逐点 Horner 的 C 循环与 asm_poly_eval（Estrin，向量化）对比，次数可调。
+// C 循环对每个点是一条长度为 d 的乘加依赖链，编译器可以跨点向量化，但不会重排链内的运算
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 至少处理 2^26 个点，返回最好一轮的每点耗时 (ns)
+#define BENCH_NS(stmt, n, result)                                        \
+    do                                                                   \
+    {                                                                    \
+        size_t iters_ = ((size_t)1 << 26) / (n) + 1;                     \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t i_ = 0; i_ < iters_; ++i_)                       \
+            {                                                            \
+                __asm__ volatile("" ::: "memory");                       \
+                stmt;                                                    \
+            }                                                            \
+            double ns_ = (now_seconds() - start_) * 1e9 / iters_ / (n);  \
+            best_ = ns_ < best_ ? ns_ : best_;                           \
+        }                                                                \
+        (result) = best_;                                                \
+    } while (0)
+
+static void c_horner(const double *c, size_t count, const double *x, double *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        double p = 0.0;
+        for (size_t j = count; j-- > 0;)
+            p = p * x[i] + c[j];
+        out[i] = p;
+    }
+}
+
+static void c_horner_f32(const float *c, size_t count, const float *x, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        float p = 0.0f;
+        for (size_t j = count; j-- > 0;)
+            p = p * x[i] + c[j];
+        out[i] = p;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 0) : 4096;
+    size_t degree = argc > 2 ? strtoull(argv[2], NULL, 0) : 8;
+    size_t count = degree + 1;
+    double *x = malloc(n * sizeof(double));
+    double *out = malloc(n * sizeof(double));
+    double *c = malloc(count * sizeof(double));
+    float *xf = malloc(n * sizeof(float));
+    float *outf = malloc(n * sizeof(float));
+    float *cf = malloc(count * sizeof(float));
+    if (!x || !out || !c || !xf || !outf || !cf)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = (double)(i % 101) / 101.0 - 0.5;
+        xf[i] = (float)x[i];
+    }
+    for (size_t j = 0; j < count; ++j)
+    {
+        c[j] = 1.0 / (double)(j + 1);
+        cf[j] = (float)c[j];
+    }
+
+    printf("CPU features: 0x%X, %zu points, degree %zu (ns/point)\n", asm_cpu_features(), n, degree);
+    printf("%12s %10s %10s\n", "type", "C Horner", "asm");
+
+    double t_c, t_asm;
+    BENCH_NS(c_horner(c, count, x, out, n), n, t_c);
+    BENCH_NS(asm_poly_eval_f64(c, count, x, out, n), n, t_asm);
+    printf("%12s %10.3f %10.3f\n", "f64", t_c, t_asm);
+
+    BENCH_NS(c_horner_f32(cf, count, xf, outf, n), n, t_c);
+    BENCH_NS(asm_poly_eval_f32(cf, count, xf, outf, n), n, t_asm);
+    printf("%12s %10.3f %10.3f\n", "f32", t_c, t_asm);
+
+    free(x);
+    free(out);
+    free(c);
+    free(xf);
+    free(outf);
+    free(cf);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "asm_math_ops/math_ops_asm.h"
+
+// asm_string_length / asm_string_copy 与 glibc strlen / strncpy 的对比
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 每个长度至少扫描 1GB，返回最好一轮的平均每次调用耗时 (ns)
+#define BENCH_NS(expr, len, result)                                      \
+    do                                                                   \
+    {                                                                    \
+        size_t iters_ = ((size_t)1 << 30) / ((len) + 1) + 1;             \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t i_ = 0; i_ < iters_; ++i_)                       \
+            {                                                            \
+                __asm__ volatile("" ::: "memory");                       \
+                sink += (size_t)(expr);                                  \
+            }                                                            \
+            double ns_ = (now_seconds() - start_) * 1e9 / iters_;        \
+            best_ = ns_ < best_ ? ns_ : best_;                           \
+        }                                                                \
+        (result) = best_;                                                \
+    } while (0)
+
+int main(int argc, char **argv)
+{
+    size_t max_len = argc > 1 ? strtoull(argv[1], NULL, 0) : ((size_t)1 << 20);
+    size_t dest_size = 4096; // 模拟固定大小的目标缓冲区（strncpy 会填充剩余部分）
+    char *src = malloc(max_len + 2);
+    char *dst = malloc(max_len + dest_size + 1);
+    if (!src || !dst)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    memset(src, 'a', max_len + 1);
+    volatile size_t sink = 0;
+
+    printf("CPU features: 0x%X\n", asm_cpu_features());
+    printf("%10s %12s %12s %16s %16s\n", "length", "strlen", "asm_strlen", "strncpy(4KB)", "asm_copy(4KB)");
+
+    for (size_t len = 8; len <= max_len; len *= 4)
+    {
+        char *s = src + 1; // 非对齐起点
+        s[len] = '\0';
+        size_t size = len + 1 > dest_size ? len + 1 : dest_size;
+        double t_strlen, t_asm_len, t_strncpy, t_asm_copy;
+        BENCH_NS(strlen(s), len, t_strlen);
+        BENCH_NS(asm_string_length(s), len, t_asm_len);
+        BENCH_NS(strncpy(dst, s, size - 1) != NULL, len, t_strncpy);
+        BENCH_NS(asm_string_copy(dst, s, size), len, t_asm_copy);
+        printf("%10zu %9.1f ns %9.1f ns %13.1f ns %13.1f ns\n", len, t_strlen, t_asm_len, t_strncpy, t_asm_copy);
+        s[len] = 'a';
+    }
+
+    free(src);
+    free(dst);
+    return 0;
+}
@@ -0,0 +1,91 @@
+"""
+C-level declarations for the asm_math bindings.
+
+Other Cython modules can ``from asm_math cimport add, add_saturating`` and call the scalar
+entry points as plain C functions (no Python call, no int boxing); asm_math must be imported
+at runtime, nothing extra is linked. Modules that link the assembly library themselves can
+also cimport the raw declarations below (asm_add, asm_dot_f64, ...).
+"""
+
+from libc.stdint cimport int32_t, int64_t, uint8_t, uint64_t, uint32_t
+
+# Declare C functions from our assembly library
+cdef extern from "asm_math_ops/math_ops_asm.h" nogil:
+    int64_t asm_add(int64_t a, int64_t b)
+    int64_t asm_subtract(int64_t a, int64_t b)
+    int64_t asm_multiply(int64_t a, int64_t b)
+    uint64_t asm_factorial(uint32_t n)
+    uint64_t asm_power(uint32_t base, uint32_t exp)
+    uint64_t asm_bitwise_and(uint64_t a, uint64_t b)
+    uint64_t asm_bitwise_or(uint64_t a, uint64_t b)
+    uint64_t asm_left_shift(uint64_t value, int shift)
+    int asm_add_checked(int64_t a, int64_t b, int64_t *result)
+    int asm_subtract_checked(int64_t a, int64_t b, int64_t *result)
+    int asm_multiply_checked(int64_t a, int64_t b, int64_t *result)
+    int64_t asm_add_sat(int64_t a, int64_t b)
+    int64_t asm_subtract_sat(int64_t a, int64_t b)
+    int64_t asm_multiply_sat(int64_t a, int64_t b)
+
+    void asm_bitwise_and_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n)
+    void asm_bitwise_or_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n)
+    void asm_bitwise_xor_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n)
+    void asm_bitwise_and_u32(const uint32_t *a, const uint32_t *b, uint32_t *out, size_t n)
+    void asm_bitwise_or_u32(const uint32_t *a, const uint32_t *b, uint32_t *out, size_t n)
+    void asm_bitwise_xor_u32(const uint32_t *a, const uint32_t *b, uint32_t *out, size_t n)
+    void asm_bitwise_and_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n)
+    void asm_bitwise_or_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n)
+    void asm_bitwise_xor_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n)
+    void asm_bitwise_and_mask_u32(const uint32_t *a, uint32_t mask, uint32_t *out, size_t n)
+    void asm_bitwise_or_mask_u32(const uint32_t *a, uint32_t mask, uint32_t *out, size_t n)
+    void asm_bitwise_xor_mask_u32(const uint32_t *a, uint32_t mask, uint32_t *out, size_t n)
+    uint64_t asm_popcount_u64(const uint64_t *data, size_t n)
+    uint64_t asm_popcount_u32(const uint32_t *data, size_t n)
+    uint64_t asm_reduce_and_u64(const uint64_t *data, size_t n)
+    uint64_t asm_reduce_or_u64(const uint64_t *data, size_t n)
+    uint32_t asm_reduce_and_u32(const uint32_t *data, size_t n)
+    uint32_t asm_reduce_or_u32(const uint32_t *data, size_t n)
+
+    ctypedef struct asm_int_divider:
+        int32_t divisor
+    int asm_int_divider_init(asm_int_divider *d, int32_t divisor)
+    void asm_div_int_array(const asm_int_divider *d, const int32_t *inp, int32_t *out, size_t n)
+    void asm_mod_int_array(const asm_int_divider *d, const int32_t *inp, int32_t *out, size_t n)
+
+    size_t asm_add_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
+    size_t asm_sub_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
+    size_t asm_mul_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
+    size_t asm_add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+    size_t asm_sub_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+    size_t asm_mul_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+
+    double asm_dot_f64(const double *x, const double *y, size_t n)
+    float asm_dot_f32(const float *x, const float *y, size_t n)
+    void asm_axpy_f64(double a, const double *x, double *y, size_t n)
+    void asm_axpy_f32(float a, const float *x, float *y, size_t n)
+    void asm_scale_f64(double a, double *x, size_t n)
+    void asm_scale_f32(float a, float *x, size_t n)
+    double asm_norm2_f64(const double *x, size_t n)
+    float asm_norm2_f32(const float *x, size_t n)
+    void asm_fma_f64(const double *a, const double *b, const double *c, double *out, size_t n)
+    void asm_fma_f32(const float *a, const float *b, const float *c, float *out, size_t n)
+    void asm_poly_eval_f64(const double *coeffs, size_t count, const double *x, double *out, size_t n)
+    void asm_poly_eval_f32(const float *coeffs, size_t count, const float *x, float *out, size_t n)
+
+
+
+# 标量入口：Python 侧是 METH_FASTCALL 的模块函数，Cython 侧是直接的 C 调用。
+# 会抛异常的函数在 C 侧以 -1 / 0 表示可能出错（调用方需检查 PyErr_Occurred，Cython 自动处理）
+cpdef int64_t add(int64_t a, int64_t b) noexcept nogil
+cpdef int64_t subtract(int64_t a, int64_t b) noexcept nogil
+cpdef int64_t multiply(int64_t a, int64_t b) noexcept nogil
+cpdef uint64_t factorial(int n) except? 0 nogil
+cpdef uint64_t power(uint32_t base, int exp) except? 0 nogil
+cpdef uint64_t bitwise_and(uint64_t a, uint64_t b) noexcept nogil
+cpdef uint64_t bitwise_or(uint64_t a, uint64_t b) noexcept nogil
+cpdef uint64_t left_shift(uint64_t value, int shift) except? 0 nogil
+cpdef int64_t add_checked(int64_t a, int64_t b) except? -1 nogil
+cpdef int64_t subtract_checked(int64_t a, int64_t b) except? -1 nogil
+cpdef int64_t multiply_checked(int64_t a, int64_t b) except? -1 nogil
+cpdef int64_t add_saturating(int64_t a, int64_t b) noexcept nogil
+cpdef int64_t subtract_saturating(int64_t a, int64_t b) noexcept nogil
+cpdef int64_t multiply_saturating(int64_t a, int64_t b) noexcept nogil
@@ -1,22 +1,236 @@
-# cython: language_level=3
+# cython: language_level=3, binding=False
 
 """
 Cython bindings for Assembly math operations library.
 This compiles to a Python extension module that links directly to the assembly library.
+
+The scalar operations are also module-level functions (asm_math.add(1, 2)); they skip the
+AsmMathOps method lookup and are C functions for Cython code that cimports asm_math (see asm_math.pxd).
 """
 
-from libc.stdint cimport int64_t, uint64_t, uint32_t
+from cpython cimport array
+import array
+
+# Array kernels accept any C-contiguous buffer of 32-bit ('I') or 64-bit ('Q')
+# unsigned words, e.g. array.array or numpy uint32/uint64 arrays.
+ctypedef fused word_t:
+    uint32_t
+    uint64_t
+
+# BLAS-1 kernels accept C-contiguous float64 ('d') or float32 ('f') buffers, e.g. numpy arrays.
+ctypedef fused real_t:
+    float
+    double
+
+cdef enum BitwiseOp:
+    OP_AND
+    OP_OR
+    OP_XOR
+
+cdef array.array _U32_TEMPLATE = array.array('I')
+cdef array.array _U64_TEMPLATE = array.array('Q')
+cdef array.array _I32_TEMPLATE = array.array('i')
+cdef array.array _U8_TEMPLATE = array.array('B')
+cdef array.array _F32_TEMPLATE = array.array('f')
+cdef array.array _F64_TEMPLATE = array.array('d')
+
+
+cdef object _new_words(Py_ssize_t n, size_t itemsize):
+    """Allocate an uninitialized array.array of n words."""
+    return array.clone(_U32_TEMPLATE if itemsize == 4 else _U64_TEMPLATE, n, zero=False)
+
+
+# ---------------------------------------------------------------------------
+# 标量运算：模块函数（声明见 asm_math.pxd）
+# ---------------------------------------------------------------------------
+
+cpdef int64_t add(int64_t a, int64_t b) noexcept nogil:
+    """Add two int64 values using assembly (wraps on overflow)."""
+    return asm_add(a, b)
+
+
+cpdef int64_t subtract(int64_t a, int64_t b) noexcept nogil:
+    """Subtract two int64 values using assembly (wraps on overflow)."""
+    return asm_subtract(a, b)
+
+
+cpdef int64_t multiply(int64_t a, int64_t b) noexcept nogil:
+    """Multiply two int64 values using assembly (wraps on overflow)."""
+    return asm_multiply(a, b)
+
+
+cpdef uint64_t factorial(int n) except? 0 nogil:
+    """Factorial of 0 <= n <= 20 using assembly."""
+    if n < 0:
+        with gil:
+            raise ValueError("Factorial is not defined for negative numbers")
+    if n > 20:  # Prevent overflow
+        with gil:
+            raise ValueError("Factorial too large (max n=20)")
+    return asm_factorial(n)
+
+
+cpdef uint64_t power(uint32_t base, int exp) except? 0 nogil:
+    """base ** exp modulo 2**64 using assembly."""
+    if exp < 0:
+        with gil:
+            raise ValueError("Negative exponents not supported")
+    return asm_power(base, exp)
+
+
+cpdef uint64_t bitwise_and(uint64_t a, uint64_t b) noexcept nogil:
+    """Bitwise AND of two uint64 values using assembly."""
+    return asm_bitwise_and(a, b)
+
+
+cpdef uint64_t bitwise_or(uint64_t a, uint64_t b) noexcept nogil:
+    """Bitwise OR of two uint64 values using assembly."""
+    return asm_bitwise_or(a, b)
+
+
+cpdef uint64_t left_shift(uint64_t value, int shift) except? 0 nogil:
+    """Left shift of a uint64 value using assembly."""
+    if shift < 0:
+        with gil:
+            raise ValueError("Negative shift not supported")
+    return asm_left_shift(value, shift)
+
+
+cpdef int64_t add_checked(int64_t a, int64_t b) except? -1 nogil:
+    """Add two int64 values, raising OverflowError instead of wrapping."""
+    cdef int64_t result
+    if asm_add_checked(a, b, &result):
+        with gil:
+            raise OverflowError("int64 addition overflow")
+    return result
+
+
+cpdef int64_t subtract_checked(int64_t a, int64_t b) except? -1 nogil:
+    """Subtract two int64 values, raising OverflowError instead of wrapping."""
+    cdef int64_t result
+    if asm_subtract_checked(a, b, &result):
+        with gil:
+            raise OverflowError("int64 subtraction overflow")
+    return result
+
+
+cpdef int64_t multiply_checked(int64_t a, int64_t b) except? -1 nogil:
+    """Multiply two int64 values, raising OverflowError instead of wrapping."""
+    cdef int64_t result
+    if asm_multiply_checked(a, b, &result):
+        with gil:
+            raise OverflowError("int64 multiplication overflow")
+    return result
+
+
+cpdef int64_t add_saturating(int64_t a, int64_t b) noexcept nogil:
+    """Add two int64 values, clamping to the int64 range."""
+    return asm_add_sat(a, b)
+
+
+cpdef int64_t subtract_saturating(int64_t a, int64_t b) noexcept nogil:
+    """Subtract two int64 values, clamping to the int64 range."""
+    return asm_subtract_sat(a, b)
+
+
+cpdef int64_t multiply_saturating(int64_t a, int64_t b) noexcept nogil:
+    """Multiply two int64 values, clamping to the int64 range."""
+    return asm_multiply_sat(a, b)
+
+
+cdef enum ArithOp:
+    ARITH_ADD
+    ARITH_SUB
+    ARITH_MUL
+
+
+cdef object _arith_arrays(const int32_t[::1] a, const int32_t[::1] b, object out, bint saturate, ArithOp op):
+    """Shared body of the int32 batch methods: returns result, or (result, overflow) when not saturating."""
+    cdef Py_ssize_t n = a.shape[0]
+    if b.shape[0] != n:
+        raise ValueError("Input arrays must have the same length")
+    if out is None:
+        out = array.clone(_I32_TEMPLATE, n, zero=False)
+    cdef int32_t[::1] dst = out
+    if dst.shape[0] != n:
+        raise ValueError("Output array must have the same length as the inputs")
+    cdef array.array overflow = array.clone(_U8_TEMPLATE, n, zero=False)
+    if n == 0:
+        return out if saturate else (out, overflow)
+
+    if saturate:
+        if op == ARITH_ADD:
+            asm_add_int_array_sat(&a[0], &b[0], &dst[0], n)
+        elif op == ARITH_SUB:
+            asm_sub_int_array_sat(&a[0], &b[0], &dst[0], n)
+        else:
+            asm_mul_int_array_sat(&a[0], &b[0], &dst[0], n)
+        return out
 
-# Declare C functions from our assembly library
-cdef extern from "asm_math_ops/math_ops_asm.h":
-    int64_t asm_add(int64_t a, int64_t b)
-    int64_t asm_subtract(int64_t a, int64_t b)
-    int64_t asm_multiply(int64_t a, int64_t b)
-    uint64_t asm_factorial(uint32_t n)
-    uint64_t asm_power(uint32_t base, uint32_t exp)
-    uint64_t asm_bitwise_and(uint64_t a, uint64_t b)
-    uint64_t asm_bitwise_or(uint64_t a, uint64_t b)
-    uint64_t asm_left_shift(uint64_t value, int shift)
+    if op == ARITH_ADD:
+        asm_add_int_array_checked(&a[0], &b[0], &dst[0], overflow.data.as_uchars, n)
+    elif op == ARITH_SUB:
+        asm_sub_int_array_checked(&a[0], &b[0], &dst[0], overflow.data.as_uchars, n)
+    else:
+        asm_mul_int_array_checked(&a[0], &b[0], &dst[0], overflow.data.as_uchars, n)
+    return out, overflow
+
+
+cdef object _bitwise_arrays(const word_t[::1] a, const word_t[::1] b, object out, BitwiseOp op):
+    cdef Py_ssize_t n = a.shape[0]
+    if b.shape[0] != n:
+        raise ValueError("Input arrays must have the same length")
+    if out is None:
+        out = _new_words(n, sizeof(word_t))
+    cdef word_t[::1] dst = out
+    if dst.shape[0] != n:
+        raise ValueError("Output array must have the same length as the inputs")
+    if n == 0:
+        return out
+
+    if word_t is uint64_t:
+        if op == OP_AND:
+            asm_bitwise_and_u64(&a[0], &b[0], &dst[0], n)
+        elif op == OP_OR:
+            asm_bitwise_or_u64(&a[0], &b[0], &dst[0], n)
+        else:
+            asm_bitwise_xor_u64(&a[0], &b[0], &dst[0], n)
+    else:
+        if op == OP_AND:
+            asm_bitwise_and_u32(&a[0], &b[0], &dst[0], n)
+        elif op == OP_OR:
+            asm_bitwise_or_u32(&a[0], &b[0], &dst[0], n)
+        else:
+            asm_bitwise_xor_u32(&a[0], &b[0], &dst[0], n)
+    return out
+
+
+cdef object _bitwise_mask(const word_t[::1] a, object mask, object out, BitwiseOp op):
+    cdef Py_ssize_t n = a.shape[0]
+    cdef word_t value = mask
+    if out is None:
+        out = _new_words(n, sizeof(word_t))
+    cdef word_t[::1] dst = out
+    if dst.shape[0] != n:
+        raise ValueError("Output array must have the same length as the input")
+    if n == 0:
+        return out
+
+    if word_t is uint64_t:
+        if op == OP_AND:
+            asm_bitwise_and_mask_u64(&a[0], value, &dst[0], n)
+        elif op == OP_OR:
+            asm_bitwise_or_mask_u64(&a[0], value, &dst[0], n)
+        else:
+            asm_bitwise_xor_mask_u64(&a[0], value, &dst[0], n)
+    else:
+        if op == OP_AND:
+            asm_bitwise_and_mask_u32(&a[0], value, &dst[0], n)
+        elif op == OP_OR:
+            asm_bitwise_or_mask_u32(&a[0], value, &dst[0], n)
+        else:
+            asm_bitwise_xor_mask_u32(&a[0], value, &dst[0], n)
+    return out
 
 
 cdef class AsmMathOps:
@@ -24,40 +238,251 @@ cdef class AsmMathOps:
 
     def add(self, int a, int b):
         """Add two 64-bit integers using assembly."""
-        return asm_add(a, b)
+        return add(a, b)
 
     def subtract(self, int a, int b):
         """Subtract two 64-bit integers using assembly."""
-        return asm_subtract(a, b)
+        return subtract(a, b)
 
     def multiply(self, int a, int b):
         """Multiply two 64-bit integers using assembly."""
-        return asm_multiply(a, b)
+        return multiply(a, b)
 
     def factorial(self, int n):
         """Calculate factorial using assembly."""
-        if n < 0:
-            raise ValueError("Factorial is not defined for negative numbers")
-        if n > 20:  # Prevent overflow
-            raise ValueError("Factorial too large (max n=20)")
-        return asm_factorial(n)
+        return factorial(n)
 
     def power(self, int base, int exp):
         """Calculate power using assembly."""
-        if exp < 0:
-            raise ValueError("Negative exponents not supported")
-        return asm_power(base, exp)
+        return power(<uint32_t>base, exp)
 
     def bitwise_and(self, int a, int b):
         """Bitwise AND operation using assembly."""
-        return asm_bitwise_and(a, b)
+        return bitwise_and(<uint64_t>a, <uint64_t>b)
 
     def bitwise_or(self, int a, int b):
         """Bitwise OR operation using assembly."""
-        return asm_bitwise_or(a, b)
+        return bitwise_or(<uint64_t>a, <uint64_t>b)
 
     def left_shift(self, int value, int shift):
         """Left shift operation using assembly."""
-        if shift < 0:
-            raise ValueError("Negative shift not supported")
-        return asm_left_shift(value, shift)
\ No newline at end of file
+        return left_shift(<uint64_t>value, shift)
+
+    def add_checked(self, int64_t a, int64_t b):
+        """Add two int64 values, raising OverflowError instead of wrapping."""
+        return add_checked(a, b)
+
+    def subtract_checked(self, int64_t a, int64_t b):
+        """Subtract two int64 values, raising OverflowError instead of wrapping."""
+        return subtract_checked(a, b)
+
+    def multiply_checked(self, int64_t a, int64_t b):
+        """Multiply two int64 values, raising OverflowError instead of wrapping."""
+        return multiply_checked(a, b)
+
+    def add_saturating(self, int64_t a, int64_t b):
+        """Add two int64 values, clamping to the int64 range."""
+        return add_saturating(a, b)
+
+    def subtract_saturating(self, int64_t a, int64_t b):
+        """Subtract two int64 values, clamping to the int64 range."""
+        return subtract_saturating(a, b)
+
+    def multiply_saturating(self, int64_t a, int64_t b):
+        """Multiply two int64 values, clamping to the int64 range."""
+        return multiply_saturating(a, b)
+
+    def add_arrays(self, const int32_t[::1] a, const int32_t[::1] b, out=None, saturate=False):
+        """Element-wise int32 addition (AVX2) without branching on overflow.
+
+        Returns (result, overflow) where result holds the wrapped sums and overflow is an
+        array('B') of 0/1 flags; with saturate=True returns only the saturated result.
+        out may be one of the inputs.
+        """
+        return _arith_arrays(a, b, out, saturate, ARITH_ADD)
+
+    def subtract_arrays(self, const int32_t[::1] a, const int32_t[::1] b, out=None, saturate=False):
+        """Element-wise int32 subtraction; see add_arrays."""
+        return _arith_arrays(a, b, out, saturate, ARITH_SUB)
+
+    def multiply_arrays(self, const int32_t[::1] a, const int32_t[::1] b, out=None, saturate=False):
+        """Element-wise int32 multiplication; see add_arrays."""
+        return _arith_arrays(a, b, out, saturate, ARITH_MUL)
+
+    def bitwise_and_array(self, const word_t[::1] a, const word_t[::1] b, out=None):
+        """Element-wise AND of two word arrays. Writes into out (may alias a or b) or a new array."""
+        return _bitwise_arrays(a, b, out, OP_AND)
+
+    def bitwise_or_array(self, const word_t[::1] a, const word_t[::1] b, out=None):
+        """Element-wise OR of two word arrays."""
+        return _bitwise_arrays(a, b, out, OP_OR)
+
+    def bitwise_xor_array(self, const word_t[::1] a, const word_t[::1] b, out=None):
+        """Element-wise XOR of two word arrays."""
+        return _bitwise_arrays(a, b, out, OP_XOR)
+
+    def bitwise_and_mask(self, const word_t[::1] a, mask, out=None):
+        """AND every word of a with a scalar mask."""
+        return _bitwise_mask(a, mask, out, OP_AND)
+
+    def bitwise_or_mask(self, const word_t[::1] a, mask, out=None):
+        """OR every word of a with a scalar mask."""
+        return _bitwise_mask(a, mask, out, OP_OR)
+
+    def bitwise_xor_mask(self, const word_t[::1] a, mask, out=None):
+        """XOR every word of a with a scalar mask."""
+        return _bitwise_mask(a, mask, out, OP_XOR)
+
+    def popcount(self, const word_t[::1] a):
+        """Total number of set bits in a word array."""
+        if a.shape[0] == 0:
+            return 0
+        if word_t is uint64_t:
+            return asm_popcount_u64(&a[0], a.shape[0])
+        else:
+            return asm_popcount_u32(&a[0], a.shape[0])
+
+    def reduce_and(self, const word_t[::1] a):
+        """AND of all words (all bits set for an empty array)."""
+        if a.shape[0] == 0:
+            return <word_t>~(<word_t>0)
+        if word_t is uint64_t:
+            return asm_reduce_and_u64(&a[0], a.shape[0])
+        else:
+            return asm_reduce_and_u32(&a[0], a.shape[0])
+
+    def reduce_or(self, const word_t[::1] a):
+        """OR of all words (0 for an empty array)."""
+        if a.shape[0] == 0:
+            return 0
+        if word_t is uint64_t:
+            return asm_reduce_or_u64(&a[0], a.shape[0])
+        else:
+            return asm_reduce_or_u32(&a[0], a.shape[0])
+
+    def dot(self, const real_t[::1] x, const real_t[::1] y):
+        """Dot product of two float32/float64 buffers (AVX-512 / FMA)."""
+        cdef Py_ssize_t n = x.shape[0]
+        if y.shape[0] != n:
+            raise ValueError("Input arrays must have the same length")
+        if n == 0:
+            return 0.0
+        if real_t is double:
+            return asm_dot_f64(&x[0], &y[0], n)
+        else:
+            return asm_dot_f32(&x[0], &y[0], n)
+
+    def axpy(self, a, const real_t[::1] x, real_t[::1] y):
+        """y = a * x + y, updating the writable buffer y in place."""
+        cdef real_t value = a
+        cdef Py_ssize_t n = x.shape[0]
+        if y.shape[0] != n:
+            raise ValueError("Input arrays must have the same length")
+        if n == 0:
+            return
+        if real_t is double:
+            asm_axpy_f64(value, &x[0], &y[0], n)
+        else:
+            asm_axpy_f32(value, &x[0], &y[0], n)
+
+    def scale(self, a, real_t[::1] x):
+        """x = a * x, updating the writable buffer x in place."""
+        cdef real_t value = a
+        if x.shape[0] == 0:
+            return
+        if real_t is double:
+            asm_scale_f64(value, &x[0], x.shape[0])
+        else:
+            asm_scale_f32(value, &x[0], x.shape[0])
+
+    def norm(self, const real_t[::1] x):
+        """Euclidean norm, without rescaling (overflows to inf)."""
+        if x.shape[0] == 0:
+            return 0.0
+        if real_t is double:
+            return asm_norm2_f64(&x[0], x.shape[0])
+        else:
+            return asm_norm2_f32(&x[0], x.shape[0])
+
+    def fma(self, const real_t[::1] a, const real_t[::1] b, const real_t[::1] c, out=None):
+        """Element-wise a * b + c (rounded once when the CPU has FMA).
+
+        Writes into out (may be one of the inputs) or a new array of the input type.
+        """
+        cdef Py_ssize_t n = a.shape[0]
+        if b.shape[0] != n or c.shape[0] != n:
+            raise ValueError("Input arrays must have the same length")
+        if out is None:
+            out = array.clone(_F64_TEMPLATE if real_t is double else _F32_TEMPLATE, n, zero=False)
+        cdef real_t[::1] dst = out
+        if dst.shape[0] != n:
+            raise ValueError("Output array must have the same length as the inputs")
+        if n == 0:
+            return out
+        if real_t is double:
+            asm_fma_f64(&a[0], &b[0], &c[0], &dst[0], n)
+        else:
+            asm_fma_f32(&a[0], &b[0], &c[0], &dst[0], n)
+        return out
+
+    def poly_eval(self, const real_t[::1] coeffs, const real_t[::1] x, out=None):
+        """Evaluate coeffs[0] + coeffs[1] * x + ... at every point (Estrin, FMA).
+
+        Coefficients are in ascending order. Writes into out (may be x) or a new
+        array of the input type.
+        """
+        cdef Py_ssize_t n = x.shape[0]
+        cdef const real_t *c = NULL
+        if out is None:
+            out = array.clone(_F64_TEMPLATE if real_t is double else _F32_TEMPLATE, n, zero=False)
+        cdef real_t[::1] dst = out
+        if dst.shape[0] != n:
+            raise ValueError("Output array must have the same length as the inputs")
+        if n == 0:
+            return out
+        if coeffs.shape[0]:
+            c = &coeffs[0]
+        if real_t is double:
+            asm_poly_eval_f64(c, coeffs.shape[0], &x[0], &dst[0], n)
+        else:
+            asm_poly_eval_f32(c, coeffs.shape[0], &x[0], &dst[0], n)
+        return out
+
+
+cdef class AsmIntDivider:
+    """Precomputed int32 divisor for SIMD batch division and modulo.
+
+    Results truncate toward zero like C (not Python's floor division).
+    """
+    cdef asm_int_divider _d
+
+    def __cinit__(self, int divisor):
+        if asm_int_divider_init(&self._d, divisor) != 0:
+            raise ZeroDivisionError("Division by zero")
+
+    @property
+    def divisor(self):
+        return self._d.divisor
+
+    def divide_array(self, const int32_t[::1] values, out=None):
+        """Divide every element of an int32 buffer; writes into out (may be values) or a new array('i')."""
+        return self._apply(values, out, False)
+
+    def mod_array(self, const int32_t[::1] values, out=None):
+        """Remainder of every element of an int32 buffer (sign follows the dividend)."""
+        return self._apply(values, out, True)
+
+    cdef object _apply(self, const int32_t[::1] values, object out, bint mod):
+        cdef Py_ssize_t n = values.shape[0]
+        if out is None:
+            out = array.clone(_I32_TEMPLATE, n, zero=False)
+        cdef int32_t[::1] dst = out
+        if dst.shape[0] != n:
+            raise ValueError("Output array must have the same length as the input")
+        if n == 0:
+            return out
+        if mod:
+            asm_mod_int_array(&self._d, &values[0], &dst[0], n)
+        else:
+            asm_div_int_array(&self._d, &values[0], &dst[0], n)
+        return out
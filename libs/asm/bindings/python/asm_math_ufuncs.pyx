@@ -0,0 +1,120 @@
+# cython: language_level=3
+
+"""
+NumPy ufuncs backed by the assembly math operations library.
+
+Each ufunc is named after the assembly function it applies: asm_add and asm_multiply take int64
+arrays and wrap on overflow; asm_factorial maps int64 n to uint64 n!. They broadcast and accept
+out= / where= like any ufunc, and asm_add / asm_multiply support reduce / accumulate.
+
+asm_factorial is defined for 0 <= n <= 20; other inputs give 0 and set numpy's invalid-value
+flag, so np.errstate decides whether that warns (the default), raises or is ignored.
+"""
+
+cimport numpy as cnp
+from libc.stdint cimport int64_t, uint32_t, uint64_t
+# 用模块名限定汇编函数，本模块导出的 ufunc 与汇编函数同名
+cimport asm_math
+
+cnp.import_array()
+cnp.import_ufunc()
+
+cdef extern from "fenv.h" nogil:
+    int FE_INVALID
+    int feraiseexcept(int excepts)
+
+
+# ---------------------------------------------------------------------------
+# 内层循环：args = 输入、输出的起始地址，dims[0] = 元素个数，steps = 字节步长。
+# 这些汇编函数只有标量版本，每个元素调用一次（约 1 ns），但整个循环在本地代码中完成
+# ---------------------------------------------------------------------------
+
+cdef enum BinaryOp:
+    OP_ADD
+    OP_MUL
+
+
+cdef inline int64_t _apply(int64_t a, int64_t b, BinaryOp op) noexcept nogil:
+    if op == OP_ADD:
+        return asm_math.asm_add(a, b)
+    return asm_math.asm_multiply(a, b)
+
+
+cdef inline void _binary_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, BinaryOp op) noexcept nogil:
+    cdef cnp.npy_intp i, n = dims[0]
+    cdef char *a = args[0]
+    cdef char *b = args[1]
+    cdef char *out = args[2]
+    cdef const int64_t *pb
+    cdef int64_t acc
+    if a == out and steps[0] == 0 and steps[2] == 0 and steps[1] == 8:
+        # reduce：累加器同时是第一个输入和输出，步长为 0，放在寄存器中
+        pb = <const int64_t *>b
+        acc = (<int64_t *>out)[0]
+        for i in range(n):
+            acc = _apply(acc, pb[i], op)
+        (<int64_t *>out)[0] = acc
+        return
+    for i in range(n):
+        (<int64_t *>out)[0] = _apply((<int64_t *>a)[0], (<int64_t *>b)[0], op)
+        a += steps[0]
+        b += steps[1]
+        out += steps[2]
+
+
+cdef void _add_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_ADD)
+
+
+cdef void _multiply_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_MUL)
+
+
+cdef void _factorial_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    cdef cnp.npy_intp i, n = dims[0]
+    cdef char *inp = args[0]
+    cdef char *out = args[1]
+    cdef int64_t x
+    cdef bint invalid = False
+    for i in range(n):
+        x = (<int64_t *>inp)[0]
+        if 0 <= x <= 20:
+            (<uint64_t *>out)[0] = asm_math.asm_factorial(<uint32_t>x)
+        else:
+            # 负数会让汇编循环近 2^32 次，大于 20 则溢出
+            invalid = True
+            (<uint64_t *>out)[0] = 0
+        inp += steps[0]
+        out += steps[1]
+    if invalid:
+        feraiseexcept(FE_INVALID)
+
+
+# ---------------------------------------------------------------------------
+# 注册。numpy 保存这些数组的指针，它们必须和模块一样长寿。
+# 名字沿用汇编函数名：numpy 对名为 add / multiply 的 ufunc 在 reduce 时会改变默认 dtype。
+# numpy 2 的头文件中 dims / steps 带 const，Cython 的声明没有，因此赋值时显式转换
+# ---------------------------------------------------------------------------
+
+cdef cnp.PyUFuncGenericFunction _add_funcs[1]
+cdef cnp.PyUFuncGenericFunction _multiply_funcs[1]
+cdef cnp.PyUFuncGenericFunction _factorial_funcs[1]
+cdef void *_no_data[1]
+cdef char _int64_types[3]
+cdef char _factorial_types[2]
+
+_int64_types[:] = [cnp.NPY_INT64, cnp.NPY_INT64, cnp.NPY_INT64]
+_factorial_types[:] = [cnp.NPY_INT64, cnp.NPY_UINT64]
+_add_funcs[0] = <cnp.PyUFuncGenericFunction>_add_loop
+_multiply_funcs[0] = <cnp.PyUFuncGenericFunction>_multiply_loop
+_factorial_funcs[0] = <cnp.PyUFuncGenericFunction>_factorial_loop
+
+asm_add = cnp.PyUFunc_FromFuncAndData(
+    _add_funcs, _no_data, _int64_types, 1, 2, 1, cnp.PyUFunc_Zero, b"asm_add",
+    b"Element-wise int64 addition in assembly, wrapping on overflow.", 0)
+asm_multiply = cnp.PyUFunc_FromFuncAndData(
+    _multiply_funcs, _no_data, _int64_types, 1, 2, 1, cnp.PyUFunc_One, b"asm_multiply",
+    b"Element-wise int64 multiplication in assembly, wrapping on overflow.", 0)
+asm_factorial = cnp.PyUFunc_FromFuncAndData(
+    _factorial_funcs, _no_data, _factorial_types, 1, 1, 1, cnp.PyUFunc_None, b"asm_factorial",
+    b"Element-wise n! for 0 <= n <= 20 in assembly (uint64); other n give 0 with an invalid-value error.", 0)
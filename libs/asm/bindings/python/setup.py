@@ -6,21 +6,36 @@ from setuptools import setup, Extension
 from Cython.Build import cythonize
 import os
 
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+INCLUDE_DIR = os.path.join(os.path.dirname(__file__), '..', '..', 'include')
+STATIC_LIB = os.path.join(os.path.dirname(__file__), '..', '..', '..', '..', 'build', 'lib', 'libasm_math_ops.a')
+
 # Define the extension module
 extensions = [
     Extension(
         "asm_math",
         sources=["asm_math.pyx"],
-        include_dirs=[
-            os.path.join(os.path.dirname(__file__), '..', '..', 'include'),
-        ],
-        extra_objects=[
-            os.path.join(os.path.dirname(__file__), '..', '..', '..', '..', 'build', 'lib', 'libasm_math_ops.a'),
-        ],
+        include_dirs=[INCLUDE_DIR],
+        extra_objects=[STATIC_LIB],
         extra_compile_args=["-O3"],
     )
 ]
 
+# NumPy ufunc 模块只在安装了 numpy 时构建
+if numpy is not None:
+    extensions.append(Extension(
+        "asm_math_ufuncs",
+        sources=["asm_math_ufuncs.pyx"],
+        include_dirs=[INCLUDE_DIR, numpy.get_include()],
+        extra_objects=[STATIC_LIB],
+        define_macros=[("NPY_NO_DEPRECATED_API", "NPY_1_7_API_VERSION")],
+        extra_compile_args=["-O3"],
+    ))
+
 setup(
     name="asm_math_ops",
     version="1.0.0",
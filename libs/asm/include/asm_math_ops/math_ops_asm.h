@@ -2,6 +2,11 @@
 #define MATH_OPS_ASM_H
 
 #include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 // x64 汇编实现的计算函数
 extern int64_t asm_add(int64_t a, int64_t b);
@@ -13,4 +18,121 @@ extern uint64_t asm_bitwise_and(uint64_t a, uint64_t b);
 extern uint64_t asm_bitwise_or(uint64_t a, uint64_t b);
 extern uint64_t asm_left_shift(uint64_t value, int shift);
 
+// 带溢出检查的运算：溢出返回 1（*result 为回绕后的结果），否则返回 0
+extern int asm_add_checked(int64_t a, int64_t b, int64_t *result);
+extern int asm_subtract_checked(int64_t a, int64_t b, int64_t *result);
+extern int asm_multiply_checked(int64_t a, int64_t b, int64_t *result);
+
+// 饱和运算：溢出时取 INT64_MAX / INT64_MIN
+extern int64_t asm_add_sat(int64_t a, int64_t b);
+extern int64_t asm_subtract_sat(int64_t a, int64_t b);
+extern int64_t asm_multiply_sat(int64_t a, int64_t b);
+
+// CPU 特性位（asm_cpu_features 的返回值），SIMD 内核据此在运行时选择实现
+#define ASM_CPU_SSE42           (1u << 1)
+#define ASM_CPU_AVX2            (1u << 2)
+#define ASM_CPU_AVX512          (1u << 3)   // AVX-512 F + BW
+#define ASM_CPU_ERMS            (1u << 4)   // 增强型 rep movsb/stosb
+#define ASM_CPU_FMA             (1u << 5)
+#define ASM_CPU_POPCNT          (1u << 6)
+#define ASM_CPU_AVX512VPOPCNT   (1u << 7)
+
+extern uint32_t asm_cpu_features(void);
+extern uint32_t asm_cpu_restrict_features(uint32_t mask); // 仅保留 mask 中的特性（测试 / 规避用）
+extern void asm_cpu_reset_features(void);                 // 重新检测
+extern size_t asm_cpu_llc_size(void);                     // 最后一级缓存容量，未知时为 0
+
+// SIMD 内存操作，语义同 memcpy / memset（源和目标不可重叠）
+// 超过阈值的大块使用非临时存储，避免冲刷缓存；阈值默认为 LLC 容量
+extern void *asm_memory_copy(void *dest, const void *src, size_t n);
+extern void *asm_memory_set(void *dest, int value, size_t n);
+extern void asm_memory_set_nt_threshold(size_t bytes);   // 0 表示自动
+extern size_t asm_memory_get_nt_threshold(void);
+
+// SIMD 字符串操作（AVX2 / SSE2 运行时分派）
+// asm_string_copy 为 strlcpy 语义：不填充剩余缓冲区，返回 strlen(src)，返回值 >= size 表示被截断
+extern size_t asm_string_length(const char *str);
+extern size_t asm_string_copy(char *dest, const char *src, size_t size);
+extern void asm_string_length_batch(const char *const *strs, size_t count, size_t *lengths); // 空指针长度为 0
+extern size_t asm_string_copy_batch(char *const *dests, const char *const *srcs, size_t count,
+                                    size_t size, size_t *lengths); // 返回被截断的个数，lengths 可为 NULL
+
+// 整数数组按位运算（AVX-512 / AVX2 运行时分派），out 可与输入相同（原地运算）
+extern void asm_bitwise_and_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n);
+extern void asm_bitwise_or_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n);
+extern void asm_bitwise_xor_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n);
+extern void asm_bitwise_and_u32(const uint32_t *a, const uint32_t *b, uint32_t *out, size_t n);
+extern void asm_bitwise_or_u32(const uint32_t *a, const uint32_t *b, uint32_t *out, size_t n);
+extern void asm_bitwise_xor_u32(const uint32_t *a, const uint32_t *b, uint32_t *out, size_t n);
+
+// 每个元素与同一个掩码运算
+extern void asm_bitwise_and_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n);
+extern void asm_bitwise_or_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n);
+extern void asm_bitwise_xor_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n);
+extern void asm_bitwise_and_mask_u32(const uint32_t *a, uint32_t mask, uint32_t *out, size_t n);
+extern void asm_bitwise_or_mask_u32(const uint32_t *a, uint32_t mask, uint32_t *out, size_t n);
+extern void asm_bitwise_xor_mask_u32(const uint32_t *a, uint32_t mask, uint32_t *out, size_t n);
+
+// 置位总数与按位归约（空数组：AND 返回全 1，OR 返回 0）
+extern uint64_t asm_popcount_u64(const uint64_t *data, size_t n);
+extern uint64_t asm_popcount_u32(const uint32_t *data, size_t n);
+extern uint64_t asm_reduce_and_u64(const uint64_t *data, size_t n);
+extern uint64_t asm_reduce_or_u64(const uint64_t *data, size_t n);
+extern uint32_t asm_reduce_and_u32(const uint32_t *data, size_t n);
+extern uint32_t asm_reduce_or_u32(const uint32_t *data, size_t n);
+
+// 预计算的不变除数（libdivide 风格）：批量除法 / 取模变为乘法和移位（AVX-512 / AVX2 运行时分派）
+// 结果与 C 的 / 和 % 相同；INT32_MIN / -1 回绕为 INT32_MIN，余数为 0。字段由 asm_int_divider_init 填写
+typedef struct
+{
+    int32_t divisor;
+    int32_t magic;  // 0 表示 |divisor| 是 2 的幂
+    int32_t add;
+    int32_t sign;
+    uint32_t shift;
+} asm_int_divider;
+
+extern int asm_int_divider_init(asm_int_divider *d, int32_t divisor); // divisor 为 0 时返回 -1
+extern void asm_div_int_array(const asm_int_divider *d, const int32_t *in, int32_t *out, size_t n);
+extern void asm_mod_int_array(const asm_int_divider *d, const int32_t *in, int32_t *out, size_t n);
+
+// int32 数组带溢出检查 / 饱和运算（AVX2 运行时分派，无数据相关分支），返回溢出的元素个数
+// _checked 把回绕结果写入 out，overflow[i] 为 0 / 1；_sat 把饱和结果写入 out。out 可与 a 或 b 相同
+extern size_t asm_add_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n);
+extern size_t asm_sub_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n);
+extern size_t asm_mul_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n);
+extern size_t asm_add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+extern size_t asm_sub_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+extern size_t asm_mul_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+
+// 浮点数组 BLAS-1 运算（AVX-512 / AVX + FMA 运行时分派，无 FMA 时退回 SSE2 标量，乘加分别舍入）
+// 点积和范数用多个累加器分组求和，与逐个累加的舍入误差不同；_f32 在单精度下累加
+extern double asm_dot_f64(const double *x, const double *y, size_t n);
+extern float asm_dot_f32(const float *x, const float *y, size_t n);
+extern void asm_axpy_f64(double a, const double *x, double *y, size_t n); // y = a·x + y，原地更新 y
+extern void asm_axpy_f32(float a, const float *x, float *y, size_t n);
+extern void asm_scale_f64(double a, double *x, size_t n);                // x = a·x，原地更新
+extern void asm_scale_f32(float a, float *x, size_t n);
+extern double asm_norm2_f64(const double *x, size_t n);                   // 欧几里得范数，不做缩放，平方和上溢时为 inf
+extern float asm_norm2_f32(const float *x, size_t n);
+// out = a·b + c（逐元素），out 可与任一输入相同
+extern void asm_fma_f64(const double *a, const double *b, const double *c, double *out, size_t n);
+extern void asm_fma_f32(const float *a, const float *b, const float *c, float *out, size_t n);
+
+// 矩阵乘法微内核（AVX + FMA，无 FMA 时退回 SSE2 标量）：C 的 6×NR 小块 (+)= A 面板 · B 面板，NR 为 8（double）/ 16（float）。
+// a 为打包的 k×6 面板（每个 p 连续 6 个元素），b 为打包的 k×NR 面板（每个 p 连续 NR 个元素），
+// c 为行主序小块的左上角，ldc 为行距（元素个数）；accumulate 为 0 时覆盖写入，否则累加到 c
+extern void asm_gemm_kernel_f64(size_t k, const double *a, const double *b, double *c, size_t ldc, int accumulate);
+extern void asm_gemm_kernel_f32(size_t k, const float *a, const float *b, float *c, size_t ldc, int accumulate);
+
+// 批量多项式求值：out[i] = c[0] + c[1]·x[i] + ... + c[count-1]·x[i]^(count-1)（系数按升幂排列）。
+// Estrin 方案：系数按下标模 4 分为 4 组，各组用 x⁴ 的 Horner 链并行推进，再两两合并；
+// AVX-512 / AVX + FMA 每次求 2 个向量的点，其余点用标量 FMA 按相同顺序计算。out 可与 x 相同，count 为 0 时结果为 0
+extern void asm_poly_eval_f64(const double *coeffs, size_t count, const double *x, double *out, size_t n);
+extern void asm_poly_eval_f32(const float *coeffs, size_t count, const float *x, float *out, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // MATH_OPS_ASM_H
\ No newline at end of file
@@ -0,0 +1,475 @@
+; bitwise_ops.asm - x64 汇编实现的整数数组按位运算
+; 使用 System V AMD64 ABI 调用约定
+;
+; 逐元素运算与位计数和元素宽度无关，内核按字节长度处理：主循环用 AVX-512 / AVX2，
+; 余下部分按 8 字节和 4 字节标量处理；_u32 / _u64 入口只负责把元素个数换算为字节数。
+; 输出数组可以与输入数组相同（原地运算）。
+
+default rel
+
+%include "cpu_features.inc"
+
+section .rodata
+align 32
+nibble_popcnt:  db 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+                db 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+low_nibbles:    times 32 db 0x0F
+
+section .text
+global asm_bitwise_and_u64
+global asm_bitwise_or_u64
+global asm_bitwise_xor_u64
+global asm_bitwise_and_u32
+global asm_bitwise_or_u32
+global asm_bitwise_xor_u32
+global asm_bitwise_and_mask_u64
+global asm_bitwise_or_mask_u64
+global asm_bitwise_xor_mask_u64
+global asm_bitwise_and_mask_u32
+global asm_bitwise_or_mask_u32
+global asm_bitwise_xor_mask_u32
+global asm_popcount_u64
+global asm_popcount_u32
+global asm_reduce_and_u64
+global asm_reduce_or_u64
+global asm_reduce_and_u32
+global asm_reduce_or_u32
+
+; 两个数组逐元素运算，内部入口
+; 参数: rdi = a, rsi = b, rdx = out, rcx = 字节数
+; %1 = 名字, %2 = AVX2 指令, %3 = AVX-512 指令, %4 = 标量指令
+%macro BINARY_ARRAY 4
+%1:
+    LOAD_CPU_FLAGS
+    xor r8d, r8d                ; r8 = 已处理字节数
+    test eax, CPU_AVX512
+    jnz %%avx512
+    test eax, CPU_AVX2
+    jz %%tail8
+    jmp %%avx2_128
+%%avx512:
+    lea r9, [r8 + 256]
+    cmp r9, rcx
+    ja %%avx2_128
+    vmovdqu64 zmm0, [rdi + r8]
+    vmovdqu64 zmm1, [rdi + r8 + 64]
+    vmovdqu64 zmm2, [rdi + r8 + 128]
+    vmovdqu64 zmm3, [rdi + r8 + 192]
+    %3 zmm0, zmm0, [rsi + r8]
+    %3 zmm1, zmm1, [rsi + r8 + 64]
+    %3 zmm2, zmm2, [rsi + r8 + 128]
+    %3 zmm3, zmm3, [rsi + r8 + 192]
+    vmovdqu64 [rdx + r8], zmm0
+    vmovdqu64 [rdx + r8 + 64], zmm1
+    vmovdqu64 [rdx + r8 + 128], zmm2
+    vmovdqu64 [rdx + r8 + 192], zmm3
+    mov r8, r9
+    jmp %%avx512
+%%avx2_128:
+    lea r9, [r8 + 128]
+    cmp r9, rcx
+    ja %%avx2_32
+    vmovdqu ymm0, [rdi + r8]
+    vmovdqu ymm1, [rdi + r8 + 32]
+    vmovdqu ymm2, [rdi + r8 + 64]
+    vmovdqu ymm3, [rdi + r8 + 96]
+    %2 ymm0, ymm0, [rsi + r8]
+    %2 ymm1, ymm1, [rsi + r8 + 32]
+    %2 ymm2, ymm2, [rsi + r8 + 64]
+    %2 ymm3, ymm3, [rsi + r8 + 96]
+    vmovdqu [rdx + r8], ymm0
+    vmovdqu [rdx + r8 + 32], ymm1
+    vmovdqu [rdx + r8 + 64], ymm2
+    vmovdqu [rdx + r8 + 96], ymm3
+    mov r8, r9
+    jmp %%avx2_128
+%%avx2_32:
+    lea r9, [r8 + 32]
+    cmp r9, rcx
+    ja %%avx_done
+    vmovdqu ymm0, [rdi + r8]
+    %2 ymm0, ymm0, [rsi + r8]
+    vmovdqu [rdx + r8], ymm0
+    mov r8, r9
+    jmp %%avx2_32
+%%avx_done:
+    vzeroupper
+%%tail8:
+    lea r9, [r8 + 8]
+    cmp r9, rcx
+    ja %%tail4
+    mov r10, [rdi + r8]
+    %4 r10, [rsi + r8]
+    mov [rdx + r8], r10
+    mov r8, r9
+    jmp %%tail8
+%%tail4:
+    cmp r8, rcx
+    jae %%done
+    mov r10d, [rdi + r8]
+    %4 r10d, [rsi + r8]
+    mov [rdx + r8], r10d
+%%done:
+    ret
+%endmacro
+
+; 数组与标量掩码逐元素运算，内部入口
+; 参数: rdi = a, rsi = 8 字节掩码（32 位元素时高低两半相同）, rdx = out, rcx = 字节数
+%macro MASK_ARRAY 4
+%1:
+    LOAD_CPU_FLAGS
+    xor r8d, r8d
+    test eax, CPU_AVX512
+    jnz %%avx512_init
+    test eax, CPU_AVX2
+    jz %%tail8
+    vmovq xmm4, rsi
+    vpbroadcastq ymm4, xmm4
+    jmp %%avx2_128
+%%avx512_init:
+    vpbroadcastq zmm4, rsi
+%%avx512:
+    lea r9, [r8 + 256]
+    cmp r9, rcx
+    ja %%avx2_128
+    %3 zmm0, zmm4, [rdi + r8]
+    %3 zmm1, zmm4, [rdi + r8 + 64]
+    %3 zmm2, zmm4, [rdi + r8 + 128]
+    %3 zmm3, zmm4, [rdi + r8 + 192]
+    vmovdqu64 [rdx + r8], zmm0
+    vmovdqu64 [rdx + r8 + 64], zmm1
+    vmovdqu64 [rdx + r8 + 128], zmm2
+    vmovdqu64 [rdx + r8 + 192], zmm3
+    mov r8, r9
+    jmp %%avx512
+%%avx2_128:
+    lea r9, [r8 + 128]
+    cmp r9, rcx
+    ja %%avx2_32
+    %2 ymm0, ymm4, [rdi + r8]
+    %2 ymm1, ymm4, [rdi + r8 + 32]
+    %2 ymm2, ymm4, [rdi + r8 + 64]
+    %2 ymm3, ymm4, [rdi + r8 + 96]
+    vmovdqu [rdx + r8], ymm0
+    vmovdqu [rdx + r8 + 32], ymm1
+    vmovdqu [rdx + r8 + 64], ymm2
+    vmovdqu [rdx + r8 + 96], ymm3
+    mov r8, r9
+    jmp %%avx2_128
+%%avx2_32:
+    lea r9, [r8 + 32]
+    cmp r9, rcx
+    ja %%avx_done
+    %2 ymm0, ymm4, [rdi + r8]
+    vmovdqu [rdx + r8], ymm0
+    mov r8, r9
+    jmp %%avx2_32
+%%avx_done:
+    vzeroupper
+%%tail8:
+    lea r9, [r8 + 8]
+    cmp r9, rcx
+    ja %%tail4
+    mov r10, [rdi + r8]
+    %4 r10, rsi
+    mov [rdx + r8], r10
+    mov r8, r9
+    jmp %%tail8
+%%tail4:
+    cmp r8, rcx
+    jae %%done
+    mov r10d, [rdi + r8]
+    %4 r10d, esi
+    mov [rdx + r8], r10d
+%%done:
+    ret
+%endmacro
+
+BINARY_ARRAY and_bytes, vpand, vpandq, and
+BINARY_ARRAY or_bytes, vpor, vporq, or
+BINARY_ARRAY xor_bytes, vpxor, vpxorq, xor
+MASK_ARRAY and_mask_bytes, vpand, vpandq, and
+MASK_ARRAY or_mask_bytes, vpor, vporq, or
+MASK_ARRAY xor_mask_bytes, vpxor, vpxorq, xor
+
+; 公开入口：元素个数换算为字节数后跳转到内核
+; void asm_bitwise_and_u64(const uint64_t *a, const uint64_t *b, uint64_t *out, size_t n) 等
+asm_bitwise_and_u64:
+    shl rcx, 3
+    jmp and_bytes
+asm_bitwise_or_u64:
+    shl rcx, 3
+    jmp or_bytes
+asm_bitwise_xor_u64:
+    shl rcx, 3
+    jmp xor_bytes
+asm_bitwise_and_u32:
+    shl rcx, 2
+    jmp and_bytes
+asm_bitwise_or_u32:
+    shl rcx, 2
+    jmp or_bytes
+asm_bitwise_xor_u32:
+    shl rcx, 2
+    jmp xor_bytes
+
+; void asm_bitwise_and_mask_u64(const uint64_t *a, uint64_t mask, uint64_t *out, size_t n) 等
+asm_bitwise_and_mask_u64:
+    shl rcx, 3
+    jmp and_mask_bytes
+asm_bitwise_or_mask_u64:
+    shl rcx, 3
+    jmp or_mask_bytes
+asm_bitwise_xor_mask_u64:
+    shl rcx, 3
+    jmp xor_mask_bytes
+
+; 32 位掩码复制到高低两半
+%macro WIDEN_MASK32 0
+    mov esi, esi
+    mov r8, rsi
+    shl r8, 32
+    or rsi, r8
+    shl rcx, 2
+%endmacro
+
+asm_bitwise_and_mask_u32:
+    WIDEN_MASK32
+    jmp and_mask_bytes
+asm_bitwise_or_mask_u32:
+    WIDEN_MASK32
+    jmp or_mask_bytes
+asm_bitwise_xor_mask_u32:
+    WIDEN_MASK32
+    jmp xor_mask_bytes
+
+; 位计数内核
+; 参数: rdi = 数据, rsi = 字节数
+; 返回: rax = 置位总数
+; AVX-512 VPOPCNTDQ 直接计数；AVX2 用半字节查表（vpshufb）加 vpsadbw 求和；其余逐 8 字节 popcnt
+popcount_bytes:
+    LOAD_CPU_FLAGS
+    mov r10d, eax               ; r10d = CPU 特性（尾部处理仍需要）
+    xor r8d, r8d
+    xor r9d, r9d                ; r9 = 标量部分的计数
+    test r10d, CPU_AVX512VPOPCNT
+    jnz .vpopcnt
+    test r10d, CPU_AVX2
+    jnz .avx2
+    jmp .tail8
+
+.vpopcnt:
+    vpxorq zmm4, zmm4, zmm4
+    vpxorq zmm5, zmm5, zmm5
+.vpopcnt_loop:
+    lea rdx, [r8 + 128]
+    cmp rdx, rsi
+    ja .vpopcnt_done
+    vpopcntq zmm0, [rdi + r8]
+    vpopcntq zmm1, [rdi + r8 + 64]
+    vpaddq zmm4, zmm4, zmm0
+    vpaddq zmm5, zmm5, zmm1
+    mov r8, rdx
+    jmp .vpopcnt_loop
+.vpopcnt_done:
+    vpaddq zmm4, zmm4, zmm5
+    vextracti64x4 ymm5, zmm4, 1
+    vpaddq ymm4, ymm4, ymm5
+    jmp .hsum
+
+.avx2:
+    vmovdqa ymm6, [rel nibble_popcnt]
+    vmovdqa ymm7, [rel low_nibbles]
+    vpxor xmm5, xmm5, xmm5      ; vpsadbw 的零操作数
+    vpxor xmm4, xmm4, xmm4
+    vpxor xmm8, xmm8, xmm8
+.avx2_loop:
+    lea rdx, [r8 + 64]
+    cmp rdx, rsi
+    ja .avx2_done
+    vmovdqu ymm0, [rdi + r8]
+    vmovdqu ymm2, [rdi + r8 + 32]
+    vpsrlw ymm1, ymm0, 4
+    vpsrlw ymm3, ymm2, 4
+    vpand ymm0, ymm0, ymm7
+    vpand ymm1, ymm1, ymm7
+    vpand ymm2, ymm2, ymm7
+    vpand ymm3, ymm3, ymm7
+    vpshufb ymm0, ymm6, ymm0
+    vpshufb ymm1, ymm6, ymm1
+    vpshufb ymm2, ymm6, ymm2
+    vpshufb ymm3, ymm6, ymm3
+    vpaddb ymm0, ymm0, ymm1
+    vpaddb ymm2, ymm2, ymm3
+    vpsadbw ymm0, ymm0, ymm5
+    vpsadbw ymm2, ymm2, ymm5
+    vpaddq ymm4, ymm4, ymm0
+    vpaddq ymm8, ymm8, ymm2
+    mov r8, rdx
+    jmp .avx2_loop
+.avx2_done:
+    vpaddq ymm4, ymm4, ymm8
+
+.hsum:
+    vextracti128 xmm0, ymm4, 1
+    vpaddq xmm4, xmm4, xmm0
+    vpshufd xmm0, xmm4, 0x4E
+    vpaddq xmm4, xmm4, xmm0
+    vmovq r9, xmm4
+    vzeroupper
+
+.tail8:
+    lea rdx, [r8 + 8]
+    cmp rdx, rsi
+    ja .tail4
+    mov rcx, [rdi + r8]
+    mov r8, rdx
+    call popcount_word
+    add r9, rcx
+    jmp .tail8
+.tail4:
+    cmp r8, rsi
+    jae .done
+    mov ecx, [rdi + r8]
+    call popcount_word
+    add r9, rcx
+.done:
+    mov rax, r9
+    ret
+
+; 单个 64 位字的位计数：rcx -> rcx，r10d 为 CPU 特性；破坏 rax / rdx
+popcount_word:
+    test r10d, CPU_POPCNT
+    jz .swar
+    popcnt rcx, rcx
+    ret
+.swar:
+    mov rax, rcx
+    shr rax, 1
+    mov rdx, 0x5555555555555555
+    and rax, rdx
+    sub rcx, rax
+    mov rdx, 0x3333333333333333
+    mov rax, rcx
+    shr rax, 2
+    and rcx, rdx
+    and rax, rdx
+    add rcx, rax
+    mov rax, rcx
+    shr rax, 4
+    add rcx, rax
+    mov rdx, 0x0F0F0F0F0F0F0F0F
+    and rcx, rdx
+    mov rdx, 0x0101010101010101
+    imul rcx, rdx
+    shr rcx, 56
+    ret
+
+; uint64_t asm_popcount_u64(const uint64_t *data, size_t n)
+asm_popcount_u64:
+    shl rsi, 3
+    jmp popcount_bytes
+
+; uint64_t asm_popcount_u32(const uint32_t *data, size_t n)
+asm_popcount_u32:
+    shl rsi, 2
+    jmp popcount_bytes
+
+; 归约内核：对 rsi 个 64 位字做按位归约，不破坏 r11
+; 参数: rdi = 数据, rsi = 字数
+; 返回: rax = 归约结果（空数组返回单位元）
+; %1 = 名字, %2 = AVX2 指令, %3 = AVX-512 指令, %4 = 标量指令, %5 = 单位元（0 或 -1）
+%macro REDUCE_WORDS 5
+%1:
+    LOAD_CPU_FLAGS
+    mov r10d, eax
+    shl rsi, 3                  ; 字节数
+    xor r8d, r8d
+    mov rax, %5
+    test r10d, CPU_AVX2
+    jz %%tail
+    vmovq xmm4, rax
+    vpbroadcastq ymm4, xmm4
+    vmovdqa ymm5, ymm4
+    test r10d, CPU_AVX512
+    jz %%avx2
+    vpbroadcastq zmm4, rax
+    vmovdqa64 zmm5, zmm4
+%%avx512:
+    lea r9, [r8 + 128]
+    cmp r9, rsi
+    ja %%avx512_fold
+    %3 zmm4, zmm4, [rdi + r8]
+    %3 zmm5, zmm5, [rdi + r8 + 64]
+    mov r8, r9
+    jmp %%avx512
+%%avx512_fold:
+    %3 zmm4, zmm4, zmm5
+    vextracti64x4 ymm5, zmm4, 1
+%%avx2:
+    lea r9, [r8 + 64]
+    cmp r9, rsi
+    ja %%avx2_fold
+    %2 ymm4, ymm4, [rdi + r8]
+    %2 ymm5, ymm5, [rdi + r8 + 32]
+    mov r8, r9
+    jmp %%avx2
+%%avx2_fold:
+    %2 ymm4, ymm4, ymm5
+    vextracti128 xmm5, ymm4, 1
+    %2 xmm4, xmm4, xmm5
+    vpshufd xmm5, xmm4, 0x4E
+    %2 xmm4, xmm4, xmm5
+    vmovq rax, xmm4
+    vzeroupper
+%%tail:
+    cmp r8, rsi
+    jae %%done
+    %4 rax, [rdi + r8]
+    add r8, 8
+    jmp %%tail
+%%done:
+    ret
+%endmacro
+
+REDUCE_WORDS reduce_and_words, vpand, vpandq, and, -1
+REDUCE_WORDS reduce_or_words, vpor, vporq, or, 0
+
+; uint64_t asm_reduce_and_u64(const uint64_t *data, size_t n) - 空数组返回全 1
+asm_reduce_and_u64:
+    jmp reduce_and_words
+
+; uint64_t asm_reduce_or_u64(const uint64_t *data, size_t n) - 空数组返回 0
+asm_reduce_or_u64:
+    jmp reduce_or_words
+
+; uint32_t asm_reduce_and_u32(const uint32_t *data, size_t n)
+; 成对元素按 64 位字归约后折叠高低两半，奇数个时单独并入最后一个元素
+asm_reduce_and_u32:
+    mov r11d, -1
+    test sil, 1
+    jz .even
+    mov r11d, [rdi + rsi * 4 - 4]
+.even:
+    shr rsi, 1
+    call reduce_and_words
+    mov rdx, rax
+    shr rdx, 32
+    and eax, edx
+    and eax, r11d
+    ret
+
+; uint32_t asm_reduce_or_u32(const uint32_t *data, size_t n)
+asm_reduce_or_u32:
+    xor r11d, r11d
+    test sil, 1
+    jz .even
+    mov r11d, [rdi + rsi * 4 - 4]
+.even:
+    shr rsi, 1
+    call reduce_or_words
+    mov rdx, rax
+    shr rdx, 32
+    or eax, edx
+    or eax, r11d
+    ret
@@ -0,0 +1,405 @@
+; blas_ops.asm - x64 汇编实现的浮点数组 BLAS-1 运算（点积、axpy、缩放、范数、逐元素乘加）
+; 使用 System V AMD64 ABI 调用约定
+;
+; 每个运算提供 _f64 / _f32 两种入口，由同一个宏按类型展开：%2 为指令后缀中的类型字母
+; （d = double，s = float），%3 为元素字节数。内核按字节长度处理，与 bitwise_ops.asm 相同。
+; 主循环用 AVX-512（zmm）或 AVX + FMA（ymm），余下元素用标量 FMA 处理；AVX-512F 本身包含 FMA。
+; 不支持 FMA 的 CPU 退回 SSE2 标量循环，乘法和加法分别舍入，结果的最后一位可能与 FMA 路径不同。
+; 归约（点积 / 范数）用 4 个累加器隐藏 FMA 延迟，求和顺序与逐个累加不同。
+
+default rel
+
+%include "cpu_features.inc"
+
+section .text
+global asm_dot_f64
+global asm_dot_f32
+global asm_axpy_f64
+global asm_axpy_f32
+global asm_scale_f64
+global asm_scale_f32
+global asm_norm2_f64
+global asm_norm2_f32
+global asm_fma_f64
+global asm_fma_f32
+
+; xmm0 的最低元素广播到 zmm0（AVX-512）或 ymm0（AVX）
+; %1 = 类型字母, %2 = 跳转目标（AVX-512 广播后）
+%macro BROADCAST_XMM0 2
+    test eax, CPU_AVX512
+    jz %%avx
+    vbroadcasts%1 zmm0, xmm0
+    jmp %2
+%%avx:
+%ifidn %1, d
+    vmovddup xmm0, xmm0
+%else
+    vshufps xmm0, xmm0, xmm0, 0
+%endif
+    vinsertf128 ymm0, ymm0, xmm0, 1
+%endmacro
+
+; xmm0 各元素求和到最低元素
+%macro HSUM_XMM0 1
+%ifidn %1, d
+    vunpckhpd xmm1, xmm0, xmm0
+    vaddsd xmm0, xmm0, xmm1
+%else
+    vmovhlps xmm1, xmm0, xmm0
+    vaddps xmm0, xmm0, xmm1
+    vmovshdup xmm1, xmm0
+    vaddss xmm0, xmm0, xmm1
+%endif
+%endmacro
+
+; T asm_dot_xxx(const T *x, const T *y, size_t n)
+; 参数: rdi = x, rsi = y, rdx = n
+; 返回: xmm0 = Σ x[i]·y[i]（空数组为 0）
+; %1 = 名字, %2 = 类型字母, %3 = 元素字节数, %4 = 库内部入口（供范数调用）
+%macro DOT 4
+%1:
+%4:
+    LOAD_CPU_FLAGS
+    imul rcx, rdx, %3           ; rcx = 字节数
+    xor r8d, r8d                ; r8 = 已处理字节数
+    test eax, CPU_FMA | CPU_AVX512
+    jz %%scalar
+    vxorps xmm0, xmm0, xmm0
+    vxorps xmm1, xmm1, xmm1
+    vxorps xmm2, xmm2, xmm2
+    vxorps xmm3, xmm3, xmm3
+    test eax, CPU_AVX512
+    jz %%fma_128
+%%avx512:
+    lea r9, [r8 + 256]
+    cmp r9, rcx
+    ja %%avx512_done
+    vmovup%2 zmm4, [rdi + r8]
+    vmovup%2 zmm5, [rdi + r8 + 64]
+    vmovup%2 zmm6, [rdi + r8 + 128]
+    vmovup%2 zmm7, [rdi + r8 + 192]
+    vfmadd231p%2 zmm0, zmm4, [rsi + r8]
+    vfmadd231p%2 zmm1, zmm5, [rsi + r8 + 64]
+    vfmadd231p%2 zmm2, zmm6, [rsi + r8 + 128]
+    vfmadd231p%2 zmm3, zmm7, [rsi + r8 + 192]
+    mov r8, r9
+    jmp %%avx512
+%%avx512_done:
+    ; 4 个 zmm 累加器合并后折半到 ymm0，ymm 循环继续累加剩余部分
+    vaddp%2 zmm0, zmm0, zmm1
+    vaddp%2 zmm2, zmm2, zmm3
+    vaddp%2 zmm0, zmm0, zmm2
+    vextractf64x4 ymm1, zmm0, 1
+    vaddp%2 ymm0, ymm0, ymm1
+    vxorps xmm1, xmm1, xmm1
+    vxorps xmm2, xmm2, xmm2
+    vxorps xmm3, xmm3, xmm3
+%%fma_128:
+    lea r9, [r8 + 128]
+    cmp r9, rcx
+    ja %%fma_32
+    vmovup%2 ymm4, [rdi + r8]
+    vmovup%2 ymm5, [rdi + r8 + 32]
+    vmovup%2 ymm6, [rdi + r8 + 64]
+    vmovup%2 ymm7, [rdi + r8 + 96]
+    vfmadd231p%2 ymm0, ymm4, [rsi + r8]
+    vfmadd231p%2 ymm1, ymm5, [rsi + r8 + 32]
+    vfmadd231p%2 ymm2, ymm6, [rsi + r8 + 64]
+    vfmadd231p%2 ymm3, ymm7, [rsi + r8 + 96]
+    mov r8, r9
+    jmp %%fma_128
+%%fma_32:
+    lea r9, [r8 + 32]
+    cmp r9, rcx
+    ja %%fma_reduce
+    vmovup%2 ymm4, [rdi + r8]
+    vfmadd231p%2 ymm0, ymm4, [rsi + r8]
+    mov r8, r9
+    jmp %%fma_32
+%%fma_reduce:
+    vaddp%2 ymm0, ymm0, ymm1
+    vaddp%2 ymm2, ymm2, ymm3
+    vaddp%2 ymm0, ymm0, ymm2
+    vextractf128 xmm1, ymm0, 1
+    vaddp%2 xmm0, xmm0, xmm1
+    HSUM_XMM0 %2
+    vzeroupper
+%%fma_tail:
+    cmp r8, rcx
+    jae %%done
+    vmovs%2 xmm1, [rdi + r8]
+    vfmadd231s%2 xmm0, xmm1, [rsi + r8]
+    add r8, %3
+    jmp %%fma_tail
+%%scalar:
+    xorps xmm0, xmm0
+%%scalar_loop:
+    cmp r8, rcx
+    jae %%done
+    movs%2 xmm1, [rdi + r8]
+    muls%2 xmm1, [rsi + r8]
+    adds%2 xmm0, xmm1
+    add r8, %3
+    jmp %%scalar_loop
+%%done:
+    ret
+%endmacro
+
+; void asm_axpy_xxx(T a, const T *x, T *y, size_t n)
+; 参数: xmm0 = a, rdi = x, rsi = y, rdx = n
+; 结果: y[i] = a·x[i] + y[i]（原地更新 y）
+%macro AXPY 3
+%1:
+    LOAD_CPU_FLAGS
+    imul rcx, rdx, %3
+    xor r8d, r8d
+    test eax, CPU_FMA | CPU_AVX512
+    jz %%scalar
+    BROADCAST_XMM0 %2, %%avx512
+    jmp %%fma_128
+%%avx512:
+    lea r9, [r8 + 256]
+    cmp r9, rcx
+    ja %%fma_128
+    vmovup%2 zmm1, [rsi + r8]
+    vmovup%2 zmm2, [rsi + r8 + 64]
+    vmovup%2 zmm3, [rsi + r8 + 128]
+    vmovup%2 zmm4, [rsi + r8 + 192]
+    vfmadd231p%2 zmm1, zmm0, [rdi + r8]
+    vfmadd231p%2 zmm2, zmm0, [rdi + r8 + 64]
+    vfmadd231p%2 zmm3, zmm0, [rdi + r8 + 128]
+    vfmadd231p%2 zmm4, zmm0, [rdi + r8 + 192]
+    vmovup%2 [rsi + r8], zmm1
+    vmovup%2 [rsi + r8 + 64], zmm2
+    vmovup%2 [rsi + r8 + 128], zmm3
+    vmovup%2 [rsi + r8 + 192], zmm4
+    mov r8, r9
+    jmp %%avx512
+%%fma_128:
+    lea r9, [r8 + 128]
+    cmp r9, rcx
+    ja %%fma_32
+    vmovup%2 ymm1, [rsi + r8]
+    vmovup%2 ymm2, [rsi + r8 + 32]
+    vmovup%2 ymm3, [rsi + r8 + 64]
+    vmovup%2 ymm4, [rsi + r8 + 96]
+    vfmadd231p%2 ymm1, ymm0, [rdi + r8]
+    vfmadd231p%2 ymm2, ymm0, [rdi + r8 + 32]
+    vfmadd231p%2 ymm3, ymm0, [rdi + r8 + 64]
+    vfmadd231p%2 ymm4, ymm0, [rdi + r8 + 96]
+    vmovup%2 [rsi + r8], ymm1
+    vmovup%2 [rsi + r8 + 32], ymm2
+    vmovup%2 [rsi + r8 + 64], ymm3
+    vmovup%2 [rsi + r8 + 96], ymm4
+    mov r8, r9
+    jmp %%fma_128
+%%fma_32:
+    lea r9, [r8 + 32]
+    cmp r9, rcx
+    ja %%fma_done
+    vmovup%2 ymm1, [rsi + r8]
+    vfmadd231p%2 ymm1, ymm0, [rdi + r8]
+    vmovup%2 [rsi + r8], ymm1
+    mov r8, r9
+    jmp %%fma_32
+%%fma_done:
+    vzeroupper
+%%fma_tail:
+    cmp r8, rcx
+    jae %%done
+    vmovs%2 xmm1, [rsi + r8]
+    vfmadd231s%2 xmm1, xmm0, [rdi + r8]
+    vmovs%2 [rsi + r8], xmm1
+    add r8, %3
+    jmp %%fma_tail
+%%scalar:
+    cmp r8, rcx
+    jae %%done
+    movs%2 xmm1, [rdi + r8]
+    muls%2 xmm1, xmm0
+    adds%2 xmm1, [rsi + r8]
+    movs%2 [rsi + r8], xmm1
+    add r8, %3
+    jmp %%scalar
+%%done:
+    ret
+%endmacro
+
+; void asm_scale_xxx(T a, T *x, size_t n)
+; 参数: xmm0 = a, rdi = x, rsi = n
+; 结果: x[i] = a·x[i]（原地更新）
+%macro SCALE 3
+%1:
+    LOAD_CPU_FLAGS
+    imul rcx, rsi, %3
+    xor r8d, r8d
+    test eax, CPU_FMA | CPU_AVX512
+    jz %%scalar
+    BROADCAST_XMM0 %2, %%avx512
+    jmp %%avx_128
+%%avx512:
+    lea r9, [r8 + 256]
+    cmp r9, rcx
+    ja %%avx_128
+    vmulp%2 zmm1, zmm0, [rdi + r8]
+    vmulp%2 zmm2, zmm0, [rdi + r8 + 64]
+    vmulp%2 zmm3, zmm0, [rdi + r8 + 128]
+    vmulp%2 zmm4, zmm0, [rdi + r8 + 192]
+    vmovup%2 [rdi + r8], zmm1
+    vmovup%2 [rdi + r8 + 64], zmm2
+    vmovup%2 [rdi + r8 + 128], zmm3
+    vmovup%2 [rdi + r8 + 192], zmm4
+    mov r8, r9
+    jmp %%avx512
+%%avx_128:
+    lea r9, [r8 + 128]
+    cmp r9, rcx
+    ja %%avx_32
+    vmulp%2 ymm1, ymm0, [rdi + r8]
+    vmulp%2 ymm2, ymm0, [rdi + r8 + 32]
+    vmulp%2 ymm3, ymm0, [rdi + r8 + 64]
+    vmulp%2 ymm4, ymm0, [rdi + r8 + 96]
+    vmovup%2 [rdi + r8], ymm1
+    vmovup%2 [rdi + r8 + 32], ymm2
+    vmovup%2 [rdi + r8 + 64], ymm3
+    vmovup%2 [rdi + r8 + 96], ymm4
+    mov r8, r9
+    jmp %%avx_128
+%%avx_32:
+    lea r9, [r8 + 32]
+    cmp r9, rcx
+    ja %%avx_done
+    vmulp%2 ymm1, ymm0, [rdi + r8]
+    vmovup%2 [rdi + r8], ymm1
+    mov r8, r9
+    jmp %%avx_32
+%%avx_done:
+    vzeroupper
+%%scalar:
+    ; 标量乘法在两条路径上相同；AVX 路径之后 xmm0 的最低元素仍为 a
+    cmp r8, rcx
+    jae %%done
+    movs%2 xmm1, [rdi + r8]
+    muls%2 xmm1, xmm0
+    movs%2 [rdi + r8], xmm1
+    add r8, %3
+    jmp %%scalar
+%%done:
+    ret
+%endmacro
+
+; T asm_norm2_xxx(const T *x, size_t n)
+; 参数: rdi = x, rsi = n
+; 返回: xmm0 = sqrt(Σ x[i]²)；不做缩放，平方和上溢时为 inf
+; %1 = 名字, %2 = 类型字母, %3 = 点积的库内部入口
+%macro NORM2 3
+%1:
+    mov rdx, rsi
+    mov rsi, rdi
+    sub rsp, 8                  ; 保持调用时栈 16 字节对齐
+    call %3
+    add rsp, 8
+    sqrts%2 xmm0, xmm0
+    ret
+%endmacro
+
+; void asm_fma_xxx(const T *a, const T *b, const T *c, T *out, size_t n)
+; 参数: rdi = a, rsi = b, rdx = c, rcx = out（可与任一输入相同）, r8 = n
+; 结果: out[i] = a[i]·b[i] + c[i]
+%macro FMA_ARRAY 3
+%1:
+    LOAD_CPU_FLAGS
+    imul r8, r8, %3             ; r8 = 字节数
+    xor r9d, r9d                ; r9 = 已处理字节数
+    test eax, CPU_FMA | CPU_AVX512
+    jz %%scalar
+    test eax, CPU_AVX512
+    jz %%fma_128
+%%avx512:
+    lea r10, [r9 + 256]
+    cmp r10, r8
+    ja %%fma_128
+    vmovup%2 zmm0, [rdx + r9]
+    vmovup%2 zmm1, [rdx + r9 + 64]
+    vmovup%2 zmm2, [rdx + r9 + 128]
+    vmovup%2 zmm3, [rdx + r9 + 192]
+    vmovup%2 zmm4, [rdi + r9]
+    vmovup%2 zmm5, [rdi + r9 + 64]
+    vmovup%2 zmm6, [rdi + r9 + 128]
+    vmovup%2 zmm7, [rdi + r9 + 192]
+    vfmadd231p%2 zmm0, zmm4, [rsi + r9]
+    vfmadd231p%2 zmm1, zmm5, [rsi + r9 + 64]
+    vfmadd231p%2 zmm2, zmm6, [rsi + r9 + 128]
+    vfmadd231p%2 zmm3, zmm7, [rsi + r9 + 192]
+    vmovup%2 [rcx + r9], zmm0
+    vmovup%2 [rcx + r9 + 64], zmm1
+    vmovup%2 [rcx + r9 + 128], zmm2
+    vmovup%2 [rcx + r9 + 192], zmm3
+    mov r9, r10
+    jmp %%avx512
+%%fma_128:
+    lea r10, [r9 + 128]
+    cmp r10, r8
+    ja %%fma_32
+    vmovup%2 ymm0, [rdx + r9]
+    vmovup%2 ymm1, [rdx + r9 + 32]
+    vmovup%2 ymm2, [rdx + r9 + 64]
+    vmovup%2 ymm3, [rdx + r9 + 96]
+    vmovup%2 ymm4, [rdi + r9]
+    vmovup%2 ymm5, [rdi + r9 + 32]
+    vmovup%2 ymm6, [rdi + r9 + 64]
+    vmovup%2 ymm7, [rdi + r9 + 96]
+    vfmadd231p%2 ymm0, ymm4, [rsi + r9]
+    vfmadd231p%2 ymm1, ymm5, [rsi + r9 + 32]
+    vfmadd231p%2 ymm2, ymm6, [rsi + r9 + 64]
+    vfmadd231p%2 ymm3, ymm7, [rsi + r9 + 96]
+    vmovup%2 [rcx + r9], ymm0
+    vmovup%2 [rcx + r9 + 32], ymm1
+    vmovup%2 [rcx + r9 + 64], ymm2
+    vmovup%2 [rcx + r9 + 96], ymm3
+    mov r9, r10
+    jmp %%fma_128
+%%fma_32:
+    lea r10, [r9 + 32]
+    cmp r10, r8
+    ja %%fma_done
+    vmovup%2 ymm0, [rdx + r9]
+    vmovup%2 ymm4, [rdi + r9]
+    vfmadd231p%2 ymm0, ymm4, [rsi + r9]
+    vmovup%2 [rcx + r9], ymm0
+    mov r9, r10
+    jmp %%fma_32
+%%fma_done:
+    vzeroupper
+%%fma_tail:
+    cmp r9, r8
+    jae %%done
+    vmovs%2 xmm0, [rdx + r9]
+    vmovs%2 xmm4, [rdi + r9]
+    vfmadd231s%2 xmm0, xmm4, [rsi + r9]
+    vmovs%2 [rcx + r9], xmm0
+    add r9, %3
+    jmp %%fma_tail
+%%scalar:
+    cmp r9, r8
+    jae %%done
+    movs%2 xmm0, [rdi + r9]
+    muls%2 xmm0, [rsi + r9]
+    adds%2 xmm0, [rdx + r9]
+    movs%2 [rcx + r9], xmm0
+    add r9, %3
+    jmp %%scalar
+%%done:
+    ret
+%endmacro
+
+DOT asm_dot_f64, d, 8, dot_f64
+DOT asm_dot_f32, s, 4, dot_f32
+AXPY asm_axpy_f64, d, 8
+AXPY asm_axpy_f32, s, 4
+SCALE asm_scale_f64, d, 8
+SCALE asm_scale_f32, s, 4
+NORM2 asm_norm2_f64, d, dot_f64
+NORM2 asm_norm2_f32, s, dot_f32
+FMA_ARRAY asm_fma_f64, d, 8
+FMA_ARRAY asm_fma_f32, s, 4
@@ -0,0 +1,171 @@
+; checked_ops.asm - x64 汇编实现的 int32 数组带溢出检查 / 饱和运算
+; 使用 System V AMD64 ABI 调用约定
+;
+; 批量内核不含数据相关分支：溢出由符号位运算（加减）或乘积高位（乘）得出，
+; 再据此输出 0 / 1 溢出标志或混合出饱和值。返回溢出的元素个数。
+
+default rel
+
+%include "cpu_features.inc"
+
+%define OP_ADD  0
+%define OP_SUB  1
+%define OP_MUL  2
+
+section .text
+global asm_add_int_array_checked
+global asm_sub_int_array_checked
+global asm_mul_int_array_checked
+global asm_add_int_array_sat
+global asm_sub_int_array_sat
+global asm_mul_int_array_sat
+
+; size_t asm_add_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out,
+;                                  uint8_t *overflow, size_t n)
+; 参数: rdi = a, rsi = b, rdx = out, rcx = overflow（每个元素 0 / 1）, r8 = n
+; 返回: rax = 溢出的元素个数；out 为回绕后的结果
+asm_add_int_array_checked:
+    mov r9d, OP_ADD
+    jmp arith_array
+asm_sub_int_array_checked:
+    mov r9d, OP_SUB
+    jmp arith_array
+asm_mul_int_array_checked:
+    mov r9d, OP_MUL
+    jmp arith_array
+
+; size_t asm_add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+; 参数: rdi = a, rsi = b, rdx = out, rcx = n
+; 返回: rax = 饱和的元素个数；out 为饱和结果
+asm_add_int_array_sat:
+    mov r9d, OP_ADD
+    jmp arith_array_sat
+asm_sub_int_array_sat:
+    mov r9d, OP_SUB
+    jmp arith_array_sat
+asm_mul_int_array_sat:
+    mov r9d, OP_MUL
+arith_array_sat:
+    mov r8, rcx
+    xor ecx, ecx
+
+; 内部入口: rdi = a, rsi = b, rdx = out（可与 a 或 b 相同）, rcx = overflow（NULL 表示饱和）,
+;           r8 = n, r9d = OP_*
+; 循环内按 r9d 和 rcx 分支：整个数组走同一分支，预测总是命中
+arith_array:
+    LOAD_CPU_FLAGS
+    push rbx
+    xor r10d, r10d              ; r10 = 溢出计数
+    test eax, CPU_AVX2
+    jz .scalar
+    cmp r8, 8
+    jb .scalar
+
+    vpcmpeqd ymm15, ymm15, ymm15
+    vpsrld ymm14, ymm15, 1      ; INT32_MAX
+.avx2_loop:
+    vmovdqu ymm0, [rdi]
+    vmovdqu ymm1, [rsi]
+    cmp r9d, OP_SUB
+    je .avx2_sub
+    ja .avx2_mul
+    ; 加法：结果与两个操作数符号都不同即溢出
+    vpaddd ymm2, ymm0, ymm1
+    vpxor ymm3, ymm0, ymm2
+    vpxor ymm4, ymm1, ymm2
+    vpand ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 31       ; ymm3 = 溢出掩码
+    vmovdqa ymm4, ymm0          ; ymm4 符号位决定饱和方向
+    jmp .avx2_result
+.avx2_sub:
+    ; 减法：操作数符号不同且结果与 a 符号不同即溢出
+    vpsubd ymm2, ymm0, ymm1
+    vpxor ymm3, ymm0, ymm1
+    vpxor ymm4, ymm0, ymm2
+    vpand ymm3, ymm3, ymm4
+    vpsrad ymm3, ymm3, 31
+    vmovdqa ymm4, ymm0
+    jmp .avx2_result
+.avx2_mul:
+    ; 乘法：64 位乘积的高 32 位不等于低 32 位的符号扩展即溢出
+    vpmulld ymm2, ymm0, ymm1
+    vpmuldq ymm3, ymm0, ymm1
+    vpsrlq ymm4, ymm0, 32
+    vpsrlq ymm5, ymm1, 32
+    vpmuldq ymm4, ymm4, ymm5
+    vpsrlq ymm3, ymm3, 32
+    vpblendd ymm3, ymm3, ymm4, 0xAA
+    vpsrad ymm4, ymm2, 31
+    vpcmpeqd ymm3, ymm3, ymm4
+    vpxor ymm3, ymm3, ymm15
+    vpxor ymm4, ymm0, ymm1
+.avx2_result:
+    test rcx, rcx
+    jz .avx2_sat
+    ; 8 个 dword 掩码压成 8 个字节 0 / 1
+    vextracti128 xmm5, ymm3, 1
+    vpackssdw xmm5, xmm3, xmm5
+    vpacksswb xmm5, xmm5, xmm5
+    vpabsb xmm5, xmm5
+    vmovq [rcx], xmm5
+    add rcx, 8
+    jmp .avx2_store
+.avx2_sat:
+    vpsrad ymm4, ymm4, 31
+    vpxor ymm4, ymm4, ymm14     ; INT32_MAX 或 INT32_MIN
+    vpblendvb ymm2, ymm2, ymm4, ymm3
+.avx2_store:
+    vmovdqu [rdx], ymm2
+    vmovmskps eax, ymm3
+    popcnt eax, eax             ; 支持 AVX2 的 CPU 都支持 popcnt
+    add r10, rax
+    add rdi, 32
+    add rsi, 32
+    add rdx, 32
+    sub r8, 8
+    cmp r8, 8
+    jae .avx2_loop
+    vzeroupper
+
+.scalar:
+    test r8, r8
+    jz .done
+.scalar_loop:
+    xor ebx, ebx
+    mov eax, [rdi]
+    mov r11d, eax               ; r11d 符号位决定饱和方向
+    cmp r9d, OP_SUB
+    je .scalar_sub
+    ja .scalar_mul
+    add eax, [rsi]
+    jmp .scalar_flag
+.scalar_sub:
+    sub eax, [rsi]
+    jmp .scalar_flag
+.scalar_mul:
+    xor r11d, [rsi]
+    imul eax, [rsi]
+.scalar_flag:
+    seto bl
+    add r10, rbx
+    test rcx, rcx
+    jz .scalar_sat
+    mov [rcx], bl
+    inc rcx
+    jmp .scalar_store
+.scalar_sat:
+    sar r11d, 31
+    xor r11d, 0x7FFFFFFF
+    test ebx, ebx
+    cmovnz eax, r11d
+.scalar_store:
+    mov [rdx], eax
+    add rdi, 4
+    add rsi, 4
+    add rdx, 4
+    dec r8
+    jnz .scalar_loop
+.done:
+    mov rax, r10
+    pop rbx
+    ret
@@ -0,0 +1,196 @@
+; cpu_features.asm - CPU 特性检测，供各 SIMD 内核做运行时分派
+; 使用 System V AMD64 ABI 调用约定
+
+default rel
+
+%define CPU_FEATURES_IMPL
+%include "cpu_features.inc"
+
+global asm_cpu_features
+global asm_cpu_restrict_features
+global asm_cpu_reset_features
+global asm_cpu_llc_size
+global asm_cpu_flags:data hidden
+global asm_cpu_llc_bytes:data hidden
+global asm_cpu_detect:function hidden
+
+section .bss
+align 8
+asm_cpu_llc_bytes: resq 1       ; 最后一级缓存容量（字节），0 表示未知
+asm_cpu_flags:     resd 1       ; 0 表示尚未检测
+
+section .text
+
+; uint32_t asm_cpu_detect(void) - 库内部使用
+; 执行 cpuid 检测并缓存结果
+; 返回: eax = 特性位；除 rax 外不破坏任何寄存器，便于内核在入口处直接调用
+asm_cpu_detect:
+    push rbx
+    push rcx
+    push rdx
+    push rsi
+    push rdi
+    push r8
+    push r9
+    push r10
+    push r11
+
+    mov esi, CPU_INIT           ; esi 累积特性位
+    xor r8d, r8d                ; r8d = XCR0（操作系统未启用 XSAVE 时为 0）
+
+    xor eax, eax
+    cpuid
+    mov edi, eax                ; edi = 最大基本叶号
+
+    ; 最后一级缓存容量：cpuid leaf 4 各级缓存中取最大者
+    xor r10d, r10d              ; r10 = LLC 字节数
+    cmp edi, 4
+    jb .cache_ext
+    xor r11d, r11d              ; r11d = 子叶号
+.cache_loop:
+    mov eax, 4
+    mov ecx, r11d
+    cpuid
+    test eax, 0x1F              ; 缓存类型为 0 表示没有更多缓存
+    jz .cache_ext
+    mov r8d, ebx
+    shr r8d, 22
+    inc r8d                     ; 路数
+    mov r9d, ebx
+    shr r9d, 12
+    and r9d, 0x3FF
+    inc r9d                     ; 分区数
+    imul r8, r9
+    and ebx, 0xFFF
+    inc ebx                     ; 行大小
+    imul r8, rbx
+    inc ecx                     ; 组数
+    imul r8, rcx
+    cmp r8, r10
+    jbe .cache_next
+    mov r10, r8
+.cache_next:
+    inc r11d
+    cmp r11d, 16
+    jb .cache_loop
+.cache_ext:
+    ; leaf 4 不可用（如 AMD）：使用 0x80000006 EDX[31:18]，单位 512KB
+    test r10, r10
+    jnz .cache_done
+    mov eax, 0x80000000
+    cpuid
+    cmp eax, 0x80000006
+    jb .cache_done
+    mov eax, 0x80000006
+    cpuid
+    shr edx, 18
+    mov r10d, edx
+    shl r10, 19
+.cache_done:
+    mov [rel asm_cpu_llc_bytes], r10
+    xor r8d, r8d
+
+    mov eax, 1
+    cpuid
+    mov r9d, ecx                ; r9d = leaf 1 ecx
+    test r9d, 1 << 20           ; SSE4.2
+    jz .no_sse42
+    or esi, CPU_SSE42
+.no_sse42:
+    test r9d, 1 << 23           ; POPCNT
+    jz .no_popcnt
+    or esi, CPU_POPCNT
+.no_popcnt:
+    test r9d, 1 << 27           ; OSXSAVE
+    jz .no_xsave
+    xor ecx, ecx
+    xgetbv
+    mov r8d, eax
+.no_xsave:
+    ; AVX 系列需要 CPU 支持 AVX 且操作系统保存 XMM/YMM 状态
+    mov eax, r8d
+    and eax, 0x6
+    cmp eax, 0x6
+    jne .leaf7
+    test r9d, 1 << 28           ; AVX
+    jz .leaf7
+    test r9d, 1 << 12           ; FMA
+    jz .leaf7
+    or esi, CPU_FMA
+
+.leaf7:
+    cmp edi, 7
+    jb .done
+    mov eax, 7
+    xor ecx, ecx
+    cpuid
+    test ebx, 1 << 9            ; ERMS
+    jz .no_erms
+    or esi, CPU_ERMS
+.no_erms:
+    mov eax, r8d
+    and eax, 0x6
+    cmp eax, 0x6
+    jne .done
+    test r9d, 1 << 28
+    jz .done
+    test ebx, 1 << 5            ; AVX2
+    jz .done
+    or esi, CPU_AVX2
+    ; AVX-512 还需要操作系统保存 opmask / ZMM 状态
+    mov eax, r8d
+    and eax, 0xE6
+    cmp eax, 0xE6
+    jne .done
+    mov eax, ebx
+    and eax, (1 << 16) | (1 << 30)  ; AVX512F | AVX512BW
+    cmp eax, (1 << 16) | (1 << 30)
+    jne .done
+    or esi, CPU_AVX512
+    test ecx, 1 << 14           ; AVX512_VPOPCNTDQ
+    jz .done
+    or esi, CPU_AVX512VPOPCNT
+
+.done:
+    mov [rel asm_cpu_flags], esi
+    mov eax, esi
+
+    pop r11
+    pop r10
+    pop r9
+    pop r8
+    pop rdi
+    pop rsi
+    pop rdx
+    pop rcx
+    pop rbx
+    ret
+
+; uint32_t asm_cpu_features(void)
+; 返回: eax = 当前生效的特性位
+asm_cpu_features:
+    LOAD_CPU_FLAGS
+    ret
+
+; uint32_t asm_cpu_restrict_features(uint32_t mask)
+; 参数: edi = 允许使用的特性位，用于测试或规避某些指令集
+; 返回: eax = 限制后的特性位
+asm_cpu_restrict_features:
+    LOAD_CPU_FLAGS
+    and eax, edi
+    or eax, CPU_INIT
+    mov [rel asm_cpu_flags], eax
+    ret
+
+; void asm_cpu_reset_features(void)
+; 清除缓存的特性位，下次调用时重新检测
+asm_cpu_reset_features:
+    mov dword [rel asm_cpu_flags], 0
+    ret
+
+; size_t asm_cpu_llc_size(void)
+; 返回: rax = 最后一级缓存容量（字节），未知时为 0
+asm_cpu_llc_size:
+    LOAD_CPU_FLAGS
+    mov rax, [rel asm_cpu_llc_bytes]
+    ret
@@ -0,0 +1,249 @@
+; divide_ops.asm - x64 汇编实现的不变除数批量除法 / 取模
+; 使用 System V AMD64 ABI 调用约定
+;
+; 除数预先换算为乘数和移位量（算法同 libdivide），之后每个元素只需一次
+; 有符号乘法取高位、加法和移位，再修正为向零截断；取模再做一次乘减。
+; 结果与 C 的 / 和 % 相同；INT32_MIN / -1 回绕为 INT32_MIN，余数为 0。
+
+default rel
+
+%include "cpu_features.inc"
+
+; asm_int_divider 字段偏移，需与 math_ops_asm.h 保持一致
+%define DIV_DIVISOR     0
+%define DIV_MAGIC       4       ; 0 表示 |divisor| 是 2 的幂，只需移位
+%define DIV_ADD         8       ; 乘法高位结果还需加上被除数时为 -1
+%define DIV_SIGN        12      ; divisor < 0 时为 -1
+%define DIV_SHIFT       16
+
+section .text
+global asm_int_divider_init
+global asm_div_int_array
+global asm_mod_int_array
+
+; int asm_int_divider_init(asm_int_divider *d, int32_t divisor)
+; 参数: rdi = d, esi = divisor
+; 返回: eax = 0，divisor 为 0 时返回 -1（不修改 d）
+asm_int_divider_init:
+    test esi, esi
+    jz .zero
+    mov [rdi + DIV_DIVISOR], esi
+    mov eax, esi
+    sar eax, 31
+    mov [rdi + DIV_SIGN], eax
+    mov r9d, esi
+    xor r9d, eax
+    sub r9d, eax                ; r9 = |divisor|（INT32_MIN 为 2^31）
+    bsr r8d, r9d                ; r8 = floor(log2 |divisor|)
+    mov dword [rdi + DIV_ADD], 0
+    lea eax, [r9 - 1]
+    test eax, r9d
+    jnz .general
+    mov dword [rdi + DIV_MAGIC], 0
+    mov [rdi + DIV_SHIFT], r8d
+    xor eax, eax
+    ret
+.general:
+    ; m = 2^(31 + log2) / |d|（log2 <= 30，被除数放得下 64 位）
+    lea ecx, [r8 + 31]
+    mov eax, 1
+    shl rax, cl
+    xor edx, edx
+    div r9                      ; rax = m, rdx = 余数
+    mov r10d, r9d
+    sub r10d, edx
+    mov r11d, 1
+    mov ecx, r8d
+    shl r11d, cl
+    cmp r10d, r11d              ; |d| - 余数 < 2^log2 时 32 位乘数足够
+    jae .add
+    dec r8d
+    jmp .store
+.add:
+    ; 33 位乘数：存低 32 位，运算时把被除数再加回来
+    add eax, eax
+    lea r10, [rdx + rdx]
+    cmp r10, r9
+    jb .no_round
+    inc eax
+.no_round:
+    mov dword [rdi + DIV_ADD], -1
+.store:
+    inc eax
+    mov [rdi + DIV_MAGIC], eax
+    mov [rdi + DIV_SHIFT], r8d
+    xor eax, eax
+    ret
+.zero:
+    mov eax, -1
+    ret
+
+; void asm_div_int_array(const asm_int_divider *d, const int32_t *in, int32_t *out, size_t n)
+; void asm_mod_int_array(const asm_int_divider *d, const int32_t *in, int32_t *out, size_t n)
+; 参数: rdi = d, rsi = in, rdx = out（可与 in 相同）, rcx = 元素个数
+asm_div_int_array:
+    xor r8d, r8d
+    jmp divide_array
+asm_mod_int_array:
+    mov r8d, 1
+
+; 内部入口，r8d = 0 求商 / 1 求余
+; 循环内按 magic 和 r8d 分支：整个数组走同一分支，预测总是命中
+divide_array:
+    LOAD_CPU_FLAGS
+    push rbx
+    push r12
+    mov r9, rcx                 ; r9 = 剩余元素个数
+    mov ecx, [rdi + DIV_SHIFT]
+    mov r10d, [rdi + DIV_MAGIC]
+    mov r11d, 1
+    shl r11d, cl
+    dec r11d                    ; r11d = 2^shift - 1，2 的幂除数的舍入偏置
+    test eax, CPU_AVX2
+    jz .scalar
+    cmp r9, 8
+    jb .scalar
+
+    test eax, CPU_AVX512
+    jz .avx2_setup
+    cmp r9, 16
+    jb .avx2_setup
+
+    ; AVX-512：每次 16 个元素；广播到 zmm 后低 256 位也可供 AVX2 尾部使用
+    vpbroadcastd zmm8, [rdi + DIV_MAGIC]
+    vpbroadcastd zmm9, [rdi + DIV_ADD]
+    vpbroadcastd zmm10, [rdi + DIV_SIGN]
+    vpbroadcastd zmm11, [rdi + DIV_DIVISOR]
+    vpbroadcastd zmm13, r11d
+    vmovd xmm12, ecx
+    mov eax, 0xAAAA
+    kmovw k1, eax               ; 奇数 dword
+.avx512_loop:
+    vmovdqu32 zmm0, [rsi]
+    test r10d, r10d
+    jz .avx512_pow2
+    ; 有符号 32x32 乘法高位：偶数 / 奇数元素分别 vpmuldq，再拼回
+    vpmuldq zmm1, zmm0, zmm8
+    vpsrlq zmm2, zmm0, 32
+    vpmuldq zmm2, zmm2, zmm8
+    vpsrlq zmm1, zmm1, 32
+    vmovdqa32 zmm1{k1}, zmm2
+    vpandd zmm2, zmm0, zmm9
+    vpaddd zmm1, zmm1, zmm2
+    vpsrad zmm1, zmm1, xmm12
+    vpsrld zmm2, zmm1, 31
+    vpaddd zmm1, zmm1, zmm2     ; 负商加 1：向零截断
+    jmp .avx512_sign
+.avx512_pow2:
+    vpsrad zmm1, zmm0, 31
+    vpandd zmm1, zmm1, zmm13
+    vpaddd zmm1, zmm1, zmm0
+    vpsrad zmm1, zmm1, xmm12
+.avx512_sign:
+    vpxord zmm1, zmm1, zmm10
+    vpsubd zmm1, zmm1, zmm10
+    test r8d, r8d
+    jz .avx512_store
+    vpmulld zmm2, zmm1, zmm11
+    vpsubd zmm1, zmm0, zmm2
+.avx512_store:
+    vmovdqu32 [rdx], zmm1
+    add rsi, 64
+    add rdx, 64
+    sub r9, 16
+    cmp r9, 16
+    jae .avx512_loop
+    jmp .avx2_tail
+
+.avx2_setup:
+    vpbroadcastd ymm8, [rdi + DIV_MAGIC]
+    vpbroadcastd ymm9, [rdi + DIV_ADD]
+    vpbroadcastd ymm10, [rdi + DIV_SIGN]
+    vpbroadcastd ymm11, [rdi + DIV_DIVISOR]
+    vmovd xmm13, r11d
+    vpbroadcastd ymm13, xmm13
+    vmovd xmm12, ecx
+.avx2_tail:
+    cmp r9, 8
+    jb .avx_done
+.avx2_loop:
+    ; AVX2：每次 8 个元素，步骤同上
+    vmovdqu ymm0, [rsi]
+    test r10d, r10d
+    jz .avx2_pow2
+    vpmuldq ymm1, ymm0, ymm8
+    vpsrlq ymm2, ymm0, 32
+    vpmuldq ymm2, ymm2, ymm8
+    vpsrlq ymm1, ymm1, 32
+    vpblendd ymm1, ymm1, ymm2, 0xAA
+    vpand ymm2, ymm0, ymm9
+    vpaddd ymm1, ymm1, ymm2
+    vpsrad ymm1, ymm1, xmm12
+    vpsrld ymm2, ymm1, 31
+    vpaddd ymm1, ymm1, ymm2
+    jmp .avx2_sign
+.avx2_pow2:
+    vpsrad ymm1, ymm0, 31
+    vpand ymm1, ymm1, ymm13
+    vpaddd ymm1, ymm1, ymm0
+    vpsrad ymm1, ymm1, xmm12
+.avx2_sign:
+    vpxor ymm1, ymm1, ymm10
+    vpsubd ymm1, ymm1, ymm10
+    test r8d, r8d
+    jz .avx2_store
+    vpmulld ymm2, ymm1, ymm11
+    vpsubd ymm1, ymm0, ymm2
+.avx2_store:
+    vmovdqu [rdx], ymm1
+    add rsi, 32
+    add rdx, 32
+    sub r9, 8
+    cmp r9, 8
+    jae .avx2_loop
+.avx_done:
+    vzeroupper
+
+.scalar:
+    test r9, r9
+    jz .done
+    movsxd r10, r10d
+.scalar_loop:
+    movsxd rax, dword [rsi]
+    test r10, r10
+    jz .scalar_pow2
+    mov rbx, rax
+    imul rbx, r10
+    sar rbx, 32                 ; ebx = mulhi(n, magic)
+    mov r12d, eax
+    and r12d, [rdi + DIV_ADD]
+    add ebx, r12d
+    sar ebx, cl
+    mov r12d, ebx
+    shr r12d, 31
+    add ebx, r12d
+    jmp .scalar_sign
+.scalar_pow2:
+    mov ebx, eax
+    sar ebx, 31
+    and ebx, r11d
+    add ebx, eax
+    sar ebx, cl
+.scalar_sign:
+    xor ebx, [rdi + DIV_SIGN]
+    sub ebx, [rdi + DIV_SIGN]
+    test r8d, r8d
+    jz .scalar_store
+    imul ebx, [rdi + DIV_DIVISOR]
+    sub eax, ebx
+    mov ebx, eax
+.scalar_store:
+    mov [rdx], ebx
+    add rsi, 4
+    add rdx, 4
+    dec r9
+    jnz .scalar_loop
+.done:
+    pop r12
+    pop rbx
+    ret
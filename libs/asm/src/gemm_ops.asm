@@ -0,0 +1,128 @@
+; gemm_ops.asm - x64 汇编实现的矩阵乘法微内核
+; 使用 System V AMD64 ABI 调用约定
+;
+; 微内核计算 C 的一个 6×NR 小块：C[6×NR] (+)= A 面板 · B 面板，k 维全部在寄存器中累加。
+; A 面板按 k 逐列打包（每个 p 连续存放 6 个元素），B 面板按 k 逐行打包（每个 p 连续存放 NR 个元素），
+; 打包和分块由调用方（cpp_calculator 的 Gemm.cpp）完成，面板不足 6 行 / NR 列时补零。
+; AVX + FMA：12 个 ymm 累加器（每行 2 个），每个 p 加载 2 个 B 向量、广播 6 个 A 元素，12 次 FMA；
+; double 的 NR = 8，float 的 NR = 16。不支持 FMA 的 CPU 退回 SSE2 标量循环。
+
+default rel
+
+%include "cpu_features.inc"
+
+section .text
+global asm_gemm_kernel_f64
+global asm_gemm_kernel_f32
+
+; 一行的两个累加器写回 C（rcx 指向该行），r9d 非 0 时先加上 C 原有的值；之后 rcx 前进一行
+; %1, %2 = 累加器, %3 = 类型字母
+%macro STORE_ROW 3
+    test r9d, r9d
+    jz %%store
+    vaddp%3 %1, %1, [rcx]
+    vaddp%3 %2, %2, [rcx + 32]
+%%store:
+    vmovup%3 [rcx], %1
+    vmovup%3 [rcx + 32], %2
+    add rcx, r8
+%endmacro
+
+; A 面板中偏移 %1 字节的元素（一行）广播后与两个 B 向量（ymm12, ymm13）相乘，累加到 %2, %3
+; %4 = 广播用的寄存器, %5 = 类型字母
+%macro FMA_ROW 5
+    vbroadcasts%5 %4, [rsi + %1]
+    vfmadd231p%5 %2, %4, ymm12
+    vfmadd231p%5 %3, %4, ymm13
+%endmacro
+
+; void asm_gemm_kernel_xxx(size_t k, const T *a, const T *b, T *c, size_t ldc, int accumulate)
+; 参数: rdi = k, rsi = A 面板（k × 6）, rdx = B 面板（k × NR）, rcx = C 小块左上角,
+;       r8 = ldc（C 的行距，元素个数）, r9d = accumulate（0 覆盖写入 C，非 0 累加到 C）
+; %1 = 名字, %2 = 类型字母, %3 = 元素字节数, %4 = NR
+%macro GEMM_KERNEL 4
+%1:
+    LOAD_CPU_FLAGS
+    imul r8, r8, %3             ; r8 = C 的行距（字节）
+    test eax, CPU_FMA
+    jz %%scalar
+
+    vxorps xmm0, xmm0, xmm0
+    vxorps xmm1, xmm1, xmm1
+    vxorps xmm2, xmm2, xmm2
+    vxorps xmm3, xmm3, xmm3
+    vxorps xmm4, xmm4, xmm4
+    vxorps xmm5, xmm5, xmm5
+    vxorps xmm6, xmm6, xmm6
+    vxorps xmm7, xmm7, xmm7
+    vxorps xmm8, xmm8, xmm8
+    vxorps xmm9, xmm9, xmm9
+    vxorps xmm10, xmm10, xmm10
+    vxorps xmm11, xmm11, xmm11
+    test rdi, rdi
+    jz %%write
+%%loop:
+    vmovup%2 ymm12, [rdx]
+    vmovup%2 ymm13, [rdx + 32]
+    FMA_ROW 0 * %3, ymm0, ymm1, ymm14, %2
+    FMA_ROW 1 * %3, ymm2, ymm3, ymm15, %2
+    FMA_ROW 2 * %3, ymm4, ymm5, ymm14, %2
+    FMA_ROW 3 * %3, ymm6, ymm7, ymm15, %2
+    FMA_ROW 4 * %3, ymm8, ymm9, ymm14, %2
+    FMA_ROW 5 * %3, ymm10, ymm11, ymm15, %2
+    add rsi, 6 * %3
+    add rdx, 64
+    dec rdi
+    jnz %%loop
+%%write:
+    STORE_ROW ymm0, ymm1, %2
+    STORE_ROW ymm2, ymm3, %2
+    STORE_ROW ymm4, ymm5, %2
+    STORE_ROW ymm6, ymm7, %2
+    STORE_ROW ymm8, ymm9, %2
+    STORE_ROW ymm10, ymm11, %2
+    vzeroupper
+    ret
+
+%%scalar:
+    ; 逐个元素求 Σ a[p][i]·b[p][j]
+    push rbx
+    push r12
+    xor r10d, r10d              ; r10 = 行 i
+%%row:
+    xor r11d, r11d              ; r11 = 列 j
+%%col:
+    xorps xmm0, xmm0
+    lea rax, [rsi + r10 * %3]
+    lea rbx, [rdx + r11 * %3]
+    mov r12, rdi
+    test r12, r12
+    jz %%put
+%%dot:
+    movs%2 xmm1, [rax]
+    muls%2 xmm1, [rbx]
+    adds%2 xmm0, xmm1
+    add rax, 6 * %3
+    add rbx, 64
+    dec r12
+    jnz %%dot
+%%put:
+    test r9d, r9d
+    jz %%put_store
+    adds%2 xmm0, [rcx + r11 * %3]
+%%put_store:
+    movs%2 [rcx + r11 * %3], xmm0
+    inc r11
+    cmp r11, %4
+    jb %%col
+    add rcx, r8
+    inc r10
+    cmp r10, 6
+    jb %%row
+    pop r12
+    pop rbx
+    ret
+%endmacro
+
+GEMM_KERNEL asm_gemm_kernel_f64, d, 8, 8
+GEMM_KERNEL asm_gemm_kernel_f32, s, 4, 16
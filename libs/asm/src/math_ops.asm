@@ -10,6 +10,12 @@ global asm_power
 global asm_bitwise_and
 global asm_bitwise_or
 global asm_left_shift
+global asm_add_checked
+global asm_subtract_checked
+global asm_multiply_checked
+global asm_add_sat
+global asm_subtract_sat
+global asm_multiply_sat
 
 ; int64_t asm_add(int64_t a, int64_t b)
 ; 参数: rdi = a, rsi = b
@@ -92,4 +98,67 @@ asm_left_shift:
     mov rax, rdi        ; 将value移到rax
     mov cl, sil         ; 将shift移到cl (8位)
     shl rax, cl         ; 左移操作
-    ret
\ No newline at end of file
+    ret
+
+; int asm_add_checked(int64_t a, int64_t b, int64_t *result)
+; 参数: rdi = a, rsi = b, rdx = result（写入回绕后的结果）
+; 返回: eax = 1 表示溢出，否则 0
+asm_add_checked:
+    xor eax, eax
+    add rdi, rsi
+    seto al             ; 溢出标志
+    mov [rdx], rdi
+    ret
+
+; int asm_subtract_checked(int64_t a, int64_t b, int64_t *result)
+asm_subtract_checked:
+    xor eax, eax
+    sub rdi, rsi
+    seto al
+    mov [rdx], rdi
+    ret
+
+; int asm_multiply_checked(int64_t a, int64_t b, int64_t *result)
+asm_multiply_checked:
+    xor eax, eax
+    imul rdi, rsi       ; 乘积超出 64 位时置 OF
+    seto al
+    mov [rdx], rdi
+    ret
+
+; int64_t asm_add_sat(int64_t a, int64_t b)
+; 参数: rdi = a, rsi = b
+; 返回: rax，溢出时为 INT64_MAX / INT64_MIN（符号与 a 相同）
+asm_add_sat:
+    mov rcx, rdi
+    sar rcx, 63
+    mov rdx, 0x7FFFFFFFFFFFFFFF
+    xor rcx, rdx        ; rcx = 饱和值
+    mov rax, rdi
+    add rax, rsi
+    cmovo rax, rcx
+    ret
+
+; int64_t asm_subtract_sat(int64_t a, int64_t b)
+asm_subtract_sat:
+    mov rcx, rdi
+    sar rcx, 63
+    mov rdx, 0x7FFFFFFFFFFFFFFF
+    xor rcx, rdx
+    mov rax, rdi
+    sub rax, rsi
+    cmovo rax, rcx
+    ret
+
+; int64_t asm_multiply_sat(int64_t a, int64_t b)
+; 溢出时的符号由 a ^ b 决定
+asm_multiply_sat:
+    mov rcx, rdi
+    xor rcx, rsi
+    sar rcx, 63
+    mov rdx, 0x7FFFFFFFFFFFFFFF
+    xor rcx, rdx
+    mov rax, rdi
+    imul rax, rsi
+    cmovo rax, rcx
+    ret
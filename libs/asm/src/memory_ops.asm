@@ -0,0 +1,424 @@
+; memory_ops.asm - x64 汇编实现的内存拷贝 / 填充
+; 使用 System V AMD64 ABI 调用约定
+;
+; 按大小和 CPU 特性分派：
+;   < 64 字节        头尾重叠的标量 / SSE 存储，无循环
+;   >= NT 阈值       AVX2 非临时（流式）存储，不污染缓存
+;   >= 2KB 且 ERMS   rep movsb / rep stosb
+;   其余             AVX-512 / AVX2 / SSE2 循环，尾部重叠存储
+
+default rel
+
+%include "cpu_features.inc"
+
+%define ERMS_MIN_BYTES          2048
+%define NT_MIN_BYTES            256         ; 非临时路径的最小长度（保证主循环至少执行一次）
+%define DEFAULT_NT_THRESHOLD    (8 << 20)   ; 无法检测 LLC 容量时的默认阈值
+
+section .data
+align 8
+nt_threshold: dq 0              ; 0 表示自动（使用 LLC 容量）
+
+section .text
+global asm_memory_copy
+global asm_memory_set
+global asm_memory_set_nt_threshold
+global asm_memory_get_nt_threshold
+
+; 计算非临时存储阈值到 r9（需要已加载特性位）
+%macro LOAD_NT_THRESHOLD 0
+    mov r9, [rel nt_threshold]
+    test r9, r9
+    jnz %%done
+    mov r9, [rel asm_cpu_llc_bytes]
+    test r9, r9
+    jnz %%done
+    mov r9, DEFAULT_NT_THRESHOLD
+%%done:
+%endmacro
+
+; void asm_memory_set_nt_threshold(size_t bytes)
+; 参数: rdi = 阈值（字节），0 表示按 LLC 容量自动选择
+asm_memory_set_nt_threshold:
+    mov [rel nt_threshold], rdi
+    ret
+
+; size_t asm_memory_get_nt_threshold(void)
+; 返回: rax = 当前生效的阈值
+asm_memory_get_nt_threshold:
+    LOAD_CPU_FLAGS
+    LOAD_NT_THRESHOLD
+    mov rax, r9
+    ret
+
+; void *asm_memory_copy(void *dest, const void *src, size_t n)
+; 参数: rdi = dest, rsi = src, rdx = n（源和目标不可重叠，同 memcpy）
+; 返回: rax = dest
+asm_memory_copy:
+    cmp rdx, 64
+    jb .small
+
+    LOAD_CPU_FLAGS
+    mov r8d, eax                ; r8d = CPU 特性
+    mov rax, rdi                ; 返回值
+
+    test r8d, CPU_AVX2
+    jz .no_nt
+    cmp rdx, NT_MIN_BYTES
+    jb .no_nt
+    LOAD_NT_THRESHOLD
+    cmp rdx, r9
+    jae .nt_copy
+.no_nt:
+    test r8d, CPU_ERMS
+    jz .vector
+    cmp rdx, ERMS_MIN_BYTES
+    jb .vector
+    mov rcx, rdx
+    rep movsb
+    ret
+
+.vector:
+    test r8d, CPU_AVX512
+    jnz .avx512
+    test r8d, CPU_AVX2
+    jnz .avx2
+
+    ; SSE2：16 字节一组，最后 16 字节与前面重叠
+    movdqu xmm4, [rsi + rdx - 16]
+    lea r9, [rdi + rdx - 16]
+    xor ecx, ecx
+    sub rdx, 16
+.sse_loop:
+    movdqu xmm0, [rsi + rcx]
+    movdqu [rdi + rcx], xmm0
+    add rcx, 16
+    cmp rcx, rdx
+    jb .sse_loop
+    movdqu [r9], xmm4
+    ret
+
+.avx2:
+    cmp rdx, 128
+    ja .avx2_large
+    ; 64..128 字节：头尾各 64 字节，重叠存储
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm1, [rsi + 32]
+    vmovdqu ymm2, [rsi + rdx - 64]
+    vmovdqu ymm3, [rsi + rdx - 32]
+    vmovdqu [rdi], ymm0
+    vmovdqu [rdi + 32], ymm1
+    vmovdqu [rdi + rdx - 64], ymm2
+    vmovdqu [rdi + rdx - 32], ymm3
+    vzeroupper
+    ret
+.avx2_large:
+    ; 先读出尾部 128 字节，主循环每次 128 字节，最后重叠写尾部
+    vmovdqu ymm4, [rsi + rdx - 128]
+    vmovdqu ymm5, [rsi + rdx - 96]
+    vmovdqu ymm6, [rsi + rdx - 64]
+    vmovdqu ymm7, [rsi + rdx - 32]
+    lea r9, [rdi + rdx - 128]
+    xor ecx, ecx
+    sub rdx, 128
+.avx2_loop:
+    vmovdqu ymm0, [rsi + rcx]
+    vmovdqu ymm1, [rsi + rcx + 32]
+    vmovdqu ymm2, [rsi + rcx + 64]
+    vmovdqu ymm3, [rsi + rcx + 96]
+    vmovdqu [rdi + rcx], ymm0
+    vmovdqu [rdi + rcx + 32], ymm1
+    vmovdqu [rdi + rcx + 64], ymm2
+    vmovdqu [rdi + rcx + 96], ymm3
+    add rcx, 128
+    cmp rcx, rdx
+    jb .avx2_loop
+    vmovdqu [r9], ymm4
+    vmovdqu [r9 + 32], ymm5
+    vmovdqu [r9 + 64], ymm6
+    vmovdqu [r9 + 96], ymm7
+    vzeroupper
+    ret
+
+.avx512:
+    ; 256 字节以内 256 位向量已足够，避免 512 位非对齐存储频繁跨缓存行
+    cmp rdx, 256
+    jbe .avx2
+    vmovdqu64 zmm4, [rsi + rdx - 256]
+    vmovdqu64 zmm5, [rsi + rdx - 192]
+    vmovdqu64 zmm6, [rsi + rdx - 128]
+    vmovdqu64 zmm7, [rsi + rdx - 64]
+    lea r9, [rdi + rdx - 256]
+    xor ecx, ecx
+    sub rdx, 256
+.avx512_loop:
+    vmovdqu64 zmm0, [rsi + rcx]
+    vmovdqu64 zmm1, [rsi + rcx + 64]
+    vmovdqu64 zmm2, [rsi + rcx + 128]
+    vmovdqu64 zmm3, [rsi + rcx + 192]
+    vmovdqu64 [rdi + rcx], zmm0
+    vmovdqu64 [rdi + rcx + 64], zmm1
+    vmovdqu64 [rdi + rcx + 128], zmm2
+    vmovdqu64 [rdi + rcx + 192], zmm3
+    add rcx, 256
+    cmp rcx, rdx
+    jb .avx512_loop
+    vmovdqu64 [r9], zmm4
+    vmovdqu64 [r9 + 64], zmm5
+    vmovdqu64 [r9 + 128], zmm6
+    vmovdqu64 [r9 + 192], zmm7
+    vzeroupper
+    ret
+
+.nt_copy:
+    ; 头部 32 字节普通存储，之后目标按 32 字节对齐做流式存储
+    vmovdqu ymm0, [rsi]
+    vmovdqu ymm4, [rsi + rdx - 32]
+    vmovdqu [rdi], ymm0
+    lea r9, [rdi + rdx - 32]
+    mov rcx, rdi
+    neg rcx
+    and rcx, 31                 ; rcx = 到 32 字节对齐的偏移
+    lea r10, [rdx - 128]
+.nt_loop:
+    prefetcht0 [rsi + rcx + 1024]
+    vmovdqu ymm0, [rsi + rcx]
+    vmovdqu ymm1, [rsi + rcx + 32]
+    vmovdqu ymm2, [rsi + rcx + 64]
+    vmovdqu ymm3, [rsi + rcx + 96]
+    vmovntdq [rdi + rcx], ymm0
+    vmovntdq [rdi + rcx + 32], ymm1
+    vmovntdq [rdi + rcx + 64], ymm2
+    vmovntdq [rdi + rcx + 96], ymm3
+    add rcx, 128
+    cmp rcx, r10
+    jbe .nt_loop
+    sfence                      ; 流式存储对其他核可见
+    lea r10, [rdx - 32]
+.nt_tail:
+    cmp rcx, r10
+    jae .nt_done
+    vmovdqu ymm0, [rsi + rcx]
+    vmovdqu [rdi + rcx], ymm0
+    add rcx, 32
+    jmp .nt_tail
+.nt_done:
+    vmovdqu [r9], ymm4
+    vzeroupper
+    ret
+
+.small:
+    mov rax, rdi
+    cmp rdx, 16
+    jb .lt16
+    ; 16..63 字节：头尾各 16 字节，超过 32 字节时再补中间两块
+    movdqu xmm0, [rsi]
+    movdqu xmm1, [rsi + rdx - 16]
+    cmp rdx, 32
+    jbe .store16
+    movdqu xmm2, [rsi + 16]
+    movdqu xmm3, [rsi + rdx - 32]
+    movdqu [rdi + 16], xmm2
+    movdqu [rdi + rdx - 32], xmm3
+.store16:
+    movdqu [rdi], xmm0
+    movdqu [rdi + rdx - 16], xmm1
+    ret
+.lt16:
+    cmp rdx, 8
+    jb .lt8
+    mov rcx, [rsi]
+    mov r8, [rsi + rdx - 8]
+    mov [rdi], rcx
+    mov [rdi + rdx - 8], r8
+    ret
+.lt8:
+    cmp rdx, 4
+    jb .lt4
+    mov ecx, [rsi]
+    mov r8d, [rsi + rdx - 4]
+    mov [rdi], ecx
+    mov [rdi + rdx - 4], r8d
+    ret
+.lt4:
+    test rdx, rdx
+    jz .copy_done
+    movzx ecx, byte [rsi]
+    movzx r8d, byte [rsi + rdx - 1]
+    cmp rdx, 2
+    jbe .copy_edges
+    movzx r9d, byte [rsi + 1]
+    mov [rdi + 1], r9b
+.copy_edges:
+    mov [rdi], cl
+    mov [rdi + rdx - 1], r8b
+.copy_done:
+    ret
+
+; void *asm_memory_set(void *dest, int value, size_t n)
+; 参数: rdi = dest, esi = value（取低 8 位）, rdx = n
+; 返回: rax = dest
+asm_memory_set:
+    movzx ecx, sil
+    mov r10, 0x0101010101010101
+    imul rcx, r10               ; rcx = 8 字节广播值
+    cmp rdx, 64
+    jb .small
+
+    LOAD_CPU_FLAGS
+    mov r8d, eax
+    mov rax, rdi
+    movq xmm0, rcx
+    punpcklqdq xmm0, xmm0       ; xmm0 = 16 字节广播值
+
+    test r8d, CPU_AVX2
+    jz .no_nt
+    cmp rdx, NT_MIN_BYTES
+    jb .no_nt
+    LOAD_NT_THRESHOLD
+    cmp rdx, r9
+    jae .nt_set
+.no_nt:
+    test r8d, CPU_ERMS
+    jz .vector
+    cmp rdx, ERMS_MIN_BYTES
+    jb .vector
+    mov r9, rdi
+    mov eax, esi                ; rep stosb 使用 al
+    mov rcx, rdx
+    rep stosb
+    mov rax, r9
+    ret
+
+.vector:
+    test r8d, CPU_AVX512
+    jnz .avx512
+    test r8d, CPU_AVX2
+    jnz .avx2
+
+    lea r9, [rdi + rdx - 16]
+    xor ecx, ecx
+    sub rdx, 16
+.sse_loop:
+    movdqu [rdi + rcx], xmm0
+    add rcx, 16
+    cmp rcx, rdx
+    jb .sse_loop
+    movdqu [r9], xmm0
+    ret
+
+.avx2:
+    vinserti128 ymm0, ymm0, xmm0, 1
+    cmp rdx, 128
+    ja .avx2_large
+    vmovdqu [rdi], ymm0
+    vmovdqu [rdi + 32], ymm0
+    vmovdqu [rdi + rdx - 64], ymm0
+    vmovdqu [rdi + rdx - 32], ymm0
+    vzeroupper
+    ret
+.avx2_large:
+    lea r9, [rdi + rdx - 128]
+    xor ecx, ecx
+    sub rdx, 128
+.avx2_loop:
+    vmovdqu [rdi + rcx], ymm0
+    vmovdqu [rdi + rcx + 32], ymm0
+    vmovdqu [rdi + rcx + 64], ymm0
+    vmovdqu [rdi + rcx + 96], ymm0
+    add rcx, 128
+    cmp rcx, rdx
+    jb .avx2_loop
+    vmovdqu [r9], ymm0
+    vmovdqu [r9 + 32], ymm0
+    vmovdqu [r9 + 64], ymm0
+    vmovdqu [r9 + 96], ymm0
+    vzeroupper
+    ret
+
+.avx512:
+    cmp rdx, 256
+    jbe .avx2
+    vpbroadcastq zmm0, xmm0
+    lea r9, [rdi + rdx - 256]
+    xor ecx, ecx
+    sub rdx, 256
+.avx512_loop:
+    vmovdqu64 [rdi + rcx], zmm0
+    vmovdqu64 [rdi + rcx + 64], zmm0
+    vmovdqu64 [rdi + rcx + 128], zmm0
+    vmovdqu64 [rdi + rcx + 192], zmm0
+    add rcx, 256
+    cmp rcx, rdx
+    jb .avx512_loop
+    vmovdqu64 [r9], zmm0
+    vmovdqu64 [r9 + 64], zmm0
+    vmovdqu64 [r9 + 128], zmm0
+    vmovdqu64 [r9 + 192], zmm0
+    vzeroupper
+    ret
+
+.nt_set:
+    vinserti128 ymm0, ymm0, xmm0, 1
+    vmovdqu [rdi], ymm0
+    lea r9, [rdi + rdx - 32]
+    mov rcx, rdi
+    neg rcx
+    and rcx, 31
+    lea r10, [rdx - 128]
+.nt_loop:
+    vmovntdq [rdi + rcx], ymm0
+    vmovntdq [rdi + rcx + 32], ymm0
+    vmovntdq [rdi + rcx + 64], ymm0
+    vmovntdq [rdi + rcx + 96], ymm0
+    add rcx, 128
+    cmp rcx, r10
+    jbe .nt_loop
+    sfence
+    lea r10, [rdx - 32]
+.nt_tail:
+    cmp rcx, r10
+    jae .nt_done
+    vmovdqu [rdi + rcx], ymm0
+    add rcx, 32
+    jmp .nt_tail
+.nt_done:
+    vmovdqu [r9], ymm0
+    vzeroupper
+    ret
+
+.small:
+    mov rax, rdi
+    cmp rdx, 16
+    jb .lt16
+    movq xmm0, rcx
+    punpcklqdq xmm0, xmm0
+    movdqu [rdi], xmm0
+    movdqu [rdi + rdx - 16], xmm0
+    cmp rdx, 32
+    jbe .set_done
+    movdqu [rdi + 16], xmm0
+    movdqu [rdi + rdx - 32], xmm0
+    ret
+.lt16:
+    cmp rdx, 8
+    jb .lt8
+    mov [rdi], rcx
+    mov [rdi + rdx - 8], rcx
+    ret
+.lt8:
+    cmp rdx, 4
+    jb .lt4
+    mov [rdi], ecx
+    mov [rdi + rdx - 4], ecx
+    ret
+.lt4:
+    test rdx, rdx
+    jz .set_done
+    mov [rdi], cl
+    mov [rdi + rdx - 1], cl
+    cmp rdx, 3
+    jb .set_done
+    mov [rdi + 1], cl
+.set_done:
+    ret
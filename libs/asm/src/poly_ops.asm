@@ -0,0 +1,196 @@
+; poly_ops.asm - x64 汇编实现的批量多项式求值（Estrin 方案）
+; 使用 System V AMD64 ABI 调用约定
+;
+; p(x) = c[0] + c[1]·x + ... + c[d]·x^d（系数按升幂排列，count = d + 1）。
+; 按下标模 4 把系数分为 4 组，每组是 x⁴ 的多项式，用 Horner 法同时推进 4 条互不依赖的 FMA 链：
+;   p(x) = (P0(x⁴) + x·P1(x⁴)) + x²·(P2(x⁴) + x·P3(x⁴))
+; 最后一步即 Estrin 的两两合并。依赖链长度约为 d / 4，而逐项 Horner 为 d。
+; 向量循环每次求 2 个向量的点（AVX-512 为 2 个 zmm，AVX + FMA 为 2 个 ymm），共 8 条链，
+; 共用一次系数广播；剩余的点用标量 FMA 按相同的顺序计算，因此结果与点在数组中的位置无关。
+; 不支持 FMA 的 CPU 退回 SSE2 标量循环，乘和加分别舍入。
+
+default rel
+
+%include "cpu_features.inc"
+
+section .text
+global asm_poly_eval_f64
+global asm_poly_eval_f32
+
+; 求 2 个向量的点：%1 = 寄存器前缀（y / z）, %2 = 类型字母, %3 = 元素字节数,
+; %4 = 向量字节数, %5 = 每次处理的元素个数（2 个向量）
+; 寄存器：x / x² / x⁴ / P0..P3 第一个向量为 0..6，第二个向量为 7..13，14 为广播的系数
+%macro ESTRIN_VEC 5
+%%loop:
+    cmp r8, %5
+    jb %%done
+    vmovup%2 %1mm0, [rdx]
+    vmovup%2 %1mm7, [rdx + %4]
+    vmulp%2 %1mm1, %1mm0, %1mm0
+    vmulp%2 %1mm8, %1mm7, %1mm7
+    vmulp%2 %1mm2, %1mm1, %1mm1
+    vmulp%2 %1mm9, %1mm8, %1mm8
+    vbroadcasts%2 %1mm3, [rsp - 32]
+    vbroadcasts%2 %1mm4, [rsp - 32 + %3]
+    vbroadcasts%2 %1mm5, [rsp - 32 + 2 * %3]
+    vbroadcasts%2 %1mm6, [rsp - 32 + 3 * %3]
+    vmovaps %1mm10, %1mm3
+    vmovaps %1mm11, %1mm4
+    vmovaps %1mm12, %1mm5
+    vmovaps %1mm13, %1mm6
+    mov r11, r9
+    mov rax, r10
+    test rax, rax
+    jz %%combine
+%%horner:
+    vbroadcasts%2 %1mm14, [r11]
+    vfmadd213p%2 %1mm3, %1mm2, %1mm14
+    vfmadd213p%2 %1mm10, %1mm9, %1mm14
+    vbroadcasts%2 %1mm14, [r11 + %3]
+    vfmadd213p%2 %1mm4, %1mm2, %1mm14
+    vfmadd213p%2 %1mm11, %1mm9, %1mm14
+    vbroadcasts%2 %1mm14, [r11 + 2 * %3]
+    vfmadd213p%2 %1mm5, %1mm2, %1mm14
+    vfmadd213p%2 %1mm12, %1mm9, %1mm14
+    vbroadcasts%2 %1mm14, [r11 + 3 * %3]
+    vfmadd213p%2 %1mm6, %1mm2, %1mm14
+    vfmadd213p%2 %1mm13, %1mm9, %1mm14
+    sub r11, 4 * %3
+    dec rax
+    jnz %%horner
+%%combine:
+    vfmadd231p%2 %1mm3, %1mm4, %1mm0       ; P0 + x·P1
+    vfmadd231p%2 %1mm10, %1mm11, %1mm7
+    vfmadd231p%2 %1mm5, %1mm6, %1mm0       ; P2 + x·P3
+    vfmadd231p%2 %1mm12, %1mm13, %1mm7
+    vfmadd231p%2 %1mm3, %1mm5, %1mm1       ; (P0 + x·P1) + x²·(P2 + x·P3)
+    vfmadd231p%2 %1mm10, %1mm12, %1mm8
+    vmovup%2 [rcx], %1mm3
+    vmovup%2 [rcx + %4], %1mm10
+    add rdx, 2 * %4
+    add rcx, 2 * %4
+    sub r8, %5
+    jmp %%loop
+%%done:
+%endmacro
+
+; void asm_poly_eval_xxx(const T *coeffs, size_t count, const T *x, T *out, size_t n)
+; 参数: rdi = 系数（升幂，count 个）, rsi = count, rdx = x, rcx = out（可与 x 相同）, r8 = 点数
+; out[i] = p(x[i])；count 为 0 时 p 为零多项式
+; %1 = 名字, %2 = 类型字母, %3 = 元素字节数, %4 = 每个 ymm 的元素个数
+%macro POLY_EVAL 4
+%1:
+    LOAD_CPU_FLAGS
+    ; 最高的一组系数 c[4t .. 4t+3]（t = (count - 1) / 4）补零后放在红区 [rsp - 32]，
+    ; 其下 t 组按原位读取：r9 指向 c[4t - 4]，r10 = t。之后不再调用函数，红区不会被破坏
+    mov qword [rsp - 32], 0
+    mov qword [rsp - 24], 0
+    mov qword [rsp - 16], 0
+    mov qword [rsp - 8], 0
+    xor r10d, r10d
+    test rsi, rsi
+    jz %%coeffs_ready
+    lea r10, [rsi - 1]
+    shr r10, 2                  ; r10 = t
+    lea r11, [r10 * 4]          ; r11 = 4t
+%%copy_top:
+    movs%2 xmm15, [rdi + r11 * %3]
+    mov r9, r11
+    and r9, 3
+    movs%2 [rsp - 32 + r9 * %3], xmm15
+    inc r11
+    cmp r11, rsi
+    jb %%copy_top
+%%coeffs_ready:
+    lea r9, [r10 * 4 - 4]
+    lea r9, [rdi + r9 * %3]     ; r9 = &c[4t - 4]（t 为 0 时不会被读取）
+
+    test eax, CPU_FMA | CPU_AVX512
+    jz %%scalar
+    test eax, CPU_AVX512
+    jz %%avx
+    ESTRIN_VEC z, %2, %3, 64, 4 * %4
+%%avx:
+    ESTRIN_VEC y, %2, %3, 32, 2 * %4
+    vzeroupper
+
+    ; 剩余的点逐个用标量 FMA 计算，运算顺序与向量循环相同
+%%fma_tail:
+    test r8, r8
+    jz %%done
+    vmovs%2 xmm0, [rdx]
+    vmuls%2 xmm1, xmm0, xmm0
+    vmuls%2 xmm2, xmm1, xmm1
+    vmovs%2 xmm3, [rsp - 32]
+    vmovs%2 xmm4, [rsp - 32 + %3]
+    vmovs%2 xmm5, [rsp - 32 + 2 * %3]
+    vmovs%2 xmm6, [rsp - 32 + 3 * %3]
+    mov r11, r9
+    mov rax, r10
+    test rax, rax
+    jz %%fma_combine
+%%fma_horner:
+    vfmadd213s%2 xmm3, xmm2, [r11]
+    vfmadd213s%2 xmm4, xmm2, [r11 + %3]
+    vfmadd213s%2 xmm5, xmm2, [r11 + 2 * %3]
+    vfmadd213s%2 xmm6, xmm2, [r11 + 3 * %3]
+    sub r11, 4 * %3
+    dec rax
+    jnz %%fma_horner
+%%fma_combine:
+    vfmadd231s%2 xmm3, xmm4, xmm0
+    vfmadd231s%2 xmm5, xmm6, xmm0
+    vfmadd231s%2 xmm3, xmm5, xmm1
+    vmovs%2 [rcx], xmm3
+    add rdx, %3
+    add rcx, %3
+    dec r8
+    jmp %%fma_tail
+
+%%scalar:
+    ; SSE2：同样的 4 条链，乘和加分别舍入
+    test r8, r8
+    jz %%done
+    movs%2 xmm0, [rdx]
+    movaps xmm1, xmm0
+    muls%2 xmm1, xmm0
+    movaps xmm2, xmm1
+    muls%2 xmm2, xmm1
+    movs%2 xmm3, [rsp - 32]
+    movs%2 xmm4, [rsp - 32 + %3]
+    movs%2 xmm5, [rsp - 32 + 2 * %3]
+    movs%2 xmm6, [rsp - 32 + 3 * %3]
+    mov r11, r9
+    mov rax, r10
+    test rax, rax
+    jz %%scalar_combine
+%%scalar_horner:
+    muls%2 xmm3, xmm2
+    adds%2 xmm3, [r11]
+    muls%2 xmm4, xmm2
+    adds%2 xmm4, [r11 + %3]
+    muls%2 xmm5, xmm2
+    adds%2 xmm5, [r11 + 2 * %3]
+    muls%2 xmm6, xmm2
+    adds%2 xmm6, [r11 + 3 * %3]
+    sub r11, 4 * %3
+    dec rax
+    jnz %%scalar_horner
+%%scalar_combine:
+    muls%2 xmm4, xmm0
+    adds%2 xmm3, xmm4
+    muls%2 xmm6, xmm0
+    adds%2 xmm5, xmm6
+    muls%2 xmm5, xmm1
+    adds%2 xmm3, xmm5
+    movs%2 [rcx], xmm3
+    add rdx, %3
+    add rcx, %3
+    dec r8
+    jmp %%scalar
+%%done:
+    ret
+%endmacro
+
+POLY_EVAL asm_poly_eval_f64, d, 8, 4
+POLY_EVAL asm_poly_eval_f32, s, 4, 8
@@ -0,0 +1,258 @@
+; string_ops.asm - x64 汇编实现的字符串长度 / 有界拷贝
+; 使用 System V AMD64 ABI 调用约定
+;
+; 扫描按向量宽度对齐读取：对齐块不会跨越页边界，因此读到字符串末尾之后
+; 的字节也不会触发缺页；首块用移位丢掉起始地址之前的比较结果
+
+default rel
+
+%include "cpu_features.inc"
+
+extern asm_memory_copy
+
+section .text
+global asm_string_length
+global asm_string_copy
+global asm_string_length_batch
+global asm_string_copy_batch
+
+; size_t asm_string_length(const char *str)
+; 参数: rdi = str
+; 返回: rax = 长度（不含结尾 '\0'）
+; 只使用 rax/rcx/rdx/r8 和向量寄存器，批量函数内部直接调用 string_length
+asm_string_length:
+string_length:
+    LOAD_CPU_FLAGS
+    test eax, CPU_AVX2
+    jz .sse2
+
+    ; AVX2：首块按 64 字节对齐，补齐到 128 字节对齐后每次检查 128 字节
+    vpxor xmm0, xmm0, xmm0
+    mov rax, rdi
+    and rax, -64
+    mov ecx, edi
+    and ecx, 63
+    vpcmpeqb ymm1, ymm0, [rax]
+    vpcmpeqb ymm2, ymm0, [rax + 32]
+    vpmovmskb edx, ymm1
+    vpmovmskb r8d, ymm2
+    shl r8, 32
+    or rdx, r8
+    shr rdx, cl
+    test rdx, rdx
+    jnz .avx2_head
+    add rax, 64
+    test eax, 64                ; 先补齐到 128 字节对齐，循环的整块读取才不会跨页
+    jz .avx2_aligned
+    vmovdqa ymm1, [rax]
+    vmovdqa ymm2, [rax + 32]
+    vpminub ymm3, ymm1, ymm2
+    vpcmpeqb ymm3, ymm3, ymm0
+    vpmovmskb edx, ymm3
+    test edx, edx
+    jnz .avx2_found
+    add rax, 64
+.avx2_aligned:
+    sub rax, 128
+.avx2_loop:
+    ; 每次 128 字节：四路取最小值后一次比较，命中后再按 64 字节定位
+    add rax, 128
+    vmovdqa ymm1, [rax]
+    vmovdqa ymm2, [rax + 32]
+    vmovdqa ymm4, [rax + 64]
+    vmovdqa ymm5, [rax + 96]
+    vpminub ymm3, ymm1, ymm2
+    vpminub ymm6, ymm4, ymm5
+    vpminub ymm6, ymm6, ymm3
+    vpcmpeqb ymm6, ymm6, ymm0
+    vpmovmskb edx, ymm6
+    test edx, edx
+    jz .avx2_loop
+    vpcmpeqb ymm3, ymm3, ymm0
+    vpmovmskb edx, ymm3
+    test edx, edx
+    jnz .avx2_found
+    add rax, 64
+    vmovdqa ymm1, ymm4
+    vmovdqa ymm2, ymm5
+.avx2_found:
+    vpcmpeqb ymm1, ymm1, ymm0
+    vpcmpeqb ymm2, ymm2, ymm0
+    vpmovmskb edx, ymm1
+    vpmovmskb r8d, ymm2
+    shl r8, 32
+    or rdx, r8
+    bsf rdx, rdx
+    add rax, rdx
+    sub rax, rdi
+    vzeroupper
+    ret
+.avx2_head:
+    bsf rax, rdx
+    vzeroupper
+    ret
+
+.sse2:
+    ; SSE2：首块按 16 字节对齐，之后每次检查 32 字节
+    pxor xmm0, xmm0
+    mov rax, rdi
+    and rax, -16
+    mov ecx, edi
+    and ecx, 15
+    movdqa xmm1, [rax]
+    pcmpeqb xmm1, xmm0
+    pmovmskb edx, xmm1
+    shr edx, cl
+    test edx, edx
+    jnz .sse2_head
+    add rax, 16
+    test eax, 16                ; 先补齐到 32 字节对齐
+    jz .sse2_loop
+    movdqa xmm1, [rax]
+    pcmpeqb xmm1, xmm0
+    pmovmskb edx, xmm1
+    test edx, edx
+    jnz .sse2_found
+    add rax, 16
+.sse2_loop:
+    movdqa xmm1, [rax]
+    movdqa xmm2, [rax + 16]
+    movdqa xmm3, xmm1
+    pminub xmm3, xmm2
+    pcmpeqb xmm3, xmm0
+    pmovmskb edx, xmm3
+    test edx, edx
+    jnz .sse2_pair
+    add rax, 32
+    jmp .sse2_loop
+.sse2_pair:
+    pcmpeqb xmm1, xmm0
+    pmovmskb edx, xmm1
+    test edx, edx
+    jnz .sse2_found
+    add rax, 16
+    pcmpeqb xmm2, xmm0
+    pmovmskb edx, xmm2
+.sse2_found:
+    bsf edx, edx
+    add rax, rdx
+    sub rax, rdi
+    ret
+.sse2_head:
+    bsf eax, edx
+    ret
+
+; size_t asm_string_copy(char *dest, const char *src, size_t size)
+; strlcpy 语义：最多拷贝 size - 1 个字符并总是以 '\0' 结尾（size 为 0 时不写入），
+; 不填充目标缓冲区剩余部分
+; 参数: rdi = dest, rsi = src, rdx = size
+; 返回: rax = strlen(src)，返回值 >= size 表示发生了截断
+asm_string_copy:
+string_copy:
+    push rbx
+    push r12
+    push r13
+    mov rbx, rdi
+    mov r12, rsi
+    mov r13, rdx
+    mov rdi, rsi
+    call string_length
+    test r13, r13
+    jz .done
+    mov rdx, rax
+    cmp rdx, r13
+    jb .fits
+    lea rdx, [r13 - 1]          ; 截断
+.fits:
+    mov r13, rax                ; r13 = 返回值
+    mov byte [rbx + rdx], 0
+    mov rdi, rbx
+    mov rsi, r12
+    call asm_memory_copy wrt ..plt
+    mov rax, r13
+.done:
+    pop r13
+    pop r12
+    pop rbx
+    ret
+
+; void asm_string_length_batch(const char *const *strs, size_t count, size_t *lengths)
+; 参数: rdi = 字符串指针数组, rsi = 个数, rdx = 输出长度数组
+; 空指针的长度记为 0
+asm_string_length_batch:
+    push rbx
+    push r12
+    push r13
+    mov rbx, rdi
+    mov r12, rsi
+    mov r13, rdx
+    test r12, r12
+    jz .done
+.loop:
+    xor eax, eax
+    mov rdi, [rbx]
+    test rdi, rdi
+    jz .store
+    call string_length
+.store:
+    mov [r13], rax
+    add rbx, 8
+    add r13, 8
+    dec r12
+    jnz .loop
+.done:
+    pop r13
+    pop r12
+    pop rbx
+    ret
+
+; size_t asm_string_copy_batch(char *const *dests, const char *const *srcs, size_t count,
+;                              size_t size, size_t *lengths)
+; 对每一对字符串执行 asm_string_copy，所有目标缓冲区大小均为 size
+; 参数: rdi = 目标指针数组, rsi = 源指针数组, rdx = 个数, rcx = size,
+;       r8 = 输出源字符串长度数组（可为 NULL）
+; 返回: rax = 被截断的字符串个数
+asm_string_copy_batch:
+    push rbx
+    push rbp
+    push r12
+    push r13
+    push r14
+    push r15
+    sub rsp, 8                  ; 保持调用前 16 字节对齐
+    mov rbx, rdi
+    mov rbp, rsi
+    mov r12, rdx
+    mov r13, rcx
+    mov r14, r8
+    xor r15d, r15d              ; r15 = 截断计数
+    test r12, r12
+    jz .done
+.loop:
+    mov rdi, [rbx]
+    mov rsi, [rbp]
+    mov rdx, r13
+    call string_copy
+    cmp rax, r13
+    jb .no_trunc
+    inc r15
+.no_trunc:
+    test r14, r14
+    jz .next
+    mov [r14], rax
+    add r14, 8
+.next:
+    add rbx, 8
+    add rbp, 8
+    dec r12
+    jnz .loop
+.done:
+    mov rax, r15
+    add rsp, 8
+    pop r15
+    pop r14
+    pop r13
+    pop r12
+    pop rbp
+    pop rbx
+    ret
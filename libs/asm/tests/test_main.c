@@ -1,7 +1,464 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "asm_math_ops/math_ops_asm.h"
 
+// 对比 memcpy / memset 验证各长度与对齐，返回失败次数
+static int check_memory_ops(size_t max_len)
+{
+    unsigned char *src = malloc(max_len + 64);
+    unsigned char *dst = malloc(max_len + 64);
+    unsigned char *ref = malloc(max_len + 64);
+    int failures = 0;
+
+    for (size_t i = 0; i < max_len + 64; ++i)
+        src[i] = (unsigned char)(i * 131 + 7);
+
+    for (size_t len = 0; len <= max_len; len = len < 300 ? len + 1 : len * 2 + 13)
+    {
+        for (size_t off = 0; off < 3; ++off)
+        {
+            memset(dst, 0xEE, max_len + 64);
+            memset(ref, 0xEE, max_len + 64);
+            memcpy(ref + off, src + 1, len);
+            if (asm_memory_copy(dst + off, src + 1, len) != dst + off ||
+                memcmp(dst, ref, max_len + 64) != 0)
+                failures++;
+
+            memset(ref + off, 0x5A, len);
+            if (asm_memory_set(dst + off, 0x5A, len) != dst + off ||
+                memcmp(dst, ref, max_len + 64) != 0)
+                failures++;
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(ref);
+    return failures;
+}
+
+// 对比 strlen 验证各长度与起始对齐，并检查拷贝不会写到结尾 '\0' 之后，返回失败次数
+static int check_string_ops(void)
+{
+    enum { MAX_LEN = 700 };
+    char *buf = aligned_alloc(64, MAX_LEN + 128);
+    char *dst = malloc(MAX_LEN + 64);
+    int failures = 0;
+
+    for (size_t len = 0; len <= MAX_LEN; len = len < 200 ? len + 1 : len + 61)
+    {
+        for (size_t off = 0; off < 64; off += (len < 200 ? 7 : 1))
+        {
+            memset(buf, 'x', MAX_LEN + 128);
+            char *str = buf + off;
+            str[len] = '\0';
+            if (asm_string_length(str) != len)
+                failures++;
+
+            size_t sizes[] = {0, 1, len / 2 + 1, len, len + 1, len + 40};
+            for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k)
+            {
+                size_t size = sizes[k];
+                memset(dst, 0x7F, MAX_LEN + 64);
+                if (asm_string_copy(dst, str, size) != len)
+                    failures++;
+                size_t copied = size == 0 ? 0 : (len < size ? len : size - 1);
+                if (size > 0 && (memcmp(dst, str, copied) != 0 || dst[copied] != '\0'))
+                    failures++;
+                size_t untouched = size == 0 ? 0 : copied + 1;
+                if (dst[untouched] != 0x7F)
+                    failures++;
+            }
+        }
+    }
+
+    const char *strs[] = {"", "a", "hello", NULL, "0123456789abcdef0123456789abcdef0123"};
+    size_t lengths[5];
+    asm_string_length_batch(strs, 5, lengths);
+    if (lengths[0] != 0 || lengths[1] != 1 || lengths[2] != 5 || lengths[3] != 0 || lengths[4] != 36)
+        failures++;
+
+    char out[3][8];
+    char *dests[] = {out[0], out[1], out[2]};
+    const char *srcs[] = {"abc", "1234567", "truncated"};
+    if (asm_string_copy_batch(dests, srcs, 3, sizeof(out[0]), lengths) != 1 ||
+        strcmp(out[1], "1234567") != 0 || strcmp(out[2], "truncat") != 0 || lengths[2] != 9)
+        failures++;
+
+    free(buf);
+    free(dst);
+
+    // 字符串紧贴 PROT_NONE 保护页结束：越过结尾 '\0' 所在的对齐块读取会触发 SIGSEGV
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char *pages = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED || mprotect(pages + page, page, PROT_NONE) != 0)
+        return failures + 1;
+    memset(pages, 'x', page);
+    pages[page - 1] = '\0';
+    for (size_t len = 0; len < 512; ++len)
+    {
+        if (asm_string_length(pages + page - 1 - len) != len)
+            failures++;
+    }
+    munmap(pages, 2 * page);
+    return failures;
+}
+
+// 对比标量实现验证按位数组运算（含 32 / 64 位、各种长度和原地运算），返回失败次数
+static int check_bitwise_ops(void)
+{
+    enum { MAX_WORDS = 600 };
+    uint64_t a[MAX_WORDS], b[MAX_WORDS], out[MAX_WORDS];
+    int failures = 0;
+
+    for (size_t i = 0; i < MAX_WORDS; ++i)
+    {
+        a[i] = 0x9E3779B97F4A7C15ull * (i + 1);
+        b[i] = ~(a[i] >> 7) ^ (i * 0x0101010101010101ull);
+    }
+
+    for (size_t n = 0; n <= MAX_WORDS; n = n < 80 ? n + 1 : n + 37)
+    {
+        uint64_t pop = 0, all = ~0ull, any = 0;
+        asm_bitwise_and_u64(a, b, out, n);
+        for (size_t i = 0; i < n; ++i)
+            failures += out[i] != (a[i] & b[i]);
+        asm_bitwise_xor_mask_u64(a, 0xF0F0F0F00F0F0F0Full, out, n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            failures += out[i] != (a[i] ^ 0xF0F0F0F00F0F0F0Full);
+            pop += (uint64_t)__builtin_popcountll(a[i]);
+            all &= a[i] | 0x8000000000000001ull;
+            any |= a[i] & 0x0000FFFF0000FFFFull;
+        }
+        failures += asm_popcount_u64(a, n) != pop;
+
+        asm_bitwise_or_mask_u64(a, 0x8000000000000001ull, out, n);
+        failures += asm_reduce_and_u64(out, n) != all;
+        asm_bitwise_and_mask_u64(a, 0x0000FFFF0000FFFFull, out, n);
+        failures += asm_reduce_or_u64(out, n) != any;
+
+        // 32 位视图：元素个数为 2n 和 2n - 1（奇数个覆盖 4 字节尾部）
+        const uint32_t *a32 = (const uint32_t *)a, *b32 = (const uint32_t *)b;
+        uint32_t *out32 = (uint32_t *)out;
+        size_t n32 = n * 2 > 0 ? n * 2 - (n & 1) : 0;
+        uint32_t all32 = ~0u, any32 = 0;
+        uint64_t pop32 = 0;
+        asm_bitwise_or_u32(a32, b32, out32, n32);
+        for (size_t i = 0; i < n32; ++i)
+            failures += out32[i] != (a32[i] | b32[i]);
+        asm_bitwise_and_mask_u32(a32, 0x00FF00FFu, out32, n32);
+        for (size_t i = 0; i < n32; ++i)
+        {
+            failures += out32[i] != (a32[i] & 0x00FF00FFu);
+            pop32 += (uint64_t)__builtin_popcount(a32[i]);
+            all32 &= a32[i];
+            any32 |= a32[i];
+        }
+        failures += asm_popcount_u32(a32, n32) != pop32;
+        failures += asm_reduce_and_u32(a32, n32) != all32;
+        failures += asm_reduce_or_u32(a32, n32) != any32;
+
+        // 原地运算
+        memcpy(out, a, n * sizeof(uint64_t));
+        asm_bitwise_xor_u64(out, b, out, n);
+        for (size_t i = 0; i < n; ++i)
+            failures += out[i] != (a[i] ^ b[i]);
+    }
+
+    return failures;
+}
+
+// 对比 C 的 / 和 % 验证不变除数批量运算（含 2 的幂、负除数、INT32_MIN 和标量尾部），返回失败次数
+static int check_divide_ops(void)
+{
+    const int32_t divisors[] = {1, -1, 2, -8, 3, -7, 10, 60, 641, 1000, 65536, 1000003,
+                                 0x40000000, 0x7FFFFFFF, -0x7FFFFFFF, INT32_MIN};
+    enum { N = 203 };
+    int32_t in[N], out[N];
+    uint32_t seed = 2463534242u;
+    int failures = 0;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        in[i] = (int32_t)seed >> (i % 29);
+    }
+    in[0] = INT32_MIN;
+    in[1] = INT32_MAX;
+    in[2] = -1;
+    in[3] = 0;
+
+    for (size_t k = 0; k < sizeof(divisors) / sizeof(divisors[0]); ++k)
+    {
+        int32_t divisor = divisors[k];
+        asm_int_divider d;
+        failures += asm_int_divider_init(&d, divisor) != 0;
+        for (size_t n = 0; n <= N; n += n < 40 ? 1 : 41)
+        {
+            asm_div_int_array(&d, in, out, n);
+            for (size_t i = 0; i < n; ++i)
+                failures += out[i] != (in[i] == INT32_MIN && divisor == -1 ? INT32_MIN : in[i] / divisor);
+            asm_mod_int_array(&d, in, out, n);
+            for (size_t i = 0; i < n; ++i)
+                failures += out[i] != (in[i] == INT32_MIN && divisor == -1 ? 0 : in[i] % divisor);
+        }
+    }
+
+    // 所有 2 ~ 5000 的除数，原地运算
+    for (int32_t divisor = 2; divisor <= 5000; ++divisor)
+    {
+        asm_int_divider d;
+        asm_int_divider_init(&d, divisor);
+        memcpy(out, in, sizeof(in));
+        asm_div_int_array(&d, out, out, N);
+        for (size_t i = 0; i < N; ++i)
+            failures += out[i] != in[i] / divisor;
+    }
+
+    asm_int_divider zero;
+    failures += asm_int_divider_init(&zero, 0) != -1;
+    return failures;
+}
+
+// 验证浮点 BLAS-1 运算（含各种长度的标量尾部和原地运算）。输入为小整数与 2 的负幂之积，
+// 无论求和顺序和是否融合乘加，结果都是精确的；范数只比较平方。返回失败次数
+static int check_blas_ops(void)
+{
+    enum { N = 300 };
+    double x[N], y[N], c[N], out[N];
+    float xf[N], yf[N], cf[N], outf[N];
+    int failures = 0;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        x[i] = (double)((int)(i % 17) - 8);
+        y[i] = (double)(i % 5) * 0.5;
+        c[i] = (double)((int)(i % 7) - 3) * 0.25;
+        xf[i] = (float)x[i];
+        yf[i] = (float)y[i];
+        cf[i] = (float)c[i];
+    }
+
+    for (size_t n = 0; n <= N; n = n < 70 ? n + 1 : n + 23)
+    {
+        double dot = 0.0, ss = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            dot += x[i] * y[i];
+            ss += x[i] * x[i];
+        }
+        failures += asm_dot_f64(x, y, n) != dot;
+        failures += asm_dot_f32(xf, yf, n) != (float)dot;
+        double norm = asm_norm2_f64(x, n);
+        float normf = asm_norm2_f32(xf, n);
+        failures += norm * norm - ss > ss * 1e-12 || ss - norm * norm > ss * 1e-12;
+        failures += (double)normf * normf - ss > ss * 1e-6 || ss - (double)normf * normf > ss * 1e-6;
+
+        memcpy(out, y, sizeof(y));
+        memcpy(outf, yf, sizeof(yf));
+        asm_axpy_f64(-0.75, x, out, n);
+        asm_axpy_f32(-0.75f, xf, outf, n);
+        for (size_t i = 0; i < N; ++i)
+        {
+            double expected = i < n ? -0.75 * x[i] + y[i] : y[i];
+            failures += out[i] != expected || outf[i] != (float)expected;
+        }
+
+        memcpy(out, x, sizeof(x));
+        memcpy(outf, xf, sizeof(xf));
+        asm_scale_f64(0.125, out, n);
+        asm_scale_f32(0.125f, outf, n);
+        for (size_t i = 0; i < N; ++i)
+        {
+            double expected = i < n ? 0.125 * x[i] : x[i];
+            failures += out[i] != expected || outf[i] != (float)expected;
+        }
+
+        // out 与 c 相同：原地乘加
+        memcpy(out, c, sizeof(c));
+        memcpy(outf, cf, sizeof(cf));
+        asm_fma_f64(x, y, out, out, n);
+        asm_fma_f32(xf, yf, outf, outf, n);
+        for (size_t i = 0; i < N; ++i)
+        {
+            double expected = i < n ? x[i] * y[i] + c[i] : c[i];
+            failures += out[i] != expected || outf[i] != (float)expected;
+        }
+    }
+
+    // 融合乘加只舍入一次：(1 + 2^-30)² - (1 + 2^-29) 精确为 2^-60，乘加分别舍入时为 0
+    int fused = (asm_cpu_features() & (ASM_CPU_FMA | ASM_CPU_AVX512)) != 0;
+    double e = 1.0 + 1.0 / (1 << 30), f = -(1.0 + 2.0 / (1 << 30));
+    asm_fma_f64(&e, &e, &f, out, 1);
+    failures += out[0] != (fused ? 1.0 / (1ull << 60) : 0.0);
+    return failures;
+}
+
+// 验证 6×NR 矩阵乘法微内核（覆盖写入与累加两种模式），小整数数据保证结果精确，返回失败次数
+static int check_gemm_kernel(void)
+{
+    enum { K = 37, LDC = 19 };
+    double a[K * 6], b[K * 8], c[6 * LDC];
+    float af[K * 6], bf[K * 16], cf[6 * LDC];
+    int failures = 0;
+
+    for (size_t i = 0; i < K * 6; ++i)
+    {
+        a[i] = (double)((int)(i % 9) - 4);
+        af[i] = (float)a[i];
+    }
+    for (size_t i = 0; i < K * 16; ++i)
+    {
+        bf[i] = (float)((int)(i % 7) - 3) * 0.5f;
+        if (i < K * 8)
+            b[i] = (double)bf[i];
+    }
+
+    const size_t ks[] = {0, 1, 5, K};
+    for (size_t t = 0; t < sizeof(ks) / sizeof(ks[0]); ++t)
+    {
+        size_t k = ks[t];
+        for (int accumulate = 0; accumulate <= 1; ++accumulate)
+        {
+            for (size_t i = 0; i < 6 * LDC; ++i)
+            {
+                c[i] = (double)(i % 11);
+                cf[i] = (float)c[i];
+            }
+            asm_gemm_kernel_f64(k, a, b, c, LDC, accumulate);
+            asm_gemm_kernel_f32(k, af, bf, cf, LDC, accumulate);
+            for (size_t i = 0; i < 6; ++i)
+            {
+                for (size_t j = 0; j < LDC; ++j)
+                {
+                    double old = (double)((i * LDC + j) % 11), sum = 0.0, sumf = 0.0;
+                    for (size_t p = 0; p < k; ++p)
+                    {
+                        sum += j < 8 ? a[p * 6 + i] * b[p * 8 + j] : 0.0;
+                        sumf += j < 16 ? a[p * 6 + i] * bf[p * 16 + j] : 0.0;
+                    }
+                    // 小块之外的列不得被改写
+                    double expected = j < 8 ? (accumulate ? old + sum : sum) : old;
+                    double expectedf = j < 16 ? (accumulate ? old + sumf : sumf) : old;
+                    failures += c[i * LDC + j] != expected || cf[i * LDC + j] != (float)expectedf;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+// 验证批量多项式求值（各种次数、点数和原地计算），二进小数数据保证结果精确，返回失败次数
+static int check_poly_eval(void)
+{
+    enum { N = 83, MAX_COUNT = 14 };
+    double c[MAX_COUNT], x[N], out[N];
+    float cf[MAX_COUNT], xf[N], outf[N];
+    int failures = 0;
+
+    for (size_t j = 0; j < MAX_COUNT; ++j)
+    {
+        c[j] = (double)((int)(j % 5) - 2);
+        cf[j] = (float)c[j];
+    }
+    for (size_t i = 0; i < N; ++i)
+    {
+        x[i] = (double)((int)(i % 9) - 4) * 0.5;
+        xf[i] = (float)x[i];
+    }
+
+    for (size_t count = 0; count <= MAX_COUNT; ++count)
+    {
+        for (size_t n = 0; n <= N; n = n < 40 ? n + 1 : n + 43)
+        {
+            asm_poly_eval_f64(c, count, x, out, n);
+            // float 原地计算
+            memcpy(outf, xf, sizeof(xf));
+            asm_poly_eval_f32(cf, count, outf, outf, n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                double expected = 0.0;
+                for (size_t j = count; j-- > 0;)
+                    expected = expected * x[i] + c[j];
+                failures += out[i] != expected || outf[i] != (float)expected;
+            }
+        }
+    }
+    return failures;
+}
+
+// 验证 int64 标量带溢出检查 / 饱和运算的边界，返回失败次数
+static int check_checked_scalar(void)
+{
+    int64_t r = 0;
+    int failures = 0;
+    failures += asm_add_checked(INT64_MAX, 1, &r) != 1 || r != INT64_MIN;
+    failures += asm_add_checked(-5, 3, &r) != 0 || r != -2;
+    failures += asm_subtract_checked(INT64_MIN, 1, &r) != 1 || r != INT64_MAX;
+    failures += asm_subtract_checked(0, INT64_MIN, &r) != 1;
+    failures += asm_multiply_checked(INT64_MIN, -1, &r) != 1 || r != INT64_MIN;
+    failures += asm_multiply_checked(3037000499LL, 3037000499LL, &r) != 0;
+    failures += asm_multiply_checked(3037000500LL, 3037000500LL, &r) != 1;
+    failures += asm_add_sat(INT64_MAX, 1) != INT64_MAX || asm_add_sat(INT64_MIN, -1) != INT64_MIN;
+    failures += asm_subtract_sat(INT64_MIN, 1) != INT64_MIN || asm_subtract_sat(1, INT64_MIN) != INT64_MAX;
+    failures += asm_multiply_sat(INT64_MIN, -1) != INT64_MAX || asm_multiply_sat(INT64_MAX, -2) != INT64_MIN;
+    failures += asm_multiply_sat(-6, 7) != -42;
+    return failures;
+}
+
+// 对比 64 位运算验证 int32 数组带溢出检查 / 饱和运算（含标量尾部和原地运算），返回失败次数
+static int check_checked_arrays(void)
+{
+    const int32_t edge[] = {0, 1, -1, 2, 46340, -46341, 65536, INT32_MAX, INT32_MIN, INT32_MIN + 1, 0x40000000};
+    enum { E = sizeof(edge) / sizeof(edge[0]), N = E * E + 7 };
+    int32_t a[N], b[N], out[N];
+    uint8_t overflow[N];
+    int failures = 0;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        a[i] = i < E * E ? edge[i / E] : INT32_MAX - (int32_t)i;
+        b[i] = i < E * E ? edge[i % E] : (int32_t)((uint32_t)i << 24);
+    }
+
+    for (int op = 0; op < 3; ++op)
+    {
+        for (size_t n = 0; n <= N; n += n < 20 ? 1 : 17)
+        {
+            size_t expected = 0;
+            int64_t wide[N];
+            for (size_t i = 0; i < n; ++i)
+            {
+                wide[i] = op == 0 ? (int64_t)a[i] + b[i] : op == 1 ? (int64_t)a[i] - b[i] : (int64_t)a[i] * b[i];
+                expected += wide[i] != (int32_t)wide[i];
+            }
+
+            size_t count = op == 0 ? asm_add_int_array_checked(a, b, out, overflow, n)
+                           : op == 1 ? asm_sub_int_array_checked(a, b, out, overflow, n)
+                                     : asm_mul_int_array_checked(a, b, out, overflow, n);
+            failures += count != expected;
+            for (size_t i = 0; i < n; ++i)
+                failures += out[i] != (int32_t)(uint32_t)(uint64_t)wide[i] || overflow[i] != (wide[i] != (int32_t)wide[i]);
+
+            memcpy(out, a, sizeof(a));
+            count = op == 0 ? asm_add_int_array_sat(out, b, out, n)
+                    : op == 1 ? asm_sub_int_array_sat(out, b, out, n)
+                              : asm_mul_int_array_sat(out, b, out, n);
+            failures += count != expected;
+            for (size_t i = 0; i < n; ++i)
+                failures += out[i] != (wide[i] > INT32_MAX ? INT32_MAX : wide[i] < INT32_MIN ? INT32_MIN : wide[i]);
+        }
+    }
+    return failures;
+}
+
 int main()
 {
     printf("Testing x64 Assembly Math Operations\n");
@@ -36,6 +493,62 @@ int main()
     int shift = 5;
     printf("Left shift: %llu << %d = %llu\n", value, shift, asm_left_shift(value, shift));
 
+    // 测试带溢出检查 / 饱和运算
+    if (check_checked_scalar() != 0)
+    {
+        printf("Checked/saturating scalars: FAILED\n");
+        return 1;
+    }
+    printf("Checked/saturating scalars: OK\n");
+
+    // 测试 SIMD 内存操作：依次限制 CPU 特性以覆盖每条分派路径
+    uint32_t features = asm_cpu_features();
+    printf("\nCPU features: 0x%X, LLC size: %zu bytes\n", features, asm_cpu_llc_size());
+
+    const uint32_t paths[] = {0, ASM_CPU_ERMS, ASM_CPU_AVX2 | ASM_CPU_FMA, ASM_CPU_AVX2 | ASM_CPU_FMA | ASM_CPU_AVX512, 0xFFFFFFFFu};
+    const char *names[] = {"SSE2", "ERMS", "AVX2", "AVX-512", "auto"};
+    asm_memory_set_nt_threshold(4096); // 让较小的长度也走非临时存储路径
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i)
+    {
+        asm_cpu_reset_features();
+        asm_cpu_restrict_features(paths[i]);
+        int failures = check_memory_ops(1 << 17);
+        printf("Memory copy/set (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_string_ops();
+        printf("String length/copy (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_bitwise_ops();
+        printf("Bitwise arrays (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_divide_ops();
+        printf("Invariant divider (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_checked_arrays();
+        printf("Checked/saturating arrays (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_blas_ops();
+        printf("BLAS-1 dot/axpy/scale/norm/fma (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_gemm_kernel();
+        printf("GEMM micro-kernel (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+        failures = check_poly_eval();
+        printf("Polynomial evaluation (%s): %s\n", names[i], failures ? "FAILED" : "OK");
+        if (failures)
+            return 1;
+    }
+    asm_cpu_reset_features();
+    asm_memory_set_nt_threshold(0);
+    printf("Non-temporal threshold: %zu bytes\n", asm_memory_get_nt_threshold());
+
     printf("\nAll x64 assembly tests completed successfully!\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "c_math_ops/math_ops.h"
+
+// 标量函数的每次调用开销：这些调用跨越库边界，
+// 用于比较共享库 / 静态库 / LTO / PGO 构建，也是 PGO 的训练程序
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+enum { INPUTS = 1024 };
+
+// 对 INPUTS 个输入循环调用 expr（i 为下标），返回最好一轮的每次调用耗时 (ns)
+#define BENCH_CALL(expr, rounds, result)                                 \
+    do                                                                   \
+    {                                                                    \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t r_ = 0; r_ < (rounds); ++r_)                     \
+            {                                                            \
+                int64_t acc_ = 0;                                        \
+                for (size_t i = 0; i < INPUTS; ++i)                      \
+                {                                                        \
+                    acc_ += (int64_t)(expr);                             \
+                }                                                        \
+                sink += acc_;                                            \
+                __asm__ volatile("" ::: "memory");                       \
+            }                                                            \
+            double ns_ = (now_seconds() - start_) * 1e9 / ((rounds) * INPUTS); \
+            best_ = ns_ < best_ ? ns_ : best_;                           \
+        }                                                                \
+        (result) = best_;                                                \
+    } while (0)
+
+int main(int argc, char **argv)
+{
+    // 参数为每项测试的轮数（每轮 INPUTS 次调用），PGO 训练时可以取小一些
+    size_t rounds = argc > 1 ? strtoull(argv[1], NULL, 0) : 20000;
+    int32_t *a = malloc(INPUTS * sizeof(int32_t));
+    int32_t *b = malloc(INPUTS * sizeof(int32_t));
+    if (!a || !b)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    uint32_t seed = 42;
+    for (size_t i = 0; i < INPUTS; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        a[i] = (int32_t)(seed >> 8);
+        b[i] = (int32_t)(seed % 1000) + 1;
+    }
+    int_divider divider;
+    int_divider_init(&divider, 7);
+    const char *words[] = {"", "add", "calculator", "mixed language programming"};
+    int32_t small[16];
+    for (int i = 0; i < 16; ++i)
+        small[i] = a[i];
+
+    volatile int64_t sink = 0;
+    struct
+    {
+        const char *name;
+        double ns;
+    } results[9];
+    int count = 0;
+
+#define RUN(label, expr)                                \
+    do                                                  \
+    {                                                   \
+        results[count].name = label;                    \
+        BENCH_CALL(expr, rounds, results[count].ns);    \
+        ++count;                                        \
+    } while (0)
+
+    RUN("add_int", add_int(a[i], b[i]));
+    RUN("mul_int", mul_int(a[i], b[i]));
+    RUN("div_int", div_int(a[i], b[i]));
+    RUN("mod_int", mod_int(a[i], b[i]));
+    RUN("add_int_sat", add_int_sat(a[i], b[i]));
+    RUN("int_divider_div", int_divider_div(&divider, a[i]));
+    RUN("bitwise_xor", bitwise_xor((uint32_t)a[i], (uint32_t)b[i]));
+    RUN("find_max(16)", find_max(small, (i & 15) + 1));
+    RUN("string_length", string_length(words[i & 3]));
+#undef RUN
+
+    for (int k = 0; k < count; ++k)
+        printf("%-18s %8.2f ns/call\n", results[k].name, results[k].ns);
+
+    free(a);
+    free(b);
+    return (int)(sink & 0);
+}
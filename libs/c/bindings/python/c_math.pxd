@@ -0,0 +1,68 @@
+"""
+C-level declarations for the c_math bindings.
+
+Other Cython modules can ``from c_math cimport add, add_saturating`` and call the scalar
+entry points as plain C functions (no Python call, no int boxing); c_math must be imported
+at runtime, nothing extra is linked. Modules that link the C library themselves can also
+cimport the raw declarations below (add_int, add_int_sat, ...).
+"""
+
+from libc.stdint cimport int32_t, uint8_t, uint32_t
+from libc.stddef cimport size_t
+
+# Declare C functions from our library
+cdef extern from "c_math_ops/math_ops.h" nogil:
+    int32_t add_int(int32_t a, int32_t b)
+    int32_t sub_int(int32_t a, int32_t b)
+    int32_t mul_int(int32_t a, int32_t b)
+    int32_t div_int(int32_t a, int32_t b)
+    int32_t mod_int(int32_t a, int32_t b)
+    int add_int_checked(int32_t a, int32_t b, int32_t *result)
+    int sub_int_checked(int32_t a, int32_t b, int32_t *result)
+    int mul_int_checked(int32_t a, int32_t b, int32_t *result)
+    int div_int_checked(int32_t a, int32_t b, int32_t *result)
+    int32_t add_int_sat(int32_t a, int32_t b)
+    int32_t sub_int_sat(int32_t a, int32_t b)
+    int32_t mul_int_sat(int32_t a, int32_t b)
+    size_t add_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
+    size_t sub_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
+    size_t mul_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
+    size_t add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+    size_t sub_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+    size_t mul_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
+    # 与下面同名的模块函数区分
+    uint32_t c_bitwise_and "bitwise_and"(uint32_t a, uint32_t b)
+    uint32_t c_bitwise_or "bitwise_or"(uint32_t a, uint32_t b)
+    uint32_t c_bitwise_xor "bitwise_xor"(uint32_t a, uint32_t b)
+
+    ctypedef struct int_divider:
+        int32_t divisor
+    int int_divider_init(int_divider *d, int32_t divisor)
+    int32_t int_divider_div(const int_divider *d, int32_t n)
+    int32_t int_divider_mod(const int_divider *d, int32_t n)
+    void div_int_array(const int_divider *d, const int32_t *inp, int32_t *out, size_t n)
+    void mod_int_array(const int_divider *d, const int32_t *inp, int32_t *out, size_t n)
+
+    size_t argmax_int32(const int32_t *arr, size_t size)
+    size_t argmin_int32(const int32_t *arr, size_t size)
+    size_t top_k_int32(const int32_t *arr, size_t size, size_t k, size_t *indices)
+    int percentile_int32(int32_t *arr, size_t size, double q, double *result)
+
+
+# 标量入口：Python 侧是 METH_FASTCALL 的模块函数，Cython 侧是直接的 C 调用。
+# 会抛异常的函数在 C 侧以 -1 表示可能出错（调用方需检查 PyErr_Occurred，Cython 自动处理）
+cpdef int32_t add(int32_t a, int32_t b) noexcept nogil
+cpdef int32_t subtract(int32_t a, int32_t b) noexcept nogil
+cpdef int32_t multiply(int32_t a, int32_t b) noexcept nogil
+cpdef int32_t divide(int32_t a, int32_t b) except? -1 nogil
+cpdef int32_t mod(int32_t a, int32_t b) except? -1 nogil
+cpdef int32_t add_checked(int32_t a, int32_t b) except? -1 nogil
+cpdef int32_t subtract_checked(int32_t a, int32_t b) except? -1 nogil
+cpdef int32_t multiply_checked(int32_t a, int32_t b) except? -1 nogil
+cpdef int32_t divide_checked(int32_t a, int32_t b) except? -1 nogil
+cpdef int32_t add_saturating(int32_t a, int32_t b) noexcept nogil
+cpdef int32_t subtract_saturating(int32_t a, int32_t b) noexcept nogil
+cpdef int32_t multiply_saturating(int32_t a, int32_t b) noexcept nogil
+cpdef uint32_t bitwise_and(uint32_t a, uint32_t b) noexcept nogil
+cpdef uint32_t bitwise_or(uint32_t a, uint32_t b) noexcept nogil
+cpdef uint32_t bitwise_xor(uint32_t a, uint32_t b) noexcept nogil
@@ -1,23 +1,162 @@
-# cython: language_level=3
+# cython: language_level=3, binding=False
 
 """
 Cython bindings for C math operations library.
 This compiles to a Python extension module that links directly to the C library.
+
+The scalar operations are also module-level functions (c_math.add(1, 2)); they skip the
+CMathOps method lookup and are C functions for Cython code that cimports c_math (see c_math.pxd).
 """
 
-from libc.stdint cimport int32_t, uint32_t
-from libc.stddef cimport size_t
+from cpython cimport array
+from cpython.mem cimport PyMem_Malloc, PyMem_Free
+import array
+
+cdef array.array _I32_TEMPLATE = array.array('i')
+cdef array.array _U8_TEMPLATE = array.array('B')
+
+
+# ---------------------------------------------------------------------------
+# 标量运算：模块函数（声明见 c_math.pxd）
+# ---------------------------------------------------------------------------
+
+cpdef int32_t add(int32_t a, int32_t b) noexcept nogil:
+    """Add two int32 values (wraps on overflow)."""
+    return add_int(a, b)
+
+
+cpdef int32_t subtract(int32_t a, int32_t b) noexcept nogil:
+    """Subtract two int32 values (wraps on overflow)."""
+    return sub_int(a, b)
+
+
+cpdef int32_t multiply(int32_t a, int32_t b) noexcept nogil:
+    """Multiply two int32 values (wraps on overflow)."""
+    return mul_int(a, b)
+
+
+cpdef int32_t divide(int32_t a, int32_t b) except? -1 nogil:
+    """Divide two int32 values, truncating toward zero."""
+    if b == 0:
+        with gil:
+            raise ZeroDivisionError("Division by zero")
+    return div_int(a, b)
+
+
+cpdef int32_t mod(int32_t a, int32_t b) except? -1 nogil:
+    """Remainder of int32 division (sign follows the dividend)."""
+    if b == 0:
+        with gil:
+            raise ZeroDivisionError("Modulo by zero")
+    return mod_int(a, b)
+
+
+cpdef int32_t add_checked(int32_t a, int32_t b) except? -1 nogil:
+    """Add two int32 values, raising OverflowError instead of wrapping."""
+    cdef int32_t result
+    if add_int_checked(a, b, &result):
+        with gil:
+            raise OverflowError("int32 addition overflow")
+    return result
+
+
+cpdef int32_t subtract_checked(int32_t a, int32_t b) except? -1 nogil:
+    """Subtract two int32 values, raising OverflowError instead of wrapping."""
+    cdef int32_t result
+    if sub_int_checked(a, b, &result):
+        with gil:
+            raise OverflowError("int32 subtraction overflow")
+    return result
+
+
+cpdef int32_t multiply_checked(int32_t a, int32_t b) except? -1 nogil:
+    """Multiply two int32 values, raising OverflowError instead of wrapping."""
+    cdef int32_t result
+    if mul_int_checked(a, b, &result):
+        with gil:
+            raise OverflowError("int32 multiplication overflow")
+    return result
+
+
+cpdef int32_t divide_checked(int32_t a, int32_t b) except? -1 nogil:
+    """Divide two int32 values; INT32_MIN / -1 raises OverflowError."""
+    cdef int32_t result
+    cdef int status = div_int_checked(a, b, &result)
+    if status < 0:
+        with gil:
+            raise ZeroDivisionError("Division by zero")
+    if status:
+        with gil:
+            raise OverflowError("int32 division overflow")
+    return result
+
+
+cpdef int32_t add_saturating(int32_t a, int32_t b) noexcept nogil:
+    """Add two int32 values, clamping to the int32 range."""
+    return add_int_sat(a, b)
+
+
+cpdef int32_t subtract_saturating(int32_t a, int32_t b) noexcept nogil:
+    """Subtract two int32 values, clamping to the int32 range."""
+    return sub_int_sat(a, b)
+
+
+cpdef int32_t multiply_saturating(int32_t a, int32_t b) noexcept nogil:
+    """Multiply two int32 values, clamping to the int32 range."""
+    return mul_int_sat(a, b)
+
+
+cpdef uint32_t bitwise_and(uint32_t a, uint32_t b) noexcept nogil:
+    """Bitwise AND of two uint32 values."""
+    return c_bitwise_and(a, b)
+
+
+cpdef uint32_t bitwise_or(uint32_t a, uint32_t b) noexcept nogil:
+    """Bitwise OR of two uint32 values."""
+    return c_bitwise_or(a, b)
+
 
-# Declare C functions from our library
-cdef extern from "c_math_ops/math_ops.h":
-    int32_t add_int(int32_t a, int32_t b)
-    int32_t sub_int(int32_t a, int32_t b)
-    int32_t mul_int(int32_t a, int32_t b)
-    int32_t div_int(int32_t a, int32_t b)
-    int32_t mod_int(int32_t a, int32_t b)
-    uint32_t bitwise_and(uint32_t a, uint32_t b)
-    uint32_t bitwise_or(uint32_t a, uint32_t b)
-    uint32_t bitwise_xor(uint32_t a, uint32_t b)
+cpdef uint32_t bitwise_xor(uint32_t a, uint32_t b) noexcept nogil:
+    """Bitwise XOR of two uint32 values."""
+    return c_bitwise_xor(a, b)
+
+
+cdef enum ArithOp:
+    ARITH_ADD
+    ARITH_SUB
+    ARITH_MUL
+
+
+cdef object _arith_arrays(const int32_t[::1] a, const int32_t[::1] b, object out, bint saturate, ArithOp op):
+    """Shared body of the int32 batch methods: returns result, or (result, overflow) when not saturating."""
+    cdef Py_ssize_t n = a.shape[0]
+    if b.shape[0] != n:
+        raise ValueError("Input arrays must have the same length")
+    if out is None:
+        out = array.clone(_I32_TEMPLATE, n, zero=False)
+    cdef int32_t[::1] dst = out
+    if dst.shape[0] != n:
+        raise ValueError("Output array must have the same length as the inputs")
+    cdef array.array overflow = array.clone(_U8_TEMPLATE, n, zero=False)
+    if n == 0:
+        return out if saturate else (out, overflow)
+
+    if saturate:
+        if op == ARITH_ADD:
+            add_int_array_sat(&a[0], &b[0], &dst[0], n)
+        elif op == ARITH_SUB:
+            sub_int_array_sat(&a[0], &b[0], &dst[0], n)
+        else:
+            mul_int_array_sat(&a[0], &b[0], &dst[0], n)
+        return out
+
+    if op == ARITH_ADD:
+        add_int_array_checked(&a[0], &b[0], &dst[0], overflow.data.as_uchars, n)
+    elif op == ARITH_SUB:
+        sub_int_array_checked(&a[0], &b[0], &dst[0], overflow.data.as_uchars, n)
+    else:
+        mul_int_array_checked(&a[0], &b[0], &dst[0], overflow.data.as_uchars, n)
+    return out, overflow
 
 
 cdef class CMathOps:
@@ -25,36 +164,172 @@ cdef class CMathOps:
 
     def add(self, int a, int b):
         """Add two integers."""
-        return add_int(a, b)
+        return add(a, b)
 
     def subtract(self, int a, int b):
         """Subtract two integers."""
-        return sub_int(a, b)
+        return subtract(a, b)
 
     def multiply(self, int a, int b):
         """Multiply two integers."""
-        return mul_int(a, b)
+        return multiply(a, b)
 
     def divide(self, int a, int b):
         """Divide two integers."""
-        if b == 0:
-            raise ZeroDivisionError("Division by zero")
-        return div_int(a, b)
+        return divide(a, b)
 
     def mod(self, int a, int b):
         """Modulo operation."""
-        if b == 0:
-            raise ZeroDivisionError("Modulo by zero")
-        return mod_int(a, b)
+        return mod(a, b)
+
+    def add_checked(self, int a, int b):
+        """Add two int32 values, raising OverflowError instead of wrapping."""
+        return add_checked(a, b)
+
+    def subtract_checked(self, int a, int b):
+        """Subtract two int32 values, raising OverflowError instead of wrapping."""
+        return subtract_checked(a, b)
+
+    def multiply_checked(self, int a, int b):
+        """Multiply two int32 values, raising OverflowError instead of wrapping."""
+        return multiply_checked(a, b)
+
+    def divide_checked(self, int a, int b):
+        """Divide two int32 values; INT32_MIN / -1 raises OverflowError."""
+        return divide_checked(a, b)
+
+    def add_saturating(self, int a, int b):
+        """Add two int32 values, clamping to the int32 range."""
+        return add_saturating(a, b)
+
+    def subtract_saturating(self, int a, int b):
+        """Subtract two int32 values, clamping to the int32 range."""
+        return subtract_saturating(a, b)
+
+    def multiply_saturating(self, int a, int b):
+        """Multiply two int32 values, clamping to the int32 range."""
+        return multiply_saturating(a, b)
+
+    def add_arrays(self, const int32_t[::1] a, const int32_t[::1] b, out=None, saturate=False):
+        """Element-wise int32 addition without branching on overflow.
+
+        Returns (result, overflow) where result holds the wrapped sums and overflow is an
+        array('B') of 0/1 flags; with saturate=True returns only the saturated result.
+        out may be one of the inputs.
+        """
+        return _arith_arrays(a, b, out, saturate, ARITH_ADD)
+
+    def subtract_arrays(self, const int32_t[::1] a, const int32_t[::1] b, out=None, saturate=False):
+        """Element-wise int32 subtraction; see add_arrays."""
+        return _arith_arrays(a, b, out, saturate, ARITH_SUB)
+
+    def multiply_arrays(self, const int32_t[::1] a, const int32_t[::1] b, out=None, saturate=False):
+        """Element-wise int32 multiplication; see add_arrays."""
+        return _arith_arrays(a, b, out, saturate, ARITH_MUL)
+
+    def argmax(self, const int32_t[::1] values):
+        """Index of the first maximum of an int32 buffer."""
+        if values.shape[0] == 0:
+            raise ValueError("Array cannot be empty")
+        return argmax_int32(&values[0], values.shape[0])
+
+    def argmin(self, const int32_t[::1] values):
+        """Index of the first minimum of an int32 buffer."""
+        if values.shape[0] == 0:
+            raise ValueError("Array cannot be empty")
+        return argmin_int32(&values[0], values.shape[0])
+
+    def top_k(self, const int32_t[::1] values, Py_ssize_t k):
+        """Indices of the k largest elements, largest first; ties keep the lower index first."""
+        if k < 0:
+            raise ValueError("k must be non-negative")
+        cdef Py_ssize_t n = values.shape[0]
+        if k > n:
+            k = n
+        if k == 0:
+            return []
+        cdef size_t *indices = <size_t *>PyMem_Malloc(k * sizeof(size_t))
+        if indices == NULL:
+            raise MemoryError()
+        cdef size_t count, i
+        try:
+            count = top_k_int32(&values[0], n, k, indices)
+            return [indices[i] for i in range(count)]
+        finally:
+            PyMem_Free(indices)
+
+    def percentile(self, const int32_t[::1] values, double q):
+        """Percentile with linear interpolation (numpy's default), q in [0, 1]; values is not modified."""
+        cdef Py_ssize_t n = values.shape[0]
+        if n == 0:
+            raise ValueError("Array cannot be empty")
+        # 快速选择会重排数组，在副本上计算
+        cdef array.array work = array.clone(_I32_TEMPLATE, n, zero=False)
+        cdef int32_t[::1] buf = work
+        buf[:] = values
+        cdef double result
+        if percentile_int32(&buf[0], n, q, &result) != 0:
+            raise ValueError("Percentile must be between 0 and 1")
+        return result
+
+    def median(self, const int32_t[::1] values):
+        """Median of an int32 buffer (average of the two middle elements for even lengths)."""
+        return self.percentile(values, 0.5)
 
     def bitwise_and(self, int a, int b):
         """Bitwise AND operation."""
-        return bitwise_and(a, b)
+        return bitwise_and(<uint32_t>a, <uint32_t>b)
 
     def bitwise_or(self, int a, int b):
         """Bitwise OR operation."""
-        return bitwise_or(a, b)
+        return bitwise_or(<uint32_t>a, <uint32_t>b)
 
     def bitwise_xor(self, int a, int b):
         """Bitwise XOR operation."""
-        return bitwise_xor(a, b)
\ No newline at end of file
+        return bitwise_xor(<uint32_t>a, <uint32_t>b)
+
+cdef class IntDivider:
+    """Precomputed int32 divisor: division and modulo become multiply and shift.
+
+    Results truncate toward zero like C (not Python's floor division).
+    """
+    cdef int_divider _d
+
+    def __cinit__(self, int divisor):
+        if int_divider_init(&self._d, divisor) != 0:
+            raise ZeroDivisionError("Division by zero")
+
+    @property
+    def divisor(self):
+        return self._d.divisor
+
+    def divide(self, int n):
+        """Divide one integer by the divisor."""
+        return int_divider_div(&self._d, n)
+
+    def mod(self, int n):
+        """Remainder of one integer (sign follows the dividend)."""
+        return int_divider_mod(&self._d, n)
+
+    def divide_array(self, const int32_t[::1] values, out=None):
+        """Divide every element of an int32 buffer; writes into out (may be values) or a new array('i')."""
+        return self._apply(values, out, False)
+
+    def mod_array(self, const int32_t[::1] values, out=None):
+        """Remainder of every element of an int32 buffer."""
+        return self._apply(values, out, True)
+
+    cdef object _apply(self, const int32_t[::1] values, object out, bint mod):
+        cdef Py_ssize_t n = values.shape[0]
+        if out is None:
+            out = array.clone(_I32_TEMPLATE, n, zero=False)
+        cdef int32_t[::1] dst = out
+        if dst.shape[0] != n:
+            raise ValueError("Output array must have the same length as the input")
+        if n == 0:
+            return out
+        if mod:
+            mod_int_array(&self._d, &values[0], &dst[0], n)
+        else:
+            div_int_array(&self._d, &values[0], &dst[0], n)
+        return out
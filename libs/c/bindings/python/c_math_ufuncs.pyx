@@ -0,0 +1,201 @@
+# cython: language_level=3
+
+"""
+NumPy ufuncs backed by the C math operations library.
+
+Each ufunc is named after the C function it applies: add_int, add_int_sat, div_int and mod_int
+take int32 arrays; bitwise_and, bitwise_or and bitwise_xor take int32 or uint32 arrays. They
+broadcast and accept out= / where= like any ufunc, and reduce / accumulate work
+(c_math_ufuncs.add_int.reduce(values) sums with int32 wraparound).
+Other integer dtypes need an explicit cast, e.g. values.astype(np.int32).
+
+Division and modulo by zero give 0 and set numpy's divide-by-zero flag, so np.errstate decides
+whether that warns (the default), raises or is ignored. INT32_MIN / -1 wraps to INT32_MIN.
+"""
+
+cimport numpy as cnp
+from libc.stdint cimport int32_t, uint32_t
+# 用模块名限定 C 函数，本模块导出的 ufunc 与 C 函数同名
+cimport c_math
+
+cnp.import_array()
+cnp.import_ufunc()
+
+cdef extern from "fenv.h" nogil:
+    int FE_DIVBYZERO
+    int feraiseexcept(int excepts)
+
+cdef extern from "numpy/ufuncobject.h":
+    enum:
+        PyUFunc_MinusOne
+
+
+# ---------------------------------------------------------------------------
+# 内层循环。numpy 对每段数据调用一次：args = 输入、输出的起始地址，dims[0] = 元素个数，
+# steps = 各自的字节步长。连续数据直接调用批量内核或可向量化的循环，其余情况逐个元素按步长前进
+# ---------------------------------------------------------------------------
+
+cdef enum BinaryOp:
+    OP_ADD
+    OP_ADD_SAT
+    OP_AND
+    OP_OR
+    OP_XOR
+
+
+cdef inline int32_t _apply(int32_t a, int32_t b, BinaryOp op) noexcept nogil:
+    # op 在每个调用处都是常量，内联后只剩对应的一种运算
+    if op == OP_ADD:
+        return c_math.add_int(a, b)
+    if op == OP_ADD_SAT:
+        return c_math.add_int_sat(a, b)
+    if op == OP_AND:
+        return <int32_t>c_math.c_bitwise_and(<uint32_t>a, <uint32_t>b)
+    if op == OP_OR:
+        return <int32_t>c_math.c_bitwise_or(<uint32_t>a, <uint32_t>b)
+    return <int32_t>c_math.c_bitwise_xor(<uint32_t>a, <uint32_t>b)
+
+
+cdef inline void _binary_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, BinaryOp op) noexcept nogil:
+    """32 位二元运算；位运算对 int32 和 uint32 是同一个循环"""
+    cdef cnp.npy_intp i, n = dims[0]
+    cdef char *a = args[0]
+    cdef char *b = args[1]
+    cdef char *out = args[2]
+    cdef const int32_t *pa
+    cdef const int32_t *pb
+    cdef int32_t *po
+    cdef int32_t acc
+    if steps[0] == 4 and steps[1] == 4 and steps[2] == 4:
+        pa, pb, po = <const int32_t *>a, <const int32_t *>b, <int32_t *>out
+        if op == OP_ADD_SAT:
+            c_math.add_int_array_sat(pa, pb, po, n)
+        else:
+            for i in range(n):
+                po[i] = _apply(pa[i], pb[i], op)
+    elif a == out and steps[0] == 0 and steps[2] == 0 and steps[1] == 4:
+        # reduce：累加器同时是第一个输入和输出，步长为 0，放在寄存器中
+        pb = <const int32_t *>b
+        acc = (<int32_t *>out)[0]
+        for i in range(n):
+            acc = _apply(acc, pb[i], op)
+        (<int32_t *>out)[0] = acc
+    else:
+        for i in range(n):
+            (<int32_t *>out)[0] = _apply((<int32_t *>a)[0], (<int32_t *>b)[0], op)
+            a += steps[0]
+            b += steps[1]
+            out += steps[2]
+
+
+cdef void _add_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_ADD)
+
+
+cdef void _add_sat_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_ADD_SAT)
+
+
+cdef void _and_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_AND)
+
+
+cdef void _or_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_OR)
+
+
+cdef void _xor_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _binary_loop(args, dims, steps, OP_XOR)
+
+
+cdef inline void _division_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, bint mod) noexcept nogil:
+    cdef cnp.npy_intp i, n = dims[0]
+    cdef char *a = args[0]
+    cdef char *b = args[1]
+    cdef char *out = args[2]
+    cdef c_math.int_divider d
+    cdef int32_t x, y, r
+    cdef bint by_zero = False
+    if n > 0 and steps[1] == 0 and steps[0] == 4 and steps[2] == 4:
+        # 除数是广播的标量：预计算一次，整批改用乘法和移位
+        if c_math.int_divider_init(&d, (<int32_t *>b)[0]) == 0:
+            if mod:
+                c_math.mod_int_array(&d, <const int32_t *>a, <int32_t *>out, n)
+            else:
+                c_math.div_int_array(&d, <const int32_t *>a, <int32_t *>out, n)
+            return
+    for i in range(n):
+        x = (<int32_t *>a)[0]
+        y = (<int32_t *>b)[0]
+        if y == 0:
+            by_zero = True
+            r = 0
+        elif y == -1:
+            # INT32_MIN / -1 在 C 中会触发 SIGFPE，按回绕处理（与 int_divider 一致）
+            r = 0 if mod else <int32_t>(0u - <uint32_t>x)
+        else:
+            r = c_math.mod_int(x, y) if mod else c_math.div_int(x, y)
+        (<int32_t *>out)[0] = r
+        a += steps[0]
+        b += steps[1]
+        out += steps[2]
+    if by_zero:
+        feraiseexcept(FE_DIVBYZERO)
+
+
+cdef void _divide_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _division_loop(args, dims, steps, False)
+
+
+cdef void _mod_loop(char **args, const cnp.npy_intp *dims, const cnp.npy_intp *steps, void *data) noexcept nogil:
+    _division_loop(args, dims, steps, True)
+
+
+# ---------------------------------------------------------------------------
+# 注册。numpy 保存这些数组的指针，它们必须和模块一样长寿。
+# 名字沿用 C 函数名：numpy 对名为 add / multiply 的 ufunc 在 reduce 时把小整数提升为 int64，会找不到循环。
+# numpy 2 的头文件中 dims / steps 带 const，Cython 的声明没有，因此赋值时显式转换
+# ---------------------------------------------------------------------------
+
+cdef cnp.PyUFuncGenericFunction _add_funcs[1]
+cdef cnp.PyUFuncGenericFunction _add_sat_funcs[1]
+cdef cnp.PyUFuncGenericFunction _and_funcs[2]
+cdef cnp.PyUFuncGenericFunction _or_funcs[2]
+cdef cnp.PyUFuncGenericFunction _xor_funcs[2]
+cdef cnp.PyUFuncGenericFunction _divide_funcs[1]
+cdef cnp.PyUFuncGenericFunction _mod_funcs[1]
+cdef void *_no_data[2]
+cdef char _int32_types[3]
+cdef char _bitwise_types[6]
+
+_int32_types[:] = [cnp.NPY_INT32, cnp.NPY_INT32, cnp.NPY_INT32]
+_bitwise_types[:] = [cnp.NPY_INT32, cnp.NPY_INT32, cnp.NPY_INT32, cnp.NPY_UINT32, cnp.NPY_UINT32, cnp.NPY_UINT32]
+_add_funcs[0] = <cnp.PyUFuncGenericFunction>_add_loop
+_add_sat_funcs[0] = <cnp.PyUFuncGenericFunction>_add_sat_loop
+_and_funcs[0] = _and_funcs[1] = <cnp.PyUFuncGenericFunction>_and_loop
+_or_funcs[0] = _or_funcs[1] = <cnp.PyUFuncGenericFunction>_or_loop
+_xor_funcs[0] = _xor_funcs[1] = <cnp.PyUFuncGenericFunction>_xor_loop
+_divide_funcs[0] = <cnp.PyUFuncGenericFunction>_divide_loop
+_mod_funcs[0] = <cnp.PyUFuncGenericFunction>_mod_loop
+
+add_int = cnp.PyUFunc_FromFuncAndData(
+    _add_funcs, _no_data, _int32_types, 1, 2, 1, cnp.PyUFunc_Zero, b"add_int",
+    b"Element-wise int32 addition, wrapping on overflow.", 0)
+add_int_sat = cnp.PyUFunc_FromFuncAndData(
+    _add_sat_funcs, _no_data, _int32_types, 1, 2, 1, cnp.PyUFunc_None, b"add_int_sat",
+    b"Element-wise int32 addition clamped to the int32 range.", 0)
+bitwise_and = cnp.PyUFunc_FromFuncAndData(
+    _and_funcs, _no_data, _bitwise_types, 2, 2, 1, PyUFunc_MinusOne, b"bitwise_and",
+    b"Element-wise AND of int32 / uint32 values.", 0)
+bitwise_or = cnp.PyUFunc_FromFuncAndData(
+    _or_funcs, _no_data, _bitwise_types, 2, 2, 1, cnp.PyUFunc_Zero, b"bitwise_or",
+    b"Element-wise OR of int32 / uint32 values.", 0)
+bitwise_xor = cnp.PyUFunc_FromFuncAndData(
+    _xor_funcs, _no_data, _bitwise_types, 2, 2, 1, cnp.PyUFunc_Zero, b"bitwise_xor",
+    b"Element-wise XOR of int32 / uint32 values.", 0)
+div_int = cnp.PyUFunc_FromFuncAndData(
+    _divide_funcs, _no_data, _int32_types, 1, 2, 1, cnp.PyUFunc_None, b"div_int",
+    b"Element-wise int32 division truncating toward zero, like C (not numpy's floor_divide).", 0)
+mod_int = cnp.PyUFunc_FromFuncAndData(
+    _mod_funcs, _no_data, _int32_types, 1, 2, 1, cnp.PyUFunc_None, b"mod_int",
+    b"Element-wise int32 remainder whose sign follows the dividend, like C (not numpy's mod).", 0)
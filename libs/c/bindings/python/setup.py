@@ -6,21 +6,38 @@ from setuptools import setup, Extension
 from Cython.Build import cythonize
 import os
 
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+INCLUDE_DIR = os.path.join(os.path.dirname(__file__), '..', '..', 'include')
+STATIC_LIB = os.path.join(os.path.dirname(__file__), '..', '..', '..', '..', 'build', 'lib', 'libmath_ops.a')
+
 # Define the extension module
 extensions = [
     Extension(
         "c_math",
         sources=["c_math.pyx"],
-        include_dirs=[
-            os.path.join(os.path.dirname(__file__), '..', '..', 'include'),
-        ],
-        extra_objects=[
-            os.path.join(os.path.dirname(__file__), '..', '..', '..', '..', 'build', 'libs', 'c', 'libc_math_ops_s.a'),
-        ],
+        include_dirs=[INCLUDE_DIR],
+        extra_objects=[STATIC_LIB],
+        # 标量运算使用 math_ops_inline.h 的内联定义，模块函数不再经过一次跨库调用
+        define_macros=[("C_MATH_OPS_INLINE", None)],
         extra_compile_args=["-O3"],
     )
 ]
 
+# NumPy ufunc 模块只在安装了 numpy 时构建
+if numpy is not None:
+    extensions.append(Extension(
+        "c_math_ufuncs",
+        sources=["c_math_ufuncs.pyx"],
+        include_dirs=[INCLUDE_DIR, numpy.get_include()],
+        extra_objects=[STATIC_LIB],
+        define_macros=[("C_MATH_OPS_INLINE", None), ("NPY_NO_DEPRECATED_API", "NPY_1_7_API_VERSION")],
+        extra_compile_args=["-O3"],
+    ))
+
 setup(
     name="c_math_ops",
     version="1.0.0",
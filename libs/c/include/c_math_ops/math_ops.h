@@ -4,31 +4,109 @@
 #include <stdint.h>
 #include <stddef.h>
 
+// 公开接口的导出标记：库以 -fvisibility=hidden 编译，只有带 C_MATH_OPS_API 的函数进入共享库的动态符号表
+#if defined(__GNUC__) && !defined(_WIN32)
+#define C_MATH_OPS_API __attribute__((visibility("default")))
+#else
+#define C_MATH_OPS_API
+#endif
+
+// 内联快速路径：在包含本头文件前定义 C_MATH_OPS_INLINE，标记为 C_MATH_OPS_INLINE_API 的简单运算
+// 改用 math_ops_inline.h 中的 static inline 定义（语义不变），调用方可以内联并向量化循环；
+// 共享库仍导出这些函数，未定义该宏的调用方不受影响
+#if defined(C_MATH_OPS_INLINE)
+#define C_MATH_OPS_INLINE_API static inline
+#else
+#define C_MATH_OPS_INLINE_API C_MATH_OPS_API
+#endif
+
 // 基本整数运算
-int32_t add_int(int32_t a, int32_t b);
-int32_t sub_int(int32_t a, int32_t b);
-int32_t mul_int(int32_t a, int32_t b);
-int32_t div_int(int32_t a, int32_t b);
-int32_t mod_int(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t add_int(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t sub_int(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t mul_int(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t div_int(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t mod_int(int32_t a, int32_t b);
+
+// 带溢出检查的运算：溢出返回 1（*result 为回绕后的结果），否则返回 0；
+// 除法 / 取模的除数为 0 时返回 -1 且不写 *result，INT32_MIN / -1 视为溢出
+C_MATH_OPS_INLINE_API int add_int_checked(int32_t a, int32_t b, int32_t *result);
+C_MATH_OPS_INLINE_API int sub_int_checked(int32_t a, int32_t b, int32_t *result);
+C_MATH_OPS_INLINE_API int mul_int_checked(int32_t a, int32_t b, int32_t *result);
+C_MATH_OPS_INLINE_API int div_int_checked(int32_t a, int32_t b, int32_t *result);
+C_MATH_OPS_INLINE_API int mod_int_checked(int32_t a, int32_t b, int32_t *result);
+
+// 饱和运算：溢出时取 INT32_MAX / INT32_MIN
+C_MATH_OPS_INLINE_API int32_t add_int_sat(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t sub_int_sat(int32_t a, int32_t b);
+C_MATH_OPS_INLINE_API int32_t mul_int_sat(int32_t a, int32_t b);
+
+// 批量版本（无分支，x86-64 上使用 SSE2）：返回溢出的元素个数，out 可与 a 或 b 相同
+// _checked 把回绕结果写入 out，overflow[i] 为 0 / 1；_sat 把饱和结果写入 out
+C_MATH_OPS_API size_t add_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n);
+C_MATH_OPS_API size_t sub_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n);
+C_MATH_OPS_API size_t mul_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n);
+C_MATH_OPS_API size_t add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+C_MATH_OPS_API size_t sub_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+C_MATH_OPS_API size_t mul_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+
+// 预计算的不变除数：把除法 / 取模变为乘法和移位，适合用同一个除数处理大量数据
+// 结果与 C 的 / 和 % 相同（向零截断）；INT32_MIN / -1 回绕为 INT32_MIN，余数为 0
+typedef struct
+{
+    int32_t divisor;
+    int32_t magic;  // 0 表示 |divisor| 是 2 的幂，只需移位
+    int32_t add;    // 乘法高位结果还需加上被除数时为 -1，否则为 0
+    int32_t sign;   // divisor < 0 时为 -1，否则为 0
+    uint32_t shift;
+} int_divider;
+
+C_MATH_OPS_API int int_divider_init(int_divider *d, int32_t divisor); // 成功返回 0，divisor 为 0 时返回 -1
+C_MATH_OPS_INLINE_API int32_t int_divider_div(const int_divider *d, int32_t n);
+C_MATH_OPS_INLINE_API int32_t int_divider_mod(const int_divider *d, int32_t n);
+C_MATH_OPS_API void div_int_array(const int_divider *d, const int32_t *in, int32_t *out, size_t n); // out 可与 in 相同
+C_MATH_OPS_API void mod_int_array(const int_divider *d, const int32_t *in, int32_t *out, size_t n);
 
 // 位运算
-uint32_t left_shift(uint32_t value, int shift);
-uint32_t right_shift(uint32_t value, int shift);
-uint32_t bitwise_and(uint32_t a, uint32_t b);
-uint32_t bitwise_or(uint32_t a, uint32_t b);
-uint32_t bitwise_xor(uint32_t a, uint32_t b);
+C_MATH_OPS_INLINE_API uint32_t left_shift(uint32_t value, int shift);
+C_MATH_OPS_INLINE_API uint32_t right_shift(uint32_t value, int shift);
+C_MATH_OPS_INLINE_API uint32_t bitwise_and(uint32_t a, uint32_t b);
+C_MATH_OPS_INLINE_API uint32_t bitwise_or(uint32_t a, uint32_t b);
+C_MATH_OPS_INLINE_API uint32_t bitwise_xor(uint32_t a, uint32_t b);
 
 // 数组操作
-int64_t sum_array(const int32_t *arr, size_t size);
-int32_t find_max(const int32_t *arr, size_t size);
-int32_t find_min(const int32_t *arr, size_t size);
+C_MATH_OPS_API int64_t sum_array(const int32_t *arr, size_t size);
+C_MATH_OPS_API int32_t find_max(const int32_t *arr, size_t size);
+C_MATH_OPS_API int32_t find_min(const int32_t *arr, size_t size);
+
+// 选择与排名（selection.c）
+// argmax / argmin：最大 / 最小值首次出现的下标，空数组返回 0；double 版本忽略 NaN（全为 NaN 时返回 0）
+C_MATH_OPS_API size_t argmax_int32(const int32_t *arr, size_t size);
+C_MATH_OPS_API size_t argmin_int32(const int32_t *arr, size_t size);
+C_MATH_OPS_API size_t argmax_double(const double *arr, size_t size);
+C_MATH_OPS_API size_t argmin_double(const double *arr, size_t size);
+// 最大的 k 个元素的下标写入 indices（容量至少为 k），按值从大到小，值相同时下标小的在前；
+// 返回写入的个数 min(k, size)，double 版本跳过 NaN。O(n log k)，不分配内存
+C_MATH_OPS_API size_t top_k_int32(const int32_t *arr, size_t size, size_t k, size_t *indices);
+C_MATH_OPS_API size_t top_k_double(const double *arr, size_t size, size_t k, size_t *indices);
+// 快速选择：重排 arr，使 arr[k] 为第 k 小（从 0 起）的元素，左侧都不大于、右侧都不小于它，返回 arr[k]。
+// k >= size 时返回 0 且不修改 arr；double 版本要求不含 NaN
+C_MATH_OPS_API int32_t select_kth_int32(int32_t *arr, size_t size, size_t k);
+C_MATH_OPS_API double select_kth_double(double *arr, size_t size, size_t k);
+// 分位数 q ∈ [0, 1]，按位置 (size - 1) * q 线性插值（同 numpy 默认方法），中位数为 q = 0.5。
+// 会重排 arr；成功返回 0，size 为 0 或 q 越界返回 -1
+C_MATH_OPS_API int percentile_int32(int32_t *arr, size_t size, double q, double *result);
+C_MATH_OPS_API int percentile_double(double *arr, size_t size, double q, double *result);
 
 // 字符串操作
-size_t string_length(const char *str);
-void string_copy(char *dest, const char *src, size_t max_len);
+C_MATH_OPS_API size_t string_length(const char *str);
+C_MATH_OPS_API size_t string_copy(char *dest, const char *src, size_t max_len); // 返回 strlen(src)，>= max_len 表示被截断
 
 // 内存操作
-void *memory_copy(void *dest, const void *src, size_t n);
-void *memory_set(void *dest, int value, size_t n);
+C_MATH_OPS_API void *memory_copy(void *dest, const void *src, size_t n);
+C_MATH_OPS_API void *memory_set(void *dest, int value, size_t n);
+
+#if defined(C_MATH_OPS_INLINE)
+#include "c_math_ops/math_ops_inline.h"
+#endif
 
 #endif // MATH_OPS_H
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef MATH_OPS_INLINE_H
+#define MATH_OPS_INLINE_H
+
+// 简单运算的定义，由库（math_ops.c，生成导出函数）和定义了 C_MATH_OPS_INLINE 的调用方
+// （经 math_ops.h 包含，生成 static inline 函数）共用，两者语义完全一致。不要直接包含本文件
+#ifndef MATH_OPS_H
+#error "include c_math_ops/math_ops.h (optionally with C_MATH_OPS_INLINE defined) instead"
+#endif
+
+// 基本整数运算：溢出时按 32 位补码回绕（经 uint32_t 计算，避免有符号溢出的未定义行为），
+// INT32_MIN / -1 同样回绕为 INT32_MIN
+C_MATH_OPS_INLINE_API int32_t add_int(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+C_MATH_OPS_INLINE_API int32_t sub_int(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+C_MATH_OPS_INLINE_API int32_t mul_int(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a * (uint32_t)b);
+}
+
+C_MATH_OPS_INLINE_API int32_t div_int(int32_t a, int32_t b)
+{
+    if (b == 0)
+        return 0; // 简单错误处理
+    if (b == -1)
+        return (int32_t)(0u - (uint32_t)a);
+    return a / b;
+}
+
+C_MATH_OPS_INLINE_API int32_t mod_int(int32_t a, int32_t b)
+{
+    if (b == 0 || b == -1)
+        return 0;
+    return a % b;
+}
+
+// 带溢出检查的运算（先按无符号回绕计算，避免有符号溢出的未定义行为）
+C_MATH_OPS_INLINE_API int add_int_checked(int32_t a, int32_t b, int32_t *result)
+{
+    int32_t sum = (int32_t)((uint32_t)a + (uint32_t)b);
+    *result = sum;
+    return ((a ^ sum) & (b ^ sum)) < 0;
+}
+
+C_MATH_OPS_INLINE_API int sub_int_checked(int32_t a, int32_t b, int32_t *result)
+{
+    int32_t diff = (int32_t)((uint32_t)a - (uint32_t)b);
+    *result = diff;
+    return ((a ^ b) & (a ^ diff)) < 0;
+}
+
+C_MATH_OPS_INLINE_API int mul_int_checked(int32_t a, int32_t b, int32_t *result)
+{
+    int64_t product = (int64_t)a * b;
+    *result = (int32_t)product;
+    return product != (int32_t)product;
+}
+
+C_MATH_OPS_INLINE_API int div_int_checked(int32_t a, int32_t b, int32_t *result)
+{
+    if (b == 0)
+        return -1;
+    if (a == INT32_MIN && b == -1)
+    {
+        *result = INT32_MIN;
+        return 1;
+    }
+    *result = a / b;
+    return 0;
+}
+
+C_MATH_OPS_INLINE_API int mod_int_checked(int32_t a, int32_t b, int32_t *result)
+{
+    if (b == 0)
+        return -1;
+    *result = b == -1 ? 0 : a % b;
+    return 0;
+}
+
+// 饱和运算：溢出时结果的符号由 a（加减）或 a ^ b（乘）决定
+C_MATH_OPS_INLINE_API int32_t add_int_sat(int32_t a, int32_t b)
+{
+    int32_t sum;
+    return add_int_checked(a, b, &sum) ? (a < 0 ? INT32_MIN : INT32_MAX) : sum;
+}
+
+C_MATH_OPS_INLINE_API int32_t sub_int_sat(int32_t a, int32_t b)
+{
+    int32_t diff;
+    return sub_int_checked(a, b, &diff) ? (a < 0 ? INT32_MIN : INT32_MAX) : diff;
+}
+
+C_MATH_OPS_INLINE_API int32_t mul_int_sat(int32_t a, int32_t b)
+{
+    int32_t product;
+    return mul_int_checked(a, b, &product) ? ((a ^ b) < 0 ? INT32_MIN : INT32_MAX) : product;
+}
+
+// 不变除数（int_divider_init 较重，不在此列）
+C_MATH_OPS_INLINE_API int32_t int_divider_div(const int_divider *d, int32_t n)
+{
+    int32_t q;
+    if (d->magic == 0)
+    {
+        // 负数先加 2^shift - 1，使算术右移变为向零截断
+        q = (int32_t)((uint32_t)n + ((uint32_t)(n >> 31) & ((1u << d->shift) - 1))) >> d->shift;
+    }
+    else
+    {
+        q = (int32_t)(((int64_t)n * d->magic) >> 32);
+        q = (int32_t)((uint32_t)q + ((uint32_t)n & (uint32_t)d->add)) >> d->shift;
+        q += (int32_t)((uint32_t)q >> 31);
+    }
+    return (int32_t)(((uint32_t)q ^ (uint32_t)d->sign) - (uint32_t)d->sign);
+}
+
+C_MATH_OPS_INLINE_API int32_t int_divider_mod(const int_divider *d, int32_t n)
+{
+    return (int32_t)((uint32_t)n - (uint32_t)int_divider_div(d, n) * (uint32_t)d->divisor);
+}
+
+// 位运算
+C_MATH_OPS_INLINE_API uint32_t left_shift(uint32_t value, int shift)
+{
+    return value << shift;
+}
+
+C_MATH_OPS_INLINE_API uint32_t right_shift(uint32_t value, int shift)
+{
+    return value >> shift;
+}
+
+C_MATH_OPS_INLINE_API uint32_t bitwise_and(uint32_t a, uint32_t b)
+{
+    return a & b;
+}
+
+C_MATH_OPS_INLINE_API uint32_t bitwise_or(uint32_t a, uint32_t b)
+{
+    return a | b;
+}
+
+C_MATH_OPS_INLINE_API uint32_t bitwise_xor(uint32_t a, uint32_t b)
+{
+    return a ^ b;
+}
+
+#endif // MATH_OPS_INLINE_H
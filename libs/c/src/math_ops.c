@@ -1,65 +1,253 @@
+// 库本身总是生成导出函数，即使构建时全局定义了 C_MATH_OPS_INLINE
+#undef C_MATH_OPS_INLINE
 #include "c_math_ops/math_ops.h"
+#include "probes.h"
 #include <string.h>
 
-// 基本整数运算
-int32_t add_int(int32_t a, int32_t b)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+// SSE2 只有无符号 32x32->64 乘法，有符号高位需要修正：
+// mulhi_s(a, b) = mulhi_u(a, b) - (a < 0 ? b : 0) - (b < 0 ? a : 0)
+static inline __m128i mulhi_epi32_sse2(__m128i a, __m128i b)
 {
-    return a + b;
+    const __m128i odd_mask = _mm_set_epi32(-1, 0, -1, 0);
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, b), 32);
+    __m128i odd = _mm_and_si128(_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), odd_mask);
+    __m128i hi = _mm_or_si128(even, odd);
+    hi = _mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(a, 31), b));
+    return _mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(b, 31), a));
 }
 
-int32_t sub_int(int32_t a, int32_t b)
+static inline __m128i mullo_epi32_sse2(__m128i a, __m128i b)
 {
-    return a - b;
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
 }
+#endif
+
+// 简单运算（基本运算、溢出检查、饱和、不变除数的单个元素、位运算）与内联快速路径共用定义
+#include "c_math_ops/math_ops_inline.h"
+
+// 批量运算的内部实现：overflow 为 NULL 时输出饱和结果，否则输出回绕结果和溢出标志
+enum { ARITH_ADD, ARITH_SUB, ARITH_MUL };
 
-int32_t mul_int(int32_t a, int32_t b)
+#if defined(__SSE2__)
+static size_t arith_array_sse2(int op, const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow,
+                               size_t n, size_t *count)
 {
-    return a * b;
+    static const uint8_t popcount4[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    const __m128i max = _mm_set1_epi32(INT32_MAX);
+    const __m128i one = _mm_set1_epi8(1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i r, ovf, sign;
+        if (op == ARITH_ADD)
+        {
+            r = _mm_add_epi32(x, y);
+            ovf = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(x, r), _mm_xor_si128(y, r)), 31);
+            sign = x;
+        }
+        else if (op == ARITH_SUB)
+        {
+            r = _mm_sub_epi32(x, y);
+            ovf = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(x, y), _mm_xor_si128(x, r)), 31);
+            sign = x;
+        }
+        else
+        {
+            // 乘积高 32 位不等于低 32 位的符号扩展即为溢出
+            r = mullo_epi32_sse2(x, y);
+            ovf = _mm_cmpeq_epi32(mulhi_epi32_sse2(x, y), _mm_srai_epi32(r, 31));
+            ovf = _mm_xor_si128(ovf, _mm_set1_epi32(-1));
+            sign = _mm_xor_si128(x, y);
+        }
+
+        if (overflow)
+        {
+            __m128i words = _mm_packs_epi32(ovf, ovf);
+            __m128i bytes = _mm_packs_epi16(words, words);
+            int32_t flags = _mm_cvtsi128_si32(_mm_and_si128(bytes, one));
+            memcpy(overflow + i, &flags, sizeof(flags));
+        }
+        else
+        {
+            __m128i sat = _mm_xor_si128(_mm_srai_epi32(sign, 31), max);
+            r = _mm_or_si128(_mm_and_si128(ovf, sat), _mm_andnot_si128(ovf, r));
+        }
+        _mm_storeu_si128((__m128i *)(out + i), r);
+        *count += popcount4[_mm_movemask_ps(_mm_castsi128_ps(ovf))];
+    }
+    return i;
 }
+#endif
 
-int32_t div_int(int32_t a, int32_t b)
+static size_t arith_array(int op, const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
 {
-    if (b == 0)
-        return 0; // 简单错误处理
-    return a / b;
+    size_t i = 0, count = 0;
+#if defined(__SSE2__)
+    i = arith_array_sse2(op, a, b, out, overflow, n, &count);
+#endif
+    for (; i < n; ++i)
+    {
+        int32_t r;
+        int ovf = op == ARITH_ADD ? add_int_checked(a[i], b[i], &r)
+                  : op == ARITH_SUB ? sub_int_checked(a[i], b[i], &r)
+                                    : mul_int_checked(a[i], b[i], &r);
+        if (overflow)
+            overflow[i] = (uint8_t)ovf;
+        else if (ovf)
+            r = (op == ARITH_MUL ? (a[i] ^ b[i]) : a[i]) < 0 ? INT32_MIN : INT32_MAX;
+        out[i] = r;
+        count += (size_t)ovf;
+    }
+    return count;
 }
 
-int32_t mod_int(int32_t a, int32_t b)
+size_t add_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
 {
-    if (b == 0)
-        return 0;
-    return a % b;
+    MATH_OPS_PROBE(n);
+    return arith_array(ARITH_ADD, a, b, out, overflow, n);
 }
 
-// 位运算
-uint32_t left_shift(uint32_t value, int shift)
+size_t sub_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
 {
-    return value << shift;
+    MATH_OPS_PROBE(n);
+    return arith_array(ARITH_SUB, a, b, out, overflow, n);
 }
 
-uint32_t right_shift(uint32_t value, int shift)
+size_t mul_int_array_checked(const int32_t *a, const int32_t *b, int32_t *out, uint8_t *overflow, size_t n)
 {
-    return value >> shift;
+    MATH_OPS_PROBE(n);
+    return arith_array(ARITH_MUL, a, b, out, overflow, n);
 }
 
-uint32_t bitwise_and(uint32_t a, uint32_t b)
+size_t add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
 {
-    return a & b;
+    MATH_OPS_PROBE(n);
+    return arith_array(ARITH_ADD, a, b, out, NULL, n);
 }
 
-uint32_t bitwise_or(uint32_t a, uint32_t b)
+size_t sub_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
 {
-    return a | b;
+    MATH_OPS_PROBE(n);
+    return arith_array(ARITH_SUB, a, b, out, NULL, n);
 }
 
-uint32_t bitwise_xor(uint32_t a, uint32_t b)
+size_t mul_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n)
 {
-    return a ^ b;
+    MATH_OPS_PROBE(n);
+    return arith_array(ARITH_MUL, a, b, out, NULL, n);
+}
+
+// 不变除数（算法同 libdivide：商 = (mulhi(n, magic) + (n & add)) >> shift，再修正为向零截断）
+int int_divider_init(int_divider *d, int32_t divisor)
+{
+    MATH_OPS_PROBE(0);
+    if (divisor == 0)
+        return -1;
+
+    uint32_t abs_d = divisor < 0 ? 0u - (uint32_t)divisor : (uint32_t)divisor;
+    uint32_t log2_d = 31;
+    while (!(abs_d >> log2_d))
+        --log2_d;
+
+    d->divisor = divisor;
+    d->sign = divisor < 0 ? -1 : 0;
+    d->add = 0;
+    if ((abs_d & (abs_d - 1)) == 0)
+    {
+        d->magic = 0;
+        d->shift = log2_d;
+        return 0;
+    }
+
+    uint64_t dividend = (uint64_t)1 << (31 + log2_d);
+    uint32_t m = (uint32_t)(dividend / abs_d);
+    uint32_t rem = (uint32_t)(dividend % abs_d);
+    if (abs_d - rem < (1u << log2_d))
+    {
+        d->shift = log2_d - 1;
+    }
+    else
+    {
+        // 33 位乘数：存低 32 位，运算时把被除数再加回来
+        m += m;
+        if ((uint64_t)rem * 2 >= abs_d)
+            ++m;
+        d->add = -1;
+        d->shift = log2_d;
+    }
+    d->magic = (int32_t)(m + 1);
+    return 0;
+}
+
+#if defined(__SSE2__)
+// SSE2 每次处理 4 个元素，处理前 n / 4 * 4 个，返回已处理的个数
+static size_t divide_array_sse2(const int_divider *d, const int32_t *in, int32_t *out, size_t n, int mod)
+{
+    const __m128i magic = _mm_set1_epi32(d->magic);
+    const __m128i add = _mm_set1_epi32(d->add);
+    const __m128i sign = _mm_set1_epi32(d->sign);
+    const __m128i divisor = _mm_set1_epi32(d->divisor);
+    const __m128i pow2_mask = _mm_set1_epi32((int32_t)((1u << d->shift) - 1));
+    const __m128i shift = _mm_cvtsi32_si128((int)d->shift);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i q;
+        if (d->magic == 0)
+        {
+            q = _mm_add_epi32(x, _mm_and_si128(_mm_srai_epi32(x, 31), pow2_mask));
+            q = _mm_sra_epi32(q, shift);
+        }
+        else
+        {
+            q = _mm_add_epi32(mulhi_epi32_sse2(x, magic), _mm_and_si128(x, add));
+            q = _mm_sra_epi32(q, shift);
+            q = _mm_add_epi32(q, _mm_srli_epi32(q, 31));
+        }
+        q = _mm_sub_epi32(_mm_xor_si128(q, sign), sign);
+        if (mod)
+            q = _mm_sub_epi32(x, mullo_epi32_sse2(q, divisor));
+        _mm_storeu_si128((__m128i *)(out + i), q);
+    }
+    return i;
+}
+#endif
+
+void div_int_array(const int_divider *d, const int32_t *in, int32_t *out, size_t n)
+{
+    MATH_OPS_PROBE(n);
+    size_t i = 0;
+#if defined(__SSE2__)
+    i = divide_array_sse2(d, in, out, n, 0);
+#endif
+    for (; i < n; ++i)
+        out[i] = int_divider_div(d, in[i]);
+}
+
+void mod_int_array(const int_divider *d, const int32_t *in, int32_t *out, size_t n)
+{
+    MATH_OPS_PROBE(n);
+    size_t i = 0;
+#if defined(__SSE2__)
+    i = divide_array_sse2(d, in, out, n, 1);
+#endif
+    for (; i < n; ++i)
+        out[i] = int_divider_mod(d, in[i]);
 }
 
 // 数组操作
 int64_t sum_array(const int32_t *arr, size_t size)
 {
+    MATH_OPS_PROBE(size);
     int64_t sum = 0;
     for (size_t i = 0; i < size; ++i)
     {
@@ -70,6 +258,7 @@ int64_t sum_array(const int32_t *arr, size_t size)
 
 int32_t find_max(const int32_t *arr, size_t size)
 {
+    MATH_OPS_PROBE(size);
     if (size == 0)
         return 0;
     int32_t max = arr[0];
@@ -83,6 +272,7 @@ int32_t find_max(const int32_t *arr, size_t size)
 
 int32_t find_min(const int32_t *arr, size_t size)
 {
+    MATH_OPS_PROBE(size);
     if (size == 0)
         return 0;
     int32_t min = arr[0];
@@ -97,22 +287,33 @@ int32_t find_min(const int32_t *arr, size_t size)
 // 字符串操作
 size_t string_length(const char *str)
 {
+    MATH_OPS_PROBE(0);
     return strlen(str);
 }
 
-void string_copy(char *dest, const char *src, size_t max_len)
+size_t string_copy(char *dest, const char *src, size_t max_len)
 {
-    strncpy(dest, src, max_len - 1);
-    dest[max_len - 1] = '\0';
+    MATH_OPS_PROBE(max_len);
+    // strlcpy 语义：只拷贝需要的字节，不像 strncpy 那样把剩余缓冲区全部填 0
+    size_t len = strlen(src);
+    if (max_len > 0)
+    {
+        size_t n = len < max_len ? len : max_len - 1;
+        memcpy(dest, src, n);
+        dest[n] = '\0';
+    }
+    return len;
 }
 
 // 内存操作
 void *memory_copy(void *dest, const void *src, size_t n)
 {
+    MATH_OPS_PROBE(n);
     return memcpy(dest, src, n);
 }
 
 void *memory_set(void *dest, int value, size_t n)
 {
+    MATH_OPS_PROBE(n);
     return memset(dest, value, n);
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef MATH_OPS_PROBES_H
+#define MATH_OPS_PROBES_H
+
+// USDT 静态探针（provider math_ops），库内部使用，不安装。
+// MATH_OPS_PROBE(n) 在当前位置触发 op_entry(op, n)，在作用域结束（任何一个 return）时触发 op_return(op, n)：
+// op 为函数名（const char*），n 为元素个数（uint64_t）。退出探针借助 GCC / Clang 的 cleanup 属性，
+// 不必在每个 return 前手写。以 sys/sdt.h 构建（CALC_HAVE_SDT，见 cmake/BuildOptions.cmake 的 ENABLE_USDT）时
+// 未被跟踪的探针只是一条 nop，否则展开为空语句。简单整数运算（math_ops_inline.h）面向内联，不带探针
+
+#ifdef CALC_HAVE_SDT
+
+#include <stdint.h>
+#include <sys/sdt.h>
+
+typedef struct
+{
+    const char *op;
+    uint64_t n;
+} math_ops_probe;
+
+static inline void math_ops_probe_return(const math_ops_probe *p)
+{
+    STAP_PROBE2(math_ops, op_return, p->op, p->n);
+}
+
+#define MATH_OPS_PROBE(count)                                                          \
+    math_ops_probe math_ops_probe_ __attribute__((cleanup(math_ops_probe_return))) = \
+        {__func__, (uint64_t)(count)};                                                \
+    STAP_PROBE2(math_ops, op_entry, math_ops_probe_.op, math_ops_probe_.n)
+
+#else
+
+#define MATH_OPS_PROBE(count) ((void)0)
+
+#endif
+
+#endif // MATH_OPS_PROBES_H
@@ -0,0 +1,491 @@
+#include "c_math_ops/math_ops.h"
+#include "probes.h"
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 选择与排名：argmax / argmin、top-k、快速选择和分位数
+
+// argmax / argmin 分块处理：先求块内最值（SIMD，不跟踪下标），只有严格优于当前结果时
+// 才在仍在 L1 中的块里查找其首次出现的位置，整个数组只从内存读一遍
+enum { ARG_BLOCK = 1024 };
+
+#if defined(__SSE2__)
+static inline __m128i extreme_epi32_sse2(__m128i acc, __m128i x, int want_max)
+{
+    __m128i take = want_max ? _mm_cmpgt_epi32(x, acc) : _mm_cmpgt_epi32(acc, x);
+    return _mm_or_si128(_mm_and_si128(take, x), _mm_andnot_si128(take, acc));
+}
+
+// x 为 NaN 时 max_pd / min_pd 返回第二个操作数，NaN 不会进入 acc
+static inline __m128d extreme_pd_sse2(__m128d acc, __m128d x, int want_max)
+{
+    return want_max ? _mm_max_pd(x, acc) : _mm_min_pd(x, acc);
+}
+#endif
+
+static int32_t block_extreme_int32(const int32_t *arr, size_t n, int want_max)
+{
+    int32_t best = arr[0];
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (n >= 8)
+    {
+        __m128i acc0 = _mm_loadu_si128((const __m128i *)arr);
+        __m128i acc1 = _mm_loadu_si128((const __m128i *)(arr + 4));
+        for (i = 8; i + 8 <= n; i += 8)
+        {
+            acc0 = extreme_epi32_sse2(acc0, _mm_loadu_si128((const __m128i *)(arr + i)), want_max);
+            acc1 = extreme_epi32_sse2(acc1, _mm_loadu_si128((const __m128i *)(arr + i + 4)), want_max);
+        }
+        acc0 = extreme_epi32_sse2(acc0, acc1, want_max);
+        acc0 = extreme_epi32_sse2(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(1, 0, 3, 2)), want_max);
+        acc0 = extreme_epi32_sse2(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(2, 3, 0, 1)), want_max);
+        best = _mm_cvtsi128_si32(acc0);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (want_max ? arr[i] > best : arr[i] < best)
+            best = arr[i];
+    }
+    return best;
+}
+
+// 不含 NaN 的最值；全部为 NaN 时返回 init（-inf / +inf）
+static double block_extreme_double(const double *arr, size_t n, int want_max, double init)
+{
+    double best = init;
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128d acc0 = _mm_set1_pd(init), acc1 = acc0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = extreme_pd_sse2(acc0, _mm_loadu_pd(arr + i), want_max);
+        acc1 = extreme_pd_sse2(acc1, _mm_loadu_pd(arr + i + 2), want_max);
+    }
+    acc0 = extreme_pd_sse2(acc0, acc1, want_max);
+    acc0 = extreme_pd_sse2(acc0, _mm_unpackhi_pd(acc0, acc0), want_max);
+    best = _mm_cvtsd_f64(acc0);
+#endif
+    for (; i < n; ++i)
+    {
+        if (want_max ? arr[i] > best : arr[i] < best)
+            best = arr[i];
+    }
+    return best;
+}
+
+// value 在 arr[0, n) 中首次出现的位置，不存在时返回 n
+static size_t find_first_int32(const int32_t *arr, size_t n, int32_t value)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i v = _mm_set1_epi32(value);
+    for (; i + 4 <= n; i += 4)
+    {
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(arr + i)), v)))
+            break;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (arr[i] == value)
+            return i;
+    }
+    return n;
+}
+
+static size_t find_first_double(const double *arr, size_t n, double value)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128d v = _mm_set1_pd(value);
+    for (; i + 2 <= n; i += 2)
+    {
+        if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i), v)))
+            break;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (arr[i] == value)
+            return i;
+    }
+    return n;
+}
+
+static size_t arg_extreme_int32(const int32_t *arr, size_t size, int want_max)
+{
+    if (size == 0)
+        return 0;
+    int32_t best = arr[0];
+    size_t best_index = 0;
+    for (size_t begin = 0; begin < size; begin += ARG_BLOCK)
+    {
+        size_t n = size - begin < ARG_BLOCK ? size - begin : ARG_BLOCK;
+        int32_t m = block_extreme_int32(arr + begin, n, want_max);
+        // 严格更优才更新，相同的值保留更早的位置
+        if (want_max ? m > best : m < best)
+        {
+            best = m;
+            best_index = begin + find_first_int32(arr + begin, n, m);
+        }
+    }
+    return best_index;
+}
+
+static size_t arg_extreme_double(const double *arr, size_t size, int want_max)
+{
+    const double init = want_max ? -HUGE_VAL : HUGE_VAL;
+    double best = init;
+    size_t best_index = size;
+    for (size_t begin = 0; begin < size; begin += ARG_BLOCK)
+    {
+        size_t n = size - begin < ARG_BLOCK ? size - begin : ARG_BLOCK;
+        double m = block_extreme_double(arr + begin, n, want_max, init);
+        if (want_max ? m > best : m < best)
+        {
+            best = m;
+            best_index = begin + find_first_double(arr + begin, n, m);
+        }
+    }
+    if (best_index == size)
+    {
+        // 非 NaN 的元素都等于 init（或全部为 NaN）
+        best_index = find_first_double(arr, size, init);
+        if (best_index == size)
+            best_index = 0;
+    }
+    return best_index;
+}
+
+size_t argmax_int32(const int32_t *arr, size_t size)
+{
+    MATH_OPS_PROBE(size);
+    return arg_extreme_int32(arr, size, 1);
+}
+
+size_t argmin_int32(const int32_t *arr, size_t size)
+{
+    MATH_OPS_PROBE(size);
+    return arg_extreme_int32(arr, size, 0);
+}
+
+size_t argmax_double(const double *arr, size_t size)
+{
+    MATH_OPS_PROBE(size);
+    return arg_extreme_double(arr, size, 1);
+}
+
+size_t argmin_double(const double *arr, size_t size)
+{
+    MATH_OPS_PROBE(size);
+    return arg_extreme_double(arr, size, 0);
+}
+
+// top-k：indices 本身作为大小为 k 的小顶堆，堆顶是已选元素中最差的一个
+// （值更小，或值相同但下标更大），新元素只有严格大于堆顶才可能入选
+#define TOP_K_WORSE(arr, a, b) ((arr)[a] < (arr)[b] || ((arr)[a] == (arr)[b] && (a) > (b)))
+
+#define DEFINE_TOP_K_HEAP(T, SUFFIX)                                                   \
+    static void top_k_sift_down_##SUFFIX(const T *arr, size_t *heap, size_t n, size_t pos) \
+    {                                                                                  \
+        size_t item = heap[pos];                                                       \
+        for (;;)                                                                       \
+        {                                                                              \
+            size_t child = 2 * pos + 1;                                                \
+            if (child >= n)                                                            \
+                break;                                                                 \
+            if (child + 1 < n && TOP_K_WORSE(arr, heap[child + 1], heap[child]))       \
+                ++child;                                                               \
+            if (!TOP_K_WORSE(arr, heap[child], item))                                  \
+                break;                                                                 \
+            heap[pos] = heap[child];                                                   \
+            pos = child;                                                               \
+        }                                                                              \
+        heap[pos] = item;                                                              \
+    }                                                                                  \
+                                                                                       \
+    /* 把堆排成从好到差：反复把堆顶（最差）换到末尾 */                                 \
+    static void top_k_finish_##SUFFIX(const T *arr, size_t *heap, size_t n)            \
+    {                                                                                  \
+        for (size_t end = n; end > 1; --end)                                           \
+        {                                                                              \
+            size_t worst = heap[0];                                                    \
+            heap[0] = heap[end - 1];                                                   \
+            heap[end - 1] = worst;                                                     \
+            top_k_sift_down_##SUFFIX(arr, heap, end - 1, 0);                           \
+        }                                                                              \
+    }
+
+DEFINE_TOP_K_HEAP(int32_t, int32)
+DEFINE_TOP_K_HEAP(double, double)
+
+// 堆满后 SIMD 跳过没有元素大于门槛的整组（k 远小于 n 时绝大多数元素在这里被排除）
+#if defined(__SSE2__)
+static size_t skip_not_above_int32(const int32_t *arr, size_t i, size_t size, int32_t threshold)
+{
+    const __m128i t = _mm_set1_epi32(threshold);
+    while (i + 8 <= size)
+    {
+        __m128i gt = _mm_or_si128(_mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(arr + i)), t),
+                                  _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(arr + i + 4)), t));
+        if (_mm_movemask_epi8(gt))
+            break;
+        i += 8;
+    }
+    return i;
+}
+
+static size_t skip_not_above_double(const double *arr, size_t i, size_t size, double threshold)
+{
+    const __m128d t = _mm_set1_pd(threshold);
+    while (i + 4 <= size)
+    {
+        __m128d gt = _mm_or_pd(_mm_cmpgt_pd(_mm_loadu_pd(arr + i), t), _mm_cmpgt_pd(_mm_loadu_pd(arr + i + 2), t));
+        if (_mm_movemask_pd(gt))
+            break;
+        i += 4;
+    }
+    return i;
+}
+#else
+static size_t skip_not_above_int32(const int32_t *arr, size_t i, size_t size, int32_t threshold)
+{
+    (void)arr;
+    (void)size;
+    (void)threshold;
+    return i;
+}
+
+static size_t skip_not_above_double(const double *arr, size_t i, size_t size, double threshold)
+{
+    (void)arr;
+    (void)size;
+    (void)threshold;
+    return i;
+}
+#endif
+
+size_t top_k_int32(const int32_t *arr, size_t size, size_t k, size_t *indices)
+{
+    MATH_OPS_PROBE(size);
+    size_t count = 0, i = 0;
+    if (k == 0)
+        return 0;
+    for (; i < size && count < k; ++i)
+        indices[count++] = i;
+    for (size_t pos = count / 2; pos-- > 0;)
+        top_k_sift_down_int32(arr, indices, count, pos);
+
+    while (i < size)
+    {
+        i = skip_not_above_int32(arr, i, size, arr[indices[0]]);
+        size_t end = i + 8 < size ? i + 8 : size;
+        for (; i < end; ++i)
+        {
+            if (arr[i] > arr[indices[0]])
+            {
+                indices[0] = i;
+                top_k_sift_down_int32(arr, indices, count, 0);
+            }
+        }
+    }
+    top_k_finish_int32(arr, indices, count);
+    return count;
+}
+
+size_t top_k_double(const double *arr, size_t size, size_t k, size_t *indices)
+{
+    MATH_OPS_PROBE(size);
+    size_t count = 0, i = 0;
+    if (k == 0)
+        return 0;
+    for (; i < size && count < k; ++i)
+    {
+        if (arr[i] == arr[i]) // 跳过 NaN
+            indices[count++] = i;
+    }
+    for (size_t pos = count / 2; pos-- > 0;)
+        top_k_sift_down_double(arr, indices, count, pos);
+
+    while (i < size)
+    {
+        i = skip_not_above_double(arr, i, size, arr[indices[0]]);
+        size_t end = i + 4 < size ? i + 4 : size;
+        for (; i < end; ++i)
+        {
+            if (arr[i] > arr[indices[0]]) // NaN 比较为假，不会入选
+            {
+                indices[0] = i;
+                top_k_sift_down_double(arr, indices, count, 0);
+            }
+        }
+    }
+    top_k_finish_double(arr, indices, count);
+    return count;
+}
+
+// 快速选择：三数取中 + Hoare 划分，区间较小时插入排序；划分轮数超过 2·log2(n) 时
+// 改为对剩余区间堆排序，最坏情况仍为 O(n log n)
+#define DEFINE_SELECT(T, SUFFIX)                                                       \
+    static void heap_sift_##SUFFIX(T *a, size_t n, size_t pos)                         \
+    {                                                                                  \
+        T item = a[pos];                                                               \
+        for (;;)                                                                       \
+        {                                                                              \
+            size_t child = 2 * pos + 1;                                                \
+            if (child >= n)                                                            \
+                break;                                                                 \
+            if (child + 1 < n && a[child] < a[child + 1])                              \
+                ++child;                                                               \
+            if (!(item < a[child]))                                                    \
+                break;                                                                 \
+            a[pos] = a[child];                                                         \
+            pos = child;                                                               \
+        }                                                                              \
+        a[pos] = item;                                                                 \
+    }                                                                                  \
+                                                                                       \
+    static void heap_sort_##SUFFIX(T *a, size_t n)                                     \
+    {                                                                                  \
+        for (size_t pos = n / 2; pos-- > 0;)                                           \
+            heap_sift_##SUFFIX(a, n, pos);                                             \
+        for (size_t end = n; end > 1; --end)                                           \
+        {                                                                              \
+            T top = a[0];                                                              \
+            a[0] = a[end - 1];                                                         \
+            a[end - 1] = top;                                                          \
+            heap_sift_##SUFFIX(a, end - 1, 0);                                         \
+        }                                                                              \
+    }                                                                                  \
+                                                                                       \
+    static void insertion_sort_##SUFFIX(T *a, size_t n)                                \
+    {                                                                                  \
+        for (size_t i = 1; i < n; ++i)                                                 \
+        {                                                                              \
+            T item = a[i];                                                             \
+            size_t j = i;                                                              \
+            for (; j > 0 && item < a[j - 1]; --j)                                      \
+                a[j] = a[j - 1];                                                       \
+            a[j] = item;                                                               \
+        }                                                                              \
+    }                                                                                  \
+                                                                                       \
+    static void select_range_##SUFFIX(T *a, size_t size, size_t k)                     \
+    {                                                                                  \
+        size_t lo = 0, hi = size - 1, budget = 4;                                      \
+        for (size_t n = size; n > 1; n >>= 1)                                          \
+            budget += 2;                                                               \
+        while (hi > lo)                                                                \
+        {                                                                              \
+            if (hi - lo < 16)                                                          \
+            {                                                                          \
+                insertion_sort_##SUFFIX(a + lo, hi - lo + 1);                          \
+                return;                                                                \
+            }                                                                          \
+            if (budget-- == 0)                                                         \
+            {                                                                          \
+                heap_sort_##SUFFIX(a + lo, hi - lo + 1);                               \
+                return;                                                                \
+            }                                                                          \
+            /* 排好 a[lo] <= a[mid] <= a[hi]，两端同时作为划分扫描的哨兵 */            \
+            size_t mid = lo + (hi - lo) / 2;                                           \
+            T t;                                                                       \
+            if (a[mid] < a[lo]) { t = a[mid]; a[mid] = a[lo]; a[lo] = t; }             \
+            if (a[hi] < a[mid]) { t = a[hi]; a[hi] = a[mid]; a[mid] = t; }             \
+            if (a[mid] < a[lo]) { t = a[mid]; a[mid] = a[lo]; a[lo] = t; }             \
+            T pivot = a[mid];                                                          \
+            size_t i = lo, j = hi;                                                     \
+            for (;;)                                                                   \
+            {                                                                          \
+                do                                                                     \
+                    ++i;                                                               \
+                while (a[i] < pivot);                                                  \
+                do                                                                     \
+                    --j;                                                               \
+                while (pivot < a[j]);                                                  \
+                if (i >= j)                                                            \
+                    break;                                                             \
+                t = a[i];                                                              \
+                a[i] = a[j];                                                           \
+                a[j] = t;                                                              \
+            }                                                                          \
+            /* a[lo, j] <= pivot <= a[j + 1, hi] */                                    \
+            if (k <= j)                                                                \
+                hi = j;                                                                \
+            else                                                                       \
+                lo = j + 1;                                                            \
+        }                                                                              \
+    }
+
+DEFINE_SELECT(int32_t, int32)
+DEFINE_SELECT(double, double)
+
+int32_t select_kth_int32(int32_t *arr, size_t size, size_t k)
+{
+    MATH_OPS_PROBE(size);
+    if (k >= size)
+        return 0;
+    select_range_int32(arr, size, k);
+    return arr[k];
+}
+
+double select_kth_double(double *arr, size_t size, size_t k)
+{
+    MATH_OPS_PROBE(size);
+    if (k >= size)
+        return 0.0;
+    select_range_double(arr, size, k);
+    return arr[k];
+}
+
+// 分位数：位置 (size - 1) * q 的整数部分用快速选择得到，小数部分与右侧最小值线性插值
+int percentile_int32(int32_t *arr, size_t size, double q, double *result)
+{
+    MATH_OPS_PROBE(size);
+    if (size == 0 || !(q >= 0.0 && q <= 1.0))
+        return -1;
+    double pos = q * (double)(size - 1);
+    size_t k = (size_t)pos;
+    double frac = pos - (double)k;
+    double lower = select_kth_int32(arr, size, k);
+    if (frac > 0.0 && k + 1 < size)
+    {
+        int32_t upper = arr[k + 1];
+        for (size_t i = k + 2; i < size; ++i)
+        {
+            if (arr[i] < upper)
+                upper = arr[i];
+        }
+        lower += ((double)upper - lower) * frac;
+    }
+    *result = lower;
+    return 0;
+}
+
+int percentile_double(double *arr, size_t size, double q, double *result)
+{
+    MATH_OPS_PROBE(size);
+    if (size == 0 || !(q >= 0.0 && q <= 1.0))
+        return -1;
+    double pos = q * (double)(size - 1);
+    size_t k = (size_t)pos;
+    double frac = pos - (double)k;
+    double lower = select_kth_double(arr, size, k);
+    if (frac > 0.0 && k + 1 < size)
+    {
+        double upper = arr[k + 1];
+        for (size_t i = k + 2; i < size; ++i)
+        {
+            if (arr[i] < upper)
+                upper = arr[i];
+        }
+        lower += (upper - lower) * frac;
+    }
+    *result = lower;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#define C_MATH_OPS_INLINE
+#include "c_math_ops/math_ops.h"
+
+// 内联快速路径测试：本文件中的简单运算是 static inline 版本，
+// 与库中导出的批量函数（不受 C_MATH_OPS_INLINE 影响）和直接计算的结果对比
+
+static const int32_t edge[] = {0, 1, -1, 2, -2, 7, -7, 46340, -46340, 46341, 65536, -65536,
+                               INT32_MAX, INT32_MAX - 1, INT32_MIN, INT32_MIN + 1, 0x40000000, -0x40000000};
+enum { E = sizeof(edge) / sizeof(edge[0]), N = E * E };
+
+// 溢出检查和饱和运算，返回失败次数
+static int check_checked(const int32_t *a, const int32_t *b)
+{
+    int32_t out[N], sat[N];
+    uint8_t overflow[N];
+    int failures = 0;
+
+    for (int op = 0; op < 3; ++op)
+    {
+        if (op == 0)
+        {
+            add_int_array_checked(a, b, out, overflow, N);
+            add_int_array_sat(a, b, sat, N);
+        }
+        else if (op == 1)
+        {
+            sub_int_array_checked(a, b, out, overflow, N);
+            sub_int_array_sat(a, b, sat, N);
+        }
+        else
+        {
+            mul_int_array_checked(a, b, out, overflow, N);
+            mul_int_array_sat(a, b, sat, N);
+        }
+        for (size_t i = 0; i < N; ++i)
+        {
+            int32_t r;
+            int ovf = op == 0 ? add_int_checked(a[i], b[i], &r)
+                      : op == 1 ? sub_int_checked(a[i], b[i], &r)
+                                : mul_int_checked(a[i], b[i], &r);
+            int32_t s = op == 0 ? add_int_sat(a[i], b[i]) : op == 1 ? sub_int_sat(a[i], b[i]) : mul_int_sat(a[i], b[i]);
+            failures += ovf != overflow[i] || r != out[i] || s != sat[i];
+            // 普通运算按 32 位补码回绕，与检查版本给出的结果一致
+            failures += (op == 0 ? add_int(a[i], b[i]) : op == 1 ? sub_int(a[i], b[i]) : mul_int(a[i], b[i])) != r;
+        }
+    }
+    return failures;
+}
+
+// 除法 / 取模，与库中导出的不变除数批量函数对比，返回失败次数
+static int check_division(void)
+{
+    int failures = 0;
+    for (size_t j = 0; j < E; ++j)
+    {
+        int_divider d;
+        if (int_divider_init(&d, edge[j]) != 0)
+        {
+            failures += edge[j] != 0;
+            continue;
+        }
+        int32_t quot[E], rem[E];
+        div_int_array(&d, edge, quot, E);
+        mod_int_array(&d, edge, rem, E);
+        for (size_t i = 0; i < E; ++i)
+        {
+            failures += int_divider_div(&d, edge[i]) != quot[i] || int_divider_mod(&d, edge[i]) != rem[i];
+            int32_t q, r;
+            int status = div_int_checked(edge[i], edge[j], &q);
+            failures += mod_int_checked(edge[i], edge[j], &r) != 0 || r != rem[i];
+            if (status == 1)
+            {
+                failures += edge[i] != INT32_MIN || edge[j] != -1 || q != INT32_MIN;
+                failures += div_int(edge[i], edge[j]) != INT32_MIN || mod_int(edge[i], edge[j]) != 0;
+                continue;
+            }
+            failures += status != 0 || q != quot[i];
+            failures += div_int(edge[i], edge[j]) != quot[i] || mod_int(edge[i], edge[j]) != rem[i];
+        }
+    }
+    int32_t r = 123;
+    failures += div_int(5, 0) != 0 || mod_int(5, 0) != 0;
+    failures += div_int_checked(5, 0, &r) != -1 || mod_int_checked(5, 0, &r) != -1 || r != 123;
+    return failures;
+}
+
+static int check_bitwise(void)
+{
+    int failures = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        uint32_t a = (uint32_t)edge[i / E], b = (uint32_t)edge[i % E];
+        int shift = (int)(i % 32);
+        failures += bitwise_and(a, b) != (a & b) || bitwise_or(a, b) != (a | b) || bitwise_xor(a, b) != (a ^ b);
+        failures += left_shift(a, shift) != a << shift || right_shift(a, shift) != a >> shift;
+    }
+    return failures;
+}
+
+int main(void)
+{
+    int32_t a[N], b[N];
+    for (size_t i = 0; i < N; ++i)
+    {
+        a[i] = edge[i / E];
+        b[i] = edge[i % E];
+    }
+
+    int failures = check_checked(a, b);
+    printf("Inline checked/saturating arithmetic: %s\n", failures ? "FAILED" : "OK");
+    int total = failures;
+
+    failures = check_division();
+    printf("Inline division: %s\n", failures ? "FAILED" : "OK");
+    total += failures;
+
+    failures = check_bitwise();
+    printf("Inline bitwise operations: %s\n", failures ? "FAILED" : "OK");
+    total += failures;
+
+    if (total)
+        return 1;
+    printf("C inline fast path test completed successfully!\n");
+    return 0;
+}
@@ -1,6 +1,217 @@
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "c_math_ops/math_ops.h"
 
+// 对比硬件除法验证不变除数（含 2 的幂、负除数和 INT32_MIN 边界），返回失败次数
+static int check_int_divider(void)
+{
+    const int32_t divisors[] = {1, -1, 2, -2, 3, -3, 5, 7, 10, 16, -16, 60, 100, 641, 1000, 65536,
+                                 1000003, 0x40000000, 0x7FFFFFFF, -0x7FFFFFFF, INT32_MIN};
+    enum { N = 1027 };
+    int32_t in[N], quot[N], rem[N];
+    uint32_t seed = 12345;
+    int failures = 0;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = (int32_t)(seed ^ (seed << 16));
+    }
+    in[0] = 0;
+    in[1] = INT32_MAX;
+    in[2] = INT32_MIN + 1;
+    in[3] = -1;
+    in[4] = INT32_MIN;
+
+    for (size_t k = 0; k < sizeof(divisors) / sizeof(divisors[0]); ++k)
+    {
+        int32_t divisor = divisors[k];
+        int_divider d;
+        if (int_divider_init(&d, divisor) != 0)
+            return failures + 1;
+        div_int_array(&d, in, quot, N);
+        mod_int_array(&d, in, rem, N);
+        for (size_t i = 0; i < N; ++i)
+        {
+            int32_t q = in[i] == INT32_MIN && divisor == -1 ? INT32_MIN : in[i] / divisor;
+            int32_t r = in[i] == INT32_MIN && divisor == -1 ? 0 : in[i] % divisor;
+            failures += quot[i] != q || rem[i] != r;
+            failures += int_divider_div(&d, in[i]) != q || int_divider_mod(&d, in[i]) != r;
+        }
+    }
+
+    // 连续除数 × 连续被除数
+    for (int32_t divisor = 2; divisor < 3000; ++divisor)
+    {
+        int_divider d;
+        int_divider_init(&d, divisor);
+        for (int32_t n = -5000; n <= 5000; n += 7)
+            failures += int_divider_div(&d, n) != n / divisor || int_divider_div(&d, n * 4099) != n * 4099 / divisor;
+    }
+
+    int_divider zero;
+    failures += int_divider_init(&zero, 0) != -1;
+    return failures;
+}
+
+// 对比 64 位运算验证带溢出检查 / 饱和运算（标量和批量），返回失败次数
+static int check_checked_arith(void)
+{
+    const int32_t edge[] = {0, 1, -1, 2, -2, 46340, -46340, 46341, 65536, -65536,
+                             INT32_MAX, INT32_MAX - 1, INT32_MIN, INT32_MIN + 1, 0x40000000, -0x40000000};
+    enum { E = sizeof(edge) / sizeof(edge[0]), N = E * E + 3 };
+    int32_t a[N], b[N], out[N];
+    uint8_t overflow[N];
+    int failures = 0;
+
+    for (size_t i = 0; i < E * E; ++i)
+    {
+        a[i] = edge[i / E];
+        b[i] = edge[i % E];
+    }
+    for (size_t i = E * E; i < N; ++i)
+    {
+        a[i] = INT32_MAX - (int32_t)i;
+        b[i] = (int32_t)i * 3;
+    }
+
+    for (int op = 0; op < 3; ++op)
+    {
+        size_t expected_count = 0;
+        int64_t wide[N];
+        for (size_t i = 0; i < N; ++i)
+        {
+            wide[i] = op == 0 ? (int64_t)a[i] + b[i] : op == 1 ? (int64_t)a[i] - b[i] : (int64_t)a[i] * b[i];
+            expected_count += wide[i] != (int32_t)wide[i];
+        }
+
+        size_t count = op == 0 ? add_int_array_checked(a, b, out, overflow, N)
+                       : op == 1 ? sub_int_array_checked(a, b, out, overflow, N)
+                                 : mul_int_array_checked(a, b, out, overflow, N);
+        failures += count != expected_count;
+        for (size_t i = 0; i < N; ++i)
+        {
+            int ovf = wide[i] != (int32_t)wide[i];
+            int32_t r;
+            int scalar_ovf = op == 0 ? add_int_checked(a[i], b[i], &r)
+                             : op == 1 ? sub_int_checked(a[i], b[i], &r)
+                                       : mul_int_checked(a[i], b[i], &r);
+            failures += overflow[i] != ovf || scalar_ovf != ovf;
+            failures += out[i] != (int32_t)(uint32_t)(uint64_t)wide[i] || r != out[i];
+        }
+
+        count = op == 0 ? add_int_array_sat(a, b, out, N)
+                : op == 1 ? sub_int_array_sat(a, b, out, N)
+                          : mul_int_array_sat(a, b, out, N);
+        failures += count != expected_count;
+        for (size_t i = 0; i < N; ++i)
+        {
+            int32_t sat = wide[i] > INT32_MAX ? INT32_MAX : wide[i] < INT32_MIN ? INT32_MIN : (int32_t)wide[i];
+            int32_t scalar = op == 0 ? add_int_sat(a[i], b[i]) : op == 1 ? sub_int_sat(a[i], b[i]) : mul_int_sat(a[i], b[i]);
+            failures += out[i] != sat || scalar != sat;
+        }
+    }
+
+    int32_t r = 123;
+    failures += div_int_checked(7, 0, &r) != -1 || mod_int_checked(7, 0, &r) != -1 || r != 123;
+    failures += div_int_checked(INT32_MIN, -1, &r) != 1 || r != INT32_MIN;
+    failures += mod_int_checked(INT32_MIN, -1, &r) != 0 || r != 0;
+    failures += div_int_checked(-7, 2, &r) != 0 || r != -3;
+    return failures;
+}
+
+// 选择与排名：与逐个比较 / 排序后的结果对比，返回失败次数
+static int cmp_int32(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int check_selection(void)
+{
+    enum { N = 3001, K = 25 };
+    static int32_t in[N], work[N], sorted[N];
+    static double din[N];
+    size_t indices[K];
+    uint32_t seed = 777;
+    int failures = 0;
+
+    // 取值范围小，制造大量重复值以检验首次出现 / 相同值的顺序
+    for (size_t i = 0; i < N; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = (int32_t)(seed >> 16) % 500 - 250;
+    }
+    in[2000] = INT32_MAX;
+    in[2900] = INT32_MAX;
+    in[17] = INT32_MIN;
+    for (size_t i = 0; i < N; ++i)
+        din[i] = in[i] * 0.5;
+
+    for (size_t n = 1; n <= N; n += n < 40 ? 1 : 997)
+    {
+        size_t max_i = 0, min_i = 0, dmax_i = 0, dmin_i = 0;
+        for (size_t i = 1; i < n; ++i)
+        {
+            max_i = in[i] > in[max_i] ? i : max_i;
+            min_i = in[i] < in[min_i] ? i : min_i;
+            dmax_i = din[i] > din[dmax_i] ? i : dmax_i;
+            dmin_i = din[i] < din[dmin_i] ? i : dmin_i;
+        }
+        failures += argmax_int32(in, n) != max_i || argmin_int32(in, n) != min_i;
+        failures += argmax_double(din, n) != dmax_i || argmin_double(din, n) != dmin_i;
+
+        // top-k：值不增，值相同时下标递增，且第 K 个之后没有更大的值
+        size_t count = top_k_int32(in, n, K, indices);
+        failures += count != (n < K ? n : K);
+        for (size_t j = 1; j < count; ++j)
+        {
+            int32_t a = in[indices[j - 1]], b = in[indices[j]];
+            failures += a < b || (a == b && indices[j - 1] > indices[j]);
+        }
+        memcpy(sorted, in, n * sizeof(int32_t));
+        qsort(sorted, n, sizeof(int32_t), cmp_int32);
+        for (size_t j = 0; j < count; ++j)
+            failures += in[indices[j]] != sorted[n - 1 - j];
+        failures += top_k_double(din, n, K, indices) != count;
+        for (size_t j = 0; j < count; ++j)
+            failures += din[indices[j]] != sorted[n - 1 - j] * 0.5;
+
+        // 快速选择和分位数
+        for (size_t k = 0; k < n; k += n / 7 + 1)
+        {
+            memcpy(work, in, n * sizeof(int32_t));
+            failures += select_kth_int32(work, n, k) != sorted[k];
+            for (size_t i = 0; i < n; ++i)
+                failures += i < k ? work[i] > work[k] : work[i] < work[k];
+        }
+        double median;
+        memcpy(work, in, n * sizeof(int32_t));
+        failures += percentile_int32(work, n, 0.5, &median) != 0;
+        double expected = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + (double)sorted[n / 2]) / 2;
+        failures += median != expected;
+    }
+
+    // 已排序和全部相同的输入（快速选择的退化情况）
+    for (size_t i = 0; i < N; ++i)
+        work[i] = (int32_t)i;
+    failures += select_kth_int32(work, N, 1234) != 1234;
+    for (size_t i = 0; i < N; ++i)
+        work[i] = 7;
+    failures += select_kth_int32(work, N, 99) != 7 || argmax_int32(work, N) != 0;
+
+    // NaN 被忽略
+    double with_nan[] = {NAN, 1.0, NAN, 3.0, 3.0, -2.0};
+    failures += argmax_double(with_nan, 6) != 3 || argmin_double(with_nan, 6) != 5;
+    failures += top_k_double(with_nan, 6, 10, indices) != 4 || indices[0] != 3 || indices[1] != 4;
+
+    double q;
+    failures += percentile_int32(work, 0, 0.5, &q) != -1 || percentile_int32(work, 1, 1.5, &q) != -1;
+    return failures;
+}
+
 int main()
 {
     // 测试基本运算
@@ -26,6 +237,36 @@ int main()
     string_copy(dest, test_str, sizeof(dest));
     printf("String copy: %s\n", dest);
 
+    char small[6];
+    size_t full_len = string_copy(small, test_str, sizeof(small));
+    if (full_len != strlen(test_str) || strcmp(small, "Hello") != 0)
+    {
+        printf("String copy truncation: FAILED\n");
+        return 1;
+    }
+    printf("String copy truncated: %s (source length %zu)\n", small, full_len);
+
+    // 测试不变除数
+    int failures = check_int_divider();
+    printf("Invariant divider: %s\n", failures ? "FAILED" : "OK");
+    if (failures)
+        return 1;
+
+    // 测试带溢出检查 / 饱和运算
+    failures = check_checked_arith();
+    printf("Checked/saturating arithmetic: %s\n", failures ? "FAILED" : "OK");
+    if (failures)
+        return 1;
+
+    // 测试选择与排名
+    size_t top[3];
+    top_k_int32(arr, size, 3, top);
+    printf("Array argmax: %zu, top 3 indices: %zu %zu %zu\n", argmax_int32(arr, size), top[0], top[1], top[2]);
+    failures = check_selection();
+    printf("Selection and ranking: %s\n", failures ? "FAILED" : "OK");
+    if (failures)
+        return 1;
+
     printf("C library test completed successfully!\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cpp_calculator/c_wrapper.h"
+
+// 从 C 调用 C++ 计算器的每次调用开销：包括句柄检查、异常转换和历史记录。
+// 用于比较共享库 / 静态库 / LTO / PGO 构建，也是 PGO 的训练程序
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+enum { INPUTS = 1024 };
+
+// 对 INPUTS 个输入循环执行 stmt（i 为下标），每轮后执行 reset，返回最好一轮的每次调用耗时 (ns)
+#define BENCH_CALL(stmt, reset, rounds, result)                          \
+    do                                                                   \
+    {                                                                    \
+        double best_ = 1e30;                                             \
+        for (int round_ = 0; round_ < 3; ++round_)                       \
+        {                                                                \
+            double start_ = now_seconds();                               \
+            for (size_t r_ = 0; r_ < (rounds); ++r_)                     \
+            {                                                            \
+                for (size_t i = 0; i < INPUTS; ++i)                      \
+                {                                                        \
+                    stmt;                                                \
+                }                                                        \
+                reset;                                                   \
+            }                                                            \
+            double ns_ = (now_seconds() - start_) * 1e9 / ((rounds) * INPUTS); \
+            best_ = ns_ < best_ ? ns_ : best_;                           \
+        }                                                                \
+        (result) = best_;                                                \
+    } while (0)
+
+int main(int argc, char **argv)
+{
+    // 参数为每项测试的轮数（每轮 INPUTS 次调用），PGO 训练时可以取小一些
+    size_t rounds = argc > 1 ? strtoull(argv[1], NULL, 0) : 500;
+    double *x = malloc(INPUTS * sizeof(double));
+    int32_t *values = malloc(INPUTS * sizeof(int32_t));
+    CalculatorHandle *calc = calculator_create();
+    AdvancedCalculatorHandle *adv = advanced_calculator_create();
+    AccumulatorHandle *stats = accumulator_create(ACCUMULATOR_STATS, ACCUMULATOR_INT32);
+    if (!x || !values || !calc || !adv || !stats)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < INPUTS; ++i)
+    {
+        x[i] = (double)i * 0.25 - 100.125; // 不含 0，除法不会出错
+        values[i] = (int32_t)(i * 2654435761u >> 8);
+    }
+
+    double sum = 0.0;
+    double r;
+    int64_t total;
+    size_t errors = 0;
+    double ns[6];
+
+    // 每次运算都生成一条历史记录，每轮结束清空，避免历史无限增长
+    BENCH_CALL(errors += calculator_add(calc, x[i], 1.5, &r) != CALC_SUCCESS; sum += r,
+               calculator_clear_history(calc), rounds, ns[0]);
+    BENCH_CALL(errors += calculator_divide(calc, x[i], x[INPUTS - 1 - i], &r) != CALC_SUCCESS; sum += r,
+               calculator_clear_history(calc), rounds, ns[1]);
+    BENCH_CALL(errors += advanced_calculator_power(adv, x[i], 3, &r) != CALC_SUCCESS; sum += r,
+               advanced_calculator_clear_history(adv), rounds, ns[2]);
+    // 除以零：走异常转换为错误码的路径
+    BENCH_CALL(errors += calculator_divide(calc, x[i], 0.0, &r) == CALC_SUCCESS,
+               calculator_clear_history(calc), rounds, ns[3]);
+    // 不记录历史的调用：只剩跨语言调用和句柄检查
+    BENCH_CALL(errors += accumulator_update_int32(stats, values + (i & ~(size_t)15), 16) != CALC_SUCCESS,
+               accumulator_reset(stats), rounds * 10, ns[4]);
+    BENCH_CALL(errors += advanced_calculator_sum_array_int32(adv, values + (i & ~(size_t)15), 16, &total) != CALC_SUCCESS;
+               sum += (double)total,
+               (void)0, rounds * 10, ns[5]);
+
+    printf("calculator_add              %8.2f ns/call\n", ns[0]);
+    printf("calculator_divide           %8.2f ns/call\n", ns[1]);
+    printf("advanced_calculator_power   %8.2f ns/call\n", ns[2]);
+    printf("calculator_divide (by 0)    %8.2f ns/call\n", ns[3]);
+    printf("accumulator_update_int32    %8.2f ns/call (16 elements)\n", ns[4]);
+    printf("advanced_calculator_sum     %8.2f ns/call (16 elements)\n", ns[5]);
+    printf("checksum %g, errors %zu\n", sum, errors);
+
+    accumulator_destroy(stats);
+    advanced_calculator_destroy(adv);
+    calculator_destroy(calc);
+    free(values);
+    free(x);
+    return errors != 0;
+}
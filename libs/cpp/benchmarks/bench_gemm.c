@@ -0,0 +1,105 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cpp_calculator/c_wrapper.h"
+
+// 矩阵乘法：朴素 i-j-p 三重循环与 advanced_calculator_matmul_double / _float（分块打包 + FMA 微内核，
+// 单线程与全部线程）对比，方阵边长从 4 到 1024，输出 GFLOP/s
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 重复执行 stmt 直到累计至少 0.2 秒（至少一次），取三轮中最好一轮的 GFLOP/s
+#define BENCH_GFLOPS(stmt, flops, result)                                       \
+    do                                                                          \
+    {                                                                           \
+        double best_ = 0.0;                                                     \
+        for (int round_ = 0; round_ < 3; ++round_)                              \
+        {                                                                       \
+            size_t reps_ = 0;                                                   \
+            double start_ = now_seconds(), elapsed_;                            \
+            do                                                                  \
+            {                                                                   \
+                stmt;                                                           \
+                ++reps_;                                                        \
+                elapsed_ = now_seconds() - start_;                              \
+            } while (elapsed_ < 0.2);                                           \
+            double rate_ = (flops) * reps_ / elapsed_ * 1e-9;                   \
+            best_ = rate_ > best_ ? rate_ : best_;                              \
+        }                                                                       \
+        (result) = best_;                                                       \
+    } while (0)
+
+// 教科书式的三重循环，最内层沿 b 的列跨行访问
+#define NAIVE_MATMUL(T)                                                         \
+    static void naive_matmul_##T(const T *a, const T *b, T *c, size_t n)        \
+    {                                                                           \
+        for (size_t i = 0; i < n; ++i)                                          \
+        {                                                                       \
+            for (size_t j = 0; j < n; ++j)                                      \
+            {                                                                   \
+                T sum = 0;                                                      \
+                for (size_t p = 0; p < n; ++p)                                  \
+                    sum += a[i * n + p] * b[p * n + j];                         \
+                c[i * n + j] = sum;                                             \
+            }                                                                   \
+        }                                                                       \
+    }
+
+NAIVE_MATMUL(double)
+NAIVE_MATMUL(float)
+
+int main(int argc, char **argv)
+{
+    // 参数：最大边长（默认 1024），边长从 4 开始每次翻倍
+    size_t max_n = argc > 1 ? strtoull(argv[1], NULL, 0) : 1024;
+    AdvancedCalculatorHandle *adv = advanced_calculator_create();
+    double *a = malloc(max_n * max_n * sizeof(double));
+    double *b = malloc(max_n * max_n * sizeof(double));
+    double *c = malloc(max_n * max_n * sizeof(double));
+    float *af = malloc(max_n * max_n * sizeof(float));
+    float *bf = malloc(max_n * max_n * sizeof(float));
+    float *cf = malloc(max_n * max_n * sizeof(float));
+    if (!adv || !a || !b || !c || !af || !bf || !cf)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < max_n * max_n; ++i)
+    {
+        a[i] = (double)((int)(i % 13) - 6) * 0.25;
+        b[i] = (double)((int)(i % 7) - 3) * 0.5;
+        af[i] = (float)a[i];
+        bf[i] = (float)b[i];
+    }
+
+    size_t errors = 0;
+    printf("%6s %12s %12s %12s %12s %12s %12s\n", "n", "naive f64", "gemm f64", "gemm f64 MT",
+           "naive f32", "gemm f32", "gemm f32 MT");
+    for (size_t n = 4; n <= max_n; n *= 2)
+    {
+        double flops = 2.0 * n * n * n, rate[6];
+        BENCH_GFLOPS(naive_matmul_double(a, b, c, n), flops, rate[0]);
+        BENCH_GFLOPS(errors += advanced_calculator_matmul_double(adv, a, b, c, n, n, n, 1) != CALC_SUCCESS, flops, rate[1]);
+        BENCH_GFLOPS(errors += advanced_calculator_matmul_double(adv, a, b, c, n, n, n, 0) != CALC_SUCCESS, flops, rate[2]);
+        BENCH_GFLOPS(naive_matmul_float(af, bf, cf, n), flops, rate[3]);
+        BENCH_GFLOPS(errors += advanced_calculator_matmul_float(adv, af, bf, cf, n, n, n, 1) != CALC_SUCCESS, flops, rate[4]);
+        BENCH_GFLOPS(errors += advanced_calculator_matmul_float(adv, af, bf, cf, n, n, n, 0) != CALC_SUCCESS, flops, rate[5]);
+        printf("%6zu %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f\n", n, rate[0], rate[1], rate[2], rate[3], rate[4], rate[5]);
+    }
+    printf("GFLOP/s, errors %zu\n", errors);
+
+    advanced_calculator_destroy(adv);
+    free(cf);
+    free(bf);
+    free(af);
+    free(c);
+    free(b);
+    free(a);
+    return errors != 0;
+}
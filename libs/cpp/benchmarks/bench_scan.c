@@ -0,0 +1,89 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cpp_calculator/c_wrapper.h"
+
+// 滑动窗口和前缀扫描：逐窗口调用 advanced_calculator_sum_array_int32（O(n·w)）与
+// window_sum_int32 / window_max_int32（O(n)）对比，以及单线程与全部线程的前缀和
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 执行 stmt 三次，返回最好一次的每元素耗时 (ns)
+#define BENCH_ARRAY(stmt, elements, result)                             \
+    do                                                                  \
+    {                                                                   \
+        double best_ = 1e30;                                            \
+        for (int round_ = 0; round_ < 3; ++round_)                      \
+        {                                                               \
+            double start_ = now_seconds();                              \
+            stmt;                                                       \
+            double ns_ = (now_seconds() - start_) * 1e9 / (elements);   \
+            best_ = ns_ < best_ ? ns_ : best_;                          \
+        }                                                               \
+        (result) = best_;                                               \
+    } while (0)
+
+int main(int argc, char **argv)
+{
+    // 参数：数组长度和窗口大小
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 0) : 1u << 22;
+    size_t window = argc > 2 ? strtoull(argv[2], NULL, 0) : 64;
+    if (window == 0 || window > n)
+    {
+        printf("Window must be between 1 and %zu\n", n);
+        return 1;
+    }
+    size_t outputs = n - window + 1;
+    int32_t *data = malloc(n * sizeof(int32_t));
+    int32_t *maxima = malloc(outputs * sizeof(int32_t));
+    int64_t *sums = malloc(n * sizeof(int64_t));
+    AdvancedCalculatorHandle *adv = advanced_calculator_create();
+    if (!data || !maxima || !sums || !adv)
+    {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        // 取值较小，使 sum_array（和的类型为 int32_t）在窗口不太大时不溢出，两种结果可以对比
+        data[i] = (int32_t)((uint32_t)(i * 2654435761u) >> 12) - (1 << 19);
+    }
+
+    size_t errors = 0;
+    int64_t checksum = 0;
+    double ns[6];
+
+    BENCH_ARRAY(for (size_t i = 0; i < outputs; ++i)
+                    errors += advanced_calculator_sum_array_int32(adv, data + i, window, &sums[i]) != CALC_SUCCESS,
+                outputs, ns[0]);
+    checksum += sums[outputs - 1];
+    BENCH_ARRAY(errors += window_sum_int32(data, n, window, sums, 1) != CALC_SUCCESS, outputs, ns[1]);
+    checksum -= sums[outputs - 1];
+    BENCH_ARRAY(errors += window_sum_int32(data, n, window, sums, 0) != CALC_SUCCESS, outputs, ns[2]);
+    BENCH_ARRAY(errors += window_max_int32(data, n, window, maxima, 1) != CALC_SUCCESS, outputs, ns[3]);
+    BENCH_ARRAY(errors += prefix_sum_int32(data, n, sums, PREFIX_SUM_INCLUSIVE, 1) != CALC_SUCCESS, n, ns[4]);
+    BENCH_ARRAY(errors += prefix_sum_int32(data, n, sums, PREFIX_SUM_INCLUSIVE, 0) != CALC_SUCCESS, n, ns[5]);
+
+    printf("n = %zu, window = %zu\n", n, window);
+    printf("sum_array per window        %8.3f ns/output\n", ns[0]);
+    printf("window_sum (1 thread)       %8.3f ns/output\n", ns[1]);
+    printf("window_sum (all threads)    %8.3f ns/output\n", ns[2]);
+    printf("window_max (1 thread)       %8.3f ns/output\n", ns[3]);
+    printf("prefix_sum (1 thread)       %8.3f ns/element\n", ns[4]);
+    printf("prefix_sum (all threads)    %8.3f ns/element\n", ns[5]);
+    // 两种窗口和的最后一个结果相同时 checksum 为 0
+    printf("checksum %lld, errors %zu\n", (long long)checksum, errors);
+
+    advanced_calculator_destroy(adv);
+    free(sums);
+    free(maxima);
+    free(data);
+    return errors != 0 || checksum != 0;
+}
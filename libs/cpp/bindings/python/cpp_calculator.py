@@ -4,7 +4,7 @@ Python bindings for C++ Calculator library using pybind11.
 
 import os
 import sys
-from typing import List, Union
+from typing import List, Optional, Union
 
 
 class CppCalculator:
@@ -90,6 +90,38 @@ class CppCalculator:
         """Clear calculation history."""
         self._get_basic_calculator().clear_history()
 
+    def export_history(self, first: int = 0, count: Optional[int] = None, binary: bool = False) -> bytes:
+        """Serialize history entries [first, first + count) in a single call.
+
+        Text format is one entry per line; binary format is a native-endian
+        uint32 length followed by the entry bytes for each record.
+        """
+        return self._get_basic_calculator().export_history(first, count, binary)
+
+    def history_view(self):
+        """Read-only sequence over the history; entries are converted on access."""
+        return self._get_basic_calculator().history_view()
+
+    def open_journal(self, path: str, sync: str = "batch"):
+        """Persist every new history entry to an append-only journal file.
+
+        sync is "none", "batch" (fdatasync after each batch) or "interval"
+        (at most once per second). Entries are written by a background thread.
+        """
+        self._get_basic_calculator().open_journal(path, sync)
+
+    def flush_journal(self):
+        """Block until all journaled entries have been written."""
+        self._get_basic_calculator().flush_journal()
+
+    def close_journal(self):
+        """Write remaining entries and close the journal."""
+        self._get_basic_calculator().close_journal()
+
+    def read_journal(self, path: str) -> List[tuple]:
+        """Read a journal file as a list of (timestamp_ns, entry) tuples."""
+        return self._cpp_mod.read_journal(path)
+
     def get_calculator_type(self) -> str:
         """Get calculator type."""
         return self._get_basic_calculator().get_calculator_type()
@@ -162,6 +194,288 @@ class CppCalculator:
         else:
             return self._get_advanced_calculator().min_element_double([float(x) for x in arr])
 
+    def _select(self, name: str, arr: List[Union[int, float]], *args):
+        if not arr:
+            raise ValueError("Array cannot be empty")
+
+        calc = self._get_advanced_calculator()
+        try:
+            if isinstance(arr[0], int):
+                return getattr(calc, f"{name}_int")(arr, *args)
+            return getattr(calc, f"{name}_double")([float(x) for x in arr], *args)
+        except self._cpp_mod.CalculatorException as e:
+            raise ValueError(str(e))
+
+    def argmax(self, arr: List[Union[int, float]]) -> int:
+        """Index of the first maximum element (NaN is ignored)."""
+        return self._select("argmax", arr)
+
+    def argmin(self, arr: List[Union[int, float]]) -> int:
+        """Index of the first minimum element (NaN is ignored)."""
+        return self._select("argmin", arr)
+
+    def top_k(self, arr: List[Union[int, float]], k: int) -> List[int]:
+        """Indices of the k largest elements, largest first; ties keep the lower index first."""
+        if k < 0:
+            raise ValueError("k must be non-negative")
+        return self._select("top_k", arr, k)
+
+    def percentile(self, arr: List[Union[int, float]], q: float) -> float:
+        """Percentile with linear interpolation (numpy's default), q in [0, 1]."""
+        return self._select("percentile", arr, float(q))
+
+    def median(self, arr: List[Union[int, float]]) -> float:
+        """Median (average of the two middle elements for even lengths)."""
+        return self._select("median", arr)
+
     def batch_add(self, values: List[Union[int, float]], addend: Union[int, float]) -> List[float]:
         """Batch add operation."""
-        return self._get_advanced_calculator().batch_add([float(x) for x in values], float(addend))
\ No newline at end of file
+        return self._get_advanced_calculator().batch_add([float(x) for x in values], float(addend))
+
+    # File-backed (mmap) operations on raw binary int32/double files
+    def _file_op(self, int_fn: str, double_fn: str, path: str, dtype: str):
+        if dtype not in ("int32", "double"):
+            raise ValueError(f"Unsupported dtype: {dtype}")
+        calc = self._get_advanced_calculator()
+        try:
+            return getattr(calc, int_fn if dtype == "int32" else double_fn)(path)
+        except self._cpp_mod.CalculatorException as e:
+            if "File I/O error" in str(e):
+                raise OSError(str(e))
+            if "empty" in str(e):
+                raise ValueError(f"File is empty: {path}")
+            raise
+
+    def sum_file(self, path: str, dtype: str = "double") -> Union[int, float]:
+        """Sum all elements of a raw binary file without loading it into memory."""
+        return self._file_op("sum_file_int", "sum_file_double", path, dtype)
+
+    def max_file(self, path: str, dtype: str = "double") -> Union[int, float]:
+        """Find maximum element of a raw binary file."""
+        return self._file_op("max_file_int", "max_file_double", path, dtype)
+
+    def min_file(self, path: str, dtype: str = "double") -> Union[int, float]:
+        """Find minimum element of a raw binary file."""
+        return self._file_op("min_file_int", "min_file_double", path, dtype)
+
+    def batch_add_file(self, input_path: str, output_path: str, addend: Union[int, float]) -> int:
+        """Add addend to every double in input_path, writing results to output_path."""
+        try:
+            return self._get_advanced_calculator().batch_add_file(input_path, output_path, float(addend))
+        except self._cpp_mod.CalculatorException as e:
+            if "File I/O error" in str(e):
+                raise OSError(str(e))
+            raise
+
+    # Streaming accumulators
+    def create_accumulator(self, kind: str = "sum", dtype: str = "double"):
+        """Create a streaming accumulator fed chunk by chunk via update().
+
+        kind is one of "sum", "min", "max", "stats"; dtype is "int32" or "double".
+        Accumulators of the same kind can be combined with merge().
+        """
+        kinds = {"sum": "Sum", "min": "Min", "max": "Max", "stats": "Stats"}
+        suffixes = {"int32": "Int", "double": "Double"}
+        if kind not in kinds or dtype not in suffixes:
+            raise ValueError(f"Unsupported accumulator: {kind}/{dtype}")
+        return getattr(self._cpp_mod, f"{kinds[kind]}Accumulator{suffixes[dtype]}")()
+
+    # Prefix scans and sliding windows (results are array.array; int32 sums are int64)
+    def _scan(self, name: str, dtype: str, *args):
+        suffixes = {"int32": "int", "float32": "float", "double": "double"}
+        fn = getattr(self._cpp_mod, f"{name}_{suffixes[dtype]}", None) if dtype in suffixes else None
+        if fn is None:
+            raise ValueError(f"Unsupported dtype for {name}: {dtype}")
+        try:
+            return fn(*args)
+        except self._cpp_mod.CalculatorException as e:
+            raise ValueError(str(e))
+
+    def prefix_sum(self, values, dtype: str = "double", exclusive: bool = False, threads: int = 0):
+        """Running sum; with exclusive=True element i excludes values[i] (first result is 0).
+
+        values may be a list or any contiguous buffer (array.array, numpy) of the dtype.
+        threads=0 uses all hardware threads for large inputs.
+        """
+        return self._scan("prefix_sum", dtype, values, exclusive, threads)
+
+    def cumulative_min(self, values, dtype: str = "double", threads: int = 0):
+        """Running minimum."""
+        return self._scan("cumulative_min", dtype, values, threads)
+
+    def cumulative_max(self, values, dtype: str = "double", threads: int = 0):
+        """Running maximum."""
+        return self._scan("cumulative_max", dtype, values, threads)
+
+    def window_sum(self, values, window: int, dtype: str = "double", threads: int = 0):
+        """Sum of every window of `window` consecutive values (len(values) - window + 1 results)."""
+        return self._scan("window_sum", dtype, values, window, threads)
+
+    def window_min(self, values, window: int, dtype: str = "double", threads: int = 0):
+        """Minimum of every window."""
+        return self._scan("window_min", dtype, values, window, threads)
+
+    def window_max(self, values, window: int, dtype: str = "double", threads: int = 0):
+        """Maximum of every window."""
+        return self._scan("window_max", dtype, values, window, threads)
+
+    # Sorting and bucketing
+    def sort(self, values, dtype: str = "double", in_place: bool = False, threads: int = 0):
+        """Ascending sort: radix sort for int32/float32, parallel merge sort for double (NaN last).
+
+        Returns a sorted array.array; with in_place=True sorts a writable contiguous buffer
+        (array.array, numpy) of the dtype and returns None.
+        """
+        return self._scan("sort" if in_place else "sorted", dtype, values, threads)
+
+    def histogram(self, values, lo: float, hi: float, bins: int, dtype: str = "double", threads: int = 0):
+        """Counts of `bins` equal-width bins over [lo, hi] as array('Q').
+
+        The last bin includes hi (like numpy.histogram); values outside the range and NaN are skipped.
+        """
+        if bins < 0:
+            raise ValueError("bins must be non-negative")
+        return self._scan("histogram", dtype, values, float(lo), float(hi), bins, threads)
+
+    def group_by(self, keys, values, dtype: str = "double", threads: int = 0):
+        """Per-key aggregation of values grouped by int32 keys.
+
+        Returns a dict of array.array columns "key", "sum", "min", "max", "count", sorted by key
+        (int32 sums are int64). keys and values may be lists or contiguous buffers.
+        """
+        columns = self._scan("group_by", dtype, keys, values, threads)
+        return dict(zip(("key", "sum", "min", "max", "count"), columns))
+
+    # BLAS-1 operations (dtype "double" or "float32"; numpy arrays are used without copying)
+    def dot(self, x, y, dtype: str = "double") -> float:
+        """Dot product of two equal-length arrays (FMA-vectorized)."""
+        return self._scan("dot", dtype, x, y)
+
+    def axpy(self, a: float, x, y, dtype: str = "double"):
+        """y = a * x + y, updating y in place.
+
+        y must be a writable contiguous buffer (array.array, numpy) of the dtype; x may be a list.
+        """
+        self._scan("axpy", dtype, a, x, y)
+
+    def scale(self, a: float, x, dtype: str = "double"):
+        """x = a * x, updating the writable contiguous buffer x in place."""
+        self._scan("scale", dtype, a, x)
+
+    def norm(self, x, dtype: str = "double") -> float:
+        """Euclidean norm sqrt(sum(x * x)), without rescaling (overflows to inf)."""
+        return self._scan("norm", dtype, x)
+
+    def fma(self, a, b, c, dtype: str = "double", out=None):
+        """Element-wise a * b + c, rounded once on CPUs with FMA.
+
+        Writes into out (a writable buffer, may be one of the inputs) and returns it;
+        without out returns a new array.array.
+        """
+        return self._scan("fma", dtype, a, b, c, out)
+
+    def poly_eval(self, coeffs, x, dtype: str = "double", out=None):
+        """Evaluate the polynomial coeffs[0] + coeffs[1] * x + ... at every point of x.
+
+        Coefficients are in ascending order (as numpy.polynomial.polynomial.polyval,
+        the reverse of numpy.polyval). One call replaces per-term power/multiply/add
+        and records no history. Writes into out (may be x) and returns it; without
+        out returns a new array.array.
+        """
+        return self._scan("poly_eval", dtype, coeffs, x, out)
+
+    @staticmethod
+    def _matrix(x):
+        """Return ((rows, cols), data) for a 2-D buffer or a list of equal-length rows."""
+        shape = getattr(x, "shape", None)
+        if shape is not None:
+            if len(shape) != 2:
+                raise ValueError("Expected a 2-D matrix")
+            return tuple(shape), x
+        rows = [list(row) for row in x]
+        cols = len(rows[0]) if rows else 0
+        if any(len(row) != cols for row in rows):
+            raise ValueError("Matrix rows must have the same length")
+        return (len(rows), cols), [v for row in rows for v in row]
+
+    def matmul(self, a, b, dtype: str = "double", out=None, threads: int = 0):
+        """Matrix product a @ b of an (m x k) and a (k x n) matrix.
+
+        a and b may be lists of rows or 2-D C-contiguous buffers (numpy arrays,
+        memoryviews) of the dtype. Returns a list of rows when either input is a
+        list, otherwise a 2-D memoryview; with out (a writable buffer of m * n
+        elements) the result is written there and out is returned.
+        threads=0 uses all hardware threads for large matrices.
+        """
+        (m, k), flat_a = self._matrix(a)
+        (k2, n), flat_b = self._matrix(b)
+        if k != k2:
+            raise ValueError("Matrix dimensions do not match the array sizes")
+        result = self._scan("matmul", dtype, flat_a, flat_b, m, k, n, out, threads)
+        if out is not None:
+            return out
+        if isinstance(flat_a, list) or isinstance(flat_b, list):
+            return [list(result[i * n:(i + 1) * n]) for i in range(m)]
+        if m * n == 0:
+            # memoryview cannot be cast to a shape containing zeros
+            return memoryview(result)
+        return memoryview(result).cast("B").cast(result.typecode, (m, n))
+
+    # Shared-memory calculation server for multi-process workers
+    def start_server(self, name: str, slots: int = 64, ring_capacity: int = 64, workers: int = 1,
+                     threads: int = 0):
+        """Run a calculation server in this process under the shared memory name `name`.
+
+        Other processes connect with connect_server(name). slots bounds the number of
+        connected clients, ring_capacity the requests a client may have outstanding,
+        workers the dispatcher threads and threads the parallelism of matmul, sort and
+        prefix_sum (0 = all hardware threads). The server runs until stop() is called
+        or the object is garbage collected.
+        """
+        try:
+            return self._cpp_mod.CalcServer(name, slots, ring_capacity, workers, threads)
+        except self._cpp_mod.CalculatorException as e:
+            if "File I/O error" in str(e):
+                raise OSError(str(e))
+            raise
+
+    def connect_server(self, name: str):
+        """Connect to the calculation server `name` (raises OSError if it is not running).
+
+        Register each multiprocessing.shared_memory segment with
+        client.register(shm.buf, shm.name); segment names must start with
+        "<name>_". The client methods (sum, min, max, dot, norm,
+        axpy, scale, fma, poly_eval, matmul, sort, prefix_sum) then take C-contiguous
+        int32 / float32 / float64 buffers inside registered segments, e.g. numpy arrays
+        created with buffer=shm.buf, and write results in place. A client is used by one
+        thread at a time; close() releases its server slot.
+        """
+        try:
+            return self._cpp_mod.CalcClient(name)
+        except self._cpp_mod.CalculatorException as e:
+            if "File I/O error" in str(e):
+                raise OSError(str(e))
+            raise
+
+    # Instrumentation (recorded only when the library is built with ENABLE_INSTRUMENTATION=ON)
+    def instrumentation_enabled(self) -> bool:
+        """Whether the library records per-operation statistics."""
+        return self._cpp_mod.instrumentation_enabled()
+
+    def instrumentation_stats(self) -> dict:
+        """Statistics of every operation called since the last reset, summed over all threads.
+
+        Maps the operation name (e.g. "matmul") to a dict with "calls", "errors"
+        (calls that raised), "bytes" (input bytes processed), "total_ns", latency
+        estimates "p50_ns" / "p99_ns" / "max_ns" and "latency", the non-empty
+        histogram buckets as (lower bound in ns, count) pairs.
+        """
+        return self._cpp_mod.instrumentation_stats()
+
+    def instrumentation_error_codes(self) -> dict:
+        """How often the C API turned an exception into each CalculatorError code."""
+        return self._cpp_mod.instrumentation_error_codes()
+
+    def reset_instrumentation(self):
+        """Zero all counters."""
+        self._cpp_mod.reset_instrumentation()
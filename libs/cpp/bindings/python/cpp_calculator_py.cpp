@@ -1,16 +1,776 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/operators.h>
+#include <algorithm>
+#include <limits>
+#include <mutex>
 #include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/ArrowColumn.h"
+#include "cpp_calculator/HistoryJournal.h"
+#include "cpp_calculator/Scan.h"
+#include "cpp_calculator/Sort.h"
+#include "cpp_calculator/GroupBy.h"
+#include "cpp_calculator/Blas.h"
+#include "cpp_calculator/Gemm.h"
+#include "cpp_calculator/Polynomial.h"
+#include "cpp_calculator/Instrumentation.h"
+#include "cpp_calculator/CalcServer.h"
 
 namespace py = pybind11;
 
+// 由 pyarrow 的 _export_to_c 等导出的 ArrowArray / ArrowSchema 地址构造列视图（不接管所有权）
+static ArrowColumnView arrow_view(uintptr_t array_ptr, uintptr_t schema_ptr)
+{
+    return ArrowColumnView(reinterpret_cast<const ArrowArray *>(array_ptr),
+                           reinterpret_cast<const ArrowSchema *>(schema_ptr));
+}
+
+// 历史的只读视图：引用计算器内部的 vector，按需把单条转换为 str，不复制整个历史
+struct HistoryView
+{
+    const Calculator *calc;
+    const std::vector<std::string> &entries() const { return calc->getHistory(); }
+};
+
+// 按下标遍历历史：每次 __next__ 重新检查长度，迭代期间历史增长（vector 重新分配）或被清空也不会悬空
+struct HistoryIterator
+{
+    HistoryView view;
+    size_t index;
+};
+
+// 一次序列化历史，直接写入新建 bytes 对象的存储，不经过中间缓冲区
+static py::bytes export_history_bytes(const Calculator &calc, size_t first, py::object count, bool binary)
+{
+    size_t n = count.is_none() ? std::numeric_limits<size_t>::max() : count.cast<size_t>();
+    HistoryFormat format = binary ? HistoryFormat::Binary : HistoryFormat::Text;
+    size_t required = calc.exportHistory(first, n, format, nullptr, 0);
+    PyObject *obj = PyBytes_FromStringAndSize(nullptr, static_cast<py::ssize_t>(required));
+    if (!obj) throw py::error_already_set();
+    calc.exportHistory(first, n, format, PyBytes_AS_STRING(obj), required);
+    return py::reinterpret_steal<py::bytes>(obj);
+}
+
+static void open_journal(Calculator &calc, const std::string &path, const std::string &sync, size_t ring_bytes)
+{
+    JournalOptions options;
+    options.ring_bytes = ring_bytes;
+    if (sync == "none") options.sync = JournalSync::None;
+    else if (sync == "batch") options.sync = JournalSync::Batch;
+    else if (sync == "interval") options.sync = JournalSync::Interval;
+    else throw py::value_error("sync must be 'none', 'batch' or 'interval'");
+    calc.setJournal(std::make_shared<HistoryJournal>(path, options));
+}
+
+// 持有 GIL 时取得日志的共享所有权再释放 GIL：其它线程同时 close_journal / open_journal 也不会释放正在使用的对象
+static void flush_journal(Calculator &calc)
+{
+    std::shared_ptr<HistoryJournal> journal = calc.shareJournal();
+    if (!journal) throw py::value_error("no journal is open");
+    py::gil_scoped_release release;
+    journal->flush();
+}
+
+// 持有 GIL 时把日志从计算器上摘下，释放 GIL 后再析构（写完剩余记录、等待写线程退出）
+static void close_journal(Calculator &calc)
+{
+    std::shared_ptr<HistoryJournal> journal = calc.shareJournal();
+    calc.setJournal(nullptr);
+    py::gil_scoped_release release;
+    journal.reset();
+}
+
+// 读取整个日志文件，返回 [(timestamp_ns, entry), ...]
+static py::list read_journal(const std::string &path)
+{
+    HistoryJournalReader reader(path);
+    JournalRecord record;
+    py::list records;
+    while (reader.next(record)) {
+        records.append(py::make_tuple(record.timestamp_ns, record.entry));
+    }
+    return records;
+}
+
+// 请求连续的一维缓冲区，元素类型必须与 T 一致；writable 为 true 时还要求可写
+template <typename T>
+py::buffer_info request_contiguous(py::buffer buf, bool writable = false)
+{
+    py::buffer_info info = buf.request(writable);
+    if (info.ndim != 1 || info.itemsize != static_cast<py::ssize_t>(sizeof(T)) ||
+        info.format != py::format_descriptor<T>::format() ||
+        (info.size > 1 && info.strides[0] != static_cast<py::ssize_t>(sizeof(T)))) {
+        throw py::type_error("Expected a contiguous 1-D buffer of matching element type");
+    }
+    return info;
+}
+
+// 累加器的分块输入：支持缓冲区协议（memoryview/array/numpy，零拷贝）和普通列表
+template <typename Acc, typename T>
+void bind_accumulator_update(py::class_<Acc> &cls)
+{
+    cls.def("update", [](Acc &acc, py::buffer buf) {
+            py::buffer_info info = request_contiguous<T>(buf);
+            py::gil_scoped_release release;
+            acc.update(static_cast<const T *>(info.ptr), static_cast<size_t>(info.size));
+        }, "Feed a chunk from a contiguous buffer")
+        .def("update", [](Acc &acc, const std::vector<T> &values) {
+            acc.update(values.data(), values.size());
+        }, "Feed a chunk from a list")
+        .def("merge", &Acc::merge, "Merge another accumulator of the same kind")
+        .def("reset", &Acc::reset, "Reset to the empty state")
+        .def_property_readonly("count", &Acc::count);
+}
+
+template <typename T>
+void bind_accumulators(py::module &m, const std::string &suffix)
+{
+    py::class_<SumAccumulator<T>> sum(m, ("SumAccumulator" + suffix).c_str());
+    sum.def(py::init<>()).def("result", &SumAccumulator<T>::result, "Current sum");
+    bind_accumulator_update<SumAccumulator<T>, T>(sum);
+
+    py::class_<MinAccumulator<T>> min(m, ("MinAccumulator" + suffix).c_str());
+    min.def(py::init<>()).def("result", &MinAccumulator<T>::result, "Current minimum");
+    bind_accumulator_update<MinAccumulator<T>, T>(min);
+
+    py::class_<MaxAccumulator<T>> max(m, ("MaxAccumulator" + suffix).c_str());
+    max.def(py::init<>()).def("result", &MaxAccumulator<T>::result, "Current maximum");
+    bind_accumulator_update<MaxAccumulator<T>, T>(max);
+
+    py::class_<StatsAccumulator<T>> stats(m, ("StatsAccumulator" + suffix).c_str());
+    stats.def(py::init<>())
+        .def("sum", &StatsAccumulator<T>::sum, "Current sum")
+        .def("min", &StatsAccumulator<T>::min, "Current minimum")
+        .def("max", &StatsAccumulator<T>::max, "Current maximum")
+        .def("mean", &StatsAccumulator<T>::mean, "Current mean")
+        .def("variance", &StatsAccumulator<T>::variance, "Current population variance");
+    bind_accumulator_update<StatsAccumulator<T>, T>(stats);
+}
+
+// 扫描运算的输入：支持缓冲区协议的对象零拷贝，其它序列（列表等）复制一份
+template <typename T>
+class ScanInput
+{
+public:
+    explicit ScanInput(py::handle values)
+    {
+        if (PyObject_CheckBuffer(values.ptr())) {
+            info_ = request_contiguous<T>(py::reinterpret_borrow<py::buffer>(values));
+            data_ = static_cast<const T *>(info_.ptr);
+            size_ = static_cast<size_t>(info_.size);
+        } else {
+            copy_ = values.cast<std::vector<T>>();
+            data_ = copy_.data();
+            size_ = copy_.size();
+        }
+    }
+
+    const T *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    py::buffer_info info_;
+    std::vector<T> copy_;
+    const T *data_;
+    size_t size_;
+};
+
+template <typename T> const char *array_typecode();
+template <> const char *array_typecode<int32_t>() { return "i"; }
+template <> const char *array_typecode<int64_t>() { return "q"; }
+template <> const char *array_typecode<double>() { return "d"; }
+template <> const char *array_typecode<float>() { return "f"; }
+template <> const char *array_typecode<uint64_t>() { return "Q"; }
+
+// 新建长度为 size 的 array.array 作为扫描结果，data 指向其存储（之后不再改变大小）
+template <typename T>
+py::object make_result_array(size_t size, T *&data)
+{
+    py::object zero = py::module::import("array").attr("array")(array_typecode<T>(), py::make_tuple(0));
+    py::object result = zero.attr("__mul__")(size);
+    data = static_cast<T *>(py::buffer(result).request(true).ptr);
+    return result;
+}
+
+// 绑定前缀扫描和滑动窗口：prefix_sum_int / prefix_sum_double 等，返回 array.array。
+// 计算期间释放 GIL，数据量大时按 threads 多线程计算
+template <typename T>
+void bind_scans(py::module &m, const std::string &suffix)
+{
+    using S = scan_sum_t<T>;
+
+    m.def(("prefix_sum_" + suffix).c_str(), [](py::object values, bool exclusive, unsigned threads) {
+        ScanInput<T> in(values);
+        S *out;
+        py::object result = make_result_array(in.size(), out);
+        {
+            py::gil_scoped_release release;
+            prefix_sum(in.data(), in.size(), out, exclusive ? ScanMode::Exclusive : ScanMode::Inclusive, threads);
+        }
+        return result;
+    }, "Inclusive or exclusive prefix sum", py::arg("values"), py::arg("exclusive") = false, py::arg("threads") = 0);
+
+    using Cumulative = void (*)(const T *, size_t, T *, unsigned);
+    auto bind_cumulative = [&m, &suffix](const char *name, Cumulative fn, const char *doc) {
+        m.def((name + ("_" + suffix)).c_str(), [fn](py::object values, unsigned threads) {
+            ScanInput<T> in(values);
+            T *out;
+            py::object result = make_result_array(in.size(), out);
+            {
+                py::gil_scoped_release release;
+                fn(in.data(), in.size(), out, threads);
+            }
+            return result;
+        }, doc, py::arg("values"), py::arg("threads") = 0);
+    };
+    bind_cumulative("cumulative_min", &cumulative_min<T>, "Running minimum");
+    bind_cumulative("cumulative_max", &cumulative_max<T>, "Running maximum");
+
+    m.def(("window_sum_" + suffix).c_str(), [](py::object values, size_t window, unsigned threads) {
+        ScanInput<T> in(values);
+        S *out;
+        py::object result = make_result_array(window_count(in.size(), window), out);
+        {
+            py::gil_scoped_release release;
+            window_sum(in.data(), in.size(), window, out, threads);
+        }
+        return result;
+    }, "Sum of every window of the given size", py::arg("values"), py::arg("window"), py::arg("threads") = 0);
+
+    using Window = void (*)(const T *, size_t, size_t, T *, unsigned);
+    auto bind_window = [&m, &suffix](const char *name, Window fn, const char *doc) {
+        m.def((name + ("_" + suffix)).c_str(), [fn](py::object values, size_t window, unsigned threads) {
+            ScanInput<T> in(values);
+            T *out;
+            py::object result = make_result_array(window_count(in.size(), window), out);
+            {
+                py::gil_scoped_release release;
+                fn(in.data(), in.size(), window, out, threads);
+            }
+            return result;
+        }, doc, py::arg("values"), py::arg("window"), py::arg("threads") = 0);
+    };
+    bind_window("window_min", &window_min<T>, "Minimum of every window (monotonic deque)");
+    bind_window("window_max", &window_max<T>, "Maximum of every window (monotonic deque)");
+}
+
+// 绑定排序：sort_int / sort_float / sort_double 原地排序可写的连续缓冲区，
+// sorted_* 返回排好序的新 array.array（输入可以是列表）。排序期间释放 GIL
+template <typename T>
+void bind_sorts(py::module &m, const std::string &suffix)
+{
+    m.def(("sort_" + suffix).c_str(), [](py::buffer values, unsigned threads) {
+        py::buffer_info info = request_contiguous<T>(values, true);
+        py::gil_scoped_release release;
+        sort_values(static_cast<T *>(info.ptr), static_cast<size_t>(info.size), threads);
+    }, "Sort a writable contiguous buffer in place", py::arg("values"), py::arg("threads") = 0);
+    m.def(("sorted_" + suffix).c_str(), [](py::handle values, unsigned threads) {
+        ScanInput<T> in(values);
+        T *out;
+        py::object result = make_result_array(in.size(), out);
+        {
+            py::gil_scoped_release release;
+            std::copy(in.data(), in.data() + in.size(), out);
+            sort_values(out, in.size(), threads);
+        }
+        return result;
+    }, "Sorted copy as array.array", py::arg("values"), py::arg("threads") = 0);
+}
+
+// 绑定直方图：histogram_int / histogram_double 返回 array.array('Q') 的桶计数
+template <typename T>
+void bind_histogram(py::module &m, const std::string &suffix)
+{
+    m.def(("histogram_" + suffix).c_str(), [](py::handle values, double lo, double hi, size_t bins, unsigned threads) {
+        ScanInput<T> in(values);
+        uint64_t *counts;
+        py::object result = make_result_array(bins, counts);
+        {
+            py::gil_scoped_release release;
+            histogram(in.data(), in.size(), lo, hi, bins, counts, threads);
+        }
+        return result;
+    }, "Counts of bins equal-width bins over [lo, hi]", py::arg("values"), py::arg("lo"), py::arg("hi"),
+       py::arg("bins"), py::arg("threads") = 0);
+}
+
+// 把结果向量复制为 array.array
+template <typename T>
+py::object to_result_array(const std::vector<T> &values)
+{
+    T *out;
+    py::object result = make_result_array(values.size(), out);
+    std::copy(values.begin(), values.end(), out);
+    return result;
+}
+
+// 绑定分组聚合：group_by_int / group_by_double 返回 (keys, sums, mins, maxs, counts) 五个 array.array，按键升序
+template <typename T>
+void bind_group_by(py::module &m, const std::string &suffix)
+{
+    m.def(("group_by_" + suffix).c_str(), [](py::handle keys, py::handle values, unsigned threads) {
+        ScanInput<int32_t> in_keys(keys);
+        ScanInput<T> in_values(values);
+        if (in_keys.size() != in_values.size()) {
+            throw py::value_error("Key and value arrays must have the same length");
+        }
+        GroupByResult<T> groups;
+        {
+            py::gil_scoped_release release;
+            groups = group_by(in_keys.data(), in_values.data(), in_values.size(), threads);
+        }
+        return py::make_tuple(to_result_array(groups.keys), to_result_array(groups.sums), to_result_array(groups.mins),
+                              to_result_array(groups.maxs), to_result_array(groups.counts));
+    }, "Per-key sum/min/max/count as (keys, sums, mins, maxs, counts)", py::arg("keys"), py::arg("values"),
+       py::arg("threads") = 0);
+}
+
+static void require_same_length(size_t a, size_t b)
+{
+    if (a != b) {
+        throw py::value_error("Input arrays must have the same length");
+    }
+}
+
+// 绑定 BLAS-1 运算：dot_double / axpy_float 等。输入可以是列表或连续缓冲区（numpy 数组零拷贝），
+// axpy / scale 原地更新可写的缓冲区；fma 写入 out（省略时新建 array.array）。计算期间释放 GIL
+template <typename T>
+void bind_blas(py::module &m, const std::string &suffix)
+{
+    m.def(("dot_" + suffix).c_str(), [](py::handle x, py::handle y) {
+        ScanInput<T> in_x(x), in_y(y);
+        require_same_length(in_x.size(), in_y.size());
+        py::gil_scoped_release release;
+        return dot_product(in_x.data(), in_y.data(), in_x.size());
+    }, "Dot product", py::arg("x"), py::arg("y"));
+    m.def(("axpy_" + suffix).c_str(), [](T a, py::handle x, py::buffer y) {
+        ScanInput<T> in_x(x);
+        py::buffer_info info = request_contiguous<T>(y, true);
+        require_same_length(in_x.size(), static_cast<size_t>(info.size));
+        py::gil_scoped_release release;
+        axpy(a, in_x.data(), static_cast<T *>(info.ptr), in_x.size());
+    }, "y = a * x + y, updating the writable buffer y in place", py::arg("a"), py::arg("x"), py::arg("y"));
+    m.def(("scale_" + suffix).c_str(), [](T a, py::buffer x) {
+        py::buffer_info info = request_contiguous<T>(x, true);
+        py::gil_scoped_release release;
+        scale_values(a, static_cast<T *>(info.ptr), static_cast<size_t>(info.size));
+    }, "x = a * x, updating the writable buffer x in place", py::arg("a"), py::arg("x"));
+    m.def(("norm_" + suffix).c_str(), [](py::handle x) {
+        ScanInput<T> in(x);
+        py::gil_scoped_release release;
+        return norm2(in.data(), in.size());
+    }, "Euclidean norm", py::arg("x"));
+    m.def(("fma_" + suffix).c_str(), [](py::handle a, py::handle b, py::handle c, py::object out) {
+        ScanInput<T> in_a(a), in_b(b), in_c(c);
+        require_same_length(in_a.size(), in_b.size());
+        require_same_length(in_a.size(), in_c.size());
+        T *data;
+        py::buffer_info info;
+        if (out.is_none()) {
+            out = make_result_array(in_a.size(), data);
+        } else {
+            info = request_contiguous<T>(py::reinterpret_borrow<py::buffer>(out), true);
+            require_same_length(in_a.size(), static_cast<size_t>(info.size));
+            data = static_cast<T *>(info.ptr);
+        }
+        {
+            py::gil_scoped_release release;
+            fused_multiply_add(in_a.data(), in_b.data(), in_c.data(), data, in_a.size());
+        }
+        return out;
+    }, "Element-wise a * b + c into out (a new array.array when omitted); out may alias an input",
+       py::arg("a"), py::arg("b"), py::arg("c"), py::arg("out") = py::none());
+}
+
+// 检查缓冲区按行主序连续存放（任意维数），元素类型必须与 T 一致
+template <typename T>
+void require_c_contiguous(const py::buffer_info &info)
+{
+    bool contiguous = info.itemsize == static_cast<py::ssize_t>(sizeof(T)) &&
+                      info.format == py::format_descriptor<T>::format();
+    py::ssize_t stride = static_cast<py::ssize_t>(sizeof(T));
+    for (py::ssize_t d = info.ndim; contiguous && d-- > 0;) {
+        contiguous = info.shape[d] <= 1 || info.strides[d] == stride;
+        stride *= info.shape[d];
+    }
+    if (!contiguous) {
+        throw py::type_error("Expected a C-contiguous buffer of matching element type");
+    }
+}
+
+// 矩阵的输入：按行主序连续存放的缓冲区（任意维数，如二维 numpy 数组）零拷贝，其它序列按扁平列表复制
+template <typename T>
+class MatrixInput
+{
+public:
+    explicit MatrixInput(py::handle values)
+    {
+        if (PyObject_CheckBuffer(values.ptr())) {
+            info_ = py::reinterpret_borrow<py::buffer>(values).request();
+            require_c_contiguous<T>(info_);
+            data_ = static_cast<const T *>(info_.ptr);
+            size_ = static_cast<size_t>(info_.size);
+        } else {
+            copy_ = values.cast<std::vector<T>>();
+            data_ = copy_.data();
+            size_ = copy_.size();
+        }
+    }
+
+    const T *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    py::buffer_info info_;
+    std::vector<T> copy_;
+    const T *data_;
+    size_t size_;
+};
+
+static void require_matrix(size_t size, size_t rows, size_t cols)
+{
+    if ((rows != 0 && cols > std::numeric_limits<size_t>::max() / rows) || size != rows * cols) {
+        throw py::value_error("Matrix dimensions do not match the array sizes");
+    }
+}
+
+// 绑定矩阵乘法：matmul_double / matmul_float。a（m×k）、b（k×n）为行主序的列表或连续缓冲区，
+// 结果写入 out（m×n 个元素的可写连续缓冲区，不能与输入重叠；省略时新建扁平的 array.array）。计算期间释放 GIL
+template <typename T>
+void bind_matmul(py::module &m, const std::string &suffix)
+{
+    m.def(("matmul_" + suffix).c_str(), [](py::handle a, py::handle b, size_t rows, size_t inner, size_t cols,
+                                           py::object out, unsigned threads) {
+        MatrixInput<T> in_a(a), in_b(b);
+        require_matrix(in_a.size(), rows, inner);
+        require_matrix(in_b.size(), inner, cols);
+        T *data;
+        py::buffer_info info;
+        if (out.is_none()) {
+            if (cols != 0 && rows > std::numeric_limits<size_t>::max() / cols) {
+                throw py::value_error("Matrix dimensions do not match the array sizes");
+            }
+            out = make_result_array(rows * cols, data);
+        } else {
+            info = py::reinterpret_borrow<py::buffer>(out).request(true);
+            require_c_contiguous<T>(info);
+            require_matrix(static_cast<size_t>(info.size), rows, cols);
+            data = static_cast<T *>(info.ptr);
+        }
+        {
+            py::gil_scoped_release release;
+            gemm(rows, cols, inner, in_a.data(), inner, in_b.data(), cols, data, cols, threads);
+        }
+        return out;
+    }, "Row-major (m x k) @ (k x n) into out (a new flat array.array when omitted)",
+       py::arg("a"), py::arg("b"), py::arg("m"), py::arg("k"), py::arg("n"), py::arg("out") = py::none(),
+       py::arg("threads") = 0);
+}
+
+// 绑定多项式求值：poly_eval_double / poly_eval_float。系数按升幂排列，x 为列表或连续缓冲区，
+// 结果写入 out（省略时新建 array.array，out 可与 x 相同）。计算期间释放 GIL
+template <typename T>
+void bind_poly_eval(py::module &m, const std::string &suffix)
+{
+    m.def(("poly_eval_" + suffix).c_str(), [](py::handle coeffs, py::handle x, py::object out) {
+        ScanInput<T> in_c(coeffs), in_x(x);
+        T *data;
+        py::buffer_info info;
+        if (out.is_none()) {
+            out = make_result_array(in_x.size(), data);
+        } else {
+            info = request_contiguous<T>(py::reinterpret_borrow<py::buffer>(out), true);
+            require_same_length(in_x.size(), static_cast<size_t>(info.size));
+            data = static_cast<T *>(info.ptr);
+        }
+        {
+            py::gil_scoped_release release;
+            poly_eval(in_c.data(), in_c.size(), in_x.data(), data, in_x.size());
+        }
+        return out;
+    }, "Evaluate c[0] + c[1]*x + ... at every x into out (a new array.array when omitted)",
+       py::arg("coeffs"), py::arg("x"), py::arg("out") = py::none());
+}
+
+// 绑定运行统计：instrumentation_stats() 返回 {运算名: dict}，只包含有调用记录的运算。
+// latency 为 (下界 ns, 次数) 列表，只列出非空的桶
+void bind_instrumentation(py::module &m)
+{
+    m.def("instrumentation_enabled", &instrumentation_enabled,
+          "Whether the library was built with ENABLE_INSTRUMENTATION=ON");
+    m.def("instrumentation_stats", [] {
+        py::dict result;
+        for (size_t i = 0; i < static_cast<size_t>(InstrumentedOperation::Count); ++i) {
+            auto op = static_cast<InstrumentedOperation>(i);
+            OperationStats stats = operation_stats(op);
+            if (stats.calls == 0) continue;
+            py::list latency;
+            for (size_t b = 0; b < kLatencyBuckets; ++b) {
+                if (stats.latency[b]) latency.append(py::make_tuple(latency_bucket_floor(b), stats.latency[b]));
+            }
+            py::dict entry;
+            entry["calls"] = stats.calls;
+            entry["errors"] = stats.errors;
+            entry["bytes"] = stats.bytes;
+            entry["total_ns"] = stats.total_ns;
+            entry["p50_ns"] = latency_percentile(stats, 0.5);
+            entry["p99_ns"] = latency_percentile(stats, 0.99);
+            entry["max_ns"] = latency_percentile(stats, 1.0);
+            entry["latency"] = latency;
+            result[operation_name(op)] = entry;
+        }
+        return result;
+    }, "Per-operation calls, errors, bytes, total_ns, p50/p99/max latency and non-empty latency buckets");
+    m.def("instrumentation_error_codes", [] {
+        py::dict result;
+        for (size_t code = 1; code < kErrorCodeSlots; ++code) {
+            uint64_t count = error_code_count(static_cast<int>(code));
+            if (count) result[py::int_(code)] = count;
+        }
+        return result;
+    }, "How often the C API mapped an exception to each CalculatorError code");
+    m.def("reset_instrumentation", &reset_instrumentation, "Zero all instrumentation counters");
+}
+
+// 共享内存计算服务的客户端。CalcClient 只能由一个线程使用，而调用期间释放了 GIL，
+// 因此由互斥锁串行化；close() 之后（或对象回收时）归还槽位
+struct PyCalcClient
+{
+    explicit PyCalcClient(const std::string &name) : client(new CalcClient(name)) {}
+
+    CalcClient &get()
+    {
+        if (!client) throw py::value_error("calculation server client is closed");
+        return *client;
+    }
+
+    std::unique_ptr<CalcClient> client;
+    std::mutex mutex;
+};
+
+// 请求按行主序连续存放的缓冲区（任意维数、任意元素类型），数组参数须位于已注册的段内
+static py::buffer_info shm_buffer(py::buffer buf, bool writable = false)
+{
+    py::buffer_info info = buf.request(writable);
+    py::ssize_t stride = info.itemsize;
+    for (py::ssize_t d = info.ndim; d-- > 0;) {
+        if (info.shape[d] > 1 && info.strides[d] != stride) {
+            throw py::type_error("Expected a C-contiguous buffer");
+        }
+        stride *= info.shape[d];
+    }
+    return info;
+}
+
+static uint32_t shm_dtype(const py::buffer_info &info)
+{
+    if (info.format == py::format_descriptor<int32_t>::format()) return CALC_SHM_INT32;
+    if (info.format == py::format_descriptor<float>::format()) return CALC_SHM_FLOAT;
+    if (info.format == py::format_descriptor<double>::format()) return CALC_SHM_DOUBLE;
+    throw py::type_error("Expected a buffer of int32, float32 or float64 elements");
+}
+
+static void require_same_dtype(const py::buffer_info &a, const py::buffer_info &b)
+{
+    if (shm_dtype(a) != shm_dtype(b)) {
+        throw py::type_error("Input buffers must have the same element type");
+    }
+}
+
+// 在锁内把缓冲区转换为请求参数并同步调用；服务端的错误状态转换为 CalculatorException
+static CalcShmCompletion shm_call(PyCalcClient &c, CalcShmRequest request,
+                                  std::initializer_list<const py::buffer_info *> args)
+{
+    py::gil_scoped_release release;
+    std::lock_guard<std::mutex> lock(c.mutex);
+    CalcClient &client = c.get();
+    size_t i = 0;
+    for (const py::buffer_info *info : args) {
+        request.args[i++] = client.operand(info->ptr, static_cast<size_t>(info->size),
+                                           static_cast<size_t>(info->itemsize));
+    }
+    return client.call(request);
+}
+
+static CalcShmRequest shm_request(uint32_t op, uint32_t dtype)
+{
+    CalcShmRequest request{};
+    request.op = op;
+    request.dtype = dtype;
+    return request;
+}
+
+// sum / min / max：int32 得到 int，其它得到 float
+static py::object shm_reduce(PyCalcClient &c, py::buffer x, uint32_t op)
+{
+    py::buffer_info in = shm_buffer(x);
+    uint32_t dtype = shm_dtype(in);
+    CalcShmCompletion done = shm_call(c, shm_request(op, dtype), {&in});
+    if (dtype == CALC_SHM_INT32) return py::int_(done.int_value);
+    return py::float_(done.value);
+}
+
+// 绑定共享内存计算服务：CalcServer 在本进程中运行服务，CalcClient 从任意进程连接。
+// 客户端的运算参数是位于 register 过的段内的缓冲区（如 multiprocessing.shared_memory 上的 numpy 数组），
+// 结果原地写入共享内存；调用期间释放 GIL
+void bind_calc_server(py::module &m)
+{
+    py::class_<CalcServer>(m, "CalcServer")
+        .def(py::init([](const std::string &name, unsigned slots, unsigned ring_capacity, unsigned workers,
+                         unsigned threads) {
+            CalcServerOptions options;
+            options.slots = slots;
+            options.ring_capacity = ring_capacity;
+            options.workers = workers;
+            options.threads = threads;
+            return new CalcServer(name, options);
+        }), py::arg("name"), py::arg("slots") = CalcServerOptions().slots,
+            py::arg("ring_capacity") = CalcServerOptions().ring_capacity,
+            py::arg("workers") = CalcServerOptions().workers, py::arg("threads") = 0)
+        .def("stop", &CalcServer::stop, "Stop the dispatcher threads; waiting clients get an error",
+             py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("name", &CalcServer::name)
+        .def_property_readonly("completed", &CalcServer::completedCount)
+        .def_property_readonly("clients", &CalcServer::clientCount);
+
+    py::class_<PyCalcClient>(m, "CalcClient")
+        .def(py::init<const std::string &>(), py::arg("name"))
+        .def("close", [](PyCalcClient &c) {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(c.mutex);
+            c.client.reset();
+        }, "Release the server slot")
+        .def("register", [](PyCalcClient &c, py::buffer buf, const std::string &name) {
+            py::buffer_info info = shm_buffer(buf);
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(c.mutex);
+            return c.get().registerSegment(name, info.ptr, static_cast<size_t>(info.size * info.itemsize));
+        }, "Register the whole mapping of shared memory segment name (e.g. SharedMemory.buf); returns its index",
+           py::arg("buffer"), py::arg("name"))
+        .def("unregister", [](PyCalcClient &c, uint32_t segment) {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(c.mutex);
+            c.get().unregisterSegment(segment);
+        }, "Unmap a registered segment on the server", py::arg("segment"))
+        .def("sum", [](PyCalcClient &c, py::buffer x) { return shm_reduce(c, x, CALC_SHM_OP_SUM); },
+             "Sum of an int32 or float64 buffer", py::arg("x"))
+        .def("min", [](PyCalcClient &c, py::buffer x) { return shm_reduce(c, x, CALC_SHM_OP_MIN); },
+             "Minimum of an int32 or float64 buffer", py::arg("x"))
+        .def("max", [](PyCalcClient &c, py::buffer x) { return shm_reduce(c, x, CALC_SHM_OP_MAX); },
+             "Maximum of an int32 or float64 buffer", py::arg("x"))
+        .def("dot", [](PyCalcClient &c, py::buffer x, py::buffer y) {
+            py::buffer_info in_x = shm_buffer(x), in_y = shm_buffer(y);
+            require_same_dtype(in_x, in_y);
+            return shm_call(c, shm_request(CALC_SHM_OP_DOT, shm_dtype(in_x)), {&in_x, &in_y}).value;
+        }, "Dot product", py::arg("x"), py::arg("y"))
+        .def("norm", [](PyCalcClient &c, py::buffer x) {
+            py::buffer_info in = shm_buffer(x);
+            return shm_call(c, shm_request(CALC_SHM_OP_NORM, shm_dtype(in)), {&in}).value;
+        }, "Euclidean norm", py::arg("x"))
+        .def("axpy", [](PyCalcClient &c, double a, py::buffer x, py::buffer y) {
+            py::buffer_info in_x = shm_buffer(x), out = shm_buffer(y, true);
+            require_same_dtype(in_x, out);
+            CalcShmRequest request = shm_request(CALC_SHM_OP_AXPY, shm_dtype(in_x));
+            request.scalar = a;
+            shm_call(c, request, {&in_x, &out});
+        }, "y = a * x + y in place", py::arg("a"), py::arg("x"), py::arg("y"))
+        .def("scale", [](PyCalcClient &c, double a, py::buffer x) {
+            py::buffer_info out = shm_buffer(x, true);
+            CalcShmRequest request = shm_request(CALC_SHM_OP_SCALE, shm_dtype(out));
+            request.scalar = a;
+            shm_call(c, request, {&out});
+        }, "x = a * x in place", py::arg("a"), py::arg("x"))
+        .def("fma", [](PyCalcClient &c, py::buffer a, py::buffer b, py::buffer cc, py::buffer out) {
+            py::buffer_info in_a = shm_buffer(a), in_b = shm_buffer(b), in_c = shm_buffer(cc);
+            py::buffer_info result = shm_buffer(out, true);
+            require_same_dtype(in_a, in_b);
+            require_same_dtype(in_a, in_c);
+            require_same_dtype(in_a, result);
+            shm_call(c, shm_request(CALC_SHM_OP_FMA, shm_dtype(in_a)), {&in_a, &in_b, &in_c, &result});
+        }, "out = a * b + c element-wise", py::arg("a"), py::arg("b"), py::arg("c"), py::arg("out"))
+        .def("poly_eval", [](PyCalcClient &c, py::buffer coeffs, py::buffer x, py::buffer out) {
+            py::buffer_info in_c = shm_buffer(coeffs), in_x = shm_buffer(x), result = shm_buffer(out, true);
+            require_same_dtype(in_c, in_x);
+            require_same_dtype(in_c, result);
+            shm_call(c, shm_request(CALC_SHM_OP_POLY_EVAL, shm_dtype(in_x)), {&in_c, &in_x, &result});
+        }, "out = c[0] + c[1]*x + ... (coefficients in ascending order)",
+           py::arg("coeffs"), py::arg("x"), py::arg("out"))
+        .def("matmul", [](PyCalcClient &c, py::buffer a, py::buffer b, py::buffer out, uint64_t rows,
+                          uint64_t inner, uint64_t cols) {
+            py::buffer_info in_a = shm_buffer(a), in_b = shm_buffer(b), result = shm_buffer(out, true);
+            require_same_dtype(in_a, in_b);
+            require_same_dtype(in_a, result);
+            CalcShmRequest request = shm_request(CALC_SHM_OP_MATMUL, shm_dtype(in_a));
+            request.dims[0] = rows;
+            request.dims[1] = inner;
+            request.dims[2] = cols;
+            shm_call(c, request, {&in_a, &in_b, &result});
+        }, "Row-major (m x k) @ (k x n) into out, which must not overlap the inputs",
+           py::arg("a"), py::arg("b"), py::arg("out"), py::arg("m"), py::arg("k"), py::arg("n"))
+        .def("sort", [](PyCalcClient &c, py::buffer x) {
+            py::buffer_info data = shm_buffer(x, true);
+            shm_call(c, shm_request(CALC_SHM_OP_SORT, shm_dtype(data)), {&data});
+        }, "Sort in place", py::arg("x"))
+        .def("prefix_sum", [](PyCalcClient &c, py::buffer x, py::buffer out, bool exclusive) {
+            py::buffer_info in = shm_buffer(x), result = shm_buffer(out, true);
+            uint32_t dtype = shm_dtype(in);
+            // int32 的前缀和输出为 int64（numpy 的格式为 "l"，pybind11 为 "q"）
+            bool matches = dtype == CALC_SHM_INT32
+                ? result.itemsize == 8 && (result.format == "l" || result.format == "q")
+                : dtype == CALC_SHM_DOUBLE && result.format == in.format;
+            if (!matches) {
+                throw py::type_error("prefix_sum needs int32 -> int64 or float64 -> float64 buffers");
+            }
+            CalcShmRequest request = shm_request(CALC_SHM_OP_PREFIX_SUM, dtype);
+            request.dims[0] = exclusive ? 1 : 0;
+            shm_call(c, request, {&in, &result});
+        }, "Inclusive or exclusive prefix sum into out", py::arg("x"), py::arg("out"), py::arg("exclusive") = false)
+        .def_property_readonly("closed", [](const PyCalcClient &c) { return !c.client; });
+}
+
 PYBIND11_MODULE(cpp_calculator_py, m) {
     m.doc() = "Python bindings for C++ Calculator library";
 
     // 绑定 CalculatorException
     py::register_exception<CalculatorException>(m, "CalculatorException");
 
+    m.def("read_journal", &read_journal, py::arg("path"),
+          "Read a history journal file as a list of (timestamp_ns, entry) tuples");
+
+    // 历史只读视图（支持 len / 下标 / 切片 / 迭代，随计算器实时变化）
+    py::class_<HistoryView>(m, "HistoryView")
+        .def("__len__", [](const HistoryView &v) { return v.entries().size(); })
+        .def("__getitem__", [](const HistoryView &v, py::ssize_t index) {
+            py::ssize_t size = static_cast<py::ssize_t>(v.entries().size());
+            if (index < 0) index += size;
+            if (index < 0 || index >= size) throw py::index_error("history index out of range");
+            return v.entries()[static_cast<size_t>(index)];
+        })
+        .def("__getitem__", [](const HistoryView &v, py::slice slice) {
+            size_t start, stop, step, length;
+            if (!slice.compute(v.entries().size(), &start, &stop, &step, &length)) {
+                throw py::error_already_set();
+            }
+            py::list out(length);
+            for (size_t i = 0; i < length; ++i, start += step) {
+                out[i] = py::str(v.entries()[start]);
+            }
+            return out;
+        })
+        .def("__iter__", [](const HistoryView &v) {
+            return HistoryIterator{v, 0};
+        }, py::keep_alive<0, 1>());
+
+    py::class_<HistoryIterator>(m, "HistoryIterator")
+        .def("__iter__", [](HistoryIterator &it) -> HistoryIterator & { return it; },
+             py::return_value_policy::reference_internal)
+        .def("__next__", [](HistoryIterator &it) {
+            const std::vector<std::string> &entries = it.view.entries();
+            if (it.index >= entries.size()) throw py::stop_iteration();
+            return entries[it.index++];
+        });
+
     // 绑定基础计算器类
     py::class_<Calculator>(m, "Calculator")
         .def(py::init<>())
@@ -21,6 +781,16 @@ PYBIND11_MODULE(cpp_calculator_py, m) {
         .def("get_last_result", &Calculator::getLastResult, "Get last calculation result")
         .def("get_history", &Calculator::getHistory, "Get calculation history")
         .def("clear_history", &Calculator::clearHistory, "Clear calculation history")
+        .def("export_history", &export_history_bytes, py::arg("first") = 0, py::arg("count") = py::none(),
+             py::arg("binary") = false,
+             "Serialize history in one call: newline-delimited text, or uint32 length-prefixed records")
+        .def("history_view", [](const Calculator &calc) { return HistoryView{&calc}; },
+             py::keep_alive<0, 1>(), "Read-only view of history that converts entries on access")
+        .def("open_journal", &open_journal, py::arg("path"), py::arg("sync") = "batch",
+             py::arg("ring_bytes") = JournalOptions().ring_bytes,
+             "Append every new history entry to a journal file via a background writer")
+        .def("flush_journal", &flush_journal, "Block until journaled entries are written to disk")
+        .def("close_journal", &close_journal, "Write remaining entries and close the journal")
         .def("get_calculator_type", &Calculator::getCalculatorType, "Get calculator type");
 
     // 绑定高级计算器类
@@ -49,7 +819,93 @@ PYBIND11_MODULE(cpp_calculator_py, m) {
         .def("min_element_double", [](AdvancedCalculator& calc, const std::vector<double>& arr) {
             return calc.min_element(arr);
         }, "Find min in double array")
-        .def("batch_add", &AdvancedCalculator::batch_add, "Batch add operation");
+        .def("argmax_int", [](AdvancedCalculator& calc, const std::vector<int32_t>& arr) {
+            return calc.argmax(arr);
+        }, "Index of the first maximum in integer array")
+        .def("argmin_int", [](AdvancedCalculator& calc, const std::vector<int32_t>& arr) {
+            return calc.argmin(arr);
+        }, "Index of the first minimum in integer array")
+        .def("top_k_int", [](AdvancedCalculator& calc, const std::vector<int32_t>& arr, size_t k) {
+            return calc.top_k(arr, k);
+        }, "Indices of the k largest elements, largest first", py::arg("arr"), py::arg("k"))
+        .def("percentile_int", [](AdvancedCalculator& calc, const std::vector<int32_t>& arr, double q) {
+            return calc.percentile(arr, q);
+        }, "Linearly interpolated percentile, q in [0, 1]", py::arg("arr"), py::arg("q"))
+        .def("median_int", [](AdvancedCalculator& calc, const std::vector<int32_t>& arr) {
+            return calc.median(arr);
+        }, "Median of integer array")
+        .def("argmax_double", [](AdvancedCalculator& calc, const std::vector<double>& arr) {
+            return calc.argmax(arr);
+        }, "Index of the first maximum in double array")
+        .def("argmin_double", [](AdvancedCalculator& calc, const std::vector<double>& arr) {
+            return calc.argmin(arr);
+        }, "Index of the first minimum in double array")
+        .def("top_k_double", [](AdvancedCalculator& calc, const std::vector<double>& arr, size_t k) {
+            return calc.top_k(arr, k);
+        }, "Indices of the k largest elements, largest first", py::arg("arr"), py::arg("k"))
+        .def("percentile_double", [](AdvancedCalculator& calc, const std::vector<double>& arr, double q) {
+            return calc.percentile(arr, q);
+        }, "Linearly interpolated percentile, q in [0, 1]", py::arg("arr"), py::arg("q"))
+        .def("median_double", [](AdvancedCalculator& calc, const std::vector<double>& arr) {
+            return calc.median(arr);
+        }, "Median of double array")
+        .def("batch_add", &AdvancedCalculator::batch_add, "Batch add operation")
+        .def("sum_file_int", &AdvancedCalculator::sum_file_int32, "Sum a raw int32 file via mmap",
+             py::call_guard<py::gil_scoped_release>())
+        .def("max_file_int", &AdvancedCalculator::max_file_int32, "Find max in a raw int32 file via mmap",
+             py::call_guard<py::gil_scoped_release>())
+        .def("min_file_int", &AdvancedCalculator::min_file_int32, "Find min in a raw int32 file via mmap",
+             py::call_guard<py::gil_scoped_release>())
+        .def("sum_file_double", &AdvancedCalculator::sum_file_double, "Sum a raw double file via mmap",
+             py::call_guard<py::gil_scoped_release>())
+        .def("max_file_double", &AdvancedCalculator::max_file_double, "Find max in a raw double file via mmap",
+             py::call_guard<py::gil_scoped_release>())
+        .def("min_file_double", &AdvancedCalculator::min_file_double, "Find min in a raw double file via mmap",
+             py::call_guard<py::gil_scoped_release>())
+        .def("sum_arrow", [](AdvancedCalculator& calc, uintptr_t array_ptr, uintptr_t schema_ptr) {
+            return calc.sum_column(arrow_view(array_ptr, schema_ptr));
+        }, "Sum an Arrow C Data Interface array, skipping nulls", py::arg("array_ptr"), py::arg("schema_ptr"))
+        .def("max_arrow", [](AdvancedCalculator& calc, uintptr_t array_ptr, uintptr_t schema_ptr) {
+            return calc.max_column(arrow_view(array_ptr, schema_ptr));
+        }, "Find max in an Arrow array, skipping nulls", py::arg("array_ptr"), py::arg("schema_ptr"))
+        .def("min_arrow", [](AdvancedCalculator& calc, uintptr_t array_ptr, uintptr_t schema_ptr) {
+            return calc.min_column(arrow_view(array_ptr, schema_ptr));
+        }, "Find min in an Arrow array, skipping nulls", py::arg("array_ptr"), py::arg("schema_ptr"))
+        .def("batch_add_arrow", [](AdvancedCalculator& calc, uintptr_t array_ptr, uintptr_t schema_ptr, double addend) {
+            ArrowColumnView column = arrow_view(array_ptr, schema_ptr);
+            std::vector<double> results(column.length());
+            std::string validity((column.length() + 7) / 8, '\0');
+            calc.batch_add_column(column, addend, results.data(), reinterpret_cast<uint8_t*>(&validity[0]));
+            return py::make_tuple(results, py::bytes(validity));
+        }, "Add addend to an Arrow array; returns (values, validity bitmap)",
+           py::arg("array_ptr"), py::arg("schema_ptr"), py::arg("addend"))
+        .def("batch_add_file", &AdvancedCalculator::batch_add_file,
+             "Add addend to every double in input file, writing results to output file via mmap",
+             py::arg("input_path"), py::arg("output_path"), py::arg("addend"),
+             py::call_guard<py::gil_scoped_release>());
+
+    // 绑定流式累加器
+    bind_accumulators<int32_t>(m, "Int");
+    bind_accumulators<double>(m, "Double");
+
+    // 绑定前缀扫描和滑动窗口
+    bind_scans<int32_t>(m, "int");
+    bind_scans<double>(m, "double");
+    bind_sorts<int32_t>(m, "int");
+    bind_sorts<float>(m, "float");
+    bind_sorts<double>(m, "double");
+    bind_histogram<int32_t>(m, "int");
+    bind_histogram<double>(m, "double");
+    bind_group_by<int32_t>(m, "int");
+    bind_group_by<double>(m, "double");
+    bind_blas<float>(m, "float");
+    bind_blas<double>(m, "double");
+    bind_matmul<float>(m, "float");
+    bind_matmul<double>(m, "double");
+    bind_poly_eval<float>(m, "float");
+    bind_poly_eval<double>(m, "double");
+    bind_instrumentation(m);
+    bind_calc_server(m);
 
     // 绑定操作基类
     py::class_<Operation>(m, "Operation")
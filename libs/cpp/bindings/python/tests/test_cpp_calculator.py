@@ -3,6 +3,7 @@ Tests for C++ Calculator Python bindings.
 """
 
 import pytest
+import struct
 import sys
 import os
 
@@ -17,6 +18,22 @@ except ImportError:
     CppCalculator = None
 
 
+def _server_dot_worker(server_name, shm_name, n, results):
+    """Worker process: attach to the shared segment and compute through its own client."""
+    import numpy as np
+    from multiprocessing import shared_memory
+    shm = shared_memory.SharedMemory(name=shm_name)
+    try:
+        client = CppCalculator().connect_server(server_name)
+        client.register(shm.buf, shm.name)
+        x = np.ndarray((2, n), dtype=np.float64, buffer=shm.buf)
+        results.put(client.dot(x[0], x[1]))
+        del x
+        client.close()
+    finally:
+        shm.close()
+
+
 @pytest.mark.skipif(not CPP_BINDINGS_AVAILABLE, reason="C++ Python bindings not available")
 class TestCppCalculator:
     """Test C++ Calculator Python bindings."""
@@ -57,6 +74,60 @@ class TestCppCalculator:
         assert "5 - 3 = 2" in history
         assert "2 * 4 = 8" in history
 
+    def test_history_export(self):
+        """Test bulk history export and the read-only view."""
+        self.calc.add(1, 2)
+        self.calc.subtract(5, 3)
+        self.calc.multiply(2, 4)
+
+        assert self.calc.export_history() == b"1 + 2 = 3\n5 - 3 = 2\n2 * 4 = 8\n"
+        assert self.calc.export_history(1, 1) == b"5 - 3 = 2\n"
+
+        data = self.calc.export_history(binary=True)
+        records, offset = [], 0
+        while offset < len(data):
+            (length,) = struct.unpack_from("=I", data, offset)
+            records.append(data[offset + 4:offset + 4 + length].decode())
+            offset += 4 + length
+        assert records == self.calc.get_history()
+
+        view = self.calc.history_view()
+        assert len(view) == 3
+        assert view[0] == "1 + 2 = 3"
+        assert view[-1] == "2 * 4 = 8"
+        assert view[1:] == ["5 - 3 = 2", "2 * 4 = 8"]
+        assert list(view) == self.calc.get_history()
+        with pytest.raises(IndexError):
+            view[3]
+
+        # 迭代期间历史增长（vector 重新分配）：按下标遍历，不会悬空，新条目也被遍历到
+        seen = []
+        for entry in view:
+            seen.append(entry)
+            if len(seen) == 1:
+                for _ in range(100):
+                    self.calc.add(1, 2)
+        assert len(seen) == 103 and seen[-1] == "1 + 2 = 3"
+
+    def test_history_journal(self, tmp_path):
+        """Test persisting history through the journal."""
+        path = str(tmp_path / "history.journal")
+        self.calc.open_journal(path, sync="none")
+        self.calc.add(1, 2)
+        self.calc.multiply(3, 4)
+        self.calc.flush_journal()
+        self.calc.clear_history()
+        self.calc.subtract(9, 4)
+        self.calc.close_journal()
+        self.calc.add(5, 5)  # 关闭后不再写入
+
+        records = self.calc.read_journal(path)
+        assert [entry for _, entry in records] == ["1 + 2 = 3", "3 * 4 = 12", "9 - 4 = 5"]
+        assert all(ts > 0 for ts, _ in records)
+
+        with pytest.raises(ValueError):
+            self.calc.flush_journal()
+
     def test_clear_history(self):
         """Test clearing history."""
         self.calc.add(1, 1)
@@ -149,6 +220,335 @@ class TestCppCalculator:
         expected = [11.0, 12.0, 13.0, 14.0]
         assert result == expected
 
+    def test_file_operations(self, tmp_path):
+        """Test mmap-backed file reductions and batch add."""
+        import array
+        int_path = tmp_path / "ints.bin"
+        int_path.write_bytes(array.array("i", [4, -2, 9, 7]).tobytes())
+        assert self.calc.sum_file(str(int_path), "int32") == 18
+        assert self.calc.max_file(str(int_path), "int32") == 9
+        assert self.calc.min_file(str(int_path), "int32") == -2
+
+        in_path = tmp_path / "in.bin"
+        out_path = tmp_path / "out.bin"
+        in_path.write_bytes(array.array("d", [1.5, 2.5, 3.0]).tobytes())
+        assert abs(self.calc.sum_file(str(in_path)) - 7.0) < 1e-9
+        assert self.calc.batch_add_file(str(in_path), str(out_path), 10) == 3
+        assert list(array.array("d", out_path.read_bytes())) == [11.5, 12.5, 13.0]
+
+    def test_file_errors(self, tmp_path):
+        """Test missing and empty files."""
+        with pytest.raises(OSError):
+            self.calc.sum_file(str(tmp_path / "missing.bin"))
+
+        empty = tmp_path / "empty.bin"
+        empty.write_bytes(b"")
+        assert self.calc.sum_file(str(empty)) == 0
+        with pytest.raises(ValueError):
+            self.calc.max_file(str(empty))
+
+    def test_accumulators(self):
+        """Test chunked accumulators and merging."""
+        import array
+        acc = self.calc.create_accumulator("sum", "int32")
+        acc.update([1, 2, 3])
+        acc.update(array.array("i", [4, 5]))
+        assert acc.result() == 15
+        assert acc.count == 5
+
+        left = self.calc.create_accumulator("stats")
+        right = self.calc.create_accumulator("stats")
+        left.update([1.0, 2.0])
+        right.update([3.0, 4.0])
+        left.merge(right)
+        assert left.count == 4
+        assert abs(left.mean() - 2.5) < 1e-12
+        assert abs(left.variance() - 1.25) < 1e-12
+
+        empty = self.calc.create_accumulator("max")
+        with pytest.raises(Exception):
+            empty.result()
+
+    def test_scans(self):
+        """Test prefix sums, cumulative extrema and sliding windows."""
+        import array
+        values = [3, 1, 4, 1, 5, 9, 2, 6]
+        assert list(self.calc.prefix_sum(values, "int32")) == [3, 4, 8, 9, 14, 23, 25, 31]
+        assert list(self.calc.prefix_sum(values, "int32", exclusive=True)) == [0, 3, 4, 8, 9, 14, 23, 25]
+        assert list(self.calc.cumulative_max(array.array("d", values))) == [3, 3, 4, 4, 5, 9, 9, 9]
+        assert list(self.calc.window_sum(values, 3, "int32")) == [8, 6, 10, 15, 16, 17]
+        assert list(self.calc.window_min(values, 3)) == [1, 1, 1, 1, 2, 2]
+        assert list(self.calc.window_max(array.array("i", values), 3, "int32")) == [4, 4, 9, 9, 9, 9]
+
+        # 多线程分块结果与逐窗口计算一致
+        big = [(i * 7919) % 1000 - 500 for i in range(200000)]
+        sums = self.calc.window_sum(big, 50, "int32", threads=4)
+        assert len(sums) == len(big) - 49
+        assert sums[12345] == sum(big[12345:12395])
+        assert self.calc.prefix_sum(big, "int32", threads=4)[-1] == sum(big)
+
+        # 滑出窗口的 inf / 大数不影响后面的窗口
+        assert list(self.calc.window_sum([float("inf"), 1, 1, 1, 1, 1], 2))[1:] == [2, 2, 2, 2]
+        assert list(self.calc.window_sum([1e20, 1, 1, 1, 1], 2)) == [1e20, 2, 2, 2]
+
+        with pytest.raises(ValueError):
+            self.calc.window_sum(values, 9)
+        with pytest.raises(ValueError):
+            self.calc.window_max(values, 0)
+        with pytest.raises(TypeError):
+            self.calc.prefix_sum(array.array("d", values), "int32")
+
+    def test_selection(self):
+        """Test argmin/argmax, top-k and percentiles."""
+        values = [3, 1, 4, 1, 5, 9, 2, 6]
+        assert self.calc.argmax(values) == 5
+        assert self.calc.argmin(values) == 1
+        assert self.calc.top_k(values, 3) == [5, 7, 4]
+        assert self.calc.top_k([2, 7, 2, 7], 3) == [1, 3, 0]
+        assert self.calc.top_k(values, 20) == [5, 7, 4, 2, 0, 6, 1, 3]
+        assert self.calc.median(values) == 3.5
+        assert self.calc.percentile([2.5, -1.0, 3.0, -4.5], 0.75) == pytest.approx(2.625)
+        assert self.calc.percentile(values, 0.0) == 1
+        assert self.calc.percentile(values, 1.0) == 9
+
+        with pytest.raises(ValueError):
+            self.calc.argmax([])
+        with pytest.raises(ValueError):
+            self.calc.percentile(values, 1.5)
+
+    def test_sort_and_histogram(self):
+        """Test radix/merge sorts and fixed-bin histograms."""
+        import array
+        import random
+        values = [3, -1, 4, 1, -5, 9, 2, 6]
+        assert list(self.calc.sort(values, "int32")) == sorted(values)
+        assert list(self.calc.sort([2.5, -0.5, 1.0], "float32")) == [-0.5, 1.0, 2.5]
+
+        buf = array.array("i", values)
+        assert self.calc.sort(buf, "int32", in_place=True) is None
+        assert list(buf) == sorted(values)
+
+        rng = random.Random(7)
+        big = [rng.uniform(-1e6, 1e6) for _ in range(300000)] + [float("nan")]
+        result = self.calc.sort(big, threads=4)
+        assert list(result[:-1]) == sorted(big[:-1])
+        assert result[-1] != result[-1]
+
+        assert list(self.calc.histogram([0, 1, 2, 3, 4, 10, -1], 0, 4, 4, "int32")) == [1, 1, 1, 2]
+        assert list(self.calc.histogram(big, -1e6, 1e6, 2)) == [
+            sum(1 for x in big if -1e6 <= x < 0), sum(1 for x in big if 0 <= x <= 1e6)]
+
+        with pytest.raises(ValueError):
+            self.calc.histogram(values, 1, 0, 4, "int32")
+        with pytest.raises(ValueError):
+            self.calc.histogram(values, 0, 1, 4, "float32")
+        with pytest.raises(TypeError):
+            self.calc.sort(array.array("d", values), "int32", in_place=True)
+
+    def test_group_by(self):
+        """Test grouped sum/min/max/count on dense and sparse keys."""
+        import array
+        keys = [3, 1, 3, 2, 1, 3]
+        values = [1.5, 2.0, -1.0, 4.0, 0.5, 2.5]
+        groups = self.calc.group_by(keys, values)
+        assert list(groups["key"]) == [1, 2, 3]
+        assert list(groups["sum"]) == [2.5, 4.0, 3.0]
+        assert list(groups["min"]) == [0.5, 4.0, -1.0]
+        assert list(groups["max"]) == [2.0, 4.0, 2.5]
+        assert list(groups["count"]) == [2, 1, 3]
+
+        # 键分布稀疏时走哈希表；数据量大时按哈希分区多线程聚合
+        big_keys = array.array("i", [(i * 2654435761) % 1000 * 100003 for i in range(200000)])
+        big_values = [i % 17 for i in range(200000)]
+        groups = self.calc.group_by(big_keys, big_values, "int32", threads=4)
+        assert len(groups["key"]) == 1000
+        assert list(groups["key"]) == sorted(set(big_keys))
+        assert sum(groups["count"]) == 200000
+        assert sum(groups["sum"]) == sum(big_values)
+
+        with pytest.raises(ValueError):
+            self.calc.group_by([1, 2], [1.0])
+
+    def test_blas(self):
+        """Test dot/axpy/scale/norm/fma on lists, array.array and numpy buffers."""
+        import array
+        x = [1.0, 2.0, 3.0, 4.0]
+        y = array.array("d", [0.5, -1.0, 2.0, 1.0])
+        assert self.calc.dot(x, y) == 8.5
+        assert self.calc.norm([3.0, 4.0]) == 5.0
+        self.calc.axpy(2.0, x, y)
+        assert list(y) == [2.5, 3.0, 8.0, 9.0]
+        self.calc.scale(0.5, y)
+        assert list(y) == [1.25, 1.5, 4.0, 4.5]
+        assert list(self.calc.fma(x, x, [1.0] * 4)) == [2.0, 5.0, 10.0, 17.0]
+
+        # float32 与 numpy：原地更新，fma 写入 out
+        np = pytest.importorskip("numpy")
+        a = np.arange(1000, dtype=np.float32)
+        b = np.full(1000, 0.5, dtype=np.float32)
+        assert self.calc.dot(a, b, "float32") == float(np.dot(a, b))
+        self.calc.axpy(-1.0, b, a, "float32")
+        assert a[0] == -0.5 and a[999] == 998.5
+        out = np.empty(1000)
+        self.calc.fma(np.arange(1000.0), np.arange(1000.0), np.ones(1000), out=out)
+        assert out[999] == 999.0 * 999.0 + 1.0
+
+        with pytest.raises(ValueError):
+            self.calc.dot([1.0, 2.0], [1.0])
+        with pytest.raises(ValueError):
+            self.calc.norm([1, 2], "int32")
+
+    def test_matmul(self):
+        """Test matmul on nested lists, 2-D memoryviews and numpy arrays."""
+        import array
+        a = [[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]]
+        b = [[1.0, 0.0], [0.0, 1.0], [1.0, 1.0]]
+        assert self.calc.matmul(a, b) == [[4.0, 5.0], [10.0, 11.0]]
+        assert self.calc.matmul(a, b, "float32") == [[4.0, 5.0], [10.0, 11.0]]
+
+        view_a = memoryview(array.array("d", [1.0, 2.0, 3.0, 4.0, 5.0, 6.0])).cast("B").cast("d", (2, 3))
+        view_b = memoryview(array.array("d", [1.0, 0.0, 0.0, 1.0, 1.0, 1.0])).cast("B").cast("d", (3, 2))
+        assert self.calc.matmul(view_a, view_b).tolist() == [[4.0, 5.0], [10.0, 11.0]]
+
+        # numpy：与 np.matmul 比较（小整数数据结果精确），结果写入 out
+        np = pytest.importorskip("numpy")
+        x = (np.arange(97 * 45) % 9 - 4).astype(np.float32).reshape(97, 45)
+        y = (np.arange(45 * 70) % 7 - 3).astype(np.float32).reshape(45, 70)
+        out = np.empty((97, 70), dtype=np.float32)
+        assert self.calc.matmul(x, y, "float32", out=out) is out
+        assert np.array_equal(out, x @ y)
+        assert np.array_equal(np.asarray(self.calc.matmul(x.astype(np.float64), y.astype(np.float64))), x @ y)
+
+        with pytest.raises(ValueError):
+            self.calc.matmul(a, a)
+        with pytest.raises(ValueError):
+            self.calc.matmul([[1.0, 2.0], [3.0]], b)
+
+    def test_poly_eval(self):
+        """Test poly_eval on lists, array.array (in place) and numpy buffers."""
+        import array
+        assert list(self.calc.poly_eval([1.0, -2.0, 3.0], [0.0, 1.0, 2.0, -1.0])) == [1.0, 2.0, 9.0, 6.0]
+        assert list(self.calc.poly_eval([], [1.0, 2.0])) == [0.0, 0.0]
+        x = array.array("f", [0.5, 2.0, -3.0])
+        assert self.calc.poly_eval([0.0, 0.0, 0.0, 1.0], x, "float32", out=x) is x
+        assert list(x) == [0.125, 8.0, -27.0]
+
+        # numpy：与逐项 Horner 比较（二进小数数据结果精确）
+        np = pytest.importorskip("numpy")
+        points = (np.arange(1001) % 9 - 4) * 0.5
+        coeffs = [float(j % 5 - 2) for j in range(10)]
+        expected = np.zeros_like(points)
+        for c in reversed(coeffs):
+            expected = expected * points + c
+        assert np.array_equal(np.asarray(self.calc.poly_eval(coeffs, points)), expected)
+
+        with pytest.raises(ValueError):
+            self.calc.poly_eval([1, 2], [1, 2], "int32")
+
+    def test_instrumentation(self):
+        """Test per-operation counters (empty unless built with ENABLE_INSTRUMENTATION=ON)."""
+        self.calc.reset_instrumentation()
+        self.calc.sum_array([1.0, 2.0, 3.0])
+        with pytest.raises(ZeroDivisionError):
+            self.calc.divide(1, 0)
+        stats = self.calc.instrumentation_stats()
+        if not self.calc.instrumentation_enabled():
+            assert stats == {}
+            return
+        assert stats["sum_array"]["calls"] == 1
+        assert stats["sum_array"]["bytes"] == 24
+        assert stats["divide"]["errors"] == 1
+        assert sum(count for _, count in stats["divide"]["latency"]) == 1
+        assert stats["divide"]["p50_ns"] <= stats["divide"]["max_ns"]
+        # 清零后不再包含任何运算
+        self.calc.reset_instrumentation()
+        assert self.calc.instrumentation_stats() == {}
+
+    def test_calc_server(self):
+        """Test the shared-memory calculation server from this and a forked worker process."""
+        np = pytest.importorskip("numpy")
+        import multiprocessing
+        from multiprocessing import shared_memory
+
+        server_name = f"calc_py_server_{os.getpid()}"
+        n = 1000
+        shm = shared_memory.SharedMemory(name=f"{server_name}_data", create=True, size=4 * n * 8)
+        server = self.calc.start_server(server_name, slots=4, workers=2)
+        try:
+            client = self.calc.connect_server(server_name)
+            assert client.register(shm.buf, shm.name) == 0
+            x = np.ndarray((2, n), dtype=np.float64, buffer=shm.buf)
+            x[0] = np.arange(n)
+            x[1] = 2.0
+            assert client.sum(x[0]) == n * (n - 1) / 2
+            assert client.dot(x[0], x[1]) == n * (n - 1)
+            assert client.norm(x[1]) == pytest.approx(2.0 * n ** 0.5)
+
+            # 结果原地写入共享内存
+            y = np.ndarray((n,), dtype=np.float64, buffer=shm.buf, offset=2 * n * 8)
+            y[:] = 1.0
+            client.axpy(3.0, x[0], y)
+            assert y[-1] == 3.0 * (n - 1) + 1.0
+            ints = np.ndarray((n,), dtype=np.int32, buffer=shm.buf, offset=3 * n * 8)
+            ints[:] = np.arange(n, dtype=np.int32)[::-1]
+            assert client.max(ints) == n - 1 and isinstance(client.min(ints), int)
+            client.sort(ints)
+            assert ints[0] == 0 and ints[-1] == n - 1
+            a = np.ndarray((2, 2), dtype=np.float64, buffer=shm.buf)
+            out = np.ndarray((2, 2), dtype=np.float64, buffer=shm.buf, offset=2 * n * 8)
+            client.matmul(a, a, out, 2, 2, 2)
+            assert out.tolist() == [[2.0, 3.0], [6.0, 11.0]]
+
+            # 另一个进程通过自己的连接计算
+            ctx = multiprocessing.get_context("fork")
+            results = ctx.Queue()
+            worker = ctx.Process(target=_server_dot_worker, args=(server_name, shm.name, n, results))
+            worker.start()
+            assert results.get(timeout=30) == n * (n - 1)
+            worker.join(timeout=30)
+            assert worker.exitcode == 0
+
+            # 不在注册段内的数组、空输入
+            with pytest.raises(self.calc._cpp_mod.CalculatorException):
+                client.sum(np.zeros(4))
+            with pytest.raises(self.calc._cpp_mod.CalculatorException, match="empty"):
+                client.min(x[0][:0])
+            with pytest.raises(TypeError):
+                client.sum(x[0][::2])
+            del x, y, ints, a, out
+            client.close()
+            assert client.closed
+        finally:
+            server.stop()
+            shm.close()
+            shm.unlink()
+
+        with pytest.raises(OSError):
+            self.calc.connect_server(server_name)
+
+    def test_arrow_columns(self):
+        """Test Arrow C Data Interface entry points with nulls."""
+        pa = pytest.importorskip("pyarrow")
+        from pyarrow.cffi import ffi
+
+        arr = pa.array([1.5, None, 4.0, None, -2.0], type=pa.float64())
+        c_array = ffi.new("struct ArrowArray*")
+        c_schema = ffi.new("struct ArrowSchema*")
+        array_ptr = int(ffi.cast("uintptr_t", c_array))
+        schema_ptr = int(ffi.cast("uintptr_t", c_schema))
+        arr._export_to_c(array_ptr, schema_ptr)
+        try:
+            adv = self.calc._get_advanced_calculator()
+            assert adv.sum_arrow(array_ptr, schema_ptr) == 3.5
+            assert adv.max_arrow(array_ptr, schema_ptr) == 4.0
+            assert adv.min_arrow(array_ptr, schema_ptr) == -2.0
+            values, validity = adv.batch_add_arrow(array_ptr, schema_ptr, 1.0)
+            assert values[0] == 2.5 and values[2] == 5.0
+            assert validity == bytes([0b10101])
+        finally:
+            c_array.release(c_array)
+            c_schema.release(c_schema)
+
 
 if __name__ == "__main__":
     pytest.main([__file__])
\ No newline at end of file
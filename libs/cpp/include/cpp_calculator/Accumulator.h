@@ -0,0 +1,115 @@
+#ifndef ACCUMULATOR_H
+#define ACCUMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "cpp_calculator/export.h"
+
+// 累加类型：int32 求和用 int64 防止溢出
+template <typename T>
+struct AccumulatorTraits
+{
+    using sum_type = T;
+};
+
+template <>
+struct AccumulatorTraits<int32_t>
+{
+    using sum_type = int64_t;
+};
+
+// 流式归约累加器：数据可以分块多次 update，最后读取结果。
+// 单个累加器不是线程安全的；多线程时每个线程各持一个，最后用 merge 合并。
+
+// 求和
+template <typename T>
+class CPP_CALCULATOR_API SumAccumulator
+{
+public:
+    using sum_type = typename AccumulatorTraits<T>::sum_type;
+
+    SumAccumulator() : count_(0), sum_(0) {}
+
+    void update(const T *data, size_t size);
+    void merge(const SumAccumulator &other);
+    void reset();
+
+    size_t count() const { return count_; }
+    sum_type result() const { return sum_; }
+
+private:
+    size_t count_;
+    sum_type sum_;
+};
+
+// 最小值
+template <typename T>
+class CPP_CALCULATOR_API MinAccumulator
+{
+public:
+    MinAccumulator() : count_(0), min_(0) {}
+
+    void update(const T *data, size_t size);
+    void merge(const MinAccumulator &other);
+    void reset();
+
+    size_t count() const { return count_; }
+    T result() const; // 未输入任何数据时抛出 CalculatorException
+
+private:
+    size_t count_;
+    T min_;
+};
+
+// 最大值
+template <typename T>
+class CPP_CALCULATOR_API MaxAccumulator
+{
+public:
+    MaxAccumulator() : count_(0), max_(0) {}
+
+    void update(const T *data, size_t size);
+    void merge(const MaxAccumulator &other);
+    void reset();
+
+    size_t count() const { return count_; }
+    T result() const; // 未输入任何数据时抛出 CalculatorException
+
+private:
+    size_t count_;
+    T max_;
+};
+
+// 统计量：计数、和、最值、均值与方差（分块 Welford，合并使用 Chan 公式）
+template <typename T>
+class CPP_CALCULATOR_API StatsAccumulator
+{
+public:
+    using sum_type = typename AccumulatorTraits<T>::sum_type;
+
+    StatsAccumulator() : count_(0), sum_(0), min_(0), max_(0), mean_(0.0), m2_(0.0) {}
+
+    void update(const T *data, size_t size);
+    void merge(const StatsAccumulator &other);
+    void reset();
+
+    size_t count() const { return count_; }
+    sum_type sum() const { return sum_; }
+    // 以下在未输入任何数据时抛出 CalculatorException
+    T min() const;
+    T max() const;
+    double mean() const;
+    double variance() const; // 总体方差
+
+private:
+    void checkNotEmpty() const;
+
+    size_t count_;
+    sum_type sum_;
+    T min_;
+    T max_;
+    double mean_;
+    double m2_;
+};
+
+#endif // ACCUMULATOR_H
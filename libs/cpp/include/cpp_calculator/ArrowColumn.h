@@ -0,0 +1,56 @@
+#ifndef ARROW_COLUMN_H
+#define ARROW_COLUMN_H
+
+#include <cstddef>
+#include <cstdint>
+#include "cpp_calculator/arrow_c_data.h"
+#include "cpp_calculator/export.h"
+
+// 支持的 Arrow 基本类型（对应格式串 "i" / "l" / "f" / "g"）
+enum class ArrowColumnType
+{
+    Int32,
+    Int64,
+    Float32,
+    Float64
+};
+
+// 对 Arrow C Data Interface 数组的只读视图（零拷贝，不接管所有权，不调用 release）
+class CPP_CALCULATOR_API ArrowColumnView
+{
+private:
+    ArrowColumnType type_;
+    const void *values_;      // 已包含 offset 的值缓冲区起点
+    const uint8_t *validity_; // 有效位图（LSB 序），nullptr 表示全部有效
+    size_t bit_offset_;       // 有效位图中第一个元素的位偏移
+    size_t length_;
+    int64_t null_count_;      // -1 表示未知
+
+public:
+    // 校验 schema 格式和缓冲区布局，不支持的类型抛出 CalculatorException
+    ArrowColumnView(const ArrowArray *array, const ArrowSchema *schema);
+
+    ArrowColumnType type() const { return type_; }
+    size_t length() const { return length_; }
+    bool hasNulls() const { return validity_ != nullptr && null_count_ != 0; }
+
+    template <typename T>
+    const T *values() const { return static_cast<const T *>(values_); }
+
+    // 读取从第 index 个元素开始的至多 64 个有效位（超出部分为 0）
+    uint64_t validityWord(size_t index, size_t nbits) const;
+
+    // 非空元素个数
+    size_t validCount() const;
+};
+
+// 感知有效位图的列内核：按 64 元素一块处理，全有效块走稠密循环，全空块直接跳过，
+// 混合块用无分支选择，三种情况都可以被编译器向量化
+CPP_CALCULATOR_API double arrow_column_sum(const ArrowColumnView &column);
+CPP_CALCULATOR_API double arrow_column_max(const ArrowColumnView &column); // 无有效值时抛出 CalculatorException
+CPP_CALCULATOR_API double arrow_column_min(const ArrowColumnView &column); // 无有效值时抛出 CalculatorException
+
+// results[i] = values[i] + addend（空值位置写 0.0）；validity_out 非空时写入从 0 位开始的有效位图
+CPP_CALCULATOR_API void arrow_column_add(const ArrowColumnView &column, double addend, double *results, uint8_t *validity_out);
+
+#endif // ARROW_COLUMN_H
@@ -0,0 +1,30 @@
+#ifndef BLAS_H
+#define BLAS_H
+
+#include <cstddef>
+#include "cpp_calculator/export.h"
+
+// BLAS-1 运算，提供 double / float 两种实例：转发到汇编库的向量化内核（asm_*_f64 / asm_*_f32，
+// AVX-512 / AVX + FMA 运行时分派，见 math_ops_asm.h）。不分配内存，不抛出异常。
+// 点积和范数用多个累加器分组求和，舍入与逐个累加不同；float 在单精度下累加
+
+template <typename T>
+CPP_CALCULATOR_API T dot_product(const T *x, const T *y, size_t size);
+
+// y = a·x + y，原地更新 y（x 可与 y 相同）
+template <typename T>
+CPP_CALCULATOR_API void axpy(T a, const T *x, T *y, size_t size);
+
+// x = a·x，原地更新
+template <typename T>
+CPP_CALCULATOR_API void scale_values(T a, T *x, size_t size);
+
+// 欧几里得范数 sqrt(Σ x²)：不做缩放，平方和上溢时为 inf
+template <typename T>
+CPP_CALCULATOR_API T norm2(const T *x, size_t size);
+
+// out = a·b + c（逐元素），out 可与任一输入相同。支持 FMA 的 CPU 上只舍入一次，否则乘和加分别舍入
+template <typename T>
+CPP_CALCULATOR_API void fused_multiply_add(const T *a, const T *b, const T *c, T *out, size_t size);
+
+#endif // BLAS_H
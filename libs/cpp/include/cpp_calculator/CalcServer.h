@@ -0,0 +1,125 @@
+#ifndef CALC_SERVER_H
+#define CALC_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cpp_calculator/SharedMemory.h"
+#include "cpp_calculator/calc_server_protocol.h"
+#include "cpp_calculator/export.h"
+
+// 共享内存计算服务：多个进程（如预先 fork 的 Python worker）把大数组放在 POSIX 共享内存里，
+// 由一个服务进程用全部线程和 SIMD 内核计算，请求、数据和结果都不经过序列化。
+//
+// 服务创建名为 name 的控制段，其中每个客户端占一个槽位，槽位内是两个单生产者 / 单消费者环形队列：
+// 请求队列（客户端写、服务端读）和完成队列（服务端写、客户端读），只用原子的头尾序号同步，不加锁。
+// 空闲的一方先自旋一小段时间，再在共享内存中的 futex 上睡眠，提交方只在对方睡眠时才发起唤醒系统调用。
+// 请求通过（段号, 偏移, 个数）引用客户端注册过的数据段，服务端映射同一段后直接在原地读写。
+// 仅支持 Linux（共享内存中的 futex）
+
+struct CalcServerOptions
+{
+    unsigned slots = 64;          // 最多同时连接的客户端数
+    unsigned ring_capacity = 64;  // 每个客户端最多未取走的请求数（向上取 2 的幂，超过 65536 时构造抛出异常）
+    unsigned workers = 1;         // 分派线程数（至多 16），客户端槽位 i 固定由第 i % workers 个线程处理
+    unsigned threads = 0;         // 传给 matmul / sort / prefix_sum 的线程数，0 为全部硬件线程
+    unsigned spin_us = 50;        // 分派线程空闲后先自旋多久再睡眠
+};
+
+class CPP_CALCULATOR_API CalcServer
+{
+private:
+    struct Worker;
+
+    CalcServerOptions options_;
+    SharedMemorySegment control_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_;
+    std::atomic<uint64_t> completed_;
+
+    void run(Worker &worker);
+    bool serveSlot(Worker &worker, uint32_t slot);
+    void resetSlot(Worker &worker, uint32_t slot);
+    CalcShmCompletion execute(Worker &worker, uint32_t slot, const CalcShmRequest &request);
+
+public:
+    // 创建控制段（如 "/calc_server"）并启动分派线程。同名服务仍在运行时抛出 CalculatorException；
+    // 上次异常退出留下的控制段会被删除重建
+    explicit CalcServer(const std::string &name, const CalcServerOptions &options = CalcServerOptions());
+    ~CalcServer(); // stop() 并删除控制段
+
+    CalcServer(const CalcServer &) = delete;
+    CalcServer &operator=(const CalcServer &) = delete;
+
+    // 停止分派线程；等待中的客户端随即得到“服务已停止”的错误。可重复调用
+    void stop();
+
+    const std::string &name() const { return control_.name(); }
+    uint64_t completedCount() const { return completed_.load(std::memory_order_relaxed); }
+    size_t clientCount() const; // 当前连接的客户端数
+};
+
+// 计算服务的客户端。一个对象占用一个槽位，同一时刻只能由一个线程使用（单生产者 / 单消费者）；
+// 多线程时每个线程各建一个客户端。客户端进程退出后服务端会回收它的槽位
+class CPP_CALCULATOR_API CalcClient
+{
+private:
+    struct Segment
+    {
+        const char *base; // 本进程中的映射地址，nullptr 表示空闲
+        size_t size;
+    };
+
+    SharedMemorySegment control_;
+    void *slot_;
+    void *bell_;
+    uint32_t slot_index_;
+    uint64_t head_;   // 已提交的请求数
+    uint64_t tail_;   // 已取走的完成记录数
+    std::vector<Segment> segments_;
+
+    bool serverAlive() const;
+
+public:
+    // 连接名为 server_name 的服务并占用一个槽位；服务未运行或没有空闲槽位时抛出 CalculatorException
+    explicit CalcClient(const std::string &server_name);
+    ~CalcClient(); // 归还槽位，尚未完成的请求被丢弃
+
+    CalcClient(const CalcClient &) = delete;
+    CalcClient &operator=(const CalcClient &) = delete;
+
+    // 注册本进程已映射的共享内存段 name（映射在 [base, base + size)），服务端映射同一段后返回段号。
+    // name 必须以 "<服务名>_" 开头（如服务 "/calc_server" 的 "/calc_server_data"），否则服务端拒绝。
+    // 注册与注销会等待服务端处理，调用时不能有未完成的请求
+    uint32_t registerSegment(const std::string &name, const void *base, size_t size);
+    uint32_t registerSegment(SharedMemorySegment &segment)
+    {
+        return registerSegment(segment.name(), segment.data(), segment.size());
+    }
+    void unregisterSegment(uint32_t segment);
+
+    // 把本进程中的地址转换为请求参数：[ptr, ptr + count·element_size) 必须落在某个已注册的段内
+    CalcShmOperand operand(const void *ptr, size_t count, size_t element_size) const;
+
+    // 异步接口：submit 填写 request.id 并返回；完成记录按提交顺序到达。
+    // 未取走的请求达到 ring_capacity 时 submit 抛出 CalculatorException（先 poll / wait 取走完成记录）
+    uint64_t submit(CalcShmRequest request);
+    bool poll(CalcShmCompletion &completion);
+    // 等待下一个完成记录，timeout_ms < 0 表示一直等待；超时返回 false，服务停止或退出时抛出 CalculatorException
+    bool wait(CalcShmCompletion &completion, int timeout_ms = -1);
+    size_t pending() const { return static_cast<size_t>(head_ - tail_); }
+
+    // 同步调用：提交并等待完成，status 不是 CALC_SHM_STATUS_OK 时抛出 CalculatorException。
+    // 调用时不能有未完成的请求
+    CalcShmCompletion call(CalcShmRequest request);
+
+    // 状态码对应的异常信息（OK 时为 nullptr）
+    static const char *statusMessage(int32_t status);
+};
+
+#endif // CALC_SERVER_H
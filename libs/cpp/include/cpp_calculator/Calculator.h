@@ -4,16 +4,33 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
+#include "cpp_calculator/export.h"
 
 // 前向声明
 class Operation;
+class ArrowColumnView;
+class HistoryJournal;
+template <typename T>
+struct GroupByResult;
+
+// 历史批量导出格式
+enum class HistoryFormat
+{
+    Text,  // 每条一行，以 '\n' 结尾
+    Binary // 每条为 uint32_t 长度前缀（本机字节序）+ 内容，不含结尾 '\0'
+};
 
 // 基础计算器类
-class Calculator
+class CPP_CALCULATOR_API Calculator
 {
 protected:
-    std::vector<std::string> history_; // 计算历史
-    double last_result_;               // 最后结果
+    std::vector<std::string> history_;        // 计算历史
+    double last_result_;                      // 最后结果
+    std::shared_ptr<HistoryJournal> journal_; // 可选的持久化日志
+
+    // 追加一条历史，启用日志时同时压入日志的环形缓冲区
+    void recordHistory(std::string entry);
 
 public:
     Calculator();
@@ -30,6 +47,17 @@ public:
     const std::vector<std::string> &getHistory() const { return history_; }
     void clearHistory();
 
+    // 一次导出 [first, first + count) 的历史（count 超出末尾时截断），返回所需字节数；
+    // buffer 为空或容量不足时只计算大小，不写入。first 越界抛出 CalculatorException
+    size_t exportHistory(size_t first, size_t count, HistoryFormat format,
+                         char *buffer, size_t buffer_size) const;
+
+    // 挂接持久化历史日志（nullptr 表示关闭）；clearHistory 不影响已写入日志的记录
+    void setJournal(std::shared_ptr<HistoryJournal> journal) { journal_ = std::move(journal); }
+    HistoryJournal *getJournal() const { return journal_.get(); }
+    // 共享所有权的日志，调用方持有期间即使计算器换掉或关闭日志，对象仍然有效
+    std::shared_ptr<HistoryJournal> shareJournal() const { return journal_; }
+
     // 虚函数，供子类重写
     virtual std::string getCalculatorType() const
     {
@@ -38,7 +66,7 @@ public:
 };
 
 // 高级计算器类，继承自基础计算器
-class AdvancedCalculator : public Calculator
+class CPP_CALCULATOR_API AdvancedCalculator : public Calculator
 {
 private:
     std::vector<std::unique_ptr<Operation>> operations_; // 多态操作集合
@@ -64,6 +92,64 @@ public:
     template <typename T>
     T min_element(const std::vector<T> &arr);
 
+    // 选择与排名（见 Selection.h）：最值首次出现的下标、最大的 k 个元素的下标（从大到小）、
+    // 线性插值的分位数和中位数（不修改 arr）。空数组抛出 CalculatorException
+    template <typename T>
+    size_t argmax(const std::vector<T> &arr);
+
+    template <typename T>
+    size_t argmin(const std::vector<T> &arr);
+
+    template <typename T>
+    std::vector<size_t> top_k(const std::vector<T> &arr, size_t k);
+
+    template <typename T>
+    double percentile(const std::vector<T> &arr, double q);
+
+    template <typename T>
+    double median(const std::vector<T> &arr);
+
+    // 排序与分桶（见 Sort.h）：原地升序排序（int / float 为基数排序，double 为并行归并排序），
+    // [lo, hi] 上 bins 个等宽桶的计数。threads 为 0 时使用全部硬件线程
+    template <typename T>
+    void sort(std::vector<T> &arr, unsigned threads = 0);
+
+    template <typename T>
+    std::vector<uint64_t> histogram(const std::vector<T> &arr, double lo, double hi, size_t bins, unsigned threads = 0);
+
+    // 分组聚合（见 GroupBy.h）：keys[i] 对应 values[i]，得到每个键的和 / 最小值 / 最大值 / 个数，按键升序。
+    // 两个数组长度不同时抛出 CalculatorException
+    template <typename T>
+    GroupByResult<T> group_by(const std::vector<int32_t> &keys, const std::vector<T> &values, unsigned threads = 0);
+
+    // BLAS-1 运算（见 Blas.h，double / float）：点积、y = a·x + y（原地更新 y）、x = a·x（原地）、
+    // 欧几里得范数和逐元素乘加 a·b + c。数组长度不同时抛出 CalculatorException
+    template <typename T>
+    T dot(const std::vector<T> &x, const std::vector<T> &y);
+
+    template <typename T>
+    void axpy(T a, const std::vector<T> &x, std::vector<T> &y);
+
+    template <typename T>
+    void scale(T a, std::vector<T> &x);
+
+    template <typename T>
+    T norm(const std::vector<T> &x);
+
+    template <typename T>
+    std::vector<T> fma(const std::vector<T> &a, const std::vector<T> &b, const std::vector<T> &c);
+
+    // 矩阵乘法（见 Gemm.h，double / float）：a 为 m×k、b 为 k×n 的行主序矩阵，返回 m×n 的 a·b。
+    // 数组长度与维度不符时抛出 CalculatorException。threads 为 0 时使用全部硬件线程
+    template <typename T>
+    std::vector<T> matmul(const std::vector<T> &a, const std::vector<T> &b, size_t m, size_t k, size_t n,
+                          unsigned threads = 0);
+
+    // 多项式求值（见 Polynomial.h，double / float）：coeffs 按升幂排列，返回每个 x 处的值。
+    // 不记录历史，一次调用代替逐项的 power / multiply / add
+    template <typename T>
+    std::vector<T> poly_eval(const std::vector<T> &coeffs, const std::vector<T> &x);
+
     // 重写虚函数
     std::string getCalculatorType() const override
     {
@@ -72,10 +158,28 @@ public:
 
     // 批量运算
     std::vector<double> batch_add(const std::vector<double> &values, double addend);
+
+    // 文件映射运算：直接在原始二进制文件（本机字节序 int32/double）上归约，无需整体读入内存
+    int64_t sum_file_int32(const std::string &path);
+    int32_t max_file_int32(const std::string &path);
+    int32_t min_file_int32(const std::string &path);
+    double sum_file_double(const std::string &path);
+    double max_file_double(const std::string &path);
+    double min_file_double(const std::string &path);
+
+    // 对 double 文件逐元素加 addend，结果写入输出文件（内存映射），返回处理的元素个数；
+    // 输入输出为同一文件时抛出 CalculatorException
+    size_t batch_add_file(const std::string &input_path, const std::string &output_path, double addend);
+
+    // Arrow 列运算：直接处理带有效位图的 Arrow 数组，跳过空值
+    double sum_column(const ArrowColumnView &column);
+    double max_column(const ArrowColumnView &column);
+    double min_column(const ArrowColumnView &column);
+    void batch_add_column(const ArrowColumnView &column, double addend, double *results, uint8_t *validity_out);
 };
 
 // 操作基类，用于多态
-class Operation
+class CPP_CALCULATOR_API Operation
 {
 public:
     virtual ~Operation() = default;
@@ -84,14 +188,14 @@ public:
 };
 
 // 具体操作类
-class AddOperation : public Operation
+class CPP_CALCULATOR_API AddOperation : public Operation
 {
 public:
     double execute(double a, double b = 0) override { return a + b; }
     std::string getName() const override { return "Addition"; }
 };
 
-class MultiplyOperation : public Operation
+class CPP_CALCULATOR_API MultiplyOperation : public Operation
 {
 public:
     double execute(double a, double b = 0) override { return a * b; }
@@ -99,7 +203,7 @@ public:
 };
 
 // 异常类
-class CalculatorException : public std::exception
+class CPP_CALCULATOR_API CalculatorException : public std::exception
 {
 private:
     std::string message_;
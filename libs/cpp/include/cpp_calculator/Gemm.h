@@ -0,0 +1,16 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <cstddef>
+#include "cpp_calculator/export.h"
+
+// 稠密矩阵乘法 C = A·B（行主序），提供 double / float 两种实例：AdvancedCalculator::matmul 基于这里实现。
+// A 为 m×k（行距 lda），B 为 k×n（行距 ldb），C 为 m×n（行距 ldc），C 原有内容被覆盖，C 不能与 A / B 重叠。
+// 按 KC×NC 的 B 块、MC×KC 的 A 块分块并打包，最内层为汇编库的 6×NR 寄存器分块微内核（asm_gemm_kernel_*）；
+// 很小的矩阵直接三重循环。k 维分段累加，舍入与逐个累加不同。
+// threads 为 0 时使用全部硬件线程，按 6 行一组的行面板切分给各线程；计算量小时自动退化为单线程
+template <typename T>
+CPP_CALCULATOR_API void gemm(size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b, size_t ldb,
+                             T *c, size_t ldc, unsigned threads = 0);
+
+#endif // GEMM_H
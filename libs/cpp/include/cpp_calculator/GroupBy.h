@@ -0,0 +1,38 @@
+#ifndef GROUP_BY_H
+#define GROUP_BY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/export.h"
+
+// 分组聚合：按 int32 键对值求每组的和 / 最小值 / 最大值 / 个数，提供 int32_t / double 两种实例。
+// 和的类型同累加器：int32_t 值得到 int64_t，double 值得到 double。
+//
+// 键的取值范围（max - min + 1）不超过 64K 且不明显大于元素个数时，用按键直接索引的稠密数组；
+// 否则用开放寻址（线性探测）哈希表。threads 为 0 时使用全部硬件线程，每个线程至少分到 64K 个元素：
+// 稠密路径每个线程各聚合一块再按键合并；哈希路径先按键的哈希把数据分区，每个线程独立聚合一个分区，
+// 分区之间没有相同的键，不需要合并。
+// double 的 NaN 计入和与个数，但不参与最小 / 最大值（只有 NaN 的组最小值为 +inf、最大值为 -inf）。
+
+// 每个出现过的键一组，按键升序排列，各数组等长
+template <typename T>
+struct GroupByResult
+{
+    using sum_type = typename AccumulatorTraits<T>::sum_type;
+
+    std::vector<int32_t> keys;
+    std::vector<sum_type> sums;
+    std::vector<T> mins;
+    std::vector<T> maxs;
+    std::vector<uint64_t> counts;
+
+    size_t size() const { return keys.size(); }
+};
+
+// keys[i] 与 values[i] 一一对应，共 size 个
+template <typename T>
+CPP_CALCULATOR_API GroupByResult<T> group_by(const int32_t *keys, const T *values, size_t size, unsigned threads = 0);
+
+#endif // GROUP_BY_H
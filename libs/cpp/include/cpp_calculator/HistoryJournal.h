@@ -0,0 +1,115 @@
+#ifndef HISTORY_JOURNAL_H
+#define HISTORY_JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "cpp_calculator/MappedFile.h"
+
+// 历史日志文件格式（本机字节序）：
+//   文件头  8 字节魔数 "CALCJRNL" + uint32_t 版本 + uint32_t 保留
+//   每条记录 uint32_t 长度 + uint32_t CRC32（覆盖时间戳和内容）+ int64_t 时间戳（纳秒，Unix 纪元）+ 内容
+// 只追加写入；进程崩溃时末尾可能残留半条记录（或文件系统预分配的全零区域），读取时视为日志结束
+
+// 落盘策略
+enum class JournalSync
+{
+    None,     // 只 write，由操作系统决定何时落盘
+    Batch,    // 每批写入后 fdatasync
+    Interval  // 两次 fdatasync 至少间隔 sync_interval
+};
+
+struct JournalOptions
+{
+    size_t ring_bytes = 1 << 20;                             // 环形缓冲区容量（向上取 2 的幂）
+    std::chrono::milliseconds flush_interval{10};            // 后台线程空闲时的轮询间隔
+    JournalSync sync = JournalSync::Batch;
+    std::chrono::milliseconds sync_interval{1000};           // JournalSync::Interval 使用
+};
+
+// 异步追加日志：生产者只把记录拷进单生产者 / 单消费者环形缓冲区，
+// 后台线程批量取出、计算校验和并写入文件。append 只能由一个线程调用
+class CPP_CALCULATOR_API HistoryJournal
+{
+private:
+    JournalOptions options_;
+    int fd_;
+
+    // 环形缓冲区：head_ 由生产者推进，tail_ 由写线程推进，均为单调递增的字节序号
+    std::unique_ptr<char[]> ring_;
+    size_t mask_;
+    std::atomic<uint64_t> head_;
+    std::atomic<uint64_t> tail_;
+
+    std::atomic<uint64_t> written_;  // 已写入文件（并按策略落盘）的字节序号
+    std::atomic<uint64_t> records_;  // 已提交的记录数
+    std::atomic<uint64_t> stalls_;   // 缓冲区满导致生产者等待的次数
+    std::atomic<bool> failed_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;   // 唤醒写线程
+    std::condition_variable done_;   // 通知 flush 等待者
+    uint64_t flush_target_;
+    bool stop_;
+    std::thread writer_;
+
+    void copyIn(uint64_t pos, const void *src, size_t n);
+    void copyOut(uint64_t pos, void *dst, size_t n) const;
+    bool writeAll(const char *data, size_t n);
+    void run();
+
+public:
+    // 打开（或创建）日志文件并启动写线程；已有文件必须是合法日志，末尾的半条记录会被截掉，新记录追加在后面
+    explicit HistoryJournal(const std::string &path, const JournalOptions &options = JournalOptions());
+    ~HistoryJournal(); // 写完缓冲区中剩余记录后关闭
+
+    HistoryJournal(const HistoryJournal &) = delete;
+    HistoryJournal &operator=(const HistoryJournal &) = delete;
+
+    // 热路径：记录时间戳并压入环形缓冲区；缓冲区满时让出 CPU 直到写线程腾出空间
+    void append(const std::string &entry);
+
+    // 阻塞直到此前 append 的记录全部写入文件（JournalSync::None 以外的策略还会 fdatasync）；
+    // 写入失败时抛出 CalculatorException
+    void flush();
+
+    uint64_t recordCount() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t stallCount() const { return stalls_.load(std::memory_order_relaxed); }
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+};
+
+struct JournalRecord
+{
+    int64_t timestamp_ns;
+    std::string entry;
+};
+
+// 顺序读取日志文件，校验每条记录的 CRC32
+class CPP_CALCULATOR_API HistoryJournalReader
+{
+private:
+    MappedFile file_;
+    size_t offset_;
+    bool truncated_;
+
+public:
+    // 文件不是合法日志时抛出 CalculatorException
+    explicit HistoryJournalReader(const std::string &path);
+
+    // 读取下一条记录；到达末尾（或末尾不完整的记录）返回 false。文件中间的记录校验和不符时抛出 CalculatorException
+    bool next(JournalRecord &record);
+
+    // 末尾是否有不完整的记录（写入过程中进程退出）
+    bool truncated() const { return truncated_; }
+
+    // 已读取的合法内容（文件头 + 完整记录）的字节数
+    size_t validBytes() const { return offset_; }
+};
+
+#endif // HISTORY_JOURNAL_H
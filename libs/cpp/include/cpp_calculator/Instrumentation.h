@@ -0,0 +1,103 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "cpp_calculator/export.h"
+
+// 运行统计：Calculator / AdvancedCalculator 各运算的调用次数、以异常结束的次数、处理的输入字节数和延迟直方图，
+// 以及 C 接口把异常映射为各错误码的次数。数组运算（选择、排序、分组、BLAS、矩阵乘、多项式、扫描）在
+// 自由函数内核中记录，经成员函数、C 接口、Python 绑定或计算服务调用都会计入。只有以 ENABLE_INSTRUMENTATION=ON 构建时才记录（编译期开关，
+// 关闭时记录点展开为空语句，没有任何开销）；下面的查询函数始终可用，未开启时计数恒为 0。
+// 计数按线程分开存放，写入不加锁也不使用原子读改写；读取时在锁内把所有线程（包括已退出的线程）的计数相加
+
+// 被统计的运算：X(枚举名, 对外名称)
+#define CALC_INSTRUMENTED_OPERATIONS(X)  \
+    X(Add, "add")                        \
+    X(Subtract, "subtract")              \
+    X(Multiply, "multiply")              \
+    X(Divide, "divide")                  \
+    X(Power, "power")                    \
+    X(SquareRoot, "square_root")         \
+    X(Factorial, "factorial")            \
+    X(Sine, "sine")                      \
+    X(Cosine, "cosine")                  \
+    X(SumArray, "sum_array")             \
+    X(MaxElement, "max_element")         \
+    X(MinElement, "min_element")         \
+    X(Argmax, "argmax")                  \
+    X(Argmin, "argmin")                  \
+    X(TopK, "top_k")                     \
+    X(Percentile, "percentile")          \
+    X(Sort, "sort")                      \
+    X(Histogram, "histogram")            \
+    X(GroupBy, "group_by")               \
+    X(Dot, "dot")                        \
+    X(Axpy, "axpy")                      \
+    X(Scale, "scale")                    \
+    X(Norm, "norm")                      \
+    X(Fma, "fma")                        \
+    X(Matmul, "matmul")                  \
+    X(PolyEval, "poly_eval")             \
+    X(PrefixSum, "prefix_sum")           \
+    X(CumulativeMin, "cumulative_min")   \
+    X(CumulativeMax, "cumulative_max")   \
+    X(WindowSum, "window_sum")           \
+    X(WindowMin, "window_min")           \
+    X(WindowMax, "window_max")           \
+    X(BatchAdd, "batch_add")             \
+    X(SumFile, "sum_file")               \
+    X(MaxFile, "max_file")               \
+    X(MinFile, "min_file")               \
+    X(BatchAddFile, "batch_add_file")    \
+    X(SumColumn, "sum_column")           \
+    X(MaxColumn, "max_column")           \
+    X(MinColumn, "min_column")           \
+    X(BatchAddColumn, "batch_add_column")
+
+enum class InstrumentedOperation : uint32_t
+{
+#define CALC_OPERATION_ENUM(name, text) name,
+    CALC_INSTRUMENTED_OPERATIONS(CALC_OPERATION_ENUM)
+#undef CALC_OPERATION_ENUM
+    Count
+};
+
+// 延迟直方图按 HDR 的方式对数-线性分桶：0..3 ns 各占一个桶，之后每个 2 的幂区间分为 4 个桶，
+// 桶宽不超过下界的 1/4；超过最后一个桶下界（约 1.9·10¹² ns）的延迟也计入最后一个桶
+const size_t kLatencyBuckets = 160;
+
+// 错误码计数的槽位数（CalculatorError 的取值都小于它）
+const size_t kErrorCodeSlots = 16;
+
+struct OperationStats
+{
+    uint64_t calls;                     // 调用次数
+    uint64_t errors;                    // 以异常结束的调用次数
+    uint64_t bytes;                     // 数组 / 文件运算处理的输入字节数
+    uint64_t total_ns;                  // 累计耗时
+    uint64_t latency[kLatencyBuckets];  // 延迟直方图
+};
+
+// 是否以 ENABLE_INSTRUMENTATION=ON 构建
+CPP_CALCULATOR_API bool instrumentation_enabled();
+
+// 运算的对外名称（如 "matmul"），op 越界时返回 nullptr
+CPP_CALCULATOR_API const char *operation_name(InstrumentedOperation op);
+
+// 自上次 reset_instrumentation 以来所有线程的汇总
+CPP_CALCULATOR_API OperationStats operation_stats(InstrumentedOperation op);
+
+// C 接口把异常映射为错误码 code 的次数（code 越界时为 0）
+CPP_CALCULATOR_API uint64_t error_code_count(int code);
+
+// 清零全部计数：记录当前的汇总值作为基线，之后的读取减去基线，写入方不受影响
+CPP_CALCULATOR_API void reset_instrumentation();
+
+// 第 bucket 个延迟桶的下界（ns），第 bucket + 1 个桶的下界即其上界
+CPP_CALCULATOR_API uint64_t latency_bucket_floor(size_t bucket);
+
+// 按直方图估计延迟的 q 分位数（q ∈ [0, 1]，ns）：取所在桶上下界的中点，没有记录时为 0
+CPP_CALCULATOR_API double latency_percentile(const OperationStats &stats, double q);
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,64 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include "cpp_calculator/export.h"
+
+// 内存映射文件（RAII），用于直接在原始二进制文件上做数组运算，避免整体读入内存
+class CPP_CALCULATOR_API MappedFile
+{
+private:
+    void *data_;   // 映射起始地址（空文件时为 nullptr）
+    size_t size_;  // 映射字节数
+    int fd_;       // 文件描述符
+    bool writable_;
+
+    void release();
+
+public:
+    // 只读映射已有文件，并提示内核顺序访问 / 透明大页
+    explicit MappedFile(const std::string &path);
+    // 创建（或截断）文件到 size 字节并以读写方式映射，用于输出结果
+    MappedFile(const std::string &path, size_t size);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    const void *data() const { return data_; }
+    void *data() { return data_; }
+    size_t size() const { return size_; }
+    bool writable() const { return writable_; }
+
+    // 按元素类型访问
+    template <typename T>
+    const T *as() const { return static_cast<const T *>(data_); }
+
+    template <typename T>
+    T *as() { return static_cast<T *>(data_); }
+
+    // 元素个数；文件大小不是 sizeof(T) 的整数倍时抛出异常
+    template <typename T>
+    size_t count() const
+    {
+        checkElementSize(sizeof(T));
+        return size_ / sizeof(T);
+    }
+
+    // 将已处理过的区间交还内核（只读映射下可立即回收页缓存）
+    void release_range(size_t offset, size_t length);
+
+    // 将写入的数据刷回文件
+    void sync();
+
+    // path 是否与本映射为同一文件（比较设备号和 inode，硬链接和不同写法的路径也能识别）
+    bool sameFile(const std::string &path) const;
+
+private:
+    void checkElementSize(size_t element_size) const;
+};
+
+#endif // MAPPED_FILE_H
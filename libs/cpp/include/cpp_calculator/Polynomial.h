@@ -0,0 +1,14 @@
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <cstddef>
+#include "cpp_calculator/export.h"
+
+// 批量多项式求值，提供 double / float 两种实例：out[i] = c[0] + c[1]·x[i] + ... + c[count-1]·x[i]^(count-1)。
+// 系数按升幂排列（同 numpy.polynomial.polynomial.polyval，与 numpy.polyval 相反）；count 为 0 时结果为 0。
+// 转发到汇编库的 Estrin 内核 asm_poly_eval_f64 / _f32（见 math_ops_asm.h），舍入与逐项 Horner 不同。
+// out 可与 x 相同，不分配内存，不抛出异常
+template <typename T>
+CPP_CALCULATOR_API void poly_eval(const T *coeffs, size_t count, const T *x, T *out, size_t size);
+
+#endif // POLYNOMIAL_H
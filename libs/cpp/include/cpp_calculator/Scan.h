@@ -0,0 +1,56 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/export.h"
+
+// 前缀扫描和滑动窗口运算，提供 int32_t / double 两种实例。
+// 和的类型同累加器：int32_t 输入得到 int64_t，double 输入得到 double。
+//
+// threads 为 0 时使用全部硬件线程；每个线程至少分到 64K 个元素，数据少时自动退化为单线程。
+// 多线程时数组按线程分块：扫描先并行求各块汇总值，串行合并出每块的初值后再并行扫描；
+// 滑动窗口各块独立计算（块首多读 window - 1 个元素）。
+// double 的和与顺序逐个累加相比，最后几位可能不同（SIMD 和分块改变了加法结合顺序）。
+
+enum class ScanMode
+{
+    Inclusive, // out[i] 包含 data[i]
+    Exclusive  // out[i] 只到 data[i - 1]，out[0] 为单位元（和为 0）
+};
+
+template <typename T>
+using scan_sum_t = typename AccumulatorTraits<T>::sum_type;
+
+// 前缀和；类型相同时 out 可以等于 data（原地计算）
+template <typename T>
+CPP_CALCULATOR_API void prefix_sum(const T *data, size_t size, scan_sum_t<T> *out,
+                                   ScanMode mode = ScanMode::Inclusive, unsigned threads = 0);
+
+// 累计最小 / 最大值：out[i] = min / max(data[0..i])；out 可以等于 data
+template <typename T>
+CPP_CALCULATOR_API void cumulative_min(const T *data, size_t size, T *out, unsigned threads = 0);
+template <typename T>
+CPP_CALCULATOR_API void cumulative_max(const T *data, size_t size, T *out, unsigned threads = 0);
+
+// 滑动窗口：out[i] 为 data[i, i + window) 的和 / 最小值 / 最大值，共 size - window + 1 个结果。
+// 均为 O(n)，与窗口大小无关：int32 的和为增量更新，double 的和按宽 window 的块求块内前缀 / 后缀和，
+// 每个窗口只由自身元素求出（inf、大数不会影响其他窗口，结果与线程数无关）；最值用单调队列。
+// out 不能与 data 重叠。
+// window 为 0 或大于 size 时抛出 CalculatorException
+template <typename T>
+CPP_CALCULATOR_API void window_sum(const T *data, size_t size, size_t window, scan_sum_t<T> *out,
+                                   unsigned threads = 0);
+template <typename T>
+CPP_CALCULATOR_API void window_min(const T *data, size_t size, size_t window, T *out, unsigned threads = 0);
+template <typename T>
+CPP_CALCULATOR_API void window_max(const T *data, size_t size, size_t window, T *out, unsigned threads = 0);
+
+// 窗口运算的结果个数（window 不合法时为 0）
+inline size_t window_count(size_t size, size_t window)
+{
+    return window == 0 || window > size ? 0 : size - window + 1;
+}
+
+#endif // SCAN_H
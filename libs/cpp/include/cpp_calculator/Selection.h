@@ -0,0 +1,28 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cpp_calculator/export.h"
+
+// 选择与排名，提供 int32_t / double 两种实例；AdvancedCalculator 的 argmax / top_k / percentile 等基于这里实现。
+// 空数组抛出 CalculatorException("Array is empty!")
+
+// 最大 / 最小值首次出现的下标（SSE2 分块求最值，只在结果变化的块内查找位置）；double 忽略 NaN，全为 NaN 时返回 0
+template <typename T>
+CPP_CALCULATOR_API size_t argmax(const T *data, size_t size);
+template <typename T>
+CPP_CALCULATOR_API size_t argmin(const T *data, size_t size);
+
+// 最大的 k 个元素的下标，按值从大到小，值相同时下标小的在前；k 超过元素个数时返回全部，double 跳过 NaN。
+// k 远小于 size 时用大小为 k 的堆（O(n log k)），否则对下标数组 nth_element 后只排序前 k 个
+template <typename T>
+CPP_CALCULATOR_API std::vector<size_t> top_k(const T *data, size_t size, size_t k);
+
+// 分位数 q ∈ [0, 1]，按位置 (size - 1) * q 线性插值（同 numpy 默认方法），中位数为 q = 0.5。
+// 在副本上 nth_element，不修改 data；q 越界或含 NaN 时抛出 CalculatorException
+template <typename T>
+CPP_CALCULATOR_API double percentile(const T *data, size_t size, double q);
+
+#endif // SELECTION_H
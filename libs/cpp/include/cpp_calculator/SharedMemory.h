@@ -0,0 +1,54 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstddef>
+#include <string>
+#include "cpp_calculator/export.h"
+
+// POSIX 共享内存段（RAII）：shm_open + mmap(MAP_SHARED)，多个进程映射同一段即可直接共享数组。
+// 名字开头的 '/' 可以省略（与 Python multiprocessing.shared_memory 的 name 一致）
+class CPP_CALCULATOR_API SharedMemorySegment
+{
+private:
+    void *data_;      // 映射起始地址（空段时为 nullptr）
+    size_t size_;     // 映射字节数
+    int fd_;          // 共享内存的文件描述符
+    std::string name_;
+    bool owner_;      // 由本对象创建，析构时删除名字
+
+    void release();
+
+public:
+    // 映射已有的段（读写）
+    explicit SharedMemorySegment(const std::string &name);
+    // 创建 size 字节的新段（内容为 0）；同名段已存在时抛出 CalculatorException。析构时删除该名字，
+    // 已映射的进程不受影响
+    SharedMemorySegment(const std::string &name, size_t size);
+    ~SharedMemorySegment();
+
+    SharedMemorySegment(const SharedMemorySegment &) = delete;
+    SharedMemorySegment &operator=(const SharedMemorySegment &) = delete;
+    SharedMemorySegment(SharedMemorySegment &&other) noexcept;
+    SharedMemorySegment &operator=(SharedMemorySegment &&other) noexcept;
+
+    const void *data() const { return data_; }
+    void *data() { return data_; }
+    size_t size() const { return size_; }
+    // 段当前的大小（fstat）。其它进程可以用 ftruncate 把段缩小到 size() 以下，之后访问超出部分会触发 SIGBUS，
+    // 访问不受本进程控制的段之前应先检查；无法获取时返回 0
+    size_t currentSize() const;
+    const std::string &name() const { return name_; } // 带开头的 '/'
+
+    template <typename T>
+    T *as() { return static_cast<T *>(data_); }
+    template <typename T>
+    const T *as() const { return static_cast<const T *>(data_); }
+
+    // 立即删除名字（之后其它进程无法再打开，已有映射仍然有效），析构时不再删除
+    void unlink();
+
+    // 补上开头的 '/'
+    static std::string normalizeName(const std::string &name);
+};
+
+#endif // SHARED_MEMORY_H
@@ -0,0 +1,34 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "cpp_calculator/export.h"
+
+// 排序与分桶：AdvancedCalculator 的 sort / histogram 基于这里实现。
+// threads 为 0 时使用全部硬件线程；每个线程至少分到 64K 个元素，数据少时自动退化为单线程。
+
+// LSD 基数排序（升序），提供 int32_t / float 两种实例。
+// 按 8 位分 4 趟，一次遍历统计全部 4 趟的计数，所有键在某一趟上取值相同时跳过该趟；需要 2n 个 32 位的临时空间。
+// float 按 IEEE 位模式排序：-0.0 在 +0.0 之前，NaN 按符号位排在两端（通常的正 NaN 在最后）
+template <typename T>
+CPP_CALCULATOR_API void radix_sort(T *data, size_t size);
+
+// 并行归并排序（升序）：各线程先 std::sort 一块，再逐轮两两归并；每轮按输出位置二分切分，
+// 所有线程同时参与同一次归并。NaN 排在最后，需要 n 个 double 的临时空间
+CPP_CALCULATOR_API void parallel_sort(double *data, size_t size, unsigned threads = 0);
+
+// 按元素类型选择排序算法：int32_t / float 为基数排序（单线程，忽略 threads），double 为并行归并排序
+inline void sort_values(int32_t *data, size_t size, unsigned = 0) { radix_sort(data, size); }
+inline void sort_values(float *data, size_t size, unsigned = 0) { radix_sort(data, size); }
+inline void sort_values(double *data, size_t size, unsigned threads = 0) { parallel_sort(data, size, threads); }
+
+// 等宽直方图，提供 int32_t / double 两种实例：[lo, hi] 分为 bins 个桶，第 i 个桶为
+// [lo + i·w, lo + (i+1)·w)，最后一个桶包含 hi（同 numpy.histogram）。范围外的值和 NaN 不计数。
+// counts 需要 bins 个元素，结果覆盖写入；返回计入的元素个数。
+// bins 为 0、lo / hi 不是有限值或 lo >= hi 时抛出 CalculatorException
+template <typename T>
+CPP_CALCULATOR_API size_t histogram(const T *data, size_t size, double lo, double hi, size_t bins,
+                                    uint64_t *counts, unsigned threads = 0);
+
+#endif // SORT_H
@@ -3,6 +3,9 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "cpp_calculator/arrow_c_data.h"
+#include "cpp_calculator/calc_server_protocol.h"
+#include "cpp_calculator/export.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,61 +30,320 @@ typedef enum {
     CALC_ERROR_OUT_OF_MEMORY = 3,
     CALC_ERROR_SQUARE_ROOT_NEGATIVE = 4,
     CALC_ERROR_FACTORIAL_NEGATIVE = 5,
-    CALC_ERROR_ARRAY_EMPTY = 6
+    CALC_ERROR_ARRAY_EMPTY = 6,
+    CALC_ERROR_IO = 7,
+    CALC_ERROR_BUFFER_TOO_SMALL = 8,
+    CALC_ERROR_TIMEOUT = 9
 } CalculatorError;
 
+// 历史批量导出格式
+typedef enum {
+    HISTORY_FORMAT_TEXT = 0,    // 每条一行，以 '\n' 结尾
+    HISTORY_FORMAT_BINARY = 1   // 每条为 uint32_t 长度前缀（本机字节序）+ 内容，不含结尾 '\0'
+} HistoryExportFormat;
+
+#define HISTORY_EXPORT_ALL ((size_t)-1)
+
+// 历史日志落盘策略（见 HistoryJournal.h）
+typedef enum {
+    JOURNAL_SYNC_NONE = 0,      // 只 write，由操作系统决定何时落盘
+    JOURNAL_SYNC_BATCH = 1,     // 每批写入后 fdatasync
+    JOURNAL_SYNC_INTERVAL = 2   // 至多每秒 fdatasync 一次
+} JournalSyncMode;
+
 // 基础计算器函数
-CalculatorHandle* calculator_create();
-void calculator_destroy(CalculatorHandle* handle);
+CPP_CALCULATOR_API CalculatorHandle* calculator_create();
+CPP_CALCULATOR_API void calculator_destroy(CalculatorHandle* handle);
 
-CalculatorError calculator_add(CalculatorHandle* handle, double a, double b, double* result);
-CalculatorError calculator_subtract(CalculatorHandle* handle, double a, double b, double* result);
-CalculatorError calculator_multiply(CalculatorHandle* handle, double a, double b, double* result);
-CalculatorError calculator_divide(CalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError calculator_add(CalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError calculator_subtract(CalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError calculator_multiply(CalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError calculator_divide(CalculatorHandle* handle, double a, double b, double* result);
 
-double calculator_get_last_result(CalculatorHandle* handle);
-size_t calculator_get_history_count(CalculatorHandle* handle);
-CalculatorError calculator_get_history_entry(CalculatorHandle* handle, size_t index, char* buffer, size_t buffer_size);
-void calculator_clear_history(CalculatorHandle* handle);
+CPP_CALCULATOR_API double calculator_get_last_result(CalculatorHandle* handle);
+CPP_CALCULATOR_API size_t calculator_get_history_count(CalculatorHandle* handle);
+CPP_CALCULATOR_API CalculatorError calculator_get_history_entry(CalculatorHandle* handle, size_t index, char* buffer, size_t buffer_size);
+CPP_CALCULATOR_API void calculator_clear_history(CalculatorHandle* handle);
+// 一次导出 [first, first + count) 的历史，*required 总是写入所需字节数；
+// buffer 为 NULL 时只查询大小，容量不足时返回 CALC_ERROR_BUFFER_TOO_SMALL 且不写入
+CPP_CALCULATOR_API CalculatorError calculator_export_history(CalculatorHandle* handle, size_t first, size_t count,
+                                          HistoryExportFormat format, char* buffer, size_t buffer_size,
+                                          size_t* required);
+// 持久化历史日志：之后的每条历史由后台线程追加写入 path（已有日志则继续追加）
+CPP_CALCULATOR_API CalculatorError calculator_open_journal(CalculatorHandle* handle, const char* path, JournalSyncMode sync);
+CPP_CALCULATOR_API CalculatorError calculator_flush_journal(CalculatorHandle* handle);
+CPP_CALCULATOR_API void calculator_close_journal(CalculatorHandle* handle); // 写完剩余记录后关闭
 
 // 高级计算器函数
-AdvancedCalculatorHandle* advanced_calculator_create();
-void advanced_calculator_destroy(AdvancedCalculatorHandle* handle);
+CPP_CALCULATOR_API AdvancedCalculatorHandle* advanced_calculator_create();
+CPP_CALCULATOR_API void advanced_calculator_destroy(AdvancedCalculatorHandle* handle);
 
-CalculatorError advanced_calculator_add(AdvancedCalculatorHandle* handle, double a, double b, double* result);
-CalculatorError advanced_calculator_subtract(AdvancedCalculatorHandle* handle, double a, double b, double* result);
-CalculatorError advanced_calculator_multiply(AdvancedCalculatorHandle* handle, double a, double b, double* result);
-CalculatorError advanced_calculator_divide(AdvancedCalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_add(AdvancedCalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_subtract(AdvancedCalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_multiply(AdvancedCalculatorHandle* handle, double a, double b, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_divide(AdvancedCalculatorHandle* handle, double a, double b, double* result);
 
 // 高级数学函数
-CalculatorError advanced_calculator_power(AdvancedCalculatorHandle* handle, double base, int exponent, double* result);
-CalculatorError advanced_calculator_square_root(AdvancedCalculatorHandle* handle, double value, double* result);
-CalculatorError advanced_calculator_factorial(AdvancedCalculatorHandle* handle, int n, double* result);
-CalculatorError advanced_calculator_sine(AdvancedCalculatorHandle* handle, double angle, double* result);
-CalculatorError advanced_calculator_cosine(AdvancedCalculatorHandle* handle, double angle, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_power(AdvancedCalculatorHandle* handle, double base, int exponent, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_square_root(AdvancedCalculatorHandle* handle, double value, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_factorial(AdvancedCalculatorHandle* handle, int n, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sine(AdvancedCalculatorHandle* handle, double angle, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_cosine(AdvancedCalculatorHandle* handle, double angle, double* result);
 
 // 数组操作函数 (int32_t)
-CalculatorError advanced_calculator_sum_array_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int64_t* result);
-CalculatorError advanced_calculator_max_element_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int32_t* result);
-CalculatorError advanced_calculator_min_element_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int32_t* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sum_array_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int64_t* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_max_element_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int32_t* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_min_element_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int32_t* result);
 
 // 数组操作函数 (double)
-CalculatorError advanced_calculator_sum_array_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
-CalculatorError advanced_calculator_max_element_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
-CalculatorError advanced_calculator_min_element_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sum_array_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_max_element_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_min_element_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
+
+// 选择与排名：最值首次出现的下标；最大的 k 个元素的下标（indices 容量至少为 k，从大到小，*count 为实际个数）；
+// 线性插值的分位数 q ∈ [0, 1] 和中位数。空数组返回 CALC_ERROR_ARRAY_EMPTY
+CPP_CALCULATOR_API CalculatorError advanced_calculator_argmax_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, size_t* index);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_argmin_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, size_t* index);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_argmax_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, size_t* index);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_argmin_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, size_t* index);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_top_k_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, size_t k,
+                                                                   size_t* indices, size_t* count);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_top_k_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, size_t k,
+                                                                    size_t* indices, size_t* count);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_percentile_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, double q, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_percentile_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double q, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_median_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_median_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result);
+
+// 排序与分桶：原地升序排序（int32 / float 为基数排序，double 为并行归并排序，NaN 排在最后）；
+// [lo, hi] 上 bins 个等宽桶的直方图，counts 容量为 bins，*counted 为计入的元素个数（可为 NULL）。
+// threads 为 0 时使用全部硬件线程；bins 为 0 或范围不合法时返回 CALC_ERROR_INVALID_ARGUMENT
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sort_int32(AdvancedCalculatorHandle* handle, int32_t* arr, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sort_float(AdvancedCalculatorHandle* handle, float* arr, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sort_double(AdvancedCalculatorHandle* handle, double* arr, size_t size, unsigned threads);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_histogram_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size,
+                                                                       double lo, double hi, size_t bins, uint64_t* counts,
+                                                                       size_t* counted, unsigned threads);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_histogram_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size,
+                                                                        double lo, double hi, size_t bins, uint64_t* counts,
+                                                                        size_t* counted, unsigned threads);
+
+// BLAS-1 运算（汇编库的 FMA 向量化内核，见 Blas.h）：点积、y = a·x + y（原地更新 y）、x = a·x（原地）、
+// 欧几里得范数和逐元素乘加 out = a·b + c（out 可与任一输入相同）
+CPP_CALCULATOR_API CalculatorError advanced_calculator_dot_double(AdvancedCalculatorHandle* handle, const double* x, const double* y, size_t size, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_dot_float(AdvancedCalculatorHandle* handle, const float* x, const float* y, size_t size, float* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_axpy_double(AdvancedCalculatorHandle* handle, double a, const double* x, double* y, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_axpy_float(AdvancedCalculatorHandle* handle, float a, const float* x, float* y, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_scale_double(AdvancedCalculatorHandle* handle, double a, double* x, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_scale_float(AdvancedCalculatorHandle* handle, float a, float* x, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_norm_double(AdvancedCalculatorHandle* handle, const double* x, size_t size, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_norm_float(AdvancedCalculatorHandle* handle, const float* x, size_t size, float* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_fma_double(AdvancedCalculatorHandle* handle, const double* a, const double* b,
+                                                                  const double* c, double* out, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_fma_float(AdvancedCalculatorHandle* handle, const float* a, const float* b,
+                                                                 const float* c, float* out, size_t size);
+
+// 矩阵乘法（见 Gemm.h）：a 为 m×k、b 为 k×n 的行主序矩阵，c（m×n，不能与 a / b 重叠）被覆盖为 a·b。
+// threads 为 0 时使用全部硬件线程
+CPP_CALCULATOR_API CalculatorError advanced_calculator_matmul_double(AdvancedCalculatorHandle* handle, const double* a, const double* b,
+                                                                     double* c, size_t m, size_t k, size_t n, unsigned threads);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_matmul_float(AdvancedCalculatorHandle* handle, const float* a, const float* b,
+                                                                    float* c, size_t m, size_t k, size_t n, unsigned threads);
+
+// 多项式求值（汇编库的 Estrin 内核，见 Polynomial.h）：out[i] = Σ coeffs[j]·x[i]^j，系数按升幂排列，
+// count 为 0 时结果为 0；out 可与 x 相同。不记录历史
+CPP_CALCULATOR_API CalculatorError advanced_calculator_poly_eval_double(AdvancedCalculatorHandle* handle, const double* coeffs, size_t count,
+                                                                        const double* x, double* out, size_t size);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_poly_eval_float(AdvancedCalculatorHandle* handle, const float* coeffs, size_t count,
+                                                                       const float* x, float* out, size_t size);
+
+// 分组聚合（见 GroupBy.h）：keys[i] 对应 values[i]，得到每个键的和 / 最小值 / 最大值 / 个数，按键升序。
+// 结果通过不透明句柄返回，用完后 group_by_result_destroy；threads 为 0 时使用全部硬件线程
+typedef struct GroupByResultHandle GroupByResultHandle;
+
+CPP_CALCULATOR_API CalculatorError advanced_calculator_group_by_int32(AdvancedCalculatorHandle* handle, const int32_t* keys,
+                                                                      const int32_t* values, size_t size, unsigned threads,
+                                                                      GroupByResultHandle** result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_group_by_double(AdvancedCalculatorHandle* handle, const int32_t* keys,
+                                                                       const double* values, size_t size, unsigned threads,
+                                                                       GroupByResultHandle** result);
+CPP_CALCULATOR_API void group_by_result_destroy(GroupByResultHandle* result);
+CPP_CALCULATOR_API size_t group_by_result_size(const GroupByResultHandle* result); // 组数
+
+// 各列指向结果内部的数组（长度为组数），destroy 之前有效；值类型不符时返回 NULL
+CPP_CALCULATOR_API const int32_t* group_by_result_keys(const GroupByResultHandle* result);
+CPP_CALCULATOR_API const uint64_t* group_by_result_counts(const GroupByResultHandle* result);
+CPP_CALCULATOR_API const int64_t* group_by_result_sums_int64(const GroupByResultHandle* result);   // int32 值
+CPP_CALCULATOR_API const int32_t* group_by_result_mins_int32(const GroupByResultHandle* result);
+CPP_CALCULATOR_API const int32_t* group_by_result_maxs_int32(const GroupByResultHandle* result);
+CPP_CALCULATOR_API const double* group_by_result_sums_double(const GroupByResultHandle* result);   // double 值
+CPP_CALCULATOR_API const double* group_by_result_mins_double(const GroupByResultHandle* result);
+CPP_CALCULATOR_API const double* group_by_result_maxs_double(const GroupByResultHandle* result);
 
 // 批量操作
-CalculatorError advanced_calculator_batch_add(AdvancedCalculatorHandle* handle,
+CPP_CALCULATOR_API CalculatorError advanced_calculator_batch_add(AdvancedCalculatorHandle* handle,
                                              const double* values, size_t count,
                                              double addend, double* results);
 
-double advanced_calculator_get_last_result(AdvancedCalculatorHandle* handle);
-size_t advanced_calculator_get_history_count(AdvancedCalculatorHandle* handle);
-CalculatorError advanced_calculator_get_history_entry(AdvancedCalculatorHandle* handle, size_t index, char* buffer, size_t buffer_size);
-void advanced_calculator_clear_history(AdvancedCalculatorHandle* handle);
+// 文件映射操作（原始二进制 int32/double 文件，不整体读入内存）
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sum_file_int32(AdvancedCalculatorHandle* handle, const char* path, int64_t* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_max_file_int32(AdvancedCalculatorHandle* handle, const char* path, int32_t* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_min_file_int32(AdvancedCalculatorHandle* handle, const char* path, int32_t* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sum_file_double(AdvancedCalculatorHandle* handle, const char* path, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_max_file_double(AdvancedCalculatorHandle* handle, const char* path, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_min_file_double(AdvancedCalculatorHandle* handle, const char* path, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_batch_add_file(AdvancedCalculatorHandle* handle,
+                                                  const char* input_path, const char* output_path,
+                                                  double addend, size_t* count);
+
+CPP_CALCULATOR_API double advanced_calculator_get_last_result(AdvancedCalculatorHandle* handle);
+CPP_CALCULATOR_API size_t advanced_calculator_get_history_count(AdvancedCalculatorHandle* handle);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_get_history_entry(AdvancedCalculatorHandle* handle, size_t index, char* buffer, size_t buffer_size);
+CPP_CALCULATOR_API void advanced_calculator_clear_history(AdvancedCalculatorHandle* handle);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_export_history(AdvancedCalculatorHandle* handle, size_t first, size_t count,
+                                                   HistoryExportFormat format, char* buffer, size_t buffer_size,
+                                                   size_t* required);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_open_journal(AdvancedCalculatorHandle* handle, const char* path, JournalSyncMode sync);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_flush_journal(AdvancedCalculatorHandle* handle);
+CPP_CALCULATOR_API void advanced_calculator_close_journal(AdvancedCalculatorHandle* handle);
+
+// Arrow C Data Interface 列操作（支持 int32/int64/float/double，空值被跳过，不接管所有权）
+CPP_CALCULATOR_API CalculatorError advanced_calculator_sum_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                             const struct ArrowSchema* schema, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_max_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                             const struct ArrowSchema* schema, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_min_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                             const struct ArrowSchema* schema, double* result);
+CPP_CALCULATOR_API CalculatorError advanced_calculator_count_valid_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                                     const struct ArrowSchema* schema, size_t* count);
+// results 长度为 array->length；validity_out 可为 NULL，否则需 (length + 7) / 8 字节
+CPP_CALCULATOR_API CalculatorError advanced_calculator_batch_add_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                                   const struct ArrowSchema* schema, double addend,
+                                                   double* results, uint8_t* validity_out);
+
+// 流式累加器：分块 update 后读取结果，多线程各持一个再 merge
+typedef struct AccumulatorHandle AccumulatorHandle;
+
+typedef enum {
+    ACCUMULATOR_SUM = 0,
+    ACCUMULATOR_MIN = 1,
+    ACCUMULATOR_MAX = 2,
+    ACCUMULATOR_STATS = 3
+} AccumulatorKind;
+
+typedef enum {
+    ACCUMULATOR_INT32 = 0,
+    ACCUMULATOR_DOUBLE = 1
+} AccumulatorValueType;
+
+typedef struct {
+    size_t count;
+    double sum;
+    double min;
+    double max;
+    double mean;
+    double variance;
+} AccumulatorStats;
+
+CPP_CALCULATOR_API AccumulatorHandle* accumulator_create(AccumulatorKind kind, AccumulatorValueType type);
+CPP_CALCULATOR_API void accumulator_destroy(AccumulatorHandle* handle);
+
+CPP_CALCULATOR_API CalculatorError accumulator_update_int32(AccumulatorHandle* handle, const int32_t* data, size_t size);
+CPP_CALCULATOR_API CalculatorError accumulator_update_double(AccumulatorHandle* handle, const double* data, size_t size);
+CPP_CALCULATOR_API CalculatorError accumulator_merge(AccumulatorHandle* handle, const AccumulatorHandle* other); // 种类和类型需一致
+CPP_CALCULATOR_API void accumulator_reset(AccumulatorHandle* handle);
+CPP_CALCULATOR_API size_t accumulator_count(const AccumulatorHandle* handle);
+
+// SUM/MIN/MAX 的结果；int64 版本仅适用于 int32 累加器
+CPP_CALCULATOR_API CalculatorError accumulator_result_int64(const AccumulatorHandle* handle, int64_t* result);
+CPP_CALCULATOR_API CalculatorError accumulator_result_double(const AccumulatorHandle* handle, double* result);
+// STATS 的结果
+CPP_CALCULATOR_API CalculatorError accumulator_get_stats(const AccumulatorHandle* handle, AccumulatorStats* stats);
+
+// 前缀扫描与滑动窗口（见 Scan.h）。threads 为 0 时使用全部硬件线程，数据少时自动单线程。
+// int32 的和输出为 int64；out 长度：扫描为 size，窗口为 size - window + 1
+typedef enum {
+    PREFIX_SUM_INCLUSIVE = 0,   // out[i] 包含 data[i]
+    PREFIX_SUM_EXCLUSIVE = 1    // out[i] 只到 data[i - 1]，out[0] 为 0
+} PrefixSumMode;
+
+CPP_CALCULATOR_API CalculatorError prefix_sum_int32(const int32_t* data, size_t size, int64_t* out, PrefixSumMode mode, unsigned threads);
+CPP_CALCULATOR_API CalculatorError prefix_sum_double(const double* data, size_t size, double* out, PrefixSumMode mode, unsigned threads);
+CPP_CALCULATOR_API CalculatorError cumulative_min_int32(const int32_t* data, size_t size, int32_t* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError cumulative_min_double(const double* data, size_t size, double* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError cumulative_max_int32(const int32_t* data, size_t size, int32_t* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError cumulative_max_double(const double* data, size_t size, double* out, unsigned threads);
+// window 为 0 或大于 size 时返回 CALC_ERROR_INVALID_ARGUMENT；out 不能与 data 重叠
+CPP_CALCULATOR_API CalculatorError window_sum_int32(const int32_t* data, size_t size, size_t window, int64_t* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError window_sum_double(const double* data, size_t size, size_t window, double* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError window_min_int32(const int32_t* data, size_t size, size_t window, int32_t* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError window_min_double(const double* data, size_t size, size_t window, double* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError window_max_int32(const int32_t* data, size_t size, size_t window, int32_t* out, unsigned threads);
+CPP_CALCULATOR_API CalculatorError window_max_double(const double* data, size_t size, size_t window, double* out, unsigned threads);
+
+// 运行统计（见 Instrumentation.h）：只有以 ENABLE_INSTRUMENTATION=ON 构建时才记录，否则计数恒为 0。
+// 运算按下标 0 .. instrumentation_operation_count() - 1 枚举；latency_counts[b] 为延迟落在
+// [instrumentation_latency_bucket_floor(b), instrumentation_latency_bucket_floor(b + 1)) ns 的调用次数
+#define CALC_LATENCY_BUCKETS 160
+
+typedef struct {
+    const char* name;           // 运算名称，如 "matmul"
+    uint64_t calls;
+    uint64_t errors;            // 以异常结束的调用次数
+    uint64_t bytes;             // 处理的输入字节数
+    uint64_t total_ns;
+    uint64_t latency_counts[CALC_LATENCY_BUCKETS];
+} InstrumentationStats;
+
+CPP_CALCULATOR_API int instrumentation_is_enabled(void);
+CPP_CALCULATOR_API size_t instrumentation_operation_count(void);
+CPP_CALCULATOR_API CalculatorError instrumentation_get_stats(size_t index, InstrumentationStats* stats);
+CPP_CALCULATOR_API uint64_t instrumentation_latency_bucket_floor(size_t bucket);
+// 延迟的 q 分位数估计（ns），q ∈ [0, 1]
+CPP_CALCULATOR_API double instrumentation_latency_percentile(const InstrumentationStats* stats, double q);
+// C 接口把异常转换为 error 的次数
+CPP_CALCULATOR_API uint64_t instrumentation_error_code_count(CalculatorError error);
+CPP_CALCULATOR_API void instrumentation_reset(void);
+
+// 共享内存计算服务（见 CalcServer.h，请求格式见 calc_server_protocol.h）。服务进程 calc_server_start，
+// 各工作进程 calc_client_connect 后注册自己映射的共享内存段，请求以（段号, 偏移, 个数）引用其中的数组。
+// 服务未运行、段无法打开时返回 CALC_ERROR_IO。一个客户端句柄同一时刻只能由一个线程使用
+typedef struct CalcServerHandle CalcServerHandle;
+typedef struct CalcClientHandle CalcClientHandle;
+
+typedef struct {
+    unsigned slots;          // 最多同时连接的客户端数，0 为默认（64）
+    unsigned ring_capacity;  // 每个客户端最多未完成的请求数，0 为默认（64）
+    unsigned workers;        // 分派线程数，0 为 1
+    unsigned threads;        // matmul / sort / prefix_sum 使用的线程数，0 为全部硬件线程
+} CalcServerConfig;
+
+// config 可为 NULL（全部默认）
+CPP_CALCULATOR_API CalculatorError calc_server_start(const char* name, const CalcServerConfig* config, CalcServerHandle** server);
+// 停止服务并删除控制段
+CPP_CALCULATOR_API void calc_server_stop(CalcServerHandle* server);
+CPP_CALCULATOR_API uint64_t calc_server_completed_count(const CalcServerHandle* server);
+
+CPP_CALCULATOR_API CalculatorError calc_client_connect(const char* name, CalcClientHandle** client);
+CPP_CALCULATOR_API void calc_client_disconnect(CalcClientHandle* client);
+// 注册本进程映射在 [base, base + size) 的段 name（须以 "<服务名>_" 开头），*segment 为段号；注册 / 注销时不能有未完成的请求
+CPP_CALCULATOR_API CalculatorError calc_client_register_segment(CalcClientHandle* client, const char* name, const void* base,
+                                                                size_t size, uint32_t* segment);
+CPP_CALCULATOR_API CalculatorError calc_client_unregister_segment(CalcClientHandle* client, uint32_t segment);
+// 本进程地址 → 请求参数；不在已注册段内时返回 CALC_ERROR_INVALID_ARGUMENT
+CPP_CALCULATOR_API CalculatorError calc_client_operand(const CalcClientHandle* client, const void* ptr, size_t count,
+                                                       size_t element_size, CalcShmOperand* operand);
+// 异步：submit 后按提交顺序 wait 完成记录（timeout_ms < 0 为一直等待，超时返回 CALC_ERROR_TIMEOUT），
+// 完成记录的 status 为服务端的 CalcShmStatus
+CPP_CALCULATOR_API CalculatorError calc_client_submit(CalcClientHandle* client, const CalcShmRequest* request, uint64_t* id);
+CPP_CALCULATOR_API CalculatorError calc_client_wait(CalcClientHandle* client, int timeout_ms, CalcShmCompletion* completion);
+// 同步：提交并等待，status 转换为错误码（INVALID / FAILED → CALC_ERROR_INVALID_ARGUMENT，
+// EMPTY → CALC_ERROR_ARRAY_EMPTY，IO → CALC_ERROR_IO）。completion 可为 NULL
+CPP_CALCULATOR_API CalculatorError calc_client_call(CalcClientHandle* client, const CalcShmRequest* request,
+                                                    CalcShmCompletion* completion);
 
 // 工具函数
-const char* calculator_error_to_string(CalculatorError error);
+CPP_CALCULATOR_API const char* calculator_error_to_string(CalculatorError error);
 
 #ifdef __cplusplus
 }
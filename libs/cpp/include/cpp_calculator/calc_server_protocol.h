@@ -0,0 +1,77 @@
+#ifndef CALC_SERVER_PROTOCOL_H
+#define CALC_SERVER_PROTOCOL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 共享内存计算服务（见 CalcServer.h）的请求与完成记录，C / C++ 共用，布局固定。
+// 数组参数以（段号, 字节偏移, 元素个数）引用客户端注册过的共享内存段，请求本身不携带数据
+
+typedef enum {
+    CALC_SHM_OP_SUM = 0,          // args[0] 的和：int32 得到 int_value（int64），double 得到 value
+    CALC_SHM_OP_MIN = 1,          // args[0] 的最小值（int32 / double），空数组返回 CALC_SHM_STATUS_EMPTY
+    CALC_SHM_OP_MAX = 2,          // args[0] 的最大值
+    CALC_SHM_OP_DOT = 3,          // args[0]·args[1] → value（float / double，下同）
+    CALC_SHM_OP_NORM = 4,         // ‖args[0]‖ → value
+    CALC_SHM_OP_AXPY = 5,         // args[1] = scalar·args[0] + args[1]
+    CALC_SHM_OP_SCALE = 6,        // args[0] = scalar·args[0]
+    CALC_SHM_OP_FMA = 7,          // args[3] = args[0]·args[1] + args[2]
+    CALC_SHM_OP_POLY_EVAL = 8,    // args[2][i] = Σ args[0][j]·args[1][i]^j（系数按升幂排列）
+    CALC_SHM_OP_MATMUL = 9,       // args[2] = args[0]·args[1]，维度 m、k、n 依次为 dims[0..2]，args[2] 不能与输入重叠
+    CALC_SHM_OP_SORT = 10,        // args[0] 原地升序排序（int32 / float / double）
+    CALC_SHM_OP_PREFIX_SUM = 11,  // args[1] = args[0] 的前缀和（int32 / double，int32 的输出为 int64）；dims[0] 非 0 时为 exclusive
+
+    // 由客户端注册 / 注销段时发出：dims[0] 为段号，dims[1] 为客户端映射的字节数。
+    // 段名必须以 "<服务名>_" 开头（如服务 "/calc_server" 的 "/calc_server_data"），否则得到 CALC_SHM_STATUS_INVALID
+    CALC_SHM_OP_MAP_SEGMENT = 64,
+    CALC_SHM_OP_UNMAP_SEGMENT = 65
+} CalcShmOp;
+
+typedef enum {
+    CALC_SHM_INT32 = 0,
+    CALC_SHM_FLOAT = 1,
+    CALC_SHM_DOUBLE = 2
+} CalcShmDType;
+
+typedef enum {
+    CALC_SHM_STATUS_OK = 0,
+    CALC_SHM_STATUS_INVALID = 1,  // 未知运算 / 类型、参数越出段的范围或长度不符、段名不符合要求
+    CALC_SHM_STATUS_EMPTY = 2,    // min / max 的输入为空
+    CALC_SHM_STATUS_IO = 3,       // 服务端无法映射段，或参数所在的段在请求开始前或运算中途被客户端缩小
+    CALC_SHM_STATUS_FAILED = 4    // 运算中的其它错误（如内存不足）
+} CalcShmStatus;
+
+typedef struct {
+    uint32_t segment;   // 注册时得到的段号
+    uint32_t reserved;
+    uint64_t offset;    // 段内字节偏移，须按元素大小对齐
+    uint64_t count;     // 元素个数
+} CalcShmOperand;
+
+#define CALC_SHM_MAX_ARGS 4
+
+typedef struct {
+    uint64_t id;        // 由客户端在提交时填写，原样出现在完成记录中
+    uint32_t op;        // CalcShmOp
+    uint32_t dtype;     // CalcShmDType
+    double scalar;      // axpy / scale 的系数
+    uint64_t dims[3];
+    CalcShmOperand args[CALC_SHM_MAX_ARGS];
+} CalcShmRequest;
+
+typedef struct {
+    uint64_t id;
+    int32_t status;     // CalcShmStatus
+    uint32_t reserved;
+    double value;       // 标量结果（int32 的和、最值也换算到这里）
+    int64_t int_value;  // int32 的和 / 最值；写数组的运算为处理的元素个数
+} CalcShmCompletion;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CALC_SERVER_PROTOCOL_H
@@ -0,0 +1,14 @@
+#ifndef CPP_CALCULATOR_EXPORT_H
+#define CPP_CALCULATOR_EXPORT_H
+
+// 公开接口的导出标记：库以 -fvisibility=hidden 编译（见 cmake/BuildOptions.cmake），
+// 只有带 CPP_CALCULATOR_API 的类和函数进入共享库的动态符号表
+#if defined(_WIN32)
+#define CPP_CALCULATOR_API
+#elif defined(__GNUC__)
+#define CPP_CALCULATOR_API __attribute__((visibility("default")))
+#else
+#define CPP_CALCULATOR_API
+#endif
+
+#endif // CPP_CALCULATOR_EXPORT_H
@@ -0,0 +1,244 @@
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/Calculator.h"
+
+namespace
+{
+    void throwEmpty()
+    {
+        throw CalculatorException("Array is empty!");
+    }
+}
+
+// SumAccumulator
+template <typename T>
+void SumAccumulator<T>::update(const T *data, size_t size)
+{
+    sum_type sum = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        sum += data[i];
+    }
+    sum_ += sum;
+    count_ += size;
+}
+
+template <typename T>
+void SumAccumulator<T>::merge(const SumAccumulator &other)
+{
+    sum_ += other.sum_;
+    count_ += other.count_;
+}
+
+template <typename T>
+void SumAccumulator<T>::reset()
+{
+    sum_ = 0;
+    count_ = 0;
+}
+
+// MinAccumulator
+template <typename T>
+void MinAccumulator<T>::update(const T *data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    T min = count_ ? min_ : data[0];
+    for (size_t i = 0; i < size; ++i)
+    {
+        min = data[i] < min ? data[i] : min;
+    }
+    min_ = min;
+    count_ += size;
+}
+
+template <typename T>
+void MinAccumulator<T>::merge(const MinAccumulator &other)
+{
+    if (other.count_ == 0)
+    {
+        return;
+    }
+    if (count_ == 0 || other.min_ < min_)
+    {
+        min_ = other.min_;
+    }
+    count_ += other.count_;
+}
+
+template <typename T>
+void MinAccumulator<T>::reset()
+{
+    min_ = 0;
+    count_ = 0;
+}
+
+template <typename T>
+T MinAccumulator<T>::result() const
+{
+    if (count_ == 0)
+    {
+        throwEmpty();
+    }
+    return min_;
+}
+
+// MaxAccumulator
+template <typename T>
+void MaxAccumulator<T>::update(const T *data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    T max = count_ ? max_ : data[0];
+    for (size_t i = 0; i < size; ++i)
+    {
+        max = data[i] > max ? data[i] : max;
+    }
+    max_ = max;
+    count_ += size;
+}
+
+template <typename T>
+void MaxAccumulator<T>::merge(const MaxAccumulator &other)
+{
+    if (other.count_ == 0)
+    {
+        return;
+    }
+    if (count_ == 0 || other.max_ > max_)
+    {
+        max_ = other.max_;
+    }
+    count_ += other.count_;
+}
+
+template <typename T>
+void MaxAccumulator<T>::reset()
+{
+    max_ = 0;
+    count_ = 0;
+}
+
+template <typename T>
+T MaxAccumulator<T>::result() const
+{
+    if (count_ == 0)
+    {
+        throwEmpty();
+    }
+    return max_;
+}
+
+// StatsAccumulator
+template <typename T>
+void StatsAccumulator<T>::update(const T *data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    // 第一遍：块内求和与最值
+    StatsAccumulator chunk;
+    chunk.count_ = size;
+    chunk.min_ = data[0];
+    chunk.max_ = data[0];
+    for (size_t i = 0; i < size; ++i)
+    {
+        chunk.sum_ += data[i];
+        chunk.min_ = data[i] < chunk.min_ ? data[i] : chunk.min_;
+        chunk.max_ = data[i] > chunk.max_ ? data[i] : chunk.max_;
+    }
+
+    // 第二遍：块内二阶中心矩（块已在缓存中）
+    chunk.mean_ = static_cast<double>(chunk.sum_) / static_cast<double>(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        double d = static_cast<double>(data[i]) - chunk.mean_;
+        chunk.m2_ += d * d;
+    }
+
+    merge(chunk);
+}
+
+template <typename T>
+void StatsAccumulator<T>::merge(const StatsAccumulator &other)
+{
+    if (other.count_ == 0)
+    {
+        return;
+    }
+    if (count_ == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    double n_a = static_cast<double>(count_);
+    double n_b = static_cast<double>(other.count_);
+    double n = n_a + n_b;
+    double delta = other.mean_ - mean_;
+
+    mean_ += delta * n_b / n;
+    m2_ += other.m2_ + delta * delta * n_a * n_b / n;
+    sum_ += other.sum_;
+    min_ = other.min_ < min_ ? other.min_ : min_;
+    max_ = other.max_ > max_ ? other.max_ : max_;
+    count_ += other.count_;
+}
+
+template <typename T>
+void StatsAccumulator<T>::reset()
+{
+    *this = StatsAccumulator();
+}
+
+template <typename T>
+void StatsAccumulator<T>::checkNotEmpty() const
+{
+    if (count_ == 0)
+    {
+        throwEmpty();
+    }
+}
+
+template <typename T>
+T StatsAccumulator<T>::min() const
+{
+    checkNotEmpty();
+    return min_;
+}
+
+template <typename T>
+T StatsAccumulator<T>::max() const
+{
+    checkNotEmpty();
+    return max_;
+}
+
+template <typename T>
+double StatsAccumulator<T>::mean() const
+{
+    checkNotEmpty();
+    return mean_;
+}
+
+template <typename T>
+double StatsAccumulator<T>::variance() const
+{
+    checkNotEmpty();
+    return m2_ / static_cast<double>(count_);
+}
+
+// 显式实例化
+template class SumAccumulator<int32_t>;
+template class SumAccumulator<double>;
+template class MinAccumulator<int32_t>;
+template class MinAccumulator<double>;
+template class MaxAccumulator<int32_t>;
+template class MaxAccumulator<double>;
+template class StatsAccumulator<int32_t>;
+template class StatsAccumulator<double>;
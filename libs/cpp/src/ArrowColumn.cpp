@@ -0,0 +1,442 @@
+#include "cpp_calculator/ArrowColumn.h"
+#include "cpp_calculator/Calculator.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+ArrowColumnView::ArrowColumnView(const ArrowArray *array, const ArrowSchema *schema)
+    : type_(ArrowColumnType::Float64), values_(nullptr), validity_(nullptr),
+      bit_offset_(0), length_(0), null_count_(0)
+{
+    if (!array || !schema || !schema->format || !array->release || !schema->release)
+    {
+        throw CalculatorException("Invalid Arrow array: null or released structure");
+    }
+
+    std::string format = schema->format;
+    size_t width = 0;
+    if (format == "i")
+    {
+        type_ = ArrowColumnType::Int32;
+        width = 4;
+    }
+    else if (format == "l")
+    {
+        type_ = ArrowColumnType::Int64;
+        width = 8;
+    }
+    else if (format == "f")
+    {
+        type_ = ArrowColumnType::Float32;
+        width = 4;
+    }
+    else if (format == "g")
+    {
+        type_ = ArrowColumnType::Float64;
+        width = 8;
+    }
+    else
+    {
+        throw CalculatorException("Unsupported Arrow format: " + format);
+    }
+
+    if (array->n_buffers != 2 || !array->buffers || array->length < 0 || array->offset < 0)
+    {
+        throw CalculatorException("Invalid Arrow array: expected a primitive array with 2 buffers");
+    }
+
+    length_ = static_cast<size_t>(array->length);
+    null_count_ = array->null_count;
+    bit_offset_ = static_cast<size_t>(array->offset);
+    validity_ = static_cast<const uint8_t *>(array->buffers[0]);
+
+    const uint8_t *values = static_cast<const uint8_t *>(array->buffers[1]);
+    if (!values && length_ > 0)
+    {
+        throw CalculatorException("Invalid Arrow array: missing value buffer");
+    }
+    values_ = values ? values + bit_offset_ * width : nullptr;
+}
+
+uint64_t ArrowColumnView::validityWord(size_t index, size_t nbits) const
+{
+    uint64_t mask = nbits >= 64 ? ~uint64_t(0) : ((uint64_t(1) << nbits) - 1);
+    if (!validity_)
+    {
+        return mask;
+    }
+
+    // 位图只保证覆盖到最后一个元素所在的字节，按需拼接，避免越界读取
+    size_t bit = bit_offset_ + index;
+    size_t byte = bit / 8;
+    unsigned shift = static_cast<unsigned>(bit % 8);
+    size_t nbytes = (shift + nbits + 7) / 8;
+
+    uint64_t word = 0;
+    std::memcpy(&word, validity_ + byte, nbytes < 8 ? nbytes : 8);
+    word >>= shift;
+    if (nbytes > 8)
+    {
+        word |= uint64_t(validity_[byte + 8]) << (64 - shift);
+    }
+    return word & mask;
+}
+
+size_t ArrowColumnView::validCount() const
+{
+    if (!validity_)
+    {
+        return length_;
+    }
+    if (null_count_ >= 0)
+    {
+        return length_ - static_cast<size_t>(null_count_);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < length_; i += 64)
+    {
+        size_t n = length_ - i < 64 ? length_ - i : 64;
+        count += static_cast<size_t>(__builtin_popcountll(validityWord(i, n)));
+    }
+    return count;
+}
+
+namespace
+{
+    template <typename F>
+    auto dispatch(const ArrowColumnView &column, F &&f) -> decltype(f(static_cast<const double *>(nullptr)))
+    {
+        switch (column.type())
+        {
+        case ArrowColumnType::Int32:
+            return f(column.values<int32_t>());
+        case ArrowColumnType::Int64:
+            return f(column.values<int64_t>());
+        case ArrowColumnType::Float32:
+            return f(column.values<float>());
+        case ArrowColumnType::Float64:
+        default:
+            return f(column.values<double>());
+        }
+    }
+
+    // 整数列用 int64 精确求和，浮点列用 double
+    template <typename T>
+    struct ColumnSumType
+    {
+        using type = int64_t;
+    };
+    template <>
+    struct ColumnSumType<float>
+    {
+        using type = double;
+    };
+    template <>
+    struct ColumnSumType<double>
+    {
+        using type = double;
+    };
+
+    template <typename T>
+    double sum_values(const ArrowColumnView &column, const T *values)
+    {
+        using Acc = typename ColumnSumType<T>::type;
+        size_t length = column.length();
+        Acc sum = 0;
+
+        if (!column.hasNulls())
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                sum += values[i];
+            }
+            return static_cast<double>(sum);
+        }
+
+        for (size_t base = 0; base < length; base += 64)
+        {
+            size_t n = length - base < 64 ? length - base : 64;
+            uint64_t word = column.validityWord(base, n);
+            const T *block = values + base;
+            if (word == 0)
+            {
+                continue;
+            }
+
+            Acc block_sum = 0;
+            if (n == 64 && word == ~uint64_t(0))
+            {
+                for (size_t j = 0; j < 64; ++j)
+                {
+                    block_sum += block[j];
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < n; ++j)
+                {
+                    block_sum += ((word >> j) & 1) ? static_cast<Acc>(block[j]) : Acc(0);
+                }
+            }
+            sum += block_sum;
+        }
+        return static_cast<double>(sum);
+    }
+
+    // NaN 作为 x 时比较为假，结果保持 acc，NaN 不会进入结果
+    template <bool WantMax, typename T>
+    T pick(T acc, T x)
+    {
+        return WantMax ? std::max(acc, x) : std::min(acc, x);
+    }
+
+    // 无空值的连续区间：整数类型的 std::max / std::min 归约由编译器向量化
+    template <bool WantMax, typename T>
+    T dense_extreme(const T *data, size_t n, T best)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            best = pick<WantMax>(best, data[i]);
+        }
+        return best;
+    }
+
+    // 空值位置用哨兵值代替。整数用位掩码选择：写成条件表达式时编译器会把常量哨兵折叠成条件归约，循环无法向量化
+    template <typename T>
+    T valid_or(T x, uint64_t bit, T sentinel, std::true_type)
+    {
+        T keep = -static_cast<T>(bit);
+        return static_cast<T>((x & keep) | (sentinel & ~keep));
+    }
+
+    template <typename T>
+    T valid_or(T x, uint64_t bit, T sentinel, std::false_type)
+    {
+        return bit ? x : sentinel;
+    }
+
+    // 混合块：空值位置的值缓冲区同样可读，无条件读出后替换，循环无分支
+    template <bool WantMax, typename T>
+    T masked_extreme(const T *data, size_t n, uint64_t word, T sentinel, T best)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            best = pick<WantMax>(best, valid_or(data[j], (word >> j) & 1, sentinel, std::is_integral<T>()));
+        }
+        return best;
+    }
+
+#if defined(__SSE2__)
+    // 浮点比较不满足结合律，编译器不会向量化上面的归约，这里用 SSE2 显式实现
+    template <bool WantMax>
+    __m128d extreme(__m128d acc, __m128d x) { return WantMax ? _mm_max_pd(x, acc) : _mm_min_pd(x, acc); }
+
+    template <bool WantMax>
+    __m128 extreme(__m128 acc, __m128 x) { return WantMax ? _mm_max_ps(x, acc) : _mm_min_ps(x, acc); }
+
+    template <bool WantMax>
+    double dense_extreme(const double *data, size_t n, double best)
+    {
+        size_t i = 0;
+        __m128d acc0 = _mm_set1_pd(best), acc1 = acc0;
+        for (; i + 4 <= n; i += 4)
+        {
+            acc0 = extreme<WantMax>(acc0, _mm_loadu_pd(data + i));
+            acc1 = extreme<WantMax>(acc1, _mm_loadu_pd(data + i + 2));
+        }
+        acc0 = extreme<WantMax>(acc0, acc1);
+        acc0 = extreme<WantMax>(acc0, _mm_unpackhi_pd(acc0, acc0));
+        best = _mm_cvtsd_f64(acc0);
+        for (; i < n; ++i)
+        {
+            best = pick<WantMax>(best, data[i]);
+        }
+        return best;
+    }
+
+    template <bool WantMax>
+    float dense_extreme(const float *data, size_t n, float best)
+    {
+        size_t i = 0;
+        __m128 acc0 = _mm_set1_ps(best), acc1 = acc0;
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = extreme<WantMax>(acc0, _mm_loadu_ps(data + i));
+            acc1 = extreme<WantMax>(acc1, _mm_loadu_ps(data + i + 4));
+        }
+        acc0 = extreme<WantMax>(acc0, acc1);
+        acc0 = extreme<WantMax>(acc0, _mm_movehl_ps(acc0, acc0));
+        acc0 = extreme<WantMax>(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(1, 1, 1, 1)));
+        best = _mm_cvtss_f32(acc0);
+        for (; i < n; ++i)
+        {
+            best = pick<WantMax>(best, data[i]);
+        }
+        return best;
+    }
+
+    // 有效位广播到每个 32 位通道后与通道位比较得到掩码，无效通道换成哨兵值
+    template <bool WantMax>
+    double masked_extreme(const double *data, size_t n, uint64_t word, double sentinel, double best)
+    {
+        const __m128i lanes = _mm_set_epi32(2, 2, 1, 1);
+        const __m128d fill = _mm_set1_pd(sentinel);
+        __m128d acc = _mm_set1_pd(best);
+        size_t j = 0;
+        for (; j + 2 <= n; j += 2)
+        {
+            __m128i bits = _mm_and_si128(_mm_set1_epi32(static_cast<int>((word >> j) & 3)), lanes);
+            __m128d keep = _mm_castsi128_pd(_mm_cmpeq_epi32(bits, lanes));
+            __m128d x = _mm_or_pd(_mm_and_pd(keep, _mm_loadu_pd(data + j)), _mm_andnot_pd(keep, fill));
+            acc = extreme<WantMax>(acc, x);
+        }
+        acc = extreme<WantMax>(acc, _mm_unpackhi_pd(acc, acc));
+        best = _mm_cvtsd_f64(acc);
+        for (; j < n; ++j)
+        {
+            best = pick<WantMax>(best, ((word >> j) & 1) ? data[j] : sentinel);
+        }
+        return best;
+    }
+
+    template <bool WantMax>
+    float masked_extreme(const float *data, size_t n, uint64_t word, float sentinel, float best)
+    {
+        const __m128i lanes = _mm_set_epi32(8, 4, 2, 1);
+        const __m128 fill = _mm_set1_ps(sentinel);
+        __m128 acc = _mm_set1_ps(best);
+        size_t j = 0;
+        for (; j + 4 <= n; j += 4)
+        {
+            __m128i bits = _mm_and_si128(_mm_set1_epi32(static_cast<int>((word >> j) & 15)), lanes);
+            __m128 keep = _mm_castsi128_ps(_mm_cmpeq_epi32(bits, lanes));
+            __m128 x = _mm_or_ps(_mm_and_ps(keep, _mm_loadu_ps(data + j)), _mm_andnot_ps(keep, fill));
+            acc = extreme<WantMax>(acc, x);
+        }
+        acc = extreme<WantMax>(acc, _mm_movehl_ps(acc, acc));
+        acc = extreme<WantMax>(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+        best = _mm_cvtss_f32(acc);
+        for (; j < n; ++j)
+        {
+            best = pick<WantMax>(best, ((word >> j) & 1) ? data[j] : sentinel);
+        }
+        return best;
+    }
+#endif
+
+    template <typename T, bool WantMax>
+    double extreme_values(const ArrowColumnView &column, const T *values)
+    {
+        // 浮点哨兵用 ±inf，全为 ∓inf 的列才能得到 ∓inf 本身
+        using Limits = std::numeric_limits<T>;
+        const T sentinel = Limits::has_infinity ? (WantMax ? -Limits::infinity() : Limits::infinity())
+                                                : (WantMax ? Limits::lowest() : Limits::max());
+        size_t length = column.length();
+        T best = sentinel;
+        bool seen = false;
+
+        if (!column.hasNulls())
+        {
+            seen = length > 0;
+            best = dense_extreme<WantMax>(values, length, best);
+        }
+        else
+        {
+            for (size_t base = 0; base < length; base += 64)
+            {
+                size_t n = length - base < 64 ? length - base : 64;
+                uint64_t word = column.validityWord(base, n);
+                if (word == 0)
+                {
+                    continue;
+                }
+                seen = true;
+
+                const T *block = values + base;
+                if (n == 64 && word == ~uint64_t(0))
+                {
+                    best = dense_extreme<WantMax>(block, 64, best);
+                }
+                else
+                {
+                    best = masked_extreme<WantMax>(block, n, word, sentinel, best);
+                }
+            }
+        }
+
+        if (!seen)
+        {
+            throw CalculatorException("Array is empty!");
+        }
+        return static_cast<double>(best);
+    }
+
+    template <typename T>
+    void add_values(const ArrowColumnView &column, const T *values, double addend, double *results)
+    {
+        size_t length = column.length();
+        if (!column.hasNulls())
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                results[i] = static_cast<double>(values[i]) + addend;
+            }
+            return;
+        }
+
+        for (size_t base = 0; base < length; base += 64)
+        {
+            size_t n = length - base < 64 ? length - base : 64;
+            uint64_t word = column.validityWord(base, n);
+            const T *block = values + base;
+            double *out = results + base;
+            for (size_t j = 0; j < n; ++j)
+            {
+                out[j] = ((word >> j) & 1) ? static_cast<double>(block[j]) + addend : 0.0;
+            }
+        }
+    }
+}
+
+double arrow_column_sum(const ArrowColumnView &column)
+{
+    return dispatch(column, [&column](const auto *values) { return sum_values(column, values); });
+}
+
+double arrow_column_max(const ArrowColumnView &column)
+{
+    return dispatch(column, [&column](const auto *values) {
+        using T = typename std::remove_const<typename std::remove_pointer<decltype(values)>::type>::type;
+        return extreme_values<T, true>(column, values);
+    });
+}
+
+double arrow_column_min(const ArrowColumnView &column)
+{
+    return dispatch(column, [&column](const auto *values) {
+        using T = typename std::remove_const<typename std::remove_pointer<decltype(values)>::type>::type;
+        return extreme_values<T, false>(column, values);
+    });
+}
+
+void arrow_column_add(const ArrowColumnView &column, double addend, double *results, uint8_t *validity_out)
+{
+    dispatch(column, [&](const auto *values) { add_values(column, values, addend, results); });
+
+    if (validity_out)
+    {
+        size_t length = column.length();
+        for (size_t base = 0; base < length; base += 64)
+        {
+            size_t n = length - base < 64 ? length - base : 64;
+            uint64_t word = column.validityWord(base, n);
+            std::memcpy(validity_out + base / 8, &word, (n + 7) / 8);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "cpp_calculator/Blas.h"
+#include "Instrument.h"
+#include "Probe.h"
+#ifdef CPP_CALCULATOR_NO_ASM
+#include <cmath>
+
+namespace
+{
+    // 没有 NASM 时的可移植实现（交给编译器自动向量化）
+    template <typename T>
+    T dot(const T *x, const T *y, size_t n)
+    {
+        T sum = 0;
+        for (size_t i = 0; i < n; ++i)
+            sum += x[i] * y[i];
+        return sum;
+    }
+    template <typename T>
+    void axpyKernel(T a, const T *x, T *y, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            y[i] += a * x[i];
+    }
+    template <typename T>
+    void scale(T a, T *x, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            x[i] *= a;
+    }
+    template <typename T>
+    T norm(const T *x, size_t n)
+    {
+        return std::sqrt(dot(x, x, n));
+    }
+    template <typename T>
+    void multiplyAdd(const T *a, const T *b, const T *c, T *out, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = a[i] * b[i] + c[i];
+    }
+}
+#else
+#include <asm_math_ops/math_ops_asm.h>
+
+namespace
+{
+    // 按元素类型选择汇编内核
+    inline double dot(const double *x, const double *y, size_t n) { return asm_dot_f64(x, y, n); }
+    inline float dot(const float *x, const float *y, size_t n) { return asm_dot_f32(x, y, n); }
+    inline void axpyKernel(double a, const double *x, double *y, size_t n) { asm_axpy_f64(a, x, y, n); }
+    inline void axpyKernel(float a, const float *x, float *y, size_t n) { asm_axpy_f32(a, x, y, n); }
+    inline void scale(double a, double *x, size_t n) { asm_scale_f64(a, x, n); }
+    inline void scale(float a, float *x, size_t n) { asm_scale_f32(a, x, n); }
+    inline double norm(const double *x, size_t n) { return asm_norm2_f64(x, n); }
+    inline float norm(const float *x, size_t n) { return asm_norm2_f32(x, n); }
+    inline void multiplyAdd(const double *a, const double *b, const double *c, double *out, size_t n) { asm_fma_f64(a, b, c, out, n); }
+    inline void multiplyAdd(const float *a, const float *b, const float *c, float *out, size_t n) { asm_fma_f32(a, b, c, out, n); }
+}
+#endif
+
+template <typename T>
+T dot_product(const T *x, const T *y, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Dot, 2 * size * sizeof(T));
+    return dot(x, y, size);
+}
+
+template <typename T>
+void axpy(T a, const T *x, T *y, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Axpy, 2 * size * sizeof(T));
+    axpyKernel(a, x, y, size);
+}
+
+template <typename T>
+void scale_values(T a, T *x, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Scale, size * sizeof(T));
+    scale(a, x, size);
+}
+
+template <typename T>
+T norm2(const T *x, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Norm, size * sizeof(T));
+    return norm(x, size);
+}
+
+template <typename T>
+void fused_multiply_add(const T *a, const T *b, const T *c, T *out, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Fma, 3 * size * sizeof(T));
+    multiplyAdd(a, b, c, out, size);
+}
+
+// 显式实例化
+template double dot_product<double>(const double *, const double *, size_t);
+template float dot_product<float>(const float *, const float *, size_t);
+template void axpy<double>(double, const double *, double *, size_t);
+template void axpy<float>(float, const float *, float *, size_t);
+template void scale_values<double>(double, double *, size_t);
+template void scale_values<float>(float, float *, size_t);
+template double norm2<double>(const double *, size_t);
+template float norm2<float>(const float *, size_t);
+template void fused_multiply_add<double>(const double *, const double *, const double *, double *, size_t);
+template void fused_multiply_add<float>(const float *, const float *, const float *, float *, size_t);
@@ -0,0 +1,47 @@
+#include "BusGuard.h"
+#include <mutex>
+#include <signal.h>
+
+namespace
+{
+    struct sigaction previous_action;
+    std::once_flag install_once;
+
+    void onBusError(int sig, siginfo_t *info, void *context)
+    {
+        if (sigjmp_buf *point = busguard::recoveryPoint())
+        {
+            siglongjmp(*point, 1);
+        }
+
+        // 不是受保护的访问：交给安装前的处理函数；默认处理时恢复原设置，返回后重新执行出错的指令即按默认方式终止
+        if (previous_action.sa_flags & SA_SIGINFO)
+        {
+            previous_action.sa_sigaction(sig, info, context);
+        }
+        else if (previous_action.sa_handler != SIG_DFL && previous_action.sa_handler != SIG_IGN)
+        {
+            previous_action.sa_handler(sig);
+        }
+        else
+        {
+            ::sigaction(SIGBUS, &previous_action, nullptr);
+            if (info->si_code <= 0)
+            {
+                // kill / raise 发来的信号不会重新产生
+                ::raise(sig);
+            }
+        }
+    }
+}
+
+void busguard::install()
+{
+    std::call_once(install_once, [] {
+        struct sigaction action;
+        action.sa_sigaction = onBusError;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_SIGINFO;
+        ::sigaction(SIGBUS, &action, &previous_action);
+    });
+}
@@ -0,0 +1,57 @@
+#ifndef BUS_GUARD_H
+#define BUS_GUARD_H
+
+// 库内部使用的 SIGBUS 恢复（CalcServer.cpp / Parallel.h），不安装。
+// 服务端在原地读写客户端的共享内存段，客户端可以随时用 ftruncate 缩小段，之后访问超出部分的页会收到 SIGBUS。
+// busguard::run(fn) 在当前线程上执行 fn，期间的 SIGBUS 由 install() 安装的处理函数 siglongjmp 回到 run，
+// 再以 BusError 异常抛出。跳过的栈帧不会析构：fn 中分配的临时缓冲区会泄漏，fn 内也不能持有锁。
+// 受保护的线程调用 parallel::forEachBlock 时，每一块（包括辅助线程上的块）都在各自的保护下执行
+
+#include <setjmp.h>
+
+namespace busguard
+{
+    struct BusError
+    {
+    };
+
+    // 安装进程级的 SIGBUS 处理函数，重复调用无效。不在保护范围内的 SIGBUS 交给原来的处理方式
+    void install();
+
+    // 当前线程的恢复点，不在保护范围内时为 nullptr
+    inline sigjmp_buf *&recoveryPoint()
+    {
+        static thread_local sigjmp_buf *point = nullptr;
+        return point;
+    }
+
+    inline bool active()
+    {
+        return recoveryPoint() != nullptr;
+    }
+
+    template <typename Fn>
+    void run(Fn &&fn)
+    {
+        sigjmp_buf env;
+        sigjmp_buf *saved = recoveryPoint();
+        if (sigsetjmp(env, 1) != 0)
+        {
+            recoveryPoint() = saved;
+            throw BusError();
+        }
+        recoveryPoint() = &env;
+        try
+        {
+            fn();
+        }
+        catch (...)
+        {
+            recoveryPoint() = saved;
+            throw;
+        }
+        recoveryPoint() = saved;
+    }
+}
+
+#endif // BUS_GUARD_H
@@ -0,0 +1,973 @@
+#include "cpp_calculator/CalcServer.h"
+#include "BusGuard.h"
+#include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/Blas.h"
+#include "cpp_calculator/Gemm.h"
+#include "cpp_calculator/Polynomial.h"
+#include "cpp_calculator/Scan.h"
+#include "cpp_calculator/Sort.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+    const char kMagic[8] = {'C', 'A', 'L', 'C', 'S', 'H', 'M', '1'};
+    const uint32_t kVersion = 1;
+    const unsigned kMaxWorkers = 16;
+    const unsigned kMaxRingCapacity = 1u << 16;
+    const uint32_t kSegmentsPerClient = 16;
+    const size_t kSegmentNameBytes = 64; // 含结尾 '\0'
+    const int kLivenessCheckMs = 100;    // 睡眠中的一方至少每隔这么久检查一次对方是否还在
+    const std::chrono::microseconds kClientSpin(20);
+
+    // 控制段中的原子变量被多个进程直接访问，必须是无锁（因而与地址空间无关）的
+    static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+                  "shared-memory rings need lock-free atomics");
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words must be plain 32-bit integers");
+    static_assert(sizeof(CalcShmRequest) == 144, "request layout must not change");
+    static_assert(sizeof(CalcShmCompletion) == 32, "completion layout must not change");
+
+    enum : uint32_t
+    {
+        kServerStarting = 0,
+        kServerRunning = 1,
+        kServerStopped = 2
+    };
+
+    enum : uint32_t
+    {
+        kSlotFree = 0,
+        kSlotAttached = 1,
+        kSlotClosing = 2 // 客户端已断开，等待服务端回收
+    };
+
+    // 门铃：客户端提交请求后把 seq 加一；分派线程睡眠前置 sleeping，客户端只在其为 1 时发起唤醒
+    struct alignas(64) Doorbell
+    {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> sleeping;
+    };
+
+    struct alignas(64) ControlHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t ring_capacity;
+        uint32_t workers;
+        uint64_t slot_bytes;
+        int32_t server_pid;
+        std::atomic<uint32_t> state;
+        Doorbell bells[kMaxWorkers];
+    };
+
+    // 槽位头部，其后依次是 ring_capacity 个请求和 ring_capacity 个完成记录。
+    // 头尾序号单调递增；客户端写和服务端写的字段分处不同的缓存行
+    struct alignas(64) SlotHeader
+    {
+        std::atomic<uint32_t> state;
+        std::atomic<int32_t> pid;                    // 客户端进程，用于回收已退出进程的槽位
+        alignas(64) std::atomic<uint64_t> req_head;  // 客户端写
+        std::atomic<uint32_t> client_waiting;        // 客户端写：正在（将要）等待 done_seq
+        alignas(64) std::atomic<uint64_t> req_tail;  // 以下由服务端写
+        std::atomic<uint64_t> done_head;
+        std::atomic<uint32_t> done_seq;              // 每写入一个完成记录加一，客户端在其上等待
+        char segment_names[kSegmentsPerClient][kSegmentNameBytes]; // 客户端注册段时写入，随后发出 MAP 请求
+    };
+
+    size_t slotBytes(uint32_t ring_capacity)
+    {
+        size_t bytes = sizeof(SlotHeader) + ring_capacity * (sizeof(CalcShmRequest) + sizeof(CalcShmCompletion));
+        return (bytes + 63) / 64 * 64;
+    }
+
+    SlotHeader *slotAt(void *control, uint32_t index)
+    {
+        ControlHeader *header = static_cast<ControlHeader *>(control);
+        return reinterpret_cast<SlotHeader *>(static_cast<char *>(control) + sizeof(ControlHeader) +
+                                              index * header->slot_bytes);
+    }
+
+    CalcShmRequest *requestRing(SlotHeader *slot)
+    {
+        return reinterpret_cast<CalcShmRequest *>(slot + 1);
+    }
+
+    CalcShmCompletion *completionRing(SlotHeader *slot, uint32_t ring_capacity)
+    {
+        return reinterpret_cast<CalcShmCompletion *>(requestRing(slot) + ring_capacity);
+    }
+
+    // 共享内存中的 futex（不加 FUTEX_PRIVATE_FLAG，跨进程有效）
+    void futexWait(std::atomic<uint32_t> &word, uint32_t expected, int timeout_ms)
+    {
+        struct timespec ts;
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000;
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+    }
+
+    void futexWake(std::atomic<uint32_t> &word, int count)
+    {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+    }
+
+    // 提交方：先发布数据再加序号，然后只在对方登记了睡眠时才唤醒。
+    // 等待方先读序号、登记睡眠、再检查一遍数据，之后 futex 比较序号：两边都用 seq_cst，不会漏掉唤醒
+    void ringBell(Doorbell &bell)
+    {
+        bell.seq.fetch_add(1, std::memory_order_seq_cst);
+        if (bell.sleeping.load(std::memory_order_seq_cst))
+        {
+            futexWake(bell.seq, 1);
+        }
+    }
+
+    bool processAlive(int32_t pid)
+    {
+        return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+    }
+
+    CalcServerOptions normalizeOptions(CalcServerOptions options)
+    {
+        options.slots = std::max(1u, options.slots);
+        options.workers = std::min(std::max(1u, options.workers), std::min(kMaxWorkers, options.slots));
+        if (options.ring_capacity > kMaxRingCapacity)
+        {
+            throw CalculatorException("Calculation server ring capacity must not exceed 65536!");
+        }
+        unsigned capacity = 2;
+        while (capacity < options.ring_capacity)
+        {
+            capacity <<= 1;
+        }
+        options.ring_capacity = capacity;
+        return options;
+    }
+
+    // 删除异常退出的服务留下的控制段（魔数相符且服务进程已不存在）；其它情况交给创建时报错
+    void removeStaleControl(const std::string &name)
+    {
+        try
+        {
+            SharedMemorySegment old(name);
+            if (old.size() >= sizeof(ControlHeader))
+            {
+                const ControlHeader *header = old.as<ControlHeader>();
+                if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 && !processAlive(header->server_pid))
+                {
+                    ::shm_unlink(old.name().c_str());
+                }
+            }
+        }
+        catch (const CalculatorException &)
+        {
+            // 不存在或无法打开
+        }
+    }
+
+    SharedMemorySegment createControl(const std::string &name, const CalcServerOptions &options)
+    {
+        std::string normalized = SharedMemorySegment::normalizeName(name);
+        removeStaleControl(normalized);
+
+        size_t slot_bytes = slotBytes(options.ring_capacity);
+        SharedMemorySegment control(normalized, sizeof(ControlHeader) + options.slots * slot_bytes);
+        ControlHeader *header = new (control.data()) ControlHeader();
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->version = kVersion;
+        header->slot_count = options.slots;
+        header->ring_capacity = options.ring_capacity;
+        header->workers = options.workers;
+        header->slot_bytes = slot_bytes;
+        header->server_pid = static_cast<int32_t>(::getpid());
+        for (uint32_t i = 0; i < options.slots; ++i)
+        {
+            new (slotAt(control.data(), i)) SlotHeader();
+        }
+        return control;
+    }
+
+    // 请求中的参数越界、长度不符或类型不支持
+    struct InvalidRequest
+    {
+    };
+
+    // 参数所在的段在请求开始前已被客户端用 ftruncate 缩小
+    struct SegmentTruncated
+    {
+    };
+
+    using SegmentTable = std::array<std::unique_ptr<SharedMemorySegment>, kSegmentsPerClient>;
+
+    // 客户端只能注册以 "<服务名>_" 开头的段（名字都带开头的 '/'），不能让服务端打开控制段或其它无关的共享内存
+    bool segmentNameAllowed(const std::string &server, const std::string &name)
+    {
+        return name.size() > server.size() + 1 && name.compare(0, server.size(), server) == 0 &&
+               name[server.size()] == '_';
+    }
+
+    // 把参数解析为服务端映射中的地址，检查段号、对齐和范围。
+    // 段由客户端控制，映射之后仍可能被 ftruncate 缩小：开始前按 fstat 得到的当前大小再检查一遍，
+    // 运算中途被缩小时访问触发的 SIGBUS 由 execute 中的 busguard 转为 CALC_SHM_STATUS_IO
+    template <typename T>
+    T *resolve(SegmentTable &segments, const CalcShmOperand &arg)
+    {
+        if (arg.segment >= kSegmentsPerClient || !segments[arg.segment])
+        {
+            throw InvalidRequest();
+        }
+        SharedMemorySegment &segment = *segments[arg.segment];
+        if (arg.offset % alignof(T) != 0 || arg.offset > segment.size() ||
+            arg.count > (segment.size() - arg.offset) / sizeof(T))
+        {
+            throw InvalidRequest();
+        }
+        if (segment.currentSize() < arg.offset + arg.count * sizeof(T))
+        {
+            throw SegmentTruncated();
+        }
+        return reinterpret_cast<T *>(static_cast<char *>(segment.data()) + arg.offset);
+    }
+
+    void requireCount(const CalcShmOperand &arg, uint64_t count)
+    {
+        if (arg.count != count)
+        {
+            throw InvalidRequest();
+        }
+    }
+
+    // 输出不能与输入重叠的运算（矩阵乘法）使用
+    bool overlaps(const CalcShmOperand &a, const CalcShmOperand &b, size_t element_size)
+    {
+        return a.segment == b.segment && a.count != 0 && b.count != 0 &&
+               a.offset < b.offset + b.count * element_size && b.offset < a.offset + a.count * element_size;
+    }
+
+    void setResult(CalcShmCompletion &completion, int64_t value)
+    {
+        completion.int_value = value;
+        completion.value = static_cast<double>(value);
+    }
+
+    void setResult(CalcShmCompletion &completion, int32_t value)
+    {
+        setResult(completion, static_cast<int64_t>(value));
+    }
+
+    void setResult(CalcShmCompletion &completion, double value)
+    {
+        completion.value = value;
+    }
+
+    // sum / min / max（int32 / double）
+    template <typename T>
+    void reduce(const CalcShmRequest &request, SegmentTable &segments, CalcShmCompletion &completion)
+    {
+        const T *x = resolve<const T>(segments, request.args[0]);
+        size_t n = static_cast<size_t>(request.args[0].count);
+        if (request.op == CALC_SHM_OP_SUM)
+        {
+            SumAccumulator<T> acc;
+            acc.update(x, n);
+            setResult(completion, acc.result());
+            return;
+        }
+        if (n == 0)
+        {
+            completion.status = CALC_SHM_STATUS_EMPTY;
+            return;
+        }
+        if (request.op == CALC_SHM_OP_MIN)
+        {
+            MinAccumulator<T> acc;
+            acc.update(x, n);
+            setResult(completion, acc.result());
+        }
+        else
+        {
+            MaxAccumulator<T> acc;
+            acc.update(x, n);
+            setResult(completion, acc.result());
+        }
+    }
+
+    // BLAS-1、多项式求值和矩阵乘法（float / double）
+    template <typename T>
+    void floatingOp(const CalcShmRequest &request, SegmentTable &segments, unsigned threads,
+                    CalcShmCompletion &completion)
+    {
+        const CalcShmOperand *args = request.args;
+        const uint64_t n = args[0].count;
+        switch (request.op)
+        {
+        case CALC_SHM_OP_DOT:
+            requireCount(args[1], n);
+            completion.value = dot_product(resolve<const T>(segments, args[0]), resolve<const T>(segments, args[1]), n);
+            break;
+        case CALC_SHM_OP_NORM:
+            completion.value = norm2(resolve<const T>(segments, args[0]), n);
+            break;
+        case CALC_SHM_OP_AXPY:
+            requireCount(args[1], n);
+            axpy(static_cast<T>(request.scalar), resolve<const T>(segments, args[0]), resolve<T>(segments, args[1]), n);
+            completion.int_value = static_cast<int64_t>(n);
+            break;
+        case CALC_SHM_OP_SCALE:
+            scale_values(static_cast<T>(request.scalar), resolve<T>(segments, args[0]), n);
+            completion.int_value = static_cast<int64_t>(n);
+            break;
+        case CALC_SHM_OP_FMA:
+            requireCount(args[1], n);
+            requireCount(args[2], n);
+            requireCount(args[3], n);
+            fused_multiply_add(resolve<const T>(segments, args[0]), resolve<const T>(segments, args[1]),
+                               resolve<const T>(segments, args[2]), resolve<T>(segments, args[3]), n);
+            completion.int_value = static_cast<int64_t>(n);
+            break;
+        case CALC_SHM_OP_POLY_EVAL:
+            requireCount(args[2], args[1].count);
+            poly_eval(resolve<const T>(segments, args[0]), n, resolve<const T>(segments, args[1]),
+                      resolve<T>(segments, args[2]), args[1].count);
+            completion.int_value = static_cast<int64_t>(args[1].count);
+            break;
+        case CALC_SHM_OP_MATMUL:
+        {
+            const uint64_t m = request.dims[0], k = request.dims[1], cols = request.dims[2];
+            const uint64_t limit = std::numeric_limits<uint64_t>::max();
+            if ((m != 0 && k > limit / m) || (k != 0 && cols > limit / k) || (m != 0 && cols > limit / m))
+            {
+                throw InvalidRequest();
+            }
+            requireCount(args[0], m * k);
+            requireCount(args[1], k * cols);
+            requireCount(args[2], m * cols);
+            if (overlaps(args[2], args[0], sizeof(T)) || overlaps(args[2], args[1], sizeof(T)))
+            {
+                throw InvalidRequest();
+            }
+            gemm(m, cols, k, resolve<const T>(segments, args[0]), k, resolve<const T>(segments, args[1]), cols,
+                 resolve<T>(segments, args[2]), cols, threads);
+            completion.int_value = static_cast<int64_t>(m * cols);
+            break;
+        }
+        default:
+            throw InvalidRequest();
+        }
+    }
+
+    template <typename T>
+    void sortOp(const CalcShmRequest &request, SegmentTable &segments, unsigned threads, CalcShmCompletion &completion)
+    {
+        sort_values(resolve<T>(segments, request.args[0]), request.args[0].count, threads);
+        completion.int_value = static_cast<int64_t>(request.args[0].count);
+    }
+
+    template <typename T>
+    void prefixSumOp(const CalcShmRequest &request, SegmentTable &segments, unsigned threads,
+                     CalcShmCompletion &completion)
+    {
+        const uint64_t n = request.args[0].count;
+        requireCount(request.args[1], n);
+        ScanMode mode = request.dims[0] ? ScanMode::Exclusive : ScanMode::Inclusive;
+        prefix_sum(resolve<const T>(segments, request.args[0]), n, resolve<scan_sum_t<T>>(segments, request.args[1]),
+                   mode, threads);
+        completion.int_value = static_cast<int64_t>(n);
+    }
+}
+
+// 每个分派线程处理固定的一组槽位，并持有这些客户端注册的段的映射
+struct CalcServer::Worker
+{
+    unsigned index;
+    std::vector<uint32_t> slots;
+    std::vector<SegmentTable> segments; // 槽位 s 对应 segments[s / workers]
+};
+
+// CalcServer 类的实现
+CalcServer::CalcServer(const std::string &name, const CalcServerOptions &options)
+    : options_(normalizeOptions(options)), control_(createControl(name, options_)), stop_(false), completed_(0)
+{
+    busguard::install();
+    for (unsigned w = 0; w < options_.workers; ++w)
+    {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->index = w;
+        for (uint32_t slot = w; slot < options_.slots; slot += options_.workers)
+        {
+            worker->slots.push_back(slot);
+        }
+        worker->segments.resize(worker->slots.size());
+        workers_.push_back(std::move(worker));
+    }
+
+    try
+    {
+        for (auto &worker : workers_)
+        {
+            threads_.emplace_back(&CalcServer::run, this, std::ref(*worker));
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+
+    control_.as<ControlHeader>()->state.store(kServerRunning, std::memory_order_release);
+}
+
+CalcServer::~CalcServer()
+{
+    stop();
+}
+
+void CalcServer::stop()
+{
+    ControlHeader *header = control_.as<ControlHeader>();
+    if (stop_.exchange(true))
+    {
+        return;
+    }
+
+    header->state.store(kServerStopped, std::memory_order_seq_cst);
+    for (unsigned w = 0; w < options_.workers; ++w)
+    {
+        header->bells[w].seq.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(header->bells[w].seq, INT_MAX);
+    }
+    for (auto &thread : threads_)
+    {
+        thread.join();
+    }
+    threads_.clear();
+
+    // 唤醒正在等待完成记录的客户端，它们随即发现服务已停止
+    for (uint32_t i = 0; i < options_.slots; ++i)
+    {
+        SlotHeader *slot = slotAt(control_.data(), i);
+        slot->done_seq.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(slot->done_seq, INT_MAX);
+    }
+}
+
+size_t CalcServer::clientCount() const
+{
+    size_t count = 0;
+    void *control = const_cast<void *>(control_.data());
+    for (uint32_t i = 0; i < options_.slots; ++i)
+    {
+        count += slotAt(control, i)->state.load(std::memory_order_relaxed) == kSlotAttached;
+    }
+    return count;
+}
+
+void CalcServer::run(Worker &worker)
+{
+    ControlHeader *header = control_.as<ControlHeader>();
+    Doorbell &bell = header->bells[worker.index];
+    const std::chrono::microseconds spin(options_.spin_us);
+    auto idle_since = std::chrono::steady_clock::now();
+
+    while (!stop_.load(std::memory_order_acquire))
+    {
+        bool busy = false;
+        for (uint32_t slot : worker.slots)
+        {
+            busy = serveSlot(worker, slot) || busy;
+        }
+        if (busy)
+        {
+            idle_since = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (std::chrono::steady_clock::now() - idle_since < spin)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // 登记睡眠后再检查一遍所有队列，之后提交的请求一定会改变 seq 或发起唤醒
+        uint32_t seq = bell.seq.load(std::memory_order_seq_cst);
+        bell.sleeping.store(1, std::memory_order_seq_cst);
+        bool pending = false;
+        for (uint32_t slot : worker.slots)
+        {
+            SlotHeader *s = slotAt(control_.data(), slot);
+            uint32_t state = s->state.load(std::memory_order_seq_cst);
+            pending = pending || state == kSlotClosing ||
+                      (state == kSlotAttached &&
+                       s->req_head.load(std::memory_order_seq_cst) != s->req_tail.load(std::memory_order_relaxed));
+        }
+        if (!pending && !stop_.load(std::memory_order_acquire))
+        {
+            futexWait(bell.seq, seq, kLivenessCheckMs);
+        }
+        bell.sleeping.store(0, std::memory_order_relaxed);
+
+        // 回收已退出的客户端进程占用的槽位
+        for (uint32_t slot : worker.slots)
+        {
+            SlotHeader *s = slotAt(control_.data(), slot);
+            if (s->state.load(std::memory_order_acquire) == kSlotAttached &&
+                s->pid.load(std::memory_order_acquire) > 0 && !processAlive(s->pid.load(std::memory_order_relaxed)))
+            {
+                resetSlot(worker, slot);
+            }
+        }
+        idle_since = std::chrono::steady_clock::now();
+    }
+}
+
+bool CalcServer::serveSlot(Worker &worker, uint32_t slot)
+{
+    SlotHeader *s = slotAt(control_.data(), slot);
+    uint32_t state = s->state.load(std::memory_order_acquire);
+    if (state == kSlotClosing)
+    {
+        resetSlot(worker, slot);
+        return true;
+    }
+    if (state != kSlotAttached)
+    {
+        return false;
+    }
+
+    uint64_t tail = s->req_tail.load(std::memory_order_relaxed);
+    const uint64_t head = s->req_head.load(std::memory_order_acquire);
+    if (tail == head)
+    {
+        return false;
+    }
+    if (head - tail > options_.ring_capacity)
+    {
+        // req_head 由客户端写入，超出容量（或小于 tail）说明客户端违反了协议：回收槽位，
+        // 不能按它去读环形队列之外的请求
+        resetSlot(worker, slot);
+        s->done_seq.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(s->done_seq, INT_MAX);
+        return true;
+    }
+
+    const uint32_t mask = options_.ring_capacity - 1;
+    CalcShmRequest *requests = requestRing(s);
+    CalcShmCompletion *completions = completionRing(s, options_.ring_capacity);
+    uint64_t done = s->done_head.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail)
+    {
+        // 先复制一份：客户端保证未取走完成记录的请求数不超过容量，两个队列都不会满
+        CalcShmRequest request = requests[tail & mask];
+        CalcShmCompletion completion = execute(worker, slot, request);
+        s->req_tail.store(tail + 1, std::memory_order_release);
+        completions[done & mask] = completion;
+        s->done_head.store(++done, std::memory_order_seq_cst);
+        s->done_seq.fetch_add(1, std::memory_order_seq_cst);
+        if (s->client_waiting.load(std::memory_order_seq_cst))
+        {
+            futexWake(s->done_seq, 1);
+        }
+        completed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void CalcServer::resetSlot(Worker &worker, uint32_t slot)
+{
+    for (auto &segment : worker.segments[slot / options_.workers])
+    {
+        segment.reset();
+    }
+
+    SlotHeader *s = slotAt(control_.data(), slot);
+    s->req_head.store(0, std::memory_order_relaxed);
+    s->req_tail.store(0, std::memory_order_relaxed);
+    s->done_head.store(0, std::memory_order_relaxed);
+    s->client_waiting.store(0, std::memory_order_relaxed);
+    std::memset(s->segment_names, 0, sizeof(s->segment_names));
+    s->pid.store(0, std::memory_order_relaxed);
+    s->state.store(kSlotFree, std::memory_order_release);
+}
+
+CalcShmCompletion CalcServer::execute(Worker &worker, uint32_t slot, const CalcShmRequest &request)
+{
+    CalcShmCompletion completion;
+    std::memset(&completion, 0, sizeof(completion));
+    completion.id = request.id;
+    completion.status = CALC_SHM_STATUS_OK;
+
+    SegmentTable &segments = worker.segments[slot / options_.workers];
+    const unsigned threads = options_.threads;
+    try
+    {
+        // 客户端可能在运算中途缩小段：这一请求以 CALC_SHM_STATUS_IO 结束，服务进程不会因 SIGBUS 退出
+        busguard::run([&] {
+            switch (request.op)
+            {
+            case CALC_SHM_OP_MAP_SEGMENT:
+            {
+                if (request.dims[0] >= kSegmentsPerClient)
+                {
+                    throw InvalidRequest();
+                }
+                char name[kSegmentNameBytes];
+                std::memcpy(name, slotAt(control_.data(), slot)->segment_names[request.dims[0]], sizeof(name));
+                name[sizeof(name) - 1] = '\0';
+                if (!segmentNameAllowed(control_.name(), SharedMemorySegment::normalizeName(name)))
+                {
+                    throw InvalidRequest();
+                }
+                std::unique_ptr<SharedMemorySegment> segment;
+                try
+                {
+                    segment.reset(new SharedMemorySegment(name));
+                }
+                catch (const CalculatorException &)
+                {
+                    completion.status = CALC_SHM_STATUS_IO;
+                    break;
+                }
+                // 客户端映射的范围必须在段内，之后按服务端看到的大小检查参数；
+                // 名字恰好符合前缀的另一个服务的控制段同样拒绝
+                if (segment->size() < request.dims[1] ||
+                    (segment->size() >= sizeof(ControlHeader) &&
+                     std::memcmp(segment->as<ControlHeader>()->magic, kMagic, sizeof(kMagic)) == 0))
+                {
+                    throw InvalidRequest();
+                }
+                completion.int_value = static_cast<int64_t>(segment->size());
+                segments[request.dims[0]] = std::move(segment);
+                break;
+            }
+            case CALC_SHM_OP_UNMAP_SEGMENT:
+                if (request.dims[0] >= kSegmentsPerClient)
+                {
+                    throw InvalidRequest();
+                }
+                segments[request.dims[0]].reset();
+                break;
+            case CALC_SHM_OP_SUM:
+            case CALC_SHM_OP_MIN:
+            case CALC_SHM_OP_MAX:
+                if (request.dtype == CALC_SHM_INT32)
+                    reduce<int32_t>(request, segments, completion);
+                else if (request.dtype == CALC_SHM_DOUBLE)
+                    reduce<double>(request, segments, completion);
+                else
+                    throw InvalidRequest();
+                break;
+            case CALC_SHM_OP_DOT:
+            case CALC_SHM_OP_NORM:
+            case CALC_SHM_OP_AXPY:
+            case CALC_SHM_OP_SCALE:
+            case CALC_SHM_OP_FMA:
+            case CALC_SHM_OP_POLY_EVAL:
+            case CALC_SHM_OP_MATMUL:
+                if (request.dtype == CALC_SHM_FLOAT)
+                    floatingOp<float>(request, segments, threads, completion);
+                else if (request.dtype == CALC_SHM_DOUBLE)
+                    floatingOp<double>(request, segments, threads, completion);
+                else
+                    throw InvalidRequest();
+                break;
+            case CALC_SHM_OP_SORT:
+                if (request.dtype == CALC_SHM_INT32)
+                    sortOp<int32_t>(request, segments, threads, completion);
+                else if (request.dtype == CALC_SHM_FLOAT)
+                    sortOp<float>(request, segments, threads, completion);
+                else if (request.dtype == CALC_SHM_DOUBLE)
+                    sortOp<double>(request, segments, threads, completion);
+                else
+                    throw InvalidRequest();
+                break;
+            case CALC_SHM_OP_PREFIX_SUM:
+                if (request.dtype == CALC_SHM_INT32)
+                    prefixSumOp<int32_t>(request, segments, threads, completion);
+                else if (request.dtype == CALC_SHM_DOUBLE)
+                    prefixSumOp<double>(request, segments, threads, completion);
+                else
+                    throw InvalidRequest();
+                break;
+            default:
+                throw InvalidRequest();
+            }
+        });
+    }
+    catch (const InvalidRequest &)
+    {
+        completion.status = CALC_SHM_STATUS_INVALID;
+    }
+    catch (const SegmentTruncated &)
+    {
+        completion.status = CALC_SHM_STATUS_IO;
+    }
+    catch (const busguard::BusError &)
+    {
+        completion.status = CALC_SHM_STATUS_IO;
+    }
+    catch (...)
+    {
+        // 运算本身的异常（如内存不足）只影响这一个请求
+        completion.status = CALC_SHM_STATUS_FAILED;
+    }
+    return completion;
+}
+
+// CalcClient 类的实现
+namespace
+{
+    std::string notRunning(const std::string &name)
+    {
+        return "File I/O error: calculation server '" + name + "' is not running";
+    }
+
+    SharedMemorySegment openControl(const std::string &name)
+    {
+        SharedMemorySegment control(name);
+        const ControlHeader *header = control.as<ControlHeader>();
+        if (control.size() < sizeof(ControlHeader) || std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+            header->version != kVersion ||
+            control.size() < sizeof(ControlHeader) + header->slot_count * header->slot_bytes ||
+            header->state.load(std::memory_order_acquire) != kServerRunning)
+        {
+            throw CalculatorException(notRunning(control.name()));
+        }
+        return control;
+    }
+}
+
+CalcClient::CalcClient(const std::string &server_name)
+    : control_(openControl(server_name)), slot_(nullptr), bell_(nullptr), slot_index_(0), head_(0), tail_(0),
+      segments_(kSegmentsPerClient, Segment{nullptr, 0})
+{
+    ControlHeader *header = control_.as<ControlHeader>();
+    for (uint32_t i = 0; i < header->slot_count; ++i)
+    {
+        SlotHeader *s = slotAt(control_.data(), i);
+        uint32_t expected = kSlotFree;
+        if (s->state.compare_exchange_strong(expected, kSlotAttached, std::memory_order_acq_rel))
+        {
+            s->pid.store(static_cast<int32_t>(::getpid()), std::memory_order_release);
+            slot_ = s;
+            slot_index_ = i;
+            bell_ = &header->bells[i % header->workers];
+            return;
+        }
+    }
+    throw CalculatorException("Calculation server '" + control_.name() + "' has no free client slot!");
+}
+
+CalcClient::~CalcClient()
+{
+    SlotHeader *s = static_cast<SlotHeader *>(slot_);
+    s->state.store(kSlotClosing, std::memory_order_seq_cst);
+    ringBell(*static_cast<Doorbell *>(bell_));
+}
+
+bool CalcClient::serverAlive() const
+{
+    const ControlHeader *header = control_.as<ControlHeader>();
+    return header->state.load(std::memory_order_acquire) == kServerRunning && processAlive(header->server_pid);
+}
+
+uint32_t CalcClient::registerSegment(const std::string &name, const void *base, size_t size)
+{
+    std::string normalized = SharedMemorySegment::normalizeName(name);
+    if (normalized.size() >= kSegmentNameBytes)
+    {
+        throw CalculatorException("Shared memory segment name is too long!");
+    }
+    if (!base || size == 0)
+    {
+        throw CalculatorException("Cannot register a zero-size shared memory segment!");
+    }
+
+    uint32_t index = 0;
+    while (index < kSegmentsPerClient && segments_[index].base)
+    {
+        ++index;
+    }
+    if (index == kSegmentsPerClient)
+    {
+        throw CalculatorException("Too many registered shared memory segments!");
+    }
+
+    SlotHeader *s = static_cast<SlotHeader *>(slot_);
+    std::memcpy(s->segment_names[index], normalized.c_str(), normalized.size() + 1);
+    CalcShmRequest request;
+    std::memset(&request, 0, sizeof(request));
+    request.op = CALC_SHM_OP_MAP_SEGMENT;
+    request.dims[0] = index;
+    request.dims[1] = size;
+    call(request);
+    segments_[index] = Segment{static_cast<const char *>(base), size};
+    return index;
+}
+
+void CalcClient::unregisterSegment(uint32_t segment)
+{
+    if (segment >= kSegmentsPerClient || !segments_[segment].base)
+    {
+        throw CalculatorException("Unknown shared memory segment!");
+    }
+    CalcShmRequest request;
+    std::memset(&request, 0, sizeof(request));
+    request.op = CALC_SHM_OP_UNMAP_SEGMENT;
+    request.dims[0] = segment;
+    call(request);
+    segments_[segment] = Segment{nullptr, 0};
+}
+
+CalcShmOperand CalcClient::operand(const void *ptr, size_t count, size_t element_size) const
+{
+    uintptr_t p = reinterpret_cast<uintptr_t>(ptr);
+    if (element_size == 0 || count > std::numeric_limits<size_t>::max() / element_size)
+    {
+        throw CalculatorException("Invalid shared memory buffer size!");
+    }
+    size_t bytes = count * element_size;
+    for (uint32_t i = 0; i < kSegmentsPerClient; ++i)
+    {
+        uintptr_t base = reinterpret_cast<uintptr_t>(segments_[i].base);
+        if (base && p >= base && p - base <= segments_[i].size && bytes <= segments_[i].size - (p - base))
+        {
+            CalcShmOperand arg;
+            arg.segment = i;
+            arg.reserved = 0;
+            arg.offset = p - base;
+            arg.count = count;
+            return arg;
+        }
+    }
+    throw CalculatorException("Buffer is not inside a registered shared memory segment!");
+}
+
+uint64_t CalcClient::submit(CalcShmRequest request)
+{
+    ControlHeader *header = control_.as<ControlHeader>();
+    if (head_ - tail_ >= header->ring_capacity)
+    {
+        throw CalculatorException("Too many outstanding calculation server requests!");
+    }
+    if (header->state.load(std::memory_order_acquire) != kServerRunning)
+    {
+        throw CalculatorException(notRunning(control_.name()));
+    }
+
+    SlotHeader *s = static_cast<SlotHeader *>(slot_);
+    request.id = head_ + 1;
+    requestRing(s)[head_ & (header->ring_capacity - 1)] = request;
+    s->req_head.store(++head_, std::memory_order_seq_cst);
+    ringBell(*static_cast<Doorbell *>(bell_));
+    return request.id;
+}
+
+bool CalcClient::poll(CalcShmCompletion &completion)
+{
+    SlotHeader *s = static_cast<SlotHeader *>(slot_);
+    if (tail_ == head_ || s->done_head.load(std::memory_order_seq_cst) == tail_)
+    {
+        return false;
+    }
+    uint32_t capacity = control_.as<ControlHeader>()->ring_capacity;
+    completion = completionRing(s, capacity)[tail_ & (capacity - 1)];
+    ++tail_;
+    return true;
+}
+
+bool CalcClient::wait(CalcShmCompletion &completion, int timeout_ms)
+{
+    if (poll(completion))
+    {
+        return true;
+    }
+
+    // 小请求通常在几微秒内完成，先让出 CPU 轮询一小段时间，再睡眠
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < kClientSpin)
+    {
+        std::this_thread::yield();
+        if (poll(completion))
+        {
+            return true;
+        }
+    }
+
+    SlotHeader *s = static_cast<SlotHeader *>(slot_);
+    for (;;)
+    {
+        uint32_t seq = s->done_seq.load(std::memory_order_seq_cst);
+        s->client_waiting.store(1, std::memory_order_seq_cst);
+        if (poll(completion))
+        {
+            s->client_waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        if (!serverAlive())
+        {
+            s->client_waiting.store(0, std::memory_order_relaxed);
+            throw CalculatorException(notRunning(control_.name()));
+        }
+
+        int slice = kLivenessCheckMs;
+        if (timeout_ms >= 0)
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            int remaining = timeout_ms - static_cast<int>(elapsed.count());
+            if (remaining <= 0)
+            {
+                s->client_waiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            slice = std::min(slice, remaining);
+        }
+        futexWait(s->done_seq, seq, slice);
+        s->client_waiting.store(0, std::memory_order_relaxed);
+    }
+}
+
+CalcShmCompletion CalcClient::call(CalcShmRequest request)
+{
+    if (pending() != 0)
+    {
+        throw CalculatorException("Synchronous calculation server call with outstanding requests!");
+    }
+    submit(request);
+    CalcShmCompletion completion;
+    wait(completion); // 没有其它未完成的请求，下一个完成记录就是这一个
+    if (const char *message = statusMessage(completion.status))
+    {
+        throw CalculatorException(message);
+    }
+    return completion;
+}
+
+const char *CalcClient::statusMessage(int32_t status)
+{
+    switch (status)
+    {
+    case CALC_SHM_STATUS_OK:
+        return nullptr;
+    case CALC_SHM_STATUS_INVALID:
+        return "Invalid calculation server request!";
+    case CALC_SHM_STATUS_EMPTY:
+        return "Array is empty!";
+    case CALC_SHM_STATUS_IO:
+        return "File I/O error: calculation server cannot map the shared memory segment or it was truncated";
+    default:
+        return "Calculation server operation failed!";
+    }
+}
@@ -1,5 +1,16 @@
 #include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/MappedFile.h"
+#include "cpp_calculator/ArrowColumn.h"
+#include "cpp_calculator/HistoryJournal.h"
+#include "cpp_calculator/Selection.h"
+#include "cpp_calculator/Sort.h"
+#include "cpp_calculator/GroupBy.h"
+#include "cpp_calculator/Blas.h"
+#include "cpp_calculator/Gemm.h"
+#include "cpp_calculator/Polynomial.h"
+#include "Instrument.h"
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 #include <sstream>
 #include <iostream>
@@ -9,42 +20,46 @@ Calculator::Calculator() : last_result_(0.0) {}
 
 double Calculator::add(double a, double b)
 {
+    CALC_INSTRUMENT(Add, 0);
     double result = a + b;
     last_result_ = result;
 
     std::ostringstream oss;
     oss << a << " + " << b << " = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double Calculator::subtract(double a, double b)
 {
+    CALC_INSTRUMENT(Subtract, 0);
     double result = a - b;
     last_result_ = result;
 
     std::ostringstream oss;
     oss << a << " - " << b << " = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double Calculator::multiply(double a, double b)
 {
+    CALC_INSTRUMENT(Multiply, 0);
     double result = a * b;
     last_result_ = result;
 
     std::ostringstream oss;
     oss << a << " * " << b << " = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double Calculator::divide(double a, double b)
 {
+    CALC_INSTRUMENT(Divide, 0);
     if (b == 0.0)
     {
         throw CalculatorException("Division by zero!");
@@ -55,16 +70,66 @@ double Calculator::divide(double a, double b)
 
     std::ostringstream oss;
     oss << a << " / " << b << " = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
+void Calculator::recordHistory(std::string entry)
+{
+    if (journal_)
+    {
+        journal_->append(entry);
+    }
+    history_.push_back(std::move(entry));
+}
+
 void Calculator::clearHistory()
 {
     history_.clear();
 }
 
+size_t Calculator::exportHistory(size_t first, size_t count, HistoryFormat format,
+                                 char *buffer, size_t buffer_size) const
+{
+    if (first > history_.size())
+    {
+        throw CalculatorException("History index out of range!");
+    }
+    size_t last = first + std::min(count, history_.size() - first);
+
+    // 每条的额外开销：文本格式为换行符，二进制格式为长度前缀
+    const size_t overhead = format == HistoryFormat::Text ? 1 : sizeof(uint32_t);
+    size_t required = 0;
+    for (size_t i = first; i < last; ++i)
+    {
+        required += history_[i].size() + overhead;
+    }
+    if (!buffer || buffer_size < required)
+    {
+        return required;
+    }
+
+    char *out = buffer;
+    for (size_t i = first; i < last; ++i)
+    {
+        const std::string &entry = history_[i];
+        if (format == HistoryFormat::Binary)
+        {
+            uint32_t length = static_cast<uint32_t>(entry.size());
+            std::memcpy(out, &length, sizeof(length));
+            out += sizeof(length);
+        }
+        std::memcpy(out, entry.data(), entry.size());
+        out += entry.size();
+        if (format == HistoryFormat::Text)
+        {
+            *out++ = '\n';
+        }
+    }
+    return required;
+}
+
 // AdvancedCalculator 类的实现
 AdvancedCalculator::AdvancedCalculator()
 {
@@ -75,18 +140,20 @@ AdvancedCalculator::AdvancedCalculator()
 
 double AdvancedCalculator::power(double base, int exponent)
 {
+    CALC_INSTRUMENT(Power, 0);
     double result = std::pow(base, exponent);
     last_result_ = result;
 
     std::ostringstream oss;
     oss << base << "^" << exponent << " = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double AdvancedCalculator::square_root(double value)
 {
+    CALC_INSTRUMENT(SquareRoot, 0);
     if (value < 0)
     {
         throw CalculatorException("Cannot calculate square root of negative number!");
@@ -97,13 +164,14 @@ double AdvancedCalculator::square_root(double value)
 
     std::ostringstream oss;
     oss << "sqrt(" << value << ") = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double AdvancedCalculator::factorial(int n)
 {
+    CALC_INSTRUMENT(Factorial, 0);
     if (n < 0)
     {
         throw CalculatorException("Factorial of negative number is undefined!");
@@ -119,13 +187,14 @@ double AdvancedCalculator::factorial(int n)
 
     std::ostringstream oss;
     oss << n << "! = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double AdvancedCalculator::sine(double angle)
 {
+    CALC_INSTRUMENT(Sine, 0);
     // 角度转换为弧度
     double radians = angle * M_PI / 180.0;
     double result = std::sin(radians);
@@ -133,13 +202,14 @@ double AdvancedCalculator::sine(double angle)
 
     std::ostringstream oss;
     oss << "sin(" << angle << "°) = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
 
 double AdvancedCalculator::cosine(double angle)
 {
+    CALC_INSTRUMENT(Cosine, 0);
     // 角度转换为弧度
     double radians = angle * M_PI / 180.0;
     double result = std::cos(radians);
@@ -147,7 +217,7 @@ double AdvancedCalculator::cosine(double angle)
 
     std::ostringstream oss;
     oss << "cos(" << angle << "°) = " << result;
-    history_.push_back(oss.str());
+    recordHistory(oss.str());
 
     return result;
 }
@@ -156,6 +226,7 @@ double AdvancedCalculator::cosine(double angle)
 template <typename T>
 T AdvancedCalculator::sum_array(const std::vector<T> &arr)
 {
+    CALC_INSTRUMENT(SumArray, arr.size() * sizeof(T));
     T sum = 0;
     for (const auto &val : arr)
     {
@@ -167,6 +238,7 @@ T AdvancedCalculator::sum_array(const std::vector<T> &arr)
 template <typename T>
 T AdvancedCalculator::max_element(const std::vector<T> &arr)
 {
+    CALC_INSTRUMENT(MaxElement, arr.size() * sizeof(T));
     if (arr.empty())
     {
         throw CalculatorException("Array is empty!");
@@ -177,6 +249,7 @@ T AdvancedCalculator::max_element(const std::vector<T> &arr)
 template <typename T>
 T AdvancedCalculator::min_element(const std::vector<T> &arr)
 {
+    CALC_INSTRUMENT(MinElement, arr.size() * sizeof(T));
     if (arr.empty())
     {
         throw CalculatorException("Array is empty!");
@@ -184,8 +257,142 @@ T AdvancedCalculator::min_element(const std::vector<T> &arr)
     return *std::min_element(arr.begin(), arr.end());
 }
 
+template <typename T>
+size_t AdvancedCalculator::argmax(const std::vector<T> &arr)
+{
+    return ::argmax(arr.data(), arr.size());
+}
+
+template <typename T>
+size_t AdvancedCalculator::argmin(const std::vector<T> &arr)
+{
+    return ::argmin(arr.data(), arr.size());
+}
+
+template <typename T>
+std::vector<size_t> AdvancedCalculator::top_k(const std::vector<T> &arr, size_t k)
+{
+    return ::top_k(arr.data(), arr.size(), k);
+}
+
+template <typename T>
+double AdvancedCalculator::percentile(const std::vector<T> &arr, double q)
+{
+    return ::percentile(arr.data(), arr.size(), q);
+}
+
+template <typename T>
+double AdvancedCalculator::median(const std::vector<T> &arr)
+{
+    return ::percentile(arr.data(), arr.size(), 0.5);
+}
+
+template <typename T>
+void AdvancedCalculator::sort(std::vector<T> &arr, unsigned threads)
+{
+    sort_values(arr.data(), arr.size(), threads);
+}
+
+template <typename T>
+std::vector<uint64_t> AdvancedCalculator::histogram(const std::vector<T> &arr, double lo, double hi, size_t bins, unsigned threads)
+{
+    std::vector<uint64_t> counts(bins);
+    ::histogram(arr.data(), arr.size(), lo, hi, bins, counts.data(), threads);
+    return counts;
+}
+
+template <typename T>
+GroupByResult<T> AdvancedCalculator::group_by(const std::vector<int32_t> &keys, const std::vector<T> &values, unsigned threads)
+{
+    if (keys.size() != values.size())
+    {
+        throw CalculatorException("Key and value arrays must have the same length");
+    }
+    return ::group_by(keys.data(), values.data(), values.size(), threads);
+}
+
+namespace
+{
+    void requireSameLength(size_t a, size_t b)
+    {
+        if (a != b)
+        {
+            throw CalculatorException("Input arrays must have the same length");
+        }
+    }
+
+    // size 个元素恰好是 rows×cols 的矩阵（乘积溢出时视为不符）
+    void requireMatrix(size_t size, size_t rows, size_t cols)
+    {
+        if ((rows != 0 && cols > SIZE_MAX / rows) || size != rows * cols)
+        {
+            throw CalculatorException("Matrix dimensions do not match the array sizes");
+        }
+    }
+}
+
+template <typename T>
+T AdvancedCalculator::dot(const std::vector<T> &x, const std::vector<T> &y)
+{
+    requireSameLength(x.size(), y.size());
+    return dot_product(x.data(), y.data(), x.size());
+}
+
+template <typename T>
+void AdvancedCalculator::axpy(T a, const std::vector<T> &x, std::vector<T> &y)
+{
+    requireSameLength(x.size(), y.size());
+    ::axpy(a, x.data(), y.data(), x.size());
+}
+
+template <typename T>
+void AdvancedCalculator::scale(T a, std::vector<T> &x)
+{
+    scale_values(a, x.data(), x.size());
+}
+
+template <typename T>
+T AdvancedCalculator::norm(const std::vector<T> &x)
+{
+    return norm2(x.data(), x.size());
+}
+
+template <typename T>
+std::vector<T> AdvancedCalculator::fma(const std::vector<T> &a, const std::vector<T> &b, const std::vector<T> &c)
+{
+    requireSameLength(a.size(), b.size());
+    requireSameLength(a.size(), c.size());
+    std::vector<T> out(a.size());
+    fused_multiply_add(a.data(), b.data(), c.data(), out.data(), a.size());
+    return out;
+}
+
+template <typename T>
+std::vector<T> AdvancedCalculator::matmul(const std::vector<T> &a, const std::vector<T> &b, size_t m, size_t k, size_t n,
+                                          unsigned threads)
+{
+    requireMatrix(a.size(), m, k);
+    requireMatrix(b.size(), k, n);
+    if (n != 0 && m > SIZE_MAX / n)
+    {
+        throw CalculatorException("Matrix dimensions do not match the array sizes");
+    }
+    std::vector<T> c(m * n);
+    gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n, threads);
+    return c;
+}
+
+template <typename T>
+std::vector<T> AdvancedCalculator::poly_eval(const std::vector<T> &coeffs, const std::vector<T> &x)
+{
+    std::vector<T> out(x.size());
+    ::poly_eval(coeffs.data(), coeffs.size(), x.data(), out.data(), x.size());
+    return out;
+}
+
 std::vector<double> AdvancedCalculator::batch_add(const std::vector<double> &values, double addend)
 {
+    CALC_INSTRUMENT(BatchAdd, values.size() * sizeof(double));
     std::vector<double> results;
     results.reserve(values.size());
 
@@ -197,11 +404,195 @@ std::vector<double> AdvancedCalculator::batch_add(const std::vector<double> &val
     return results;
 }
 
+// 文件映射运算的实现
+namespace
+{
+    // 每处理完一个窗口就把已读过的页交还内核，保证比内存大的文件也能平稳处理
+    const size_t kFileWindowBytes = 64u << 20;
+
+    template <typename T, typename Acc, typename Fn>
+    Acc reduce_mapped(MappedFile &file, Acc init, Fn fn)
+    {
+        const T *data = file.as<T>();
+        size_t count = file.count<T>();
+        size_t window = kFileWindowBytes / sizeof(T);
+
+        Acc acc = init;
+        for (size_t begin = 0; begin < count; begin += window)
+        {
+            size_t end = std::min(count, begin + window);
+            for (size_t i = begin; i < end; ++i)
+            {
+                acc = fn(acc, data[i]);
+            }
+            file.release_range(begin * sizeof(T), (end - begin) * sizeof(T));
+        }
+        return acc;
+    }
+
+    template <typename T>
+    T extreme_mapped(MappedFile &file, bool want_max)
+    {
+        if (file.count<T>() == 0)
+        {
+            throw CalculatorException("Array is empty!");
+        }
+        T first = file.as<T>()[0];
+        if (want_max)
+        {
+            return reduce_mapped<T>(file, first, [](T a, T b) { return b > a ? b : a; });
+        }
+        return reduce_mapped<T>(file, first, [](T a, T b) { return b < a ? b : a; });
+    }
+}
+
+int64_t AdvancedCalculator::sum_file_int32(const std::string &path)
+{
+    CALC_INSTRUMENT(SumFile, 0);
+    MappedFile file(path);
+    CALC_INSTRUMENT_ADD_BYTES(file.size());
+    return reduce_mapped<int32_t>(file, int64_t(0), [](int64_t acc, int32_t v) { return acc + v; });
+}
+
+int32_t AdvancedCalculator::max_file_int32(const std::string &path)
+{
+    CALC_INSTRUMENT(MaxFile, 0);
+    MappedFile file(path);
+    CALC_INSTRUMENT_ADD_BYTES(file.size());
+    return extreme_mapped<int32_t>(file, true);
+}
+
+int32_t AdvancedCalculator::min_file_int32(const std::string &path)
+{
+    CALC_INSTRUMENT(MinFile, 0);
+    MappedFile file(path);
+    CALC_INSTRUMENT_ADD_BYTES(file.size());
+    return extreme_mapped<int32_t>(file, false);
+}
+
+double AdvancedCalculator::sum_file_double(const std::string &path)
+{
+    CALC_INSTRUMENT(SumFile, 0);
+    MappedFile file(path);
+    CALC_INSTRUMENT_ADD_BYTES(file.size());
+    return reduce_mapped<double>(file, 0.0, [](double acc, double v) { return acc + v; });
+}
+
+double AdvancedCalculator::max_file_double(const std::string &path)
+{
+    CALC_INSTRUMENT(MaxFile, 0);
+    MappedFile file(path);
+    CALC_INSTRUMENT_ADD_BYTES(file.size());
+    return extreme_mapped<double>(file, true);
+}
+
+double AdvancedCalculator::min_file_double(const std::string &path)
+{
+    CALC_INSTRUMENT(MinFile, 0);
+    MappedFile file(path);
+    CALC_INSTRUMENT_ADD_BYTES(file.size());
+    return extreme_mapped<double>(file, false);
+}
+
+size_t AdvancedCalculator::batch_add_file(const std::string &input_path, const std::string &output_path, double addend)
+{
+    CALC_INSTRUMENT(BatchAddFile, 0);
+    MappedFile input(input_path);
+    size_t count = input.count<double>();
+    CALC_INSTRUMENT_ADD_BYTES(2 * count * sizeof(double));
+    // 创建输出会先截断文件，输入输出为同一文件时数据在读取前就被清零
+    if (input.sameFile(output_path))
+    {
+        throw CalculatorException("Input and output must be different files!");
+    }
+    MappedFile output(output_path, count * sizeof(double));
+
+    const double *src = input.as<double>();
+    double *dst = output.as<double>();
+    size_t window = kFileWindowBytes / sizeof(double);
+    for (size_t begin = 0; begin < count; begin += window)
+    {
+        size_t end = std::min(count, begin + window);
+        for (size_t i = begin; i < end; ++i)
+        {
+            dst[i] = src[i] + addend;
+        }
+        input.release_range(begin * sizeof(double), (end - begin) * sizeof(double));
+    }
+    return count;
+}
+
+// Arrow 列运算的实现
+namespace
+{
+    // 列数据区的字节数（不含有效位图），只用于统计
+    inline uint64_t columnBytes(const ArrowColumnView &column)
+    {
+        bool narrow = column.type() == ArrowColumnType::Int32 || column.type() == ArrowColumnType::Float32;
+        return static_cast<uint64_t>(column.length()) * (narrow ? 4 : 8);
+    }
+}
+
+double AdvancedCalculator::sum_column(const ArrowColumnView &column)
+{
+    CALC_INSTRUMENT(SumColumn, columnBytes(column));
+    return arrow_column_sum(column);
+}
+
+double AdvancedCalculator::max_column(const ArrowColumnView &column)
+{
+    CALC_INSTRUMENT(MaxColumn, columnBytes(column));
+    return arrow_column_max(column);
+}
+
+double AdvancedCalculator::min_column(const ArrowColumnView &column)
+{
+    CALC_INSTRUMENT(MinColumn, columnBytes(column));
+    return arrow_column_min(column);
+}
+
+void AdvancedCalculator::batch_add_column(const ArrowColumnView &column, double addend, double *results, uint8_t *validity_out)
+{
+    CALC_INSTRUMENT(BatchAddColumn, columnBytes(column));
+    arrow_column_add(column, addend, results, validity_out);
+}
+
 // 显式实例化模板方法（为了链接时可见）
 template double AdvancedCalculator::sum_array(const std::vector<double> &);
 template double AdvancedCalculator::max_element(const std::vector<double> &);
 template double AdvancedCalculator::min_element(const std::vector<double> &);
+template size_t AdvancedCalculator::argmax(const std::vector<double> &);
+template size_t AdvancedCalculator::argmin(const std::vector<double> &);
+template std::vector<size_t> AdvancedCalculator::top_k(const std::vector<double> &, size_t);
+template double AdvancedCalculator::percentile(const std::vector<double> &, double);
+template double AdvancedCalculator::median(const std::vector<double> &);
+template void AdvancedCalculator::sort(std::vector<double> &, unsigned);
+template void AdvancedCalculator::sort(std::vector<float> &, unsigned);
+template std::vector<uint64_t> AdvancedCalculator::histogram(const std::vector<double> &, double, double, size_t, unsigned);
+template GroupByResult<double> AdvancedCalculator::group_by(const std::vector<int32_t> &, const std::vector<double> &, unsigned);
+template double AdvancedCalculator::dot(const std::vector<double> &, const std::vector<double> &);
+template void AdvancedCalculator::axpy(double, const std::vector<double> &, std::vector<double> &);
+template void AdvancedCalculator::scale(double, std::vector<double> &);
+template double AdvancedCalculator::norm(const std::vector<double> &);
+template std::vector<double> AdvancedCalculator::fma(const std::vector<double> &, const std::vector<double> &, const std::vector<double> &);
+template std::vector<double> AdvancedCalculator::matmul(const std::vector<double> &, const std::vector<double> &, size_t, size_t, size_t, unsigned);
+template std::vector<double> AdvancedCalculator::poly_eval(const std::vector<double> &, const std::vector<double> &);
+template float AdvancedCalculator::dot(const std::vector<float> &, const std::vector<float> &);
+template void AdvancedCalculator::axpy(float, const std::vector<float> &, std::vector<float> &);
+template void AdvancedCalculator::scale(float, std::vector<float> &);
+template float AdvancedCalculator::norm(const std::vector<float> &);
+template std::vector<float> AdvancedCalculator::fma(const std::vector<float> &, const std::vector<float> &, const std::vector<float> &);
+template std::vector<float> AdvancedCalculator::matmul(const std::vector<float> &, const std::vector<float> &, size_t, size_t, size_t, unsigned);
+template std::vector<float> AdvancedCalculator::poly_eval(const std::vector<float> &, const std::vector<float> &);
 
 template int AdvancedCalculator::sum_array(const std::vector<int> &);
 template int AdvancedCalculator::max_element(const std::vector<int> &);
-template int AdvancedCalculator::min_element(const std::vector<int> &);
\ No newline at end of file
+template int AdvancedCalculator::min_element(const std::vector<int> &);
+template size_t AdvancedCalculator::argmax(const std::vector<int> &);
+template size_t AdvancedCalculator::argmin(const std::vector<int> &);
+template std::vector<size_t> AdvancedCalculator::top_k(const std::vector<int> &, size_t);
+template double AdvancedCalculator::percentile(const std::vector<int> &, double);
+template double AdvancedCalculator::median(const std::vector<int> &);
+template void AdvancedCalculator::sort(std::vector<int> &, unsigned);
+template std::vector<uint64_t> AdvancedCalculator::histogram(const std::vector<int> &, double, double, size_t, unsigned);
+template GroupByResult<int> AdvancedCalculator::group_by(const std::vector<int32_t> &, const std::vector<int> &, unsigned);
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "cpp_calculator/Gemm.h"
+#include "Parallel.h"
+#include "Instrument.h"
+#include "Probe.h"
+#ifndef CPP_CALCULATOR_NO_ASM
+#include <asm_math_ops/math_ops_asm.h>
+#endif
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    using parallel::forEachBlock;
+    using parallel::planThreads;
+
+#ifdef CPP_CALCULATOR_NO_ASM
+    // 没有 NASM 时的可移植微内核，约定同 asm_gemm_kernel_f64：C 的 6×NR 小块 (+)= A 面板 · B 面板
+    template <typename T, size_t NR>
+    void portableKernel(size_t k, const T *a, const T *b, T *c, size_t ldc, int accumulate)
+    {
+        T acc[6][NR] = {};
+        for (size_t p = 0; p < k; ++p)
+        {
+            for (size_t i = 0; i < 6; ++i)
+            {
+                for (size_t j = 0; j < NR; ++j)
+                {
+                    acc[i][j] += a[p * 6 + i] * b[p * NR + j];
+                }
+            }
+        }
+        for (size_t i = 0; i < 6; ++i)
+        {
+            for (size_t j = 0; j < NR; ++j)
+            {
+                c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+            }
+        }
+    }
+#endif
+
+    // 分块参数：MR×NR 为微内核的寄存器块；MC×KC 的 A 块留在 L2，KC×NC 的 B 块留在 L3，
+    // KC×NR 的 B 面板在微内核循环中留在 L1
+    template <typename T>
+    struct Blocking;
+
+    template <>
+    struct Blocking<double>
+    {
+        static const size_t MR = 6, NR = 8, KC = 256, MC = 96, NC = 2048;
+        static void kernel(size_t k, const double *a, const double *b, double *c, size_t ldc, int accumulate)
+        {
+#ifdef CPP_CALCULATOR_NO_ASM
+            portableKernel<double, NR>(k, a, b, c, ldc, accumulate);
+#else
+            asm_gemm_kernel_f64(k, a, b, c, ldc, accumulate);
+#endif
+        }
+    };
+
+    template <>
+    struct Blocking<float>
+    {
+        static const size_t MR = 6, NR = 16, KC = 256, MC = 144, NC = 4096;
+        static void kernel(size_t k, const float *a, const float *b, float *c, size_t ldc, int accumulate)
+        {
+#ifdef CPP_CALCULATOR_NO_ASM
+            portableKernel<float, NR>(k, a, b, c, ldc, accumulate);
+#else
+            asm_gemm_kernel_f32(k, a, b, c, ldc, accumulate);
+#endif
+        }
+    };
+
+    // m·n·k 不超过该值时打包的开销不划算，直接三重循环
+    const size_t kNaiveMax = 16 * 16 * 16;
+
+    inline size_t roundUp(size_t value, size_t step)
+    {
+        return (value + step - 1) / step * step;
+    }
+
+    // i-p-j 顺序的三重循环，最内层沿 B / C 的行连续访问
+    template <typename T>
+    void naiveGemm(size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc)
+    {
+        for (size_t i = 0; i < m; ++i)
+        {
+            T *row = c + i * ldc;
+            std::fill(row, row + n, T(0));
+            for (size_t p = 0; p < k; ++p)
+            {
+                T aip = a[i * lda + p];
+                const T *brow = b + p * ldb;
+                for (size_t j = 0; j < n; ++j)
+                {
+                    row[j] += aip * brow[j];
+                }
+            }
+        }
+    }
+
+    // 把 A[i0, i0+mc) × [p0, p0+kc) 打包为 MR 行一组的面板：面板内每个 p 连续存放 MR 个元素，不足 MR 行补零
+    template <typename T>
+    void packA(const T *a, size_t lda, size_t i0, size_t mc, size_t p0, size_t kc, T *dst)
+    {
+        const size_t MR = Blocking<T>::MR;
+        for (size_t ir = 0; ir < mc; ir += MR)
+        {
+            size_t rows = std::min(MR, mc - ir);
+            const T *src = a + (i0 + ir) * lda + p0;
+            for (size_t p = 0; p < kc; ++p)
+            {
+                size_t r = 0;
+                for (; r < rows; ++r)
+                    dst[r] = src[r * lda + p];
+                for (; r < MR; ++r)
+                    dst[r] = T(0);
+                dst += MR;
+            }
+        }
+    }
+
+    // 把 B[p0, p0+kc) × [j0, j0+nc) 打包为 NR 列一组的面板：面板内每个 p 连续存放 NR 个元素，不足 NR 列补零
+    template <typename T>
+    void packB(const T *b, size_t ldb, size_t p0, size_t kc, size_t j0, size_t nc, T *dst)
+    {
+        const size_t NR = Blocking<T>::NR;
+        for (size_t jr = 0; jr < nc; jr += NR)
+        {
+            size_t cols = std::min(NR, nc - jr);
+            const T *src = b + p0 * ldb + j0 + jr;
+            for (size_t p = 0; p < kc; ++p)
+            {
+                const T *row = src + p * ldb;
+                size_t j = 0;
+                for (; j < cols; ++j)
+                    dst[j] = row[j];
+                for (; j < NR; ++j)
+                    dst[j] = T(0);
+                dst += NR;
+            }
+        }
+    }
+
+    // 计算 C 的行 [rowBegin, rowEnd)：逐个 B 块、A 块打包后按 MR×NR 小块调用微内核。
+    // 右 / 下边缘不足一个小块时先写到临时块，再把有效部分写回 C
+    template <typename T>
+    void gemmRows(size_t rowBegin, size_t rowEnd, size_t n, size_t k, const T *a, size_t lda, const T *b, size_t ldb,
+                  T *c, size_t ldc, T *bufA, T *bufB, size_t nc)
+    {
+        const size_t MR = Blocking<T>::MR, NR = Blocking<T>::NR, KC = Blocking<T>::KC, MC = Blocking<T>::MC;
+        T edge[MR * NR];
+        for (size_t jc = 0; jc < n; jc += nc)
+        {
+            size_t ncur = std::min(nc, n - jc);
+            for (size_t pc = 0; pc < k; pc += KC)
+            {
+                size_t kcur = std::min(KC, k - pc);
+                int accumulate = pc > 0;
+                packB(b, ldb, pc, kcur, jc, ncur, bufB);
+                for (size_t ic = rowBegin; ic < rowEnd; ic += MC)
+                {
+                    size_t mcur = std::min(MC, rowEnd - ic);
+                    packA(a, lda, ic, mcur, pc, kcur, bufA);
+                    for (size_t jr = 0; jr < ncur; jr += NR)
+                    {
+                        size_t cols = std::min(NR, ncur - jr);
+                        const T *panelB = bufB + jr * kcur;
+                        for (size_t ir = 0; ir < mcur; ir += MR)
+                        {
+                            size_t rows = std::min(MR, mcur - ir);
+                            const T *panelA = bufA + ir * kcur;
+                            T *tile = c + (ic + ir) * ldc + jc + jr;
+                            if (rows == MR && cols == NR)
+                            {
+                                Blocking<T>::kernel(kcur, panelA, panelB, tile, ldc, accumulate);
+                                continue;
+                            }
+                            Blocking<T>::kernel(kcur, panelA, panelB, edge, NR, 0);
+                            for (size_t i = 0; i < rows; ++i)
+                            {
+                                for (size_t j = 0; j < cols; ++j)
+                                {
+                                    T value = edge[i * NR + j];
+                                    tile[i * ldc + j] = accumulate ? tile[i * ldc + j] + value : value;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void gemm(size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b, size_t ldb, T *c, size_t ldc,
+          unsigned threads)
+{
+    CALC_PROBE(m * n);
+    CALC_INSTRUMENT(Matmul, (m * k + k * n) * sizeof(T));
+    const size_t MR = Blocking<T>::MR, NR = Blocking<T>::NR, KC = Blocking<T>::KC, MC = Blocking<T>::MC,
+                 NC = Blocking<T>::NC;
+    if (m == 0 || n == 0)
+        return;
+    if (k == 0)
+    {
+        for (size_t i = 0; i < m; ++i)
+            std::fill(c + i * ldc, c + i * ldc + n, T(0));
+        return;
+    }
+    if (m * n * k <= kNaiveMax)
+    {
+        naiveGemm(m, n, k, a, lda, b, ldb, c, ldc);
+        return;
+    }
+
+    // 每个乘加约 1/64 个元素的开销计入线程规划；线程数不超过行面板数
+    size_t panels = (m + MR - 1) / MR;
+    unsigned count = static_cast<unsigned>(std::min<size_t>(planThreads(m * n * k / 64, threads), panels));
+
+    // 各线程独立打包自己的 A 块和 B 块，缓冲区在启动线程前一次分配好
+    size_t nc = std::min(NC, roundUp(n, NR));
+    size_t kc = std::min(KC, k);
+    size_t mc = std::min(MC, (panels + count - 1) / count * MR);
+    size_t sizeA = mc * kc, sizeB = kc * nc;
+    std::vector<T> buffers(count * (sizeA + sizeB));
+
+    forEachBlock(panels, count, [&](unsigned t, size_t begin, size_t end) {
+        T *bufA = buffers.data() + t * (sizeA + sizeB);
+        gemmRows(begin * MR, std::min(end * MR, m), n, k, a, lda, b, ldb, c, ldc, bufA, bufA + sizeA, nc);
+    });
+}
+
+// 显式实例化
+template void gemm<double>(size_t, size_t, size_t, const double *, size_t, const double *, size_t, double *, size_t, unsigned);
+template void gemm<float>(size_t, size_t, size_t, const float *, size_t, const float *, size_t, float *, size_t, unsigned);
@@ -0,0 +1,287 @@
+#include "cpp_calculator/GroupBy.h"
+#include "Parallel.h"
+#include "Instrument.h"
+#include "Probe.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using parallel::forEachBlock;
+    using parallel::planThreads;
+
+    // 稠密路径的条件：键的取值范围不超过 kDenseMaxRange，且不超过元素个数 + kDenseMinRange
+    const int64_t kDenseMaxRange = int64_t(1) << 16;
+    const int64_t kDenseMinRange = 4096;
+
+    // 一个组的聚合值；初始为单位元，add 不需要判断是否为组内第一个值
+    template <typename T>
+    struct Group
+    {
+        typename AccumulatorTraits<T>::sum_type sum = 0;
+        T min = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        T max = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+        uint64_t count = 0;
+
+        void add(T value)
+        {
+            sum += value;
+            min = value < min ? value : min;
+            max = max < value ? value : max;
+            ++count;
+        }
+
+        void merge(const Group &other)
+        {
+            sum += other.sum;
+            min = other.min < min ? other.min : min;
+            max = max < other.max ? other.max : max;
+            count += other.count;
+        }
+    };
+
+    template <typename T>
+    void append(GroupByResult<T> &result, int32_t key, const Group<T> &group)
+    {
+        result.keys.push_back(key);
+        result.sums.push_back(group.sum);
+        result.mins.push_back(group.min);
+        result.maxs.push_back(group.max);
+        result.counts.push_back(group.count);
+    }
+
+    // 开放寻址（线性探测）哈希表，组的聚合值直接存放在槽位中，查找和更新只访问一处内存。
+    // 装载率超过 1/2 时容量翻倍
+    template <typename T>
+    class GroupTable
+    {
+    public:
+        explicit GroupTable(size_t expected)
+        {
+            size_t capacity = 16;
+            while (capacity < 2 * std::min<size_t>(expected, 4096))
+                capacity *= 2;
+            resize(capacity);
+        }
+
+        void add(int32_t key, T value)
+        {
+            size_t mask = slots_.size() - 1;
+            for (size_t i = slotOf(key);; i = (i + 1) & mask)
+            {
+                Slot &slot = slots_[i];
+                if (slot.group.count == 0)
+                {
+                    slot.key = key;
+                    slot.group.add(value);
+                    if (2 * ++size_ > slots_.size())
+                        resize(2 * slots_.size());
+                    return;
+                }
+                if (slot.key == key)
+                {
+                    slot.group.add(value);
+                    return;
+                }
+            }
+        }
+
+        // 按槽位顺序访问所有组：fn(key, group)
+        template <typename Fn>
+        void forEach(Fn fn) const
+        {
+            for (const Slot &slot : slots_)
+            {
+                if (slot.group.count != 0)
+                    fn(slot.key, slot.group);
+            }
+        }
+
+        size_t size() const { return size_; }
+
+    private:
+        struct Slot
+        {
+            int32_t key = 0;
+            Group<T> group; // count 为 0 表示空槽
+        };
+
+        // 乘法哈希取高位；与分区用的哈希（multiplier 不同）相互独立
+        size_t slotOf(int32_t key) const
+        {
+            return (static_cast<uint32_t>(key) * 0x9E3779B1u) >> shift_;
+        }
+
+        void resize(size_t capacity)
+        {
+            std::vector<Slot> old(capacity);
+            old.swap(slots_);
+            shift_ = 32;
+            for (size_t c = capacity; c > 1; c >>= 1)
+                --shift_;
+            size_t mask = capacity - 1;
+            for (const Slot &slot : old)
+            {
+                if (slot.group.count == 0)
+                    continue;
+                size_t i = slotOf(slot.key);
+                while (slots_[i].group.count != 0)
+                    i = (i + 1) & mask;
+                slots_[i] = slot;
+            }
+        }
+
+        std::vector<Slot> slots_;
+        size_t size_ = 0;
+        unsigned shift_ = 32;
+    };
+
+    // 键所属的分区，[0, partitions)
+    inline size_t partitionOf(int32_t key, size_t partitions)
+    {
+        uint32_t h = static_cast<uint32_t>(key) * 0x85EBCA77u;
+        return static_cast<size_t>((static_cast<uint64_t>(h) * partitions) >> 32);
+    }
+
+    template <typename T>
+    GroupByResult<T> groupDense(const int32_t *keys, const T *values, size_t size, int32_t lo, size_t range, unsigned count)
+    {
+        std::vector<std::vector<Group<T>>> tables(count);
+        forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+            std::vector<Group<T>> &table = tables[t];
+            table.resize(range);
+            for (size_t i = begin; i < end; ++i)
+            {
+                table[static_cast<size_t>(static_cast<int64_t>(keys[i]) - lo)].add(values[i]);
+            }
+        });
+        // 各线程的表按键区间分块合并到第 0 张表
+        forEachBlock(range, count, [&](unsigned, size_t begin, size_t end) {
+            for (unsigned t = 1; t < tables.size(); ++t)
+            {
+                for (size_t k = begin; k < end; ++k)
+                    tables[0][k].merge(tables[t][k]);
+            }
+        });
+
+        GroupByResult<T> result;
+        for (size_t k = 0; k < range; ++k)
+        {
+            if (tables[0][k].count != 0)
+                append(result, static_cast<int32_t>(lo + static_cast<int64_t>(k)), tables[0][k]);
+        }
+        return result;
+    }
+
+    template <typename T>
+    GroupByResult<T> groupHashed(const int32_t *keys, const T *values, size_t size, unsigned count)
+    {
+        std::vector<GroupTable<T>> tables;
+        if (count <= 1)
+        {
+            tables.emplace_back(size);
+            for (size_t i = 0; i < size; ++i)
+                tables[0].add(keys[i], values[i]);
+        }
+        else
+        {
+            // 1. 各线程统计自己那一块落入每个分区的个数
+            std::vector<std::vector<size_t>> offsets(count, std::vector<size_t>(count, 0));
+            forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    ++offsets[t][partitionOf(keys[i], count)];
+            });
+            // 2. 分区 p 连续存放，其中按线程顺序排列：得出每个线程在每个分区内的写入起点
+            std::vector<size_t> bounds(count + 1, 0);
+            size_t position = 0;
+            for (unsigned p = 0; p < count; ++p)
+            {
+                bounds[p] = position;
+                for (unsigned t = 0; t < count; ++t)
+                {
+                    size_t n = offsets[t][p];
+                    offsets[t][p] = position;
+                    position += n;
+                }
+            }
+            bounds[count] = position;
+            // 3. 分发到分区
+            std::vector<int32_t> part_keys(size);
+            std::vector<T> part_values(size);
+            forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+                std::vector<size_t> &next = offsets[t];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    size_t at = next[partitionOf(keys[i], count)]++;
+                    part_keys[at] = keys[i];
+                    part_values[at] = values[i];
+                }
+            });
+            // 4. 每个线程独立聚合一个分区
+            for (unsigned p = 0; p < count; ++p)
+                tables.emplace_back(bounds[p + 1] - bounds[p]);
+            forEachBlock(count, count, [&](unsigned p, size_t, size_t) {
+                for (size_t i = bounds[p]; i < bounds[p + 1]; ++i)
+                    tables[p].add(part_keys[i], part_values[i]);
+            });
+        }
+
+        // 组数通常远小于元素个数，收集后按键排序
+        std::vector<std::pair<int32_t, const Group<T> *>> order;
+        size_t groups = 0;
+        for (const GroupTable<T> &table : tables)
+            groups += table.size();
+        order.reserve(groups);
+        for (const GroupTable<T> &table : tables)
+        {
+            table.forEach([&](int32_t key, const Group<T> &group) { order.push_back({key, &group}); });
+        }
+        std::sort(order.begin(), order.end(),
+                  [](const std::pair<int32_t, const Group<T> *> &a, const std::pair<int32_t, const Group<T> *> &b) {
+                      return a.first < b.first;
+                  });
+
+        GroupByResult<T> result;
+        result.keys.reserve(order.size());
+        result.sums.reserve(order.size());
+        result.mins.reserve(order.size());
+        result.maxs.reserve(order.size());
+        result.counts.reserve(order.size());
+        for (const auto &entry : order)
+        {
+            append(result, entry.first, *entry.second);
+        }
+        return result;
+    }
+}
+
+template <typename T>
+GroupByResult<T> group_by(const int32_t *keys, const T *values, size_t size, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(GroupBy, size * (sizeof(int32_t) + sizeof(T)));
+    if (size == 0)
+    {
+        return GroupByResult<T>();
+    }
+    unsigned count = planThreads(size, threads);
+
+    int32_t lo = keys[0], hi = keys[0];
+    for (size_t i = 1; i < size; ++i)
+    {
+        lo = std::min(lo, keys[i]);
+        hi = std::max(hi, keys[i]);
+    }
+    int64_t range = static_cast<int64_t>(hi) - lo + 1;
+    if (range <= kDenseMaxRange && range <= static_cast<int64_t>(size) + kDenseMinRange)
+    {
+        return groupDense(keys, values, size, lo, static_cast<size_t>(range), count);
+    }
+    return groupHashed(keys, values, size, count);
+}
+
+// 显式实例化
+template GroupByResult<int32_t> group_by<int32_t>(const int32_t *, const int32_t *, size_t, unsigned);
+template GroupByResult<double> group_by<double>(const int32_t *, const double *, size_t, unsigned);
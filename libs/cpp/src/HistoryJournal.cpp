@@ -0,0 +1,355 @@
+#include "cpp_calculator/HistoryJournal.h"
+#include "cpp_calculator/Calculator.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char kMagic[8] = {'C', 'A', 'L', 'C', 'J', 'R', 'N', 'L'};
+    const uint32_t kVersion = 1;
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    // 环形缓冲区和文件中使用同一记录头；环形缓冲区中 crc 为 0，由写线程填入
+    struct RecordHeader
+    {
+        uint32_t length;
+        uint32_t crc;
+        int64_t timestamp_ns;
+    };
+
+    static_assert(sizeof(FileHeader) == 16, "journal file header must be 16 bytes");
+    static_assert(sizeof(RecordHeader) == 16, "journal record header must be 16 bytes");
+
+    std::string ioError(const std::string &what, const std::string &path)
+    {
+        return "File I/O error: " + what + " '" + path + "': " + std::strerror(errno);
+    }
+
+    // CRC-32（IEEE 802.3，与 zlib 相同），可分段累加
+    uint32_t crc32(uint32_t crc, const void *data, size_t n)
+    {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        crc = ~crc;
+        for (size_t i = 0; i < n; ++i)
+        {
+            crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    uint32_t recordCrc(int64_t timestamp_ns, const char *payload, size_t length)
+    {
+        return crc32(crc32(0, &timestamp_ns, sizeof(timestamp_ns)), payload, length);
+    }
+}
+
+// HistoryJournal 类的实现
+HistoryJournal::HistoryJournal(const std::string &path, const JournalOptions &options)
+    : options_(options), fd_(-1), mask_(0), head_(0), tail_(0), written_(0), records_(0), stalls_(0),
+      failed_(false), flush_target_(0), stop_(false)
+{
+    size_t capacity = 64;
+    while (capacity < options_.ring_bytes)
+    {
+        capacity <<= 1;
+    }
+    ring_.reset(new char[capacity]);
+    mask_ = capacity - 1;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+    {
+        throw CalculatorException(ioError("cannot open", path));
+    }
+
+    try
+    {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+        {
+            throw CalculatorException(ioError("cannot stat", path));
+        }
+
+        if (st.st_size == 0)
+        {
+            FileHeader header;
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.reserved = 0;
+            if (!writeAll(reinterpret_cast<const char *>(&header), sizeof(header)))
+            {
+                throw CalculatorException(ioError("cannot write", path));
+            }
+        }
+        else
+        {
+            // 校验已有日志；上次异常退出留下的半条记录先截掉，再继续追加
+            HistoryJournalReader reader(path);
+            JournalRecord record;
+            while (reader.next(record))
+            {
+            }
+            if (reader.truncated() && ::ftruncate(fd_, static_cast<off_t>(reader.validBytes())) != 0)
+            {
+                throw CalculatorException(ioError("cannot truncate", path));
+            }
+        }
+    }
+    catch (...)
+    {
+        ::close(fd_);
+        throw;
+    }
+
+    writer_ = std::thread(&HistoryJournal::run, this);
+}
+
+HistoryJournal::~HistoryJournal()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    ::close(fd_);
+}
+
+void HistoryJournal::copyIn(uint64_t pos, const void *src, size_t n)
+{
+    size_t offset = static_cast<size_t>(pos) & mask_;
+    size_t first = std::min(n, mask_ + 1 - offset);
+    std::memcpy(ring_.get() + offset, src, first);
+    std::memcpy(ring_.get(), static_cast<const char *>(src) + first, n - first);
+}
+
+void HistoryJournal::copyOut(uint64_t pos, void *dst, size_t n) const
+{
+    size_t offset = static_cast<size_t>(pos) & mask_;
+    size_t first = std::min(n, mask_ + 1 - offset);
+    std::memcpy(dst, ring_.get() + offset, first);
+    std::memcpy(static_cast<char *>(dst) + first, ring_.get(), n - first);
+}
+
+void HistoryJournal::append(const std::string &entry)
+{
+    const size_t capacity = mask_ + 1;
+    const size_t need = sizeof(RecordHeader) + entry.size();
+    if (need > capacity || entry.size() > UINT32_MAX)
+    {
+        throw CalculatorException("Journal record exceeds ring buffer capacity!");
+    }
+
+    RecordHeader header;
+    header.length = static_cast<uint32_t>(entry.size());
+    header.crc = 0;
+    header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (capacity - (head - tail_.load(std::memory_order_acquire)) < need)
+    {
+        // 缓冲区满：唤醒写线程并等待它腾出空间（写线程出错时仍会继续消费，不会死等）
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        do
+        {
+            wake_.notify_one();
+            std::this_thread::yield();
+        } while (capacity - (head - tail_.load(std::memory_order_acquire)) < need);
+    }
+
+    copyIn(head, &header, sizeof(header));
+    copyIn(head + sizeof(header), entry.data(), entry.size());
+    head_.store(head + need, std::memory_order_release);
+    records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HistoryJournal::flush()
+{
+    uint64_t target = head_.load(std::memory_order_acquire);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        flush_target_ = std::max(flush_target_, target);
+        wake_.notify_one();
+        done_.wait(lock, [&] { return written_.load(std::memory_order_acquire) >= target; });
+    }
+    if (failed_.load())
+    {
+        throw CalculatorException("File I/O error: history journal write failed");
+    }
+}
+
+bool HistoryJournal::writeAll(const char *data, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t written = ::write(fd_, data, n);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void HistoryJournal::run()
+{
+    std::vector<char> batch;
+    auto last_sync = std::chrono::steady_clock::now();
+    bool dirty = false; // 已 write 但尚未 fdatasync
+
+    for (;;)
+    {
+        bool stopping;
+        bool flushing;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // 超时、停止、有 flush 请求或缓冲区过半时开始一批
+            wake_.wait_for(lock, options_.flush_interval, [&] {
+                return stop_ || flush_target_ > written_.load(std::memory_order_relaxed) ||
+                       head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed) > mask_ / 2;
+            });
+            stopping = stop_;
+            flushing = flush_target_ > written_.load(std::memory_order_relaxed);
+        }
+
+        // 把环形缓冲区中的记录整理成文件格式，随即释放缓冲区空间，再做系统调用
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        batch.clear();
+        while (tail < head)
+        {
+            RecordHeader header;
+            copyOut(tail, &header, sizeof(header));
+            size_t offset = batch.size();
+            batch.resize(offset + sizeof(header) + header.length);
+            char *payload = batch.data() + offset + sizeof(header);
+            copyOut(tail + sizeof(header), payload, header.length);
+            header.crc = recordCrc(header.timestamp_ns, payload, header.length);
+            std::memcpy(batch.data() + offset, &header, sizeof(header));
+            tail += sizeof(header) + header.length;
+        }
+        tail_.store(tail, std::memory_order_release);
+
+        if (!batch.empty())
+        {
+            if (!failed_.load(std::memory_order_relaxed) && !writeAll(batch.data(), batch.size()))
+            {
+                failed_.store(true);
+            }
+            dirty = true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool sync = dirty && options_.sync != JournalSync::None &&
+                    (options_.sync == JournalSync::Batch || flushing || stopping ||
+                     now - last_sync >= options_.sync_interval);
+        if (sync)
+        {
+            if (!failed_.load(std::memory_order_relaxed) && ::fdatasync(fd_) != 0)
+            {
+                failed_.store(true);
+            }
+            dirty = false;
+            last_sync = now;
+        }
+
+        written_.store(tail, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        done_.notify_all();
+
+        if (stopping && tail == head_.load(std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+}
+
+// HistoryJournalReader 类的实现
+HistoryJournalReader::HistoryJournalReader(const std::string &path)
+    : file_(path), offset_(sizeof(FileHeader)), truncated_(false)
+{
+    if (file_.size() < sizeof(FileHeader) || std::memcmp(file_.data(), kMagic, sizeof(kMagic)) != 0)
+    {
+        throw CalculatorException("File I/O error: not a history journal '" + path + "'");
+    }
+}
+
+bool HistoryJournalReader::next(JournalRecord &record)
+{
+    const char *base = static_cast<const char *>(file_.data());
+    size_t remaining = file_.size() - offset_;
+    if (remaining == 0)
+    {
+        return false;
+    }
+
+    RecordHeader header;
+    if (remaining < sizeof(header))
+    {
+        truncated_ = true;
+        return false;
+    }
+    std::memcpy(&header, base + offset_, sizeof(header));
+    if (header.length > remaining - sizeof(header))
+    {
+        truncated_ = true;
+        return false;
+    }
+
+    const char *payload = base + offset_ + sizeof(header);
+    if (recordCrc(header.timestamp_ns, payload, header.length) != header.crc)
+    {
+        // 写入被打断的最后一条记录（含文件系统预分配留下的全零尾部）同样视为日志结束；
+        // 后面还有内容时才是真正的损坏
+        size_t end = offset_ + sizeof(header) + header.length;
+        bool zero_tail = std::all_of(base + offset_, base + file_.size(), [](char c) { return c == 0; });
+        if (zero_tail || end == file_.size())
+        {
+            truncated_ = true;
+            return false;
+        }
+        throw CalculatorException("File I/O error: history journal checksum mismatch at offset " +
+                                  std::to_string(offset_));
+    }
+
+    record.timestamp_ns = header.timestamp_ns;
+    record.entry.assign(payload, header.length);
+    offset_ += sizeof(header) + header.length;
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+// 库内部的统计记录点（见 Instrumentation.h），不安装。
+// CALC_INSTRUMENT(Op, bytes) 在当前作用域结束时记录一次 Op 调用：耗时、字节数，以及是否因异常退出；
+// CALC_INSTRUMENT_ADD_BYTES(n) 给当前作用域的 CALC_INSTRUMENT 追加字节数（文件大小要映射后才知道）；
+// CALC_INSTRUMENT_ERROR_CODE(code) 记录 C 接口返回的一次错误码。
+// 未定义 CPP_CALCULATOR_INSTRUMENTATION 时它们都展开为空语句，参数不会被求值
+
+#include "cpp_calculator/Instrumentation.h"
+
+#ifdef CPP_CALCULATOR_INSTRUMENTATION
+
+#include <chrono>
+#include <exception>
+
+namespace instrument
+{
+    void record(InstrumentedOperation op, uint64_t bytes, uint64_t ns, bool failed);
+    void recordErrorCode(int code);
+
+    class Scope
+    {
+    public:
+        Scope(InstrumentedOperation op, uint64_t bytes)
+            : op_(op), bytes_(bytes), exceptions_(pendingExceptions()), start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~Scope()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            record(op_, bytes_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                   pendingExceptions() > exceptions_);
+        }
+
+        void addBytes(uint64_t bytes) { bytes_ += bytes; }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        // 正在传播的异常个数：析构时比构造时多，说明作用域因异常退出
+        static int pendingExceptions()
+        {
+#if defined(__cpp_lib_uncaught_exceptions)
+            return std::uncaught_exceptions();
+#else
+            return std::uncaught_exception() ? 1 : 0;
+#endif
+        }
+
+        InstrumentedOperation op_;
+        uint64_t bytes_;
+        int exceptions_;
+        std::chrono::steady_clock::time_point start_;
+    };
+}
+
+#define CALC_INSTRUMENT(op, bytes) instrument::Scope calc_instrument_scope_(InstrumentedOperation::op, (bytes))
+#define CALC_INSTRUMENT_ADD_BYTES(bytes) calc_instrument_scope_.addBytes(bytes)
+#define CALC_INSTRUMENT_ERROR_CODE(code) instrument::recordErrorCode(code)
+
+#else
+
+#define CALC_INSTRUMENT(op, bytes) ((void)0)
+#define CALC_INSTRUMENT_ADD_BYTES(bytes) ((void)0)
+#define CALC_INSTRUMENT_ERROR_CODE(code) ((void)0)
+
+#endif
+
+#endif // INSTRUMENT_H
@@ -0,0 +1,264 @@
+#include "cpp_calculator/Instrumentation.h"
+#include "Instrument.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    const size_t kOperations = static_cast<size_t>(InstrumentedOperation::Count);
+
+    const char *const kOperationNames[] = {
+#define CALC_OPERATION_NAME(name, text) text,
+        CALC_INSTRUMENTED_OPERATIONS(CALC_OPERATION_NAME)
+#undef CALC_OPERATION_NAME
+    };
+
+    // 单写者计数器：只有所属线程写入（普通的读加写，不需要 lock 前缀），其它线程只读；
+    // 用 relaxed 原子变量保证读取不撕裂
+    struct Counter
+    {
+        std::atomic<uint64_t> value{0};
+
+        void add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    struct OperationCounters
+    {
+        Counter calls, errors, bytes, total_ns;
+        Counter latency[kLatencyBuckets];
+    };
+
+    // 每个线程一份
+    struct ThreadCounters
+    {
+        OperationCounters operations[kOperations];
+        Counter errorCodes[kErrorCodeSlots];
+    };
+
+    void accumulate(OperationStats &total, const OperationCounters &counters)
+    {
+        total.calls += counters.calls.get();
+        total.errors += counters.errors.get();
+        total.bytes += counters.bytes.get();
+        total.total_ns += counters.total_ns.get();
+        for (size_t b = 0; b < kLatencyBuckets; ++b)
+            total.latency[b] += counters.latency[b].get();
+    }
+
+    void subtract(OperationStats &total, const OperationStats &base)
+    {
+        total.calls -= base.calls;
+        total.errors -= base.errors;
+        total.bytes -= base.bytes;
+        total.total_ns -= base.total_ns;
+        for (size_t b = 0; b < kLatencyBuckets; ++b)
+            total.latency[b] -= base.latency[b];
+    }
+
+    // 所有线程的计数：存活线程的计数块，加上已退出线程并入的 retired_；读取结果减去 reset 时的基线
+    class Registry
+    {
+    public:
+        void attach(ThreadCounters *counters)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_.push_back(counters);
+        }
+
+        void detach(ThreadCounters *counters)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t op = 0; op < kOperations; ++op)
+                accumulate(retired_.operations[op], counters->operations[op]);
+            for (size_t code = 0; code < kErrorCodeSlots; ++code)
+                retired_.errorCodes[code] += counters->errorCodes[code].get();
+            for (size_t i = 0; i < live_.size(); ++i)
+            {
+                if (live_[i] == counters)
+                {
+                    live_[i] = live_.back();
+                    live_.pop_back();
+                    break;
+                }
+            }
+        }
+
+        OperationStats operation(size_t op)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            OperationStats total = rawOperation(op);
+            subtract(total, baseline_.operations[op]);
+            return total;
+        }
+
+        uint64_t errorCode(size_t code)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return rawErrorCode(code) - baseline_.errorCodes[code];
+        }
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t op = 0; op < kOperations; ++op)
+                baseline_.operations[op] = rawOperation(op);
+            for (size_t code = 0; code < kErrorCodeSlots; ++code)
+                baseline_.errorCodes[code] = rawErrorCode(code);
+        }
+
+    private:
+        struct Totals
+        {
+            OperationStats operations[kOperations];
+            uint64_t errorCodes[kErrorCodeSlots];
+        };
+
+        OperationStats rawOperation(size_t op) const
+        {
+            OperationStats total = retired_.operations[op];
+            for (const ThreadCounters *counters : live_)
+                accumulate(total, counters->operations[op]);
+            return total;
+        }
+
+        uint64_t rawErrorCode(size_t code) const
+        {
+            uint64_t total = retired_.errorCodes[code];
+            for (const ThreadCounters *counters : live_)
+                total += counters->errorCodes[code].get();
+            return total;
+        }
+
+        std::mutex mutex_;
+        std::vector<ThreadCounters *> live_;
+        Totals retired_{};
+        Totals baseline_{};
+    };
+
+    // 有意不析构：进程退出时其它线程的 thread_local 析构仍可能访问它
+    Registry &registry()
+    {
+        static Registry *instance = new Registry;
+        return *instance;
+    }
+
+    // 线程第一次记录时分配计数块并登记，线程退出时把计数并入 retired_
+    struct ThreadSlot
+    {
+        ThreadCounters *counters;
+
+        ThreadSlot() : counters(new ThreadCounters) { registry().attach(counters); }
+        ~ThreadSlot()
+        {
+            registry().detach(counters);
+            delete counters;
+        }
+    };
+
+    ThreadCounters &localCounters()
+    {
+        thread_local ThreadSlot slot;
+        return *slot.counters;
+    }
+
+    inline size_t latencyBucket(uint64_t ns)
+    {
+        if (ns < 4)
+            return static_cast<size_t>(ns);
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+        size_t bucket = (exponent - 1) * 4 + ((ns >> (exponent - 2)) & 3);
+        return bucket < kLatencyBuckets ? bucket : kLatencyBuckets - 1;
+    }
+}
+
+namespace instrument
+{
+    void record(InstrumentedOperation op, uint64_t bytes, uint64_t ns, bool failed)
+    {
+        OperationCounters &counters = localCounters().operations[static_cast<size_t>(op)];
+        counters.calls.add(1);
+        counters.errors.add(failed ? 1 : 0);
+        counters.bytes.add(bytes);
+        counters.total_ns.add(ns);
+        counters.latency[latencyBucket(ns)].add(1);
+    }
+
+    void recordErrorCode(int code)
+    {
+        if (code >= 0 && static_cast<size_t>(code) < kErrorCodeSlots)
+            localCounters().errorCodes[code].add(1);
+    }
+}
+
+bool instrumentation_enabled()
+{
+#ifdef CPP_CALCULATOR_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *operation_name(InstrumentedOperation op)
+{
+    size_t index = static_cast<size_t>(op);
+    return index < kOperations ? kOperationNames[index] : nullptr;
+}
+
+OperationStats operation_stats(InstrumentedOperation op)
+{
+    size_t index = static_cast<size_t>(op);
+    if (index >= kOperations)
+    {
+        OperationStats empty{};
+        return empty;
+    }
+    return registry().operation(index);
+}
+
+uint64_t error_code_count(int code)
+{
+    if (code < 0 || static_cast<size_t>(code) >= kErrorCodeSlots)
+        return 0;
+    return registry().errorCode(static_cast<size_t>(code));
+}
+
+void reset_instrumentation()
+{
+    registry().reset();
+}
+
+uint64_t latency_bucket_floor(size_t bucket)
+{
+    if (bucket < 4)
+        return bucket;
+    unsigned exponent = static_cast<unsigned>(bucket / 4 + 1);
+    return static_cast<uint64_t>(4 + bucket % 4) << (exponent - 2);
+}
+
+double latency_percentile(const OperationStats &stats, double q)
+{
+    uint64_t total = 0;
+    for (size_t b = 0; b < kLatencyBuckets; ++b)
+        total += stats.latency[b];
+    if (total == 0)
+        return 0.0;
+    q = q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+    // 第 rank 个（从 1 开始）记录所在的桶
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    for (; bucket < kLatencyBuckets - 1; ++bucket)
+    {
+        seen += stats.latency[bucket];
+        if (seen >= rank)
+            break;
+    }
+    uint64_t lo = latency_bucket_floor(bucket);
+    // 宽度为 1 的桶（8 ns 以下）和最后一个没有上界的桶直接取下界
+    if (bucket == kLatencyBuckets - 1 || latency_bucket_floor(bucket + 1) - lo <= 1)
+        return static_cast<double>(lo);
+    return (static_cast<double>(lo) + static_cast<double>(latency_bucket_floor(bucket + 1))) / 2.0;
+}
@@ -0,0 +1,181 @@
+#include "cpp_calculator/MappedFile.h"
+#include "cpp_calculator/Calculator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    std::string ioError(const std::string &what, const std::string &path)
+    {
+        return "File I/O error: " + what + " '" + path + "': " + std::strerror(errno);
+    }
+
+    size_t pageSize()
+    {
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page;
+    }
+}
+
+MappedFile::MappedFile(const std::string &path)
+    : data_(nullptr), size_(0), fd_(-1), writable_(false)
+{
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0)
+    {
+        throw CalculatorException(ioError("cannot open", path));
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+    {
+        std::string msg = ioError("cannot stat", path);
+        release();
+        throw CalculatorException(msg);
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0)
+    {
+        return; // 空文件无需映射
+    }
+
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data_ == MAP_FAILED)
+    {
+        data_ = nullptr;
+        std::string msg = ioError("cannot map", path);
+        release();
+        throw CalculatorException(msg);
+    }
+
+    // 提示为顺序扫描（加大预读），大页提示失败时忽略
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+}
+
+MappedFile::MappedFile(const std::string &path, size_t size)
+    : data_(nullptr), size_(size), fd_(-1), writable_(true)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+    {
+        throw CalculatorException(ioError("cannot create", path));
+    }
+
+    if (::ftruncate(fd_, static_cast<off_t>(size_)) != 0)
+    {
+        std::string msg = ioError("cannot resize", path);
+        release();
+        throw CalculatorException(msg);
+    }
+
+    if (size_ == 0)
+    {
+        return;
+    }
+
+    data_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data_ == MAP_FAILED)
+    {
+        data_ = nullptr;
+        std::string msg = ioError("cannot map", path);
+        release();
+        throw CalculatorException(msg);
+    }
+
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(other.data_), size_(other.size_), fd_(other.fd_), writable_(other.writable_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.fd_ = -1;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        fd_ = other.fd_;
+        writable_ = other.writable_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+void MappedFile::release()
+{
+    if (data_)
+    {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void MappedFile::release_range(size_t offset, size_t length)
+{
+    // 只对只读映射生效：私有只读页可以直接丢弃，之后再访问会从文件重新读入
+    if (!data_ || writable_ || offset >= size_)
+    {
+        return;
+    }
+
+    size_t page = pageSize();
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = std::min(offset + length, size_) / page * page;
+    if (end > begin)
+    {
+        ::madvise(static_cast<char *>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+}
+
+void MappedFile::sync()
+{
+    if (data_ && writable_)
+    {
+        ::msync(data_, size_, MS_SYNC);
+    }
+}
+
+void MappedFile::checkElementSize(size_t element_size) const
+{
+    if (size_ % element_size != 0)
+    {
+        throw CalculatorException("File size is not a multiple of the element size!");
+    }
+}
+
+bool MappedFile::sameFile(const std::string &path) const
+{
+    struct stat mine, other;
+    return fd_ >= 0 && ::fstat(fd_, &mine) == 0 && ::stat(path.c_str(), &other) == 0 &&
+           mine.st_dev == other.st_dev && mine.st_ino == other.st_ino;
+}
@@ -0,0 +1,91 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// 库内部使用的分块多线程工具（Scan.cpp / Sort.cpp），不安装
+
+#include "BusGuard.h"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel
+{
+    const size_t kMinPerThread = size_t(1) << 16;
+
+    // 实际使用的线程数：threads 为 0 时取全部硬件线程，每个线程至少分到 kMinPerThread 个元素
+    inline unsigned planThreads(size_t work, unsigned threads)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        size_t limit = std::max<size_t>(1, work / kMinPerThread);
+        return static_cast<unsigned>(std::min<size_t>(threads, limit));
+    }
+
+    // 把 [0, n) 均分为 count 块，第 t 块交给 fn(t, begin, end)，全部完成后返回。
+    // 调用线程处理第 0 块；创建线程失败时剩余的块也由调用线程完成。
+    // 任一块抛出异常时其余块照常完成，全部线程汇合后重新抛出第一个异常。
+    // 调用线程处于 busguard 保护下时每一块各自受保护，块内的 SIGBUS 同样以异常的形式汇合后抛出
+    template <typename Fn>
+    void forEachBlock(size_t n, unsigned count, Fn fn)
+    {
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        const bool guarded = busguard::active();
+        auto run = [&](unsigned t) {
+            try
+            {
+                if (guarded)
+                {
+                    busguard::run([&] { fn(t, n * t / count, n * (t + 1) / count); });
+                }
+                else
+                {
+                    fn(t, n * t / count, n * (t + 1) / count);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        unsigned started = 1;
+        try
+        {
+            workers.reserve(count > 1 ? count - 1 : 0);
+            for (; started < count; ++started)
+            {
+                workers.emplace_back(run, started);
+            }
+        }
+        catch (...)
+        {
+            // 线程数或内存不足：已启动的线程照常运行，剩余的块由调用线程完成
+        }
+        for (unsigned t = started; t < count; ++t)
+        {
+            run(t);
+        }
+        run(0u);
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#endif // PARALLEL_H
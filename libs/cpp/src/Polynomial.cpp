@@ -0,0 +1,48 @@
+#include "cpp_calculator/Polynomial.h"
+#include "Instrument.h"
+#include "Probe.h"
+#ifdef CPP_CALCULATOR_NO_ASM
+
+namespace
+{
+    // 没有 NASM 时的可移植实现：逐点 Horner
+    template <typename T>
+    void evaluate(const T *c, size_t count, const T *x, T *out, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            T xi = x[i], y = 0;
+            for (size_t j = count; j-- > 0;)
+                y = y * xi + c[j];
+            out[i] = y;
+        }
+    }
+}
+#else
+#include <asm_math_ops/math_ops_asm.h>
+
+namespace
+{
+    // 按元素类型选择汇编内核
+    inline void evaluate(const double *c, size_t count, const double *x, double *out, size_t n)
+    {
+        asm_poly_eval_f64(c, count, x, out, n);
+    }
+    inline void evaluate(const float *c, size_t count, const float *x, float *out, size_t n)
+    {
+        asm_poly_eval_f32(c, count, x, out, n);
+    }
+}
+#endif
+
+template <typename T>
+void poly_eval(const T *coeffs, size_t count, const T *x, T *out, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(PolyEval, size * sizeof(T));
+    evaluate(coeffs, count, x, out, size);
+}
+
+// 显式实例化
+template void poly_eval<double>(const double *, size_t, const double *, double *, size_t);
+template void poly_eval<float>(const float *, size_t, const float *, float *, size_t);
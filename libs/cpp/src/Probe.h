@@ -0,0 +1,47 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+// USDT 静态探针（provider cpp_calculator），不安装。
+// CALC_PROBE(n) 在当前位置触发 op_entry(op, n)，在作用域结束（包括因异常退出）时触发 op_return(op, n)：
+// op 为函数名（const char*，同一函数的地址固定，可作为运算的标识），n 为元素个数（uint64_t）。
+// 以 sys/sdt.h 构建（CALC_HAVE_SDT，见 cmake/BuildOptions.cmake 的 ENABLE_USDT）时，未被跟踪的探针只是一条 nop；
+// 否则展开为空语句，参数不会被求值。消费方式见 tools/calc_probes.sh
+
+#ifdef CALC_HAVE_SDT
+
+#include <cstdint>
+#include <sys/sdt.h>
+
+namespace probe
+{
+    class Scope
+    {
+    public:
+        Scope(const char *op, uint64_t n) : op_(op), n_(n)
+        {
+            STAP_PROBE2(cpp_calculator, op_entry, op_, n_);
+        }
+
+        ~Scope()
+        {
+            STAP_PROBE2(cpp_calculator, op_return, op_, n_);
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *op_;
+        uint64_t n_;
+    };
+}
+
+#define CALC_PROBE(n) probe::Scope calc_probe_scope_(__func__, static_cast<uint64_t>(n))
+
+#else
+
+#define CALC_PROBE(n) ((void)0)
+
+#endif
+
+#endif // PROBE_H
@@ -0,0 +1,432 @@
+#include "cpp_calculator/Scan.h"
+#include "cpp_calculator/Calculator.h"
+#include "Parallel.h"
+#include "Instrument.h"
+#include "Probe.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    using parallel::forEachBlock;
+    using parallel::planThreads;
+
+    // 累计最值的二元运算：apply(acc, x) 为合并 x 之后的结果
+    struct MinOp
+    {
+        template <typename T>
+        static T apply(T acc, T x) { return x < acc ? x : acc; }
+        // 单调队列中队尾元素 back 在 x 入队后仍可能成为最值
+        template <typename T>
+        static bool keep(T back, T x) { return back < x; }
+#if defined(__SSE2__)
+        static __m128i apply(__m128i acc, __m128i x)
+        {
+            __m128i take = _mm_cmpgt_epi32(acc, x);
+            return _mm_or_si128(_mm_and_si128(take, x), _mm_andnot_si128(take, acc));
+        }
+        static __m128d apply(__m128d acc, __m128d x) { return _mm_min_pd(x, acc); }
+#endif
+    };
+
+    struct MaxOp
+    {
+        template <typename T>
+        static T apply(T acc, T x) { return acc < x ? x : acc; }
+        template <typename T>
+        static bool keep(T back, T x) { return x < back; }
+#if defined(__SSE2__)
+        static __m128i apply(__m128i acc, __m128i x)
+        {
+            __m128i take = _mm_cmpgt_epi32(x, acc);
+            return _mm_or_si128(_mm_and_si128(take, x), _mm_andnot_si128(take, acc));
+        }
+        static __m128d apply(__m128d acc, __m128d x) { return _mm_max_pd(x, acc); }
+#endif
+    };
+
+#if defined(__SSE2__)
+    // 以下 SSE2 内核处理前 n 个元素中能整块处理的部分，返回已处理的个数，carry 随之更新。
+    // 每块先在寄存器内求块内前缀，再加上 carry，使跨块的依赖链只有一次加法和一次 shuffle
+
+    // 4 个 int32 符号扩展为两组 int64
+    inline void widen(__m128i x, __m128i &lo, __m128i &hi)
+    {
+        __m128i sign = _mm_srai_epi32(x, 31);
+        lo = _mm_unpacklo_epi32(x, sign);
+        hi = _mm_unpackhi_epi32(x, sign);
+    }
+
+    inline __m128i broadcastHigh64(__m128i x)
+    {
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    // out[i] = carry + Σ(add[k] - sub[k])；exclusive 时不含第 i 项。先读后写，out 可以等于 add
+    size_t scanAddSse2(const int32_t *add, const int32_t *sub, size_t n, int64_t *out, int64_t &carry,
+                       bool exclusive)
+    {
+        __m128i c = _mm_set1_epi64x(carry);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i lo, hi;
+            widen(_mm_loadu_si128(reinterpret_cast<const __m128i *>(add + i)), lo, hi);
+            if (sub)
+            {
+                __m128i sub_lo, sub_hi;
+                widen(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sub + i)), sub_lo, sub_hi);
+                lo = _mm_sub_epi64(lo, sub_lo);
+                hi = _mm_sub_epi64(hi, sub_hi);
+            }
+            // 块内前缀：[x0, x0+x1] 和 [x2, x2+x3] + (x0+x1)
+            __m128i lo_before = _mm_slli_si128(lo, 8);
+            __m128i hi_before = _mm_add_epi64(_mm_slli_si128(hi, 8), broadcastHigh64(_mm_add_epi64(lo, lo_before)));
+            lo_before = _mm_add_epi64(lo_before, c);
+            hi_before = _mm_add_epi64(hi_before, c);
+            __m128i hi_incl = _mm_add_epi64(hi_before, hi);
+            c = broadcastHigh64(hi_incl);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), exclusive ? lo_before : _mm_add_epi64(lo_before, lo));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 2), exclusive ? hi_before : hi_incl);
+        }
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(&carry), c);
+        return i;
+    }
+
+    size_t scanAddSse2(const double *add, const double *sub, size_t n, double *out, double &carry, bool exclusive)
+    {
+        __m128d c = _mm_set1_pd(carry);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d lo = _mm_loadu_pd(add + i);
+            __m128d hi = _mm_loadu_pd(add + i + 2);
+            if (sub)
+            {
+                lo = _mm_sub_pd(lo, _mm_loadu_pd(sub + i));
+                hi = _mm_sub_pd(hi, _mm_loadu_pd(sub + i + 2));
+            }
+            const __m128d zero = _mm_setzero_pd();
+            __m128d lo_before = _mm_unpacklo_pd(zero, lo);
+            __m128d lo_sum = _mm_add_pd(lo, lo_before);
+            __m128d hi_before = _mm_add_pd(_mm_unpacklo_pd(zero, hi), _mm_unpackhi_pd(lo_sum, lo_sum));
+            lo_before = _mm_add_pd(lo_before, c);
+            hi_before = _mm_add_pd(hi_before, c);
+            __m128d hi_incl = _mm_add_pd(hi_before, hi);
+            c = _mm_unpackhi_pd(hi_incl, hi_incl);
+            _mm_storeu_pd(out + i, exclusive ? lo_before : _mm_add_pd(lo_before, lo));
+            _mm_storeu_pd(out + i + 2, exclusive ? hi_before : hi_incl);
+        }
+        carry = _mm_cvtsd_f64(c);
+        return i;
+    }
+
+    // out[i] = Op(carry, data[0..i])
+    template <typename Op>
+    size_t cumulativeSse2(const int32_t *data, size_t n, int32_t *out, int32_t &carry)
+    {
+        __m128i c = _mm_set1_epi32(carry);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            // 与左移一、二个通道的自身合并得到块内前缀；移入的通道取 x 自己的首元素，不影响结果
+            __m128i first = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 0, 0, 0));
+            x = Op::apply(_mm_or_si128(_mm_slli_si128(x, 4), _mm_srli_si128(first, 12)), x);
+            x = Op::apply(_mm_or_si128(_mm_slli_si128(x, 8), _mm_srli_si128(first, 8)), x);
+            x = Op::apply(c, x);
+            c = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), x);
+        }
+        carry = _mm_cvtsi128_si32(c);
+        return i;
+    }
+
+    template <typename Op>
+    size_t cumulativeSse2(const double *data, size_t n, double *out, double &carry)
+    {
+        __m128d c = _mm_set1_pd(carry);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d x = _mm_loadu_pd(data + i);
+            x = Op::apply(_mm_unpacklo_pd(x, x), x);
+            x = Op::apply(c, x);
+            c = _mm_unpackhi_pd(x, x);
+            _mm_storeu_pd(out + i, x);
+        }
+        carry = _mm_cvtsd_f64(c);
+        return i;
+    }
+#endif
+
+    // 增量扫描：out[i] = carry + Σ_{k<=i}(add[k] - sub[k])，sub 为 nullptr 时视为 0；
+    // exclusive 时 out[i] 不含第 i 项。返回扫描结束时的 carry
+    template <typename T>
+    scan_sum_t<T> scanAdd(const T *add, const T *sub, size_t n, scan_sum_t<T> *out, scan_sum_t<T> carry,
+                          bool exclusive)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        i = scanAddSse2(add, sub, n, out, carry, exclusive);
+#endif
+        for (; i < n; ++i)
+        {
+            scan_sum_t<T> x = static_cast<scan_sum_t<T>>(add[i]);
+            if (sub)
+            {
+                x -= static_cast<scan_sum_t<T>>(sub[i]);
+            }
+            scan_sum_t<T> next = carry + x;
+            out[i] = exclusive ? carry : next;
+            carry = next;
+        }
+        return carry;
+    }
+
+    template <typename Op, typename T>
+    T scanCumulative(const T *data, size_t n, T *out, T carry)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        i = cumulativeSse2<Op>(data, n, out, carry);
+#endif
+        for (; i < n; ++i)
+        {
+            carry = Op::apply(carry, data[i]);
+            out[i] = carry;
+        }
+        return carry;
+    }
+
+    template <typename Op, typename T>
+    void cumulative(const T *data, size_t size, T *out, unsigned threads)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        unsigned count = planThreads(size, threads);
+        if (count == 1)
+        {
+            scanCumulative<Op>(data, size, out, data[0]);
+            return;
+        }
+
+        // 先并行求每块的最值，再串行得出每块开始时的累计值
+        std::vector<T> carry(count);
+        forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+            T acc = data[begin];
+            for (size_t i = begin + 1; i < end; ++i)
+            {
+                acc = Op::apply(acc, data[i]);
+            }
+            carry[t] = acc;
+        });
+        T running = data[0];
+        for (unsigned t = 0; t < count; ++t)
+        {
+            T block = carry[t];
+            carry[t] = running;
+            running = Op::apply(running, block);
+        }
+        forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+            scanCumulative<Op>(data + begin, end - begin, out + begin, carry[t]);
+        });
+    }
+
+    size_t checkWindow(size_t size, size_t window)
+    {
+        size_t outputs = window_count(size, window);
+        if (outputs == 0)
+        {
+            throw CalculatorException("Invalid window size: must be between 1 and the array length");
+        }
+        return outputs;
+    }
+
+    // 单调队列求 out[begin, end)（需要 data[begin, end + window - 1)）。
+    // 队列保存下标，对应的值从队首到队尾严格单调，队首即当前窗口的最值
+    template <typename Op, typename T>
+    void windowExtremum(const T *data, size_t window, size_t begin, size_t end, T *out)
+    {
+        size_t capacity = 1;
+        while (capacity < window)
+        {
+            capacity <<= 1;
+        }
+        std::vector<size_t> queue(capacity);
+        const size_t mask = capacity - 1;
+        size_t head = 0, tail = 0; // 单调递增的逻辑位置，[head, tail) 为队列内容
+
+        for (size_t i = begin, last = end + window - 1; i < last; ++i)
+        {
+            if (head != tail && queue[head & mask] + window <= i)
+            {
+                ++head; // 队首滑出窗口
+            }
+            T x = data[i];
+            while (head != tail && !Op::keep(data[queue[(tail - 1) & mask]], x))
+            {
+                --tail; // 被 x 支配的元素不可能再成为最值
+            }
+            queue[tail++ & mask] = i;
+            if (i + 1 >= begin + window)
+            {
+                out[i + 1 - window] = data[queue[head & mask]];
+            }
+        }
+    }
+
+    // 求 out[begin, end)（begin < end）。int32 的和在 int64 中精确：首个窗口直接求和，
+    // 之后每次加入新元素、减去滑出的元素
+    void windowSum(const int32_t *data, size_t window, size_t begin, size_t end, int64_t *out)
+    {
+        int64_t first = 0;
+        for (size_t i = begin; i < begin + window; ++i)
+        {
+            first += data[i];
+        }
+        out[begin] = first;
+        scanAdd(data + begin + window, data + begin, end - begin - 1, out + begin + 1, first, false);
+    }
+
+    // double 做增减会把滑出窗口的 inf / 大数的舍入带到后面的窗口，因此每个窗口只由自身元素求出：
+    // 按全局下标把数组切成宽 window 的块，窗口 [i, i + window) 至多跨两块，
+    // 其和为块内后缀 suffix(i) 与下一块的前缀 prefix(i + window - 1) 之和（van Herk 方法）。
+    // 块边界与线程划分无关，结果在任意线程数下一致
+    void windowSum(const double *data, size_t window, size_t begin, size_t end, double *out)
+    {
+        // 先倒序写入块内后缀和
+        size_t last = (end - 1) / window * window + window - 1;
+        double suffix = 0;
+        for (size_t i = last + 1; i-- > begin;)
+        {
+            suffix = (i + 1) % window == 0 ? data[i] : data[i] + suffix;
+            if (i < end)
+            {
+                out[i] = suffix;
+            }
+        }
+        // 再加上窗口在下一块中的前缀和；起点对齐的窗口恰为一整块，后缀和即结果
+        double prefix = 0;
+        for (size_t j = (begin + window - 1) / window * window; j < end + window - 1; ++j)
+        {
+            prefix = j % window == 0 ? data[j] : prefix + data[j];
+            size_t i = j + 1 - window;
+            if (j + 1 >= begin + window && i % window != 0)
+            {
+                out[i] += prefix;
+            }
+        }
+    }
+
+    template <typename Op, typename T>
+    void windowExtremum(const T *data, size_t size, size_t window, T *out, unsigned threads)
+    {
+        size_t outputs = checkWindow(size, window);
+        forEachBlock(outputs, planThreads(outputs, threads), [&](unsigned, size_t begin, size_t end) {
+            windowExtremum<Op>(data, window, begin, end, out);
+        });
+    }
+}
+
+template <typename T>
+void prefix_sum(const T *data, size_t size, scan_sum_t<T> *out, ScanMode mode, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(PrefixSum, size * sizeof(T));
+    using S = scan_sum_t<T>;
+    bool exclusive = mode == ScanMode::Exclusive;
+    unsigned count = planThreads(size, threads);
+    if (count == 1)
+    {
+        scanAdd(data, static_cast<const T *>(nullptr), size, out, S(0), exclusive);
+        return;
+    }
+
+    // 先并行求每块的和，再串行得出每块的初值（块 t 之前所有元素的和）
+    std::vector<S> carry(count);
+    forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+        S sum = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            sum += data[i];
+        }
+        carry[t] = sum;
+    });
+    S running = 0;
+    for (unsigned t = 0; t < count; ++t)
+    {
+        S block = carry[t];
+        carry[t] = running;
+        running += block;
+    }
+    forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+        scanAdd(data + begin, static_cast<const T *>(nullptr), end - begin, out + begin, carry[t], exclusive);
+    });
+}
+
+template <typename T>
+void cumulative_min(const T *data, size_t size, T *out, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(CumulativeMin, size * sizeof(T));
+    cumulative<MinOp>(data, size, out, threads);
+}
+
+template <typename T>
+void cumulative_max(const T *data, size_t size, T *out, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(CumulativeMax, size * sizeof(T));
+    cumulative<MaxOp>(data, size, out, threads);
+}
+
+template <typename T>
+void window_sum(const T *data, size_t size, size_t window, scan_sum_t<T> *out, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(WindowSum, size * sizeof(T));
+    size_t outputs = checkWindow(size, window);
+    forEachBlock(outputs, planThreads(outputs, threads), [&](unsigned, size_t begin, size_t end) {
+        if (begin != end)
+        {
+            windowSum(data, window, begin, end, out);
+        }
+    });
+}
+
+template <typename T>
+void window_min(const T *data, size_t size, size_t window, T *out, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(WindowMin, size * sizeof(T));
+    windowExtremum<MinOp>(data, size, window, out, threads);
+}
+
+template <typename T>
+void window_max(const T *data, size_t size, size_t window, T *out, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(WindowMax, size * sizeof(T));
+    windowExtremum<MaxOp>(data, size, window, out, threads);
+}
+
+// 显式实例化
+template void prefix_sum<int32_t>(const int32_t *, size_t, int64_t *, ScanMode, unsigned);
+template void prefix_sum<double>(const double *, size_t, double *, ScanMode, unsigned);
+template void cumulative_min<int32_t>(const int32_t *, size_t, int32_t *, unsigned);
+template void cumulative_min<double>(const double *, size_t, double *, unsigned);
+template void cumulative_max<int32_t>(const int32_t *, size_t, int32_t *, unsigned);
+template void cumulative_max<double>(const double *, size_t, double *, unsigned);
+template void window_sum<int32_t>(const int32_t *, size_t, size_t, int64_t *, unsigned);
+template void window_sum<double>(const double *, size_t, size_t, double *, unsigned);
+template void window_min<int32_t>(const int32_t *, size_t, size_t, int32_t *, unsigned);
+template void window_min<double>(const double *, size_t, size_t, double *, unsigned);
+template void window_max<int32_t>(const int32_t *, size_t, size_t, int32_t *, unsigned);
+template void window_max<double>(const double *, size_t, size_t, double *, unsigned);
@@ -0,0 +1,242 @@
+#include "cpp_calculator/Selection.h"
+#include "cpp_calculator/Calculator.h"
+#include "Instrument.h"
+#include "Probe.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // argmax / argmin 分块：块内最值用 SIMD 求出，严格优于当前结果时才在块内（仍在 L1 中）找首次出现的位置
+    const size_t kArgBlock = 1024;
+
+    template <bool WantMax, typename T>
+    bool better(T x, T best) { return WantMax ? x > best : x < best; }
+
+#if defined(__SSE2__)
+    template <bool WantMax>
+    __m128i extreme(__m128i acc, __m128i x)
+    {
+        __m128i take = WantMax ? _mm_cmpgt_epi32(x, acc) : _mm_cmpgt_epi32(acc, x);
+        return _mm_or_si128(_mm_and_si128(take, x), _mm_andnot_si128(take, acc));
+    }
+
+    // x 为 NaN 时 max_pd / min_pd 返回 acc，NaN 不会进入结果
+    template <bool WantMax>
+    __m128d extreme(__m128d acc, __m128d x) { return WantMax ? _mm_max_pd(x, acc) : _mm_min_pd(x, acc); }
+#endif
+
+    template <bool WantMax>
+    int32_t blockExtreme(const int32_t *data, size_t n, int32_t best)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128i acc0 = _mm_set1_epi32(best), acc1 = acc0;
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = extreme<WantMax>(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+            acc1 = extreme<WantMax>(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 4)));
+        }
+        acc0 = extreme<WantMax>(acc0, acc1);
+        acc0 = extreme<WantMax>(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc0 = extreme<WantMax>(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(2, 3, 0, 1)));
+        best = _mm_cvtsi128_si32(acc0);
+#endif
+        for (; i < n; ++i)
+        {
+            if (better<WantMax>(data[i], best))
+                best = data[i];
+        }
+        return best;
+    }
+
+    template <bool WantMax>
+    double blockExtreme(const double *data, size_t n, double best)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        __m128d acc0 = _mm_set1_pd(best), acc1 = acc0;
+        for (; i + 4 <= n; i += 4)
+        {
+            acc0 = extreme<WantMax>(acc0, _mm_loadu_pd(data + i));
+            acc1 = extreme<WantMax>(acc1, _mm_loadu_pd(data + i + 2));
+        }
+        acc0 = extreme<WantMax>(acc0, acc1);
+        acc0 = extreme<WantMax>(acc0, _mm_unpackhi_pd(acc0, acc0));
+        best = _mm_cvtsd_f64(acc0);
+#endif
+        for (; i < n; ++i)
+        {
+            if (better<WantMax>(data[i], best))
+                best = data[i];
+        }
+        return best;
+    }
+
+    // 起始值：int32 取首元素；double 取 ∓inf，使 NaN 和全部元素都被正确处理
+    template <bool WantMax>
+    int32_t initialBest(const int32_t *data) { return data[0]; }
+    template <bool WantMax>
+    double initialBest(const double *)
+    {
+        return WantMax ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    }
+
+    template <bool WantMax, typename T>
+    size_t argExtreme(const T *data, size_t size)
+    {
+        if (size == 0)
+        {
+            throw CalculatorException("Array is empty!");
+        }
+        T best = initialBest<WantMax>(data);
+        size_t best_index = size;
+        for (size_t begin = 0; begin < size; begin += kArgBlock)
+        {
+            size_t n = std::min(kArgBlock, size - begin);
+            T m = blockExtreme<WantMax>(data + begin, n, best);
+            if (better<WantMax>(m, best))
+            {
+                best = m;
+                best_index = static_cast<size_t>(std::find(data + begin, data + begin + n, m) - data);
+            }
+        }
+        if (best_index == size)
+        {
+            // 没有严格优于起始值的元素：起始值本身首次出现的位置（int32 为 0；double 全为 NaN 时为 0）
+            best_index = static_cast<size_t>(std::find(data, data + size, best) - data);
+            if (best_index == size)
+                best_index = 0;
+        }
+        return best_index;
+    }
+
+    template <typename T>
+    bool isNan(T value) { return value != value; }
+
+    // 排名顺序：值大的在前，值相同时下标小的在前
+    template <typename T>
+    struct RanksBefore
+    {
+        const T *data;
+        bool operator()(size_t a, size_t b) const
+        {
+            return data[a] > data[b] || (data[a] == data[b] && a < b);
+        }
+    };
+}
+
+template <typename T>
+size_t argmax(const T *data, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Argmax, size * sizeof(T));
+    return argExtreme<true>(data, size);
+}
+
+template <typename T>
+size_t argmin(const T *data, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Argmin, size * sizeof(T));
+    return argExtreme<false>(data, size);
+}
+
+template <typename T>
+std::vector<size_t> top_k(const T *data, size_t size, size_t k)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(TopK, size * sizeof(T));
+    RanksBefore<T> before{data};
+    std::vector<size_t> result;
+    k = std::min(k, size);
+    if (k == 0)
+    {
+        return result;
+    }
+
+    if (k > size / 8)
+    {
+        // k 较大：对全部（非 NaN）下标做一次 nth_element，再排序前 k 个
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (!isNan(data[i]))
+                result.push_back(i);
+        }
+        k = std::min(k, result.size());
+        std::nth_element(result.begin(), result.begin() + k, result.end(), before);
+        result.resize(k);
+    }
+    else
+    {
+        // k 较小：以 before 为比较的堆，堆顶是已选元素中排名最靠后的一个
+        result.reserve(k);
+        size_t i = 0;
+        for (; i < size && result.size() < k; ++i)
+        {
+            if (!isNan(data[i]))
+                result.push_back(i);
+        }
+        std::make_heap(result.begin(), result.end(), before);
+        for (; i < size; ++i)
+        {
+            // 之后的下标更大，值相同不会排在前面，只需严格大于堆顶
+            if (data[i] > data[result.front()])
+            {
+                std::pop_heap(result.begin(), result.end(), before);
+                result.back() = i;
+                std::push_heap(result.begin(), result.end(), before);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), before);
+    return result;
+}
+
+template <typename T>
+double percentile(const T *data, size_t size, double q)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Percentile, size * sizeof(T));
+    if (size == 0)
+    {
+        throw CalculatorException("Array is empty!");
+    }
+    if (!(q >= 0.0 && q <= 1.0))
+    {
+        throw CalculatorException("Percentile must be between 0 and 1");
+    }
+    if (std::any_of(data, data + size, [](T v) { return isNan(v); }))
+    {
+        throw CalculatorException("Cannot rank NaN values");
+    }
+
+    std::vector<T> work(data, data + size);
+    double pos = q * static_cast<double>(size - 1);
+    size_t k = static_cast<size_t>(pos);
+    double frac = pos - static_cast<double>(k);
+    std::nth_element(work.begin(), work.begin() + k, work.end());
+    double lower = static_cast<double>(work[k]);
+    if (frac > 0.0 && k + 1 < size)
+    {
+        // nth_element 之后右侧都不小于 work[k]，其中最小的就是下一个顺序统计量
+        double upper = static_cast<double>(*std::min_element(work.begin() + k + 1, work.end()));
+        lower += (upper - lower) * frac;
+    }
+    return lower;
+}
+
+// 显式实例化
+template size_t argmax<int32_t>(const int32_t *, size_t);
+template size_t argmax<double>(const double *, size_t);
+template size_t argmin<int32_t>(const int32_t *, size_t);
+template size_t argmin<double>(const double *, size_t);
+template std::vector<size_t> top_k<int32_t>(const int32_t *, size_t, size_t);
+template std::vector<size_t> top_k<double>(const double *, size_t, size_t);
+template double percentile<int32_t>(const int32_t *, size_t, double);
+template double percentile<double>(const double *, size_t, double);
@@ -0,0 +1,155 @@
+#include "cpp_calculator/SharedMemory.h"
+#include "cpp_calculator/Calculator.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    std::string ioError(const std::string &what, const std::string &name)
+    {
+        return "File I/O error: " + what + " shared memory '" + name + "': " + std::strerror(errno);
+    }
+
+    // 映射整个段；失败时关闭 fd 并抛出异常。成功时 fd 保持打开，供 currentSize() 使用
+    void *mapSegment(int fd, size_t size, const std::string &name)
+    {
+        void *data = nullptr;
+        if (size != 0)
+        {
+            data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                std::string msg = ioError("cannot map", name);
+                ::close(fd);
+                throw CalculatorException(msg);
+            }
+        }
+        return data;
+    }
+}
+
+SharedMemorySegment::SharedMemorySegment(const std::string &name)
+    : data_(nullptr), size_(0), fd_(-1), name_(normalizeName(name)), owner_(false)
+{
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        throw CalculatorException(ioError("cannot open", name_));
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        std::string msg = ioError("cannot stat", name_);
+        ::close(fd);
+        throw CalculatorException(msg);
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    data_ = mapSegment(fd, size_, name_);
+    fd_ = fd;
+}
+
+SharedMemorySegment::SharedMemorySegment(const std::string &name, size_t size)
+    : data_(nullptr), size_(size), fd_(-1), name_(normalizeName(name)), owner_(true)
+{
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        throw CalculatorException(ioError("cannot create", name_));
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(size_)) != 0)
+    {
+        std::string msg = ioError("cannot resize", name_);
+        ::close(fd);
+        ::shm_unlink(name_.c_str());
+        throw CalculatorException(msg);
+    }
+
+    try
+    {
+        data_ = mapSegment(fd, size_, name_);
+    }
+    catch (...)
+    {
+        ::shm_unlink(name_.c_str());
+        throw;
+    }
+    fd_ = fd;
+}
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+    release();
+}
+
+SharedMemorySegment::SharedMemorySegment(SharedMemorySegment &&other) noexcept
+    : data_(other.data_), size_(other.size_), fd_(other.fd_), name_(std::move(other.name_)), owner_(other.owner_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.fd_ = -1;
+    other.owner_ = false;
+}
+
+SharedMemorySegment &SharedMemorySegment::operator=(SharedMemorySegment &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        fd_ = other.fd_;
+        name_ = std::move(other.name_);
+        owner_ = other.owner_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.fd_ = -1;
+        other.owner_ = false;
+    }
+    return *this;
+}
+
+void SharedMemorySegment::release()
+{
+    if (data_)
+    {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    unlink();
+}
+
+size_t SharedMemorySegment::currentSize() const
+{
+    struct stat st;
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(st.st_size);
+}
+
+void SharedMemorySegment::unlink()
+{
+    if (owner_)
+    {
+        ::shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+std::string SharedMemorySegment::normalizeName(const std::string &name)
+{
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
@@ -0,0 +1,259 @@
+#include "cpp_calculator/Sort.h"
+#include "cpp_calculator/Calculator.h"
+#include "Parallel.h"
+#include "Instrument.h"
+#include "Probe.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using parallel::forEachBlock;
+    using parallel::planThreads;
+
+    // 基数排序的键：把 int32 / float 的位模式变换为按无符号整数比较即有序的 uint32
+    inline uint32_t toKey(int32_t value)
+    {
+        return static_cast<uint32_t>(value) ^ 0x80000000u;
+    }
+
+    inline uint32_t toKey(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        // 负数取反（绝对值越大越靠前），非负数只翻转符号位
+        return (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+    }
+
+    inline void fromKey(uint32_t key, int32_t &value)
+    {
+        value = static_cast<int32_t>(key ^ 0x80000000u);
+    }
+
+    inline void fromKey(uint32_t key, float &value)
+    {
+        uint32_t bits = (key & 0x80000000u) ? key ^ 0x80000000u : ~key;
+        std::memcpy(&value, &bits, sizeof(bits));
+    }
+
+    // 短数组上计数和 4 趟分发的固定开销不划算，直接 std::sort 键
+    const size_t kRadixMin = 256;
+
+    // 归并 a[0, m) 与 b[0, n) 时，前 k 个输出中来自 a 的个数（值相同时 a 在前，与 std::merge 一致）
+    size_t coRank(size_t k, const double *a, size_t m, const double *b, size_t n)
+    {
+        size_t lo = k > n ? k - n : 0, hi = std::min(k, m);
+        while (lo < hi)
+        {
+            size_t i = lo + (hi - lo) / 2, j = k - i;
+            if (b[j - 1] >= a[i])
+                lo = i + 1;
+            else
+                hi = i;
+        }
+        return lo;
+    }
+
+    // 把 src 中相邻的有序段两两归并到 dst（段边界为 runs，落单的最后一段直接复制）。
+    // 只输出 [begin, end) 这一部分，一轮归并由多个线程按输出位置分担
+    void mergeRuns(const double *src, double *dst, const std::vector<size_t> &runs, size_t begin, size_t end)
+    {
+        size_t count = runs.size() - 1;
+        for (size_t r = 0; r < count; r += 2)
+        {
+            bool paired = r + 1 < count;
+            size_t lo = runs[r], hi = paired ? runs[r + 2] : runs[r + 1];
+            if (hi <= begin || lo >= end)
+                continue;
+            size_t k0 = std::max(begin, lo) - lo, k1 = std::min(end, hi) - lo;
+            if (!paired)
+            {
+                std::copy(src + lo + k0, src + lo + k1, dst + lo + k0);
+                continue;
+            }
+            const double *a = src + lo, *b = src + runs[r + 1];
+            size_t m = runs[r + 1] - lo, n = hi - runs[r + 1];
+            size_t i0 = coRank(k0, a, m, b, n), i1 = coRank(k1, a, m, b, n);
+            std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), dst + lo + k0);
+        }
+    }
+
+    // 桶不多时用 4 组计数器轮流累加，避免连续落入同一个桶的元素形成"读-改-写"依赖链
+    const size_t kLaneBins = 1024;
+
+    // 单线程计数到 counts[0, bins)，返回计入的元素个数
+    template <typename T>
+    size_t countBins(const T *data, size_t n, double lo, double hi, double scale, size_t bins,
+                     std::vector<uint64_t> &counts)
+    {
+        const size_t lanes = bins <= kLaneBins ? 4 : 1;
+        counts.assign(lanes * bins, 0);
+        uint64_t *c = counts.data();
+        size_t counted = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double x = static_cast<double>(data[i]);
+            // NaN 的比较为假，与范围外的值一起跳过
+            if (x >= lo && x <= hi)
+            {
+                size_t b = std::min(static_cast<size_t>((x - lo) * scale), bins - 1);
+                ++c[(i & (lanes - 1)) * bins + b];
+                ++counted;
+            }
+        }
+        for (size_t lane = 1; lane < lanes; ++lane)
+        {
+            for (size_t b = 0; b < bins; ++b)
+            {
+                c[b] += c[lane * bins + b];
+            }
+        }
+        return counted;
+    }
+}
+
+template <typename T>
+void radix_sort(T *data, size_t size)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Sort, size * sizeof(T));
+    if (size < 2)
+    {
+        return;
+    }
+    std::vector<uint32_t> keys(size);
+    if (size < kRadixMin)
+    {
+        for (size_t i = 0; i < size; ++i)
+            keys[i] = toKey(data[i]);
+        std::sort(keys.begin(), keys.end());
+        for (size_t i = 0; i < size; ++i)
+            fromKey(keys[i], data[i]);
+        return;
+    }
+
+    // 一次遍历得到 4 趟各自的计数
+    size_t counts[4][256] = {};
+    for (size_t i = 0; i < size; ++i)
+    {
+        uint32_t key = toKey(data[i]);
+        keys[i] = key;
+        ++counts[0][key & 0xff];
+        ++counts[1][(key >> 8) & 0xff];
+        ++counts[2][(key >> 16) & 0xff];
+        ++counts[3][key >> 24];
+    }
+
+    std::vector<uint32_t> buffer(size);
+    uint32_t *src = keys.data(), *dst = buffer.data();
+    for (unsigned pass = 0; pass < 4; ++pass)
+    {
+        unsigned shift = pass * 8;
+        size_t *offsets = counts[pass];
+        // 所有键在这一位上相同：分发不改变顺序，跳过
+        if (offsets[(src[0] >> shift) & 0xff] == size)
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t d = 0; d < 256; ++d)
+        {
+            size_t n = offsets[d];
+            offsets[d] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            uint32_t key = src[i];
+            dst[offsets[(key >> shift) & 0xff]++] = key;
+        }
+        std::swap(src, dst);
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        fromKey(src[i], data[i]);
+    }
+}
+
+void parallel_sort(double *data, size_t size, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Sort, size * sizeof(double));
+    // NaN 移到最后，其余部分才满足严格弱序
+    size_t n = static_cast<size_t>(std::partition(data, data + size, [](double v) { return v == v; }) - data);
+    unsigned count = planThreads(n, threads);
+    if (count <= 1)
+    {
+        std::sort(data, data + n);
+        return;
+    }
+
+    // 段边界与 forEachBlock 的分块一致：第 t 个线程排序第 t 段
+    std::vector<size_t> runs(count + 1);
+    for (unsigned t = 0; t <= count; ++t)
+    {
+        runs[t] = n * t / count;
+    }
+    forEachBlock(n, count, [data](unsigned, size_t begin, size_t end) { std::sort(data + begin, data + end); });
+
+    std::vector<double> buffer(n);
+    double *src = data, *dst = buffer.data();
+    while (runs.size() > 2)
+    {
+        forEachBlock(n, count, [&](unsigned, size_t begin, size_t end) { mergeRuns(src, dst, runs, begin, end); });
+        std::vector<size_t> merged;
+        for (size_t r = 0; r < runs.size(); r += 2)
+        {
+            merged.push_back(runs[r]);
+        }
+        if (merged.back() != n)
+        {
+            merged.push_back(n);
+        }
+        runs.swap(merged);
+        std::swap(src, dst);
+    }
+    if (src != data)
+    {
+        forEachBlock(n, count, [&](unsigned, size_t begin, size_t end) { std::copy(src + begin, src + end, data + begin); });
+    }
+}
+
+template <typename T>
+size_t histogram(const T *data, size_t size, double lo, double hi, size_t bins, uint64_t *counts, unsigned threads)
+{
+    CALC_PROBE(size);
+    CALC_INSTRUMENT(Histogram, size * sizeof(T));
+    if (bins == 0 || !std::isfinite(lo) || !std::isfinite(hi) || !(lo < hi) || !std::isfinite(hi - lo))
+    {
+        throw CalculatorException("Invalid histogram: bins must be positive and lo < hi finite");
+    }
+    double scale = static_cast<double>(bins) / (hi - lo);
+
+    unsigned count = planThreads(size, threads);
+    std::vector<std::vector<uint64_t>> partial(count);
+    std::vector<size_t> counted(count);
+    forEachBlock(size, count, [&](unsigned t, size_t begin, size_t end) {
+        counted[t] = countBins(data + begin, end - begin, lo, hi, scale, bins, partial[t]);
+    });
+
+    std::copy(partial[0].begin(), partial[0].begin() + bins, counts);
+    size_t total = counted[0];
+    for (unsigned t = 1; t < count; ++t)
+    {
+        for (size_t b = 0; b < bins; ++b)
+        {
+            counts[b] += partial[t][b];
+        }
+        total += counted[t];
+    }
+    return total;
+}
+
+// 显式实例化
+template void radix_sort<int32_t>(int32_t *, size_t);
+template void radix_sort<float>(float *, size_t);
+template size_t histogram<int32_t>(const int32_t *, size_t, double, double, size_t, uint64_t *, unsigned);
+template size_t histogram<double>(const double *, size_t, double, double, size_t, uint64_t *, unsigned);
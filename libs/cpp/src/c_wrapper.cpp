@@ -1,30 +1,124 @@
 #include "cpp_calculator/c_wrapper.h"
 #include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/ArrowColumn.h"
+#include "cpp_calculator/HistoryJournal.h"
+#include "cpp_calculator/Scan.h"
+#include "cpp_calculator/Selection.h"
+#include "cpp_calculator/Sort.h"
+#include "cpp_calculator/GroupBy.h"
+#include "cpp_calculator/Blas.h"
+#include "cpp_calculator/Gemm.h"
+#include "cpp_calculator/Polynomial.h"
+#include "cpp_calculator/Instrumentation.h"
+#include "cpp_calculator/CalcServer.h"
+#include "Instrument.h"
+#include "Probe.h"
+#include <algorithm>
 #include <cstring>
+#include <memory>
 #include <new>
+#include <type_traits>
 
 // 结构体定义（隐藏C++对象）
 HANDLE_DEF(Calculator)
 HANDLE_DEF(AdvancedCalculator)
 
-// 错误处理辅助函数
+// 错误处理辅助函数：异常转换成的每个错误码都计入统计（见 instrumentation_error_code_count）
 static CalculatorError cpp_exception_to_c_error(const CalculatorException& e) {
     std::string msg = e.what();
-    if (msg.find("Division by zero") != std::string::npos) {
-        return CALC_ERROR_DIVISION_BY_ZERO;
+    CalculatorError code;
+    if (msg.find("File I/O error") != std::string::npos) {
+        code = CALC_ERROR_IO;
+    } else if (msg.find("Division by zero") != std::string::npos) {
+        code = CALC_ERROR_DIVISION_BY_ZERO;
     } else if (msg.find("negative number") != std::string::npos) {
-        return CALC_ERROR_SQUARE_ROOT_NEGATIVE;
+        code = CALC_ERROR_SQUARE_ROOT_NEGATIVE;
     } else if (msg.find("undefined") != std::string::npos) {
-        return CALC_ERROR_FACTORIAL_NEGATIVE;
+        code = CALC_ERROR_FACTORIAL_NEGATIVE;
     } else if (msg.find("empty") != std::string::npos) {
-        return CALC_ERROR_ARRAY_EMPTY;
+        code = CALC_ERROR_ARRAY_EMPTY;
     } else {
+        code = CALC_ERROR_INVALID_ARGUMENT;
+    }
+    CALC_INSTRUMENT_ERROR_CODE(code);
+    return code;
+}
+
+static CalculatorError bad_alloc_to_c_error() {
+    CALC_INSTRUMENT_ERROR_CODE(CALC_ERROR_OUT_OF_MEMORY);
+    return CALC_ERROR_OUT_OF_MEMORY;
+}
+
+static CalculatorError unknown_exception_to_c_error() {
+    CALC_INSTRUMENT_ERROR_CODE(CALC_ERROR_INVALID_ARGUMENT);
+    return CALC_ERROR_INVALID_ARGUMENT;
+}
+
+// 执行 f 并把异常转换为错误码
+namespace {
+    template <typename F>
+    CalculatorError run_checked(F f) {
+        try {
+            f();
+            return CALC_SUCCESS;
+        } catch (const CalculatorException& e) {
+            return cpp_exception_to_c_error(e);
+        } catch (const std::bad_alloc&) {
+            return bad_alloc_to_c_error();
+        } catch (...) {
+            return unknown_exception_to_c_error();
+        }
+    }
+}
+
+static CalculatorError export_history(const Calculator& calculator, size_t first, size_t count,
+                                      HistoryExportFormat format, char* buffer, size_t buffer_size,
+                                      size_t* required) {
+    if (!required || (format != HISTORY_FORMAT_TEXT && format != HISTORY_FORMAT_BINARY)) {
         return CALC_ERROR_INVALID_ARGUMENT;
     }
+
+    try {
+        HistoryFormat cpp_format = format == HISTORY_FORMAT_TEXT ? HistoryFormat::Text : HistoryFormat::Binary;
+        *required = calculator.exportHistory(first, count, cpp_format, buffer, buffer_size);
+        if (buffer && buffer_size < *required) return CALC_ERROR_BUFFER_TOO_SMALL;
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+static CalculatorError open_journal(Calculator& calculator, const char* path, JournalSyncMode sync) {
+    if (!path || sync < JOURNAL_SYNC_NONE || sync > JOURNAL_SYNC_INTERVAL) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        JournalOptions options;
+        options.sync = sync == JOURNAL_SYNC_NONE ? JournalSync::None
+                     : sync == JOURNAL_SYNC_BATCH ? JournalSync::Batch
+                     : JournalSync::Interval;
+        calculator.setJournal(std::make_shared<HistoryJournal>(path, options));
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (const std::bad_alloc&) {
+        return bad_alloc_to_c_error();
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+static CalculatorError flush_journal(Calculator& calculator) {
+    HistoryJournal* journal = calculator.getJournal();
+    if (!journal) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([journal] { journal->flush(); });
 }
 
 // 基础计算器函数实现
 CalculatorHandle* calculator_create() {
+    CALC_PROBE(0);
     try {
         CalculatorHandle* handle = new CalculatorHandle();
         handle->calculator = new Calculator();
@@ -35,6 +129,7 @@ CalculatorHandle* calculator_create() {
 }
 
 void calculator_destroy(CalculatorHandle* handle) {
+    CALC_PROBE(0);
     if (handle) {
         delete handle->calculator;
         delete handle;
@@ -42,6 +137,7 @@ void calculator_destroy(CalculatorHandle* handle) {
 }
 
 CalculatorError calculator_add(CalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -50,11 +146,12 @@ CalculatorError calculator_add(CalculatorHandle* handle, double a, double b, dou
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError calculator_subtract(CalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -63,11 +160,12 @@ CalculatorError calculator_subtract(CalculatorHandle* handle, double a, double b
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError calculator_multiply(CalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -76,11 +174,12 @@ CalculatorError calculator_multiply(CalculatorHandle* handle, double a, double b
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError calculator_divide(CalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -89,19 +188,22 @@ CalculatorError calculator_divide(CalculatorHandle* handle, double a, double b,
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 double calculator_get_last_result(CalculatorHandle* handle) {
+    CALC_PROBE(0);
     return handle ? handle->calculator->getLastResult() : 0.0;
 }
 
 size_t calculator_get_history_count(CalculatorHandle* handle) {
+    CALC_PROBE(0);
     return handle ? handle->calculator->getHistory().size() : 0;
 }
 
 CalculatorError calculator_get_history_entry(CalculatorHandle* handle, size_t index, char* buffer, size_t buffer_size) {
+    CALC_PROBE(0);
     if (!handle || !buffer || buffer_size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     const auto& history = handle->calculator->getHistory();
@@ -110,19 +212,48 @@ CalculatorError calculator_get_history_entry(CalculatorHandle* handle, size_t in
     const std::string& entry = history[index];
     if (entry.size() >= buffer_size) return CALC_ERROR_INVALID_ARGUMENT;
 
-    std::strncpy(buffer, entry.c_str(), buffer_size - 1);
-    buffer[buffer_size - 1] = '\0';
+    // 长度已校验，连同结尾 '\0' 一次拷贝，不填充剩余缓冲区
+    std::memcpy(buffer, entry.c_str(), entry.size() + 1);
     return CALC_SUCCESS;
 }
 
 void calculator_clear_history(CalculatorHandle* handle) {
+    CALC_PROBE(0);
     if (handle) {
         handle->calculator->clearHistory();
     }
 }
 
+CalculatorError calculator_open_journal(CalculatorHandle* handle, const char* path, JournalSyncMode sync) {
+    CALC_PROBE(0);
+    if (!handle) return CALC_ERROR_INVALID_ARGUMENT;
+    return open_journal(*handle->calculator, path, sync);
+}
+
+CalculatorError calculator_flush_journal(CalculatorHandle* handle) {
+    CALC_PROBE(0);
+    if (!handle) return CALC_ERROR_INVALID_ARGUMENT;
+    return flush_journal(*handle->calculator);
+}
+
+void calculator_close_journal(CalculatorHandle* handle) {
+    CALC_PROBE(0);
+    if (handle) {
+        handle->calculator->setJournal(nullptr);
+    }
+}
+
+CalculatorError calculator_export_history(CalculatorHandle* handle, size_t first, size_t count,
+                                          HistoryExportFormat format, char* buffer, size_t buffer_size,
+                                          size_t* required) {
+    CALC_PROBE(0);
+    if (!handle) return CALC_ERROR_INVALID_ARGUMENT;
+    return export_history(*handle->calculator, first, count, format, buffer, buffer_size, required);
+}
+
 // 高级计算器函数实现
 AdvancedCalculatorHandle* advanced_calculator_create() {
+    CALC_PROBE(0);
     try {
         AdvancedCalculatorHandle* handle = new AdvancedCalculatorHandle();
         handle->calculator = new AdvancedCalculator();
@@ -133,6 +264,7 @@ AdvancedCalculatorHandle* advanced_calculator_create() {
 }
 
 void advanced_calculator_destroy(AdvancedCalculatorHandle* handle) {
+    CALC_PROBE(0);
     if (handle) {
         delete handle->calculator;
         delete handle;
@@ -140,6 +272,7 @@ void advanced_calculator_destroy(AdvancedCalculatorHandle* handle) {
 }
 
 CalculatorError advanced_calculator_add(AdvancedCalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -148,11 +281,12 @@ CalculatorError advanced_calculator_add(AdvancedCalculatorHandle* handle, double
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_subtract(AdvancedCalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -161,11 +295,12 @@ CalculatorError advanced_calculator_subtract(AdvancedCalculatorHandle* handle, d
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_multiply(AdvancedCalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -174,11 +309,12 @@ CalculatorError advanced_calculator_multiply(AdvancedCalculatorHandle* handle, d
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_divide(AdvancedCalculatorHandle* handle, double a, double b, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -187,11 +323,12 @@ CalculatorError advanced_calculator_divide(AdvancedCalculatorHandle* handle, dou
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_power(AdvancedCalculatorHandle* handle, double base, int exponent, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -200,11 +337,12 @@ CalculatorError advanced_calculator_power(AdvancedCalculatorHandle* handle, doub
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_square_root(AdvancedCalculatorHandle* handle, double value, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -213,11 +351,12 @@ CalculatorError advanced_calculator_square_root(AdvancedCalculatorHandle* handle
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_factorial(AdvancedCalculatorHandle* handle, int n, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -226,11 +365,12 @@ CalculatorError advanced_calculator_factorial(AdvancedCalculatorHandle* handle,
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_sine(AdvancedCalculatorHandle* handle, double angle, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -239,11 +379,12 @@ CalculatorError advanced_calculator_sine(AdvancedCalculatorHandle* handle, doubl
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_cosine(AdvancedCalculatorHandle* handle, double angle, double* result) {
+    CALC_PROBE(1);
     if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -252,12 +393,13 @@ CalculatorError advanced_calculator_cosine(AdvancedCalculatorHandle* handle, dou
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 // 数组操作实现
 CalculatorError advanced_calculator_sum_array_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int64_t* result) {
+    CALC_PROBE(size);
     if (!handle || !arr || !result || size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -267,11 +409,12 @@ CalculatorError advanced_calculator_sum_array_int32(AdvancedCalculatorHandle* ha
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_max_element_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int32_t* result) {
+    CALC_PROBE(size);
     if (!handle || !arr || !result || size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -281,11 +424,12 @@ CalculatorError advanced_calculator_max_element_int32(AdvancedCalculatorHandle*
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_min_element_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, int32_t* result) {
+    CALC_PROBE(size);
     if (!handle || !arr || !result || size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -295,11 +439,12 @@ CalculatorError advanced_calculator_min_element_int32(AdvancedCalculatorHandle*
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_sum_array_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result) {
+    CALC_PROBE(size);
     if (!handle || !arr || !result || size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -309,11 +454,12 @@ CalculatorError advanced_calculator_sum_array_double(AdvancedCalculatorHandle* h
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_max_element_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result) {
+    CALC_PROBE(size);
     if (!handle || !arr || !result || size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -323,11 +469,12 @@ CalculatorError advanced_calculator_max_element_double(AdvancedCalculatorHandle*
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_min_element_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result) {
+    CALC_PROBE(size);
     if (!handle || !arr || !result || size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -337,13 +484,14 @@ CalculatorError advanced_calculator_min_element_double(AdvancedCalculatorHandle*
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
     }
 }
 
 CalculatorError advanced_calculator_batch_add(AdvancedCalculatorHandle* handle,
                                              const double* values, size_t count,
                                              double addend, double* results) {
+    CALC_PROBE(count);
     if (!handle || !values || !results || count == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     try {
@@ -354,19 +502,124 @@ CalculatorError advanced_calculator_batch_add(AdvancedCalculatorHandle* handle,
     } catch (const CalculatorException& e) {
         return cpp_exception_to_c_error(e);
     } catch (...) {
-        return CALC_ERROR_INVALID_ARGUMENT;
+        return unknown_exception_to_c_error();
+    }
+}
+
+// 文件映射操作实现
+CalculatorError advanced_calculator_sum_file_int32(AdvancedCalculatorHandle* handle, const char* path, int64_t* result) {
+    CALC_PROBE(0);
+    if (!handle || !path || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->sum_file_int32(path);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_max_file_int32(AdvancedCalculatorHandle* handle, const char* path, int32_t* result) {
+    CALC_PROBE(0);
+    if (!handle || !path || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->max_file_int32(path);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_min_file_int32(AdvancedCalculatorHandle* handle, const char* path, int32_t* result) {
+    CALC_PROBE(0);
+    if (!handle || !path || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->min_file_int32(path);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_sum_file_double(AdvancedCalculatorHandle* handle, const char* path, double* result) {
+    CALC_PROBE(0);
+    if (!handle || !path || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->sum_file_double(path);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_max_file_double(AdvancedCalculatorHandle* handle, const char* path, double* result) {
+    CALC_PROBE(0);
+    if (!handle || !path || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->max_file_double(path);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_min_file_double(AdvancedCalculatorHandle* handle, const char* path, double* result) {
+    CALC_PROBE(0);
+    if (!handle || !path || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->min_file_double(path);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_batch_add_file(AdvancedCalculatorHandle* handle,
+                                                  const char* input_path, const char* output_path,
+                                                  double addend, size_t* count) {
+    CALC_PROBE(0);
+    if (!handle || !input_path || !output_path) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        size_t n = handle->calculator->batch_add_file(input_path, output_path, addend);
+        if (count) *count = n;
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
     }
 }
 
 double advanced_calculator_get_last_result(AdvancedCalculatorHandle* handle) {
+    CALC_PROBE(0);
     return handle ? handle->calculator->getLastResult() : 0.0;
 }
 
 size_t advanced_calculator_get_history_count(AdvancedCalculatorHandle* handle) {
+    CALC_PROBE(0);
     return handle ? handle->calculator->getHistory().size() : 0;
 }
 
 CalculatorError advanced_calculator_get_history_entry(AdvancedCalculatorHandle* handle, size_t index, char* buffer, size_t buffer_size) {
+    CALC_PROBE(0);
     if (!handle || !buffer || buffer_size == 0) return CALC_ERROR_INVALID_ARGUMENT;
 
     const auto& history = handle->calculator->getHistory();
@@ -375,19 +628,404 @@ CalculatorError advanced_calculator_get_history_entry(AdvancedCalculatorHandle*
     const std::string& entry = history[index];
     if (entry.size() >= buffer_size) return CALC_ERROR_INVALID_ARGUMENT;
 
-    std::strncpy(buffer, entry.c_str(), buffer_size - 1);
-    buffer[buffer_size - 1] = '\0';
+    // 长度已校验，连同结尾 '\0' 一次拷贝，不填充剩余缓冲区
+    std::memcpy(buffer, entry.c_str(), entry.size() + 1);
     return CALC_SUCCESS;
 }
 
 void advanced_calculator_clear_history(AdvancedCalculatorHandle* handle) {
+    CALC_PROBE(0);
     if (handle) {
         handle->calculator->clearHistory();
     }
 }
 
+CalculatorError advanced_calculator_open_journal(AdvancedCalculatorHandle* handle, const char* path, JournalSyncMode sync) {
+    CALC_PROBE(0);
+    if (!handle) return CALC_ERROR_INVALID_ARGUMENT;
+    return open_journal(*handle->calculator, path, sync);
+}
+
+CalculatorError advanced_calculator_flush_journal(AdvancedCalculatorHandle* handle) {
+    CALC_PROBE(0);
+    if (!handle) return CALC_ERROR_INVALID_ARGUMENT;
+    return flush_journal(*handle->calculator);
+}
+
+void advanced_calculator_close_journal(AdvancedCalculatorHandle* handle) {
+    CALC_PROBE(0);
+    if (handle) {
+        handle->calculator->setJournal(nullptr);
+    }
+}
+
+CalculatorError advanced_calculator_export_history(AdvancedCalculatorHandle* handle, size_t first, size_t count,
+                                                   HistoryExportFormat format, char* buffer, size_t buffer_size,
+                                                   size_t* required) {
+    CALC_PROBE(0);
+    if (!handle) return CALC_ERROR_INVALID_ARGUMENT;
+    return export_history(*handle->calculator, first, count, format, buffer, buffer_size, required);
+}
+
+// Arrow 列操作实现
+CalculatorError advanced_calculator_sum_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                             const struct ArrowSchema* schema, double* result) {
+    CALC_PROBE(array ? array->length : 0);
+    if (!handle || !array || !schema || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->sum_column(ArrowColumnView(array, schema));
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_max_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                             const struct ArrowSchema* schema, double* result) {
+    CALC_PROBE(array ? array->length : 0);
+    if (!handle || !array || !schema || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->max_column(ArrowColumnView(array, schema));
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_min_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                             const struct ArrowSchema* schema, double* result) {
+    CALC_PROBE(array ? array->length : 0);
+    if (!handle || !array || !schema || !result) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *result = handle->calculator->min_column(ArrowColumnView(array, schema));
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_count_valid_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                                     const struct ArrowSchema* schema, size_t* count) {
+    CALC_PROBE(array ? array->length : 0);
+    if (!handle || !array || !schema || !count) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        *count = ArrowColumnView(array, schema).validCount();
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+CalculatorError advanced_calculator_batch_add_arrow(AdvancedCalculatorHandle* handle, const struct ArrowArray* array,
+                                                   const struct ArrowSchema* schema, double addend,
+                                                   double* results, uint8_t* validity_out) {
+    CALC_PROBE(array ? array->length : 0);
+    if (!handle || !array || !schema || (!results && array->length > 0)) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        handle->calculator->batch_add_column(ArrowColumnView(array, schema), addend, results, validity_out);
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+// 流式累加器实现
+struct AccumulatorHandle {
+    AccumulatorKind kind;
+    AccumulatorValueType type;
+
+    AccumulatorHandle(AccumulatorKind k, AccumulatorValueType t) : kind(k), type(t) {}
+    virtual ~AccumulatorHandle() = default;
+};
+
+namespace {
+    template <typename Acc>
+    struct TypedAccumulatorHandle : AccumulatorHandle {
+        Acc acc;
+        TypedAccumulatorHandle(AccumulatorKind k, AccumulatorValueType t) : AccumulatorHandle(k, t) {}
+    };
+
+    // 按 kind 取出具体的累加器并调用 f（只读访问时由调用方传入 const 版本的 lambda）
+    template <typename T, typename F>
+    void visit_typed(AccumulatorHandle* handle, F&& f) {
+        switch (handle->kind) {
+            case ACCUMULATOR_SUM: f(static_cast<TypedAccumulatorHandle<SumAccumulator<T>>*>(handle)->acc); break;
+            case ACCUMULATOR_MIN: f(static_cast<TypedAccumulatorHandle<MinAccumulator<T>>*>(handle)->acc); break;
+            case ACCUMULATOR_MAX: f(static_cast<TypedAccumulatorHandle<MaxAccumulator<T>>*>(handle)->acc); break;
+            case ACCUMULATOR_STATS: f(static_cast<TypedAccumulatorHandle<StatsAccumulator<T>>*>(handle)->acc); break;
+        }
+    }
+
+    template <typename T>
+    AccumulatorHandle* make_accumulator(AccumulatorKind kind, AccumulatorValueType type) {
+        switch (kind) {
+            case ACCUMULATOR_SUM: return new TypedAccumulatorHandle<SumAccumulator<T>>(kind, type);
+            case ACCUMULATOR_MIN: return new TypedAccumulatorHandle<MinAccumulator<T>>(kind, type);
+            case ACCUMULATOR_MAX: return new TypedAccumulatorHandle<MaxAccumulator<T>>(kind, type);
+            case ACCUMULATOR_STATS: return new TypedAccumulatorHandle<StatsAccumulator<T>>(kind, type);
+        }
+        return nullptr;
+    }
+
+    template <typename T>
+    bool single_result(const SumAccumulator<T>& acc, double* out) { *out = static_cast<double>(acc.result()); return true; }
+    template <typename T>
+    bool single_result(const MinAccumulator<T>& acc, double* out) { *out = static_cast<double>(acc.result()); return true; }
+    template <typename T>
+    bool single_result(const MaxAccumulator<T>& acc, double* out) { *out = static_cast<double>(acc.result()); return true; }
+    template <typename T>
+    bool single_result(const StatsAccumulator<T>&, double*) { return false; }
+
+    template <typename T>
+    bool single_result(const SumAccumulator<T>& acc, int64_t* out) { *out = static_cast<int64_t>(acc.result()); return true; }
+    template <typename T>
+    bool single_result(const MinAccumulator<T>& acc, int64_t* out) { *out = static_cast<int64_t>(acc.result()); return true; }
+    template <typename T>
+    bool single_result(const MaxAccumulator<T>& acc, int64_t* out) { *out = static_cast<int64_t>(acc.result()); return true; }
+    template <typename T>
+    bool single_result(const StatsAccumulator<T>&, int64_t*) { return false; }
+
+    template <typename T>
+    CalculatorError accumulator_update(AccumulatorHandle* handle, const T* data, size_t size) {
+        try {
+            visit_typed<T>(handle, [data, size](auto& acc) { acc.update(data, size); });
+            return CALC_SUCCESS;
+        } catch (const CalculatorException& e) {
+            return cpp_exception_to_c_error(e);
+        } catch (...) {
+            return unknown_exception_to_c_error();
+        }
+    }
+
+    template <typename R>
+    CalculatorError accumulator_single_result(const AccumulatorHandle* handle, R* result) {
+        bool ok = false;
+        try {
+            auto f = [result, &ok](const auto& acc) { ok = single_result(acc, result); };
+            AccumulatorHandle* h = const_cast<AccumulatorHandle*>(handle);
+            if (h->type == ACCUMULATOR_INT32) {
+                visit_typed<int32_t>(h, f);
+            } else {
+                visit_typed<double>(h, f);
+            }
+        } catch (const CalculatorException& e) {
+            return cpp_exception_to_c_error(e);
+        } catch (...) {
+            return unknown_exception_to_c_error();
+        }
+        return ok ? CALC_SUCCESS : CALC_ERROR_INVALID_ARGUMENT;
+    }
+
+    template <typename T>
+    void fill_stats(const StatsAccumulator<T>& acc, AccumulatorStats* stats) {
+        stats->count = acc.count();
+        stats->sum = static_cast<double>(acc.sum());
+        stats->min = static_cast<double>(acc.min());
+        stats->max = static_cast<double>(acc.max());
+        stats->mean = acc.mean();
+        stats->variance = acc.variance();
+    }
+}
+
+AccumulatorHandle* accumulator_create(AccumulatorKind kind, AccumulatorValueType type) {
+    CALC_PROBE(0);
+    try {
+        if (type == ACCUMULATOR_INT32) return make_accumulator<int32_t>(kind, type);
+        if (type == ACCUMULATOR_DOUBLE) return make_accumulator<double>(kind, type);
+        return nullptr;
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void accumulator_destroy(AccumulatorHandle* handle) {
+    CALC_PROBE(0);
+    delete handle;
+}
+
+CalculatorError accumulator_update_int32(AccumulatorHandle* handle, const int32_t* data, size_t size) {
+    CALC_PROBE(size);
+    if (!handle || handle->type != ACCUMULATOR_INT32 || (!data && size)) return CALC_ERROR_INVALID_ARGUMENT;
+    return accumulator_update(handle, data, size);
+}
+
+CalculatorError accumulator_update_double(AccumulatorHandle* handle, const double* data, size_t size) {
+    CALC_PROBE(size);
+    if (!handle || handle->type != ACCUMULATOR_DOUBLE || (!data && size)) return CALC_ERROR_INVALID_ARGUMENT;
+    return accumulator_update(handle, data, size);
+}
+
+CalculatorError accumulator_merge(AccumulatorHandle* handle, const AccumulatorHandle* other) {
+    CALC_PROBE(0);
+    if (!handle || !other || handle == other) return CALC_ERROR_INVALID_ARGUMENT;
+    if (handle->kind != other->kind || handle->type != other->type) return CALC_ERROR_INVALID_ARGUMENT;
+
+    auto merge_from = [other](auto& acc) {
+        using Acc = typename std::decay<decltype(acc)>::type;
+        acc.merge(static_cast<const TypedAccumulatorHandle<Acc>*>(other)->acc);
+    };
+    if (handle->type == ACCUMULATOR_INT32) {
+        visit_typed<int32_t>(handle, merge_from);
+    } else {
+        visit_typed<double>(handle, merge_from);
+    }
+    return CALC_SUCCESS;
+}
+
+void accumulator_reset(AccumulatorHandle* handle) {
+    CALC_PROBE(0);
+    if (!handle) return;
+    auto f = [](auto& acc) { acc.reset(); };
+    if (handle->type == ACCUMULATOR_INT32) {
+        visit_typed<int32_t>(handle, f);
+    } else {
+        visit_typed<double>(handle, f);
+    }
+}
+
+size_t accumulator_count(const AccumulatorHandle* handle) {
+    CALC_PROBE(0);
+    if (!handle) return 0;
+    size_t count = 0;
+    auto f = [&count](const auto& acc) { count = acc.count(); };
+    AccumulatorHandle* h = const_cast<AccumulatorHandle*>(handle);
+    if (h->type == ACCUMULATOR_INT32) {
+        visit_typed<int32_t>(h, f);
+    } else {
+        visit_typed<double>(h, f);
+    }
+    return count;
+}
+
+CalculatorError accumulator_result_int64(const AccumulatorHandle* handle, int64_t* result) {
+    CALC_PROBE(0);
+    if (!handle || !result || handle->type != ACCUMULATOR_INT32) return CALC_ERROR_INVALID_ARGUMENT;
+    return accumulator_single_result(handle, result);
+}
+
+CalculatorError accumulator_result_double(const AccumulatorHandle* handle, double* result) {
+    CALC_PROBE(0);
+    if (!handle || !result) return CALC_ERROR_INVALID_ARGUMENT;
+    return accumulator_single_result(handle, result);
+}
+
+CalculatorError accumulator_get_stats(const AccumulatorHandle* handle, AccumulatorStats* stats) {
+    CALC_PROBE(0);
+    if (!handle || !stats || handle->kind != ACCUMULATOR_STATS) return CALC_ERROR_INVALID_ARGUMENT;
+
+    try {
+        if (handle->type == ACCUMULATOR_INT32) {
+            fill_stats(static_cast<const TypedAccumulatorHandle<StatsAccumulator<int32_t>>*>(handle)->acc, stats);
+        } else {
+            fill_stats(static_cast<const TypedAccumulatorHandle<StatsAccumulator<double>>*>(handle)->acc, stats);
+        }
+        return CALC_SUCCESS;
+    } catch (const CalculatorException& e) {
+        return cpp_exception_to_c_error(e);
+    } catch (...) {
+        return unknown_exception_to_c_error();
+    }
+}
+
+// 前缀扫描与滑动窗口
+namespace {
+    template <typename T, typename S>
+    CalculatorError prefix_sum_checked(const T* data, size_t size, S* out, PrefixSumMode mode, unsigned threads) {
+        if ((!data || !out) && size) return CALC_ERROR_INVALID_ARGUMENT;
+        if (mode != PREFIX_SUM_INCLUSIVE && mode != PREFIX_SUM_EXCLUSIVE) return CALC_ERROR_INVALID_ARGUMENT;
+        ScanMode scan_mode = mode == PREFIX_SUM_EXCLUSIVE ? ScanMode::Exclusive : ScanMode::Inclusive;
+        return run_checked([=] { prefix_sum(data, size, out, scan_mode, threads); });
+    }
+}
+
+CalculatorError prefix_sum_int32(const int32_t* data, size_t size, int64_t* out, PrefixSumMode mode, unsigned threads) {
+    CALC_PROBE(size);
+    return prefix_sum_checked(data, size, out, mode, threads);
+}
+
+CalculatorError prefix_sum_double(const double* data, size_t size, double* out, PrefixSumMode mode, unsigned threads) {
+    CALC_PROBE(size);
+    return prefix_sum_checked(data, size, out, mode, threads);
+}
+
+CalculatorError cumulative_min_int32(const int32_t* data, size_t size, int32_t* out, unsigned threads) {
+    CALC_PROBE(size);
+    if ((!data || !out) && size) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { cumulative_min(data, size, out, threads); });
+}
+
+CalculatorError cumulative_min_double(const double* data, size_t size, double* out, unsigned threads) {
+    CALC_PROBE(size);
+    if ((!data || !out) && size) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { cumulative_min(data, size, out, threads); });
+}
+
+CalculatorError cumulative_max_int32(const int32_t* data, size_t size, int32_t* out, unsigned threads) {
+    CALC_PROBE(size);
+    if ((!data || !out) && size) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { cumulative_max(data, size, out, threads); });
+}
+
+CalculatorError cumulative_max_double(const double* data, size_t size, double* out, unsigned threads) {
+    CALC_PROBE(size);
+    if ((!data || !out) && size) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { cumulative_max(data, size, out, threads); });
+}
+
+CalculatorError window_sum_int32(const int32_t* data, size_t size, size_t window, int64_t* out, unsigned threads) {
+    CALC_PROBE(size);
+    if (!data || !out) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { window_sum(data, size, window, out, threads); });
+}
+
+CalculatorError window_sum_double(const double* data, size_t size, size_t window, double* out, unsigned threads) {
+    CALC_PROBE(size);
+    if (!data || !out) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { window_sum(data, size, window, out, threads); });
+}
+
+CalculatorError window_min_int32(const int32_t* data, size_t size, size_t window, int32_t* out, unsigned threads) {
+    CALC_PROBE(size);
+    if (!data || !out) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { window_min(data, size, window, out, threads); });
+}
+
+CalculatorError window_min_double(const double* data, size_t size, size_t window, double* out, unsigned threads) {
+    CALC_PROBE(size);
+    if (!data || !out) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { window_min(data, size, window, out, threads); });
+}
+
+CalculatorError window_max_int32(const int32_t* data, size_t size, size_t window, int32_t* out, unsigned threads) {
+    CALC_PROBE(size);
+    if (!data || !out) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { window_max(data, size, window, out, threads); });
+}
+
+CalculatorError window_max_double(const double* data, size_t size, size_t window, double* out, unsigned threads) {
+    CALC_PROBE(size);
+    if (!data || !out) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { window_max(data, size, window, out, threads); });
+}
+
 // 工具函数
 const char* calculator_error_to_string(CalculatorError error) {
+    CALC_PROBE(0);
     switch (error) {
         case CALC_SUCCESS: return "Success";
         case CALC_ERROR_DIVISION_BY_ZERO: return "Division by zero";
@@ -396,6 +1034,519 @@ const char* calculator_error_to_string(CalculatorError error) {
         case CALC_ERROR_SQUARE_ROOT_NEGATIVE: return "Cannot calculate square root of negative number";
         case CALC_ERROR_FACTORIAL_NEGATIVE: return "Factorial of negative number is undefined";
         case CALC_ERROR_ARRAY_EMPTY: return "Array is empty";
+        case CALC_ERROR_IO: return "File I/O error";
+        case CALC_ERROR_BUFFER_TOO_SMALL: return "Buffer too small";
+        case CALC_ERROR_TIMEOUT: return "Timed out";
         default: return "Unknown error";
     }
-}
\ No newline at end of file
+}
+
+// 选择与排名：直接在调用方数组上计算，不复制为 std::vector
+namespace {
+    template <typename T>
+    CalculatorError top_k_into(AdvancedCalculatorHandle* handle, const T* arr, size_t size, size_t k,
+                               size_t* indices, size_t* count) {
+        if (!handle || (!arr && size) || (!indices && k) || !count) return CALC_ERROR_INVALID_ARGUMENT;
+        return run_checked([=] {
+            std::vector<size_t> top = top_k(arr, size, k);
+            std::copy(top.begin(), top.end(), indices);
+            *count = top.size();
+        });
+    }
+}
+
+CalculatorError advanced_calculator_argmax_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, size_t* index) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size) || !index) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *index = argmax(arr, size); });
+}
+
+CalculatorError advanced_calculator_argmin_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, size_t* index) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size) || !index) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *index = argmin(arr, size); });
+}
+
+CalculatorError advanced_calculator_argmax_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, size_t* index) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size) || !index) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *index = argmax(arr, size); });
+}
+
+CalculatorError advanced_calculator_argmin_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, size_t* index) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size) || !index) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *index = argmin(arr, size); });
+}
+
+CalculatorError advanced_calculator_top_k_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, size_t k,
+                                                size_t* indices, size_t* count) {
+    CALC_PROBE(size);
+    return top_k_into(handle, arr, size, k, indices, count);
+}
+
+CalculatorError advanced_calculator_top_k_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, size_t k,
+                                                 size_t* indices, size_t* count) {
+    CALC_PROBE(size);
+    return top_k_into(handle, arr, size, k, indices, count);
+}
+
+CalculatorError advanced_calculator_percentile_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, double q, double* result) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size) || !result) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *result = percentile(arr, size, q); });
+}
+
+CalculatorError advanced_calculator_percentile_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double q, double* result) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size) || !result) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *result = percentile(arr, size, q); });
+}
+
+CalculatorError advanced_calculator_median_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size, double* result) {
+    CALC_PROBE(size);
+    return advanced_calculator_percentile_int32(handle, arr, size, 0.5, result);
+}
+
+CalculatorError advanced_calculator_median_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size, double* result) {
+    CALC_PROBE(size);
+    return advanced_calculator_percentile_double(handle, arr, size, 0.5, result);
+}
+
+// 排序与分桶
+namespace {
+    template <typename T>
+    CalculatorError histogram_into(AdvancedCalculatorHandle* handle, const T* arr, size_t size, double lo, double hi,
+                                   size_t bins, uint64_t* counts, size_t* counted, unsigned threads) {
+        if (!handle || (!arr && size) || (!counts && bins)) return CALC_ERROR_INVALID_ARGUMENT;
+        return run_checked([=] {
+            size_t n = histogram(arr, size, lo, hi, bins, counts, threads);
+            if (counted) *counted = n;
+        });
+    }
+}
+
+CalculatorError advanced_calculator_sort_int32(AdvancedCalculatorHandle* handle, int32_t* arr, size_t size) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size)) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { radix_sort(arr, size); });
+}
+
+CalculatorError advanced_calculator_sort_float(AdvancedCalculatorHandle* handle, float* arr, size_t size) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size)) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { radix_sort(arr, size); });
+}
+
+CalculatorError advanced_calculator_sort_double(AdvancedCalculatorHandle* handle, double* arr, size_t size, unsigned threads) {
+    CALC_PROBE(size);
+    if (!handle || (!arr && size)) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { parallel_sort(arr, size, threads); });
+}
+
+CalculatorError advanced_calculator_histogram_int32(AdvancedCalculatorHandle* handle, const int32_t* arr, size_t size,
+                                                    double lo, double hi, size_t bins, uint64_t* counts,
+                                                    size_t* counted, unsigned threads) {
+    CALC_PROBE(size);
+    return histogram_into(handle, arr, size, lo, hi, bins, counts, counted, threads);
+}
+
+CalculatorError advanced_calculator_histogram_double(AdvancedCalculatorHandle* handle, const double* arr, size_t size,
+                                                     double lo, double hi, size_t bins, uint64_t* counts,
+                                                     size_t* counted, unsigned threads) {
+    CALC_PROBE(size);
+    return histogram_into(handle, arr, size, lo, hi, bins, counts, counted, threads);
+}
+
+// BLAS-1 运算：内核不抛出异常，只需检查参数
+namespace {
+    template <typename T>
+    CalculatorError dot_into(AdvancedCalculatorHandle* handle, const T* x, const T* y, size_t size, T* result) {
+        if (!handle || ((!x || !y) && size) || !result) return CALC_ERROR_INVALID_ARGUMENT;
+        *result = dot_product(x, y, size);
+        return CALC_SUCCESS;
+    }
+
+    template <typename T>
+    CalculatorError axpy_into(AdvancedCalculatorHandle* handle, T a, const T* x, T* y, size_t size) {
+        if (!handle || ((!x || !y) && size)) return CALC_ERROR_INVALID_ARGUMENT;
+        axpy(a, x, y, size);
+        return CALC_SUCCESS;
+    }
+
+    template <typename T>
+    CalculatorError scale_in_place(AdvancedCalculatorHandle* handle, T a, T* x, size_t size) {
+        if (!handle || (!x && size)) return CALC_ERROR_INVALID_ARGUMENT;
+        scale_values(a, x, size);
+        return CALC_SUCCESS;
+    }
+
+    template <typename T>
+    CalculatorError norm_into(AdvancedCalculatorHandle* handle, const T* x, size_t size, T* result) {
+        if (!handle || (!x && size) || !result) return CALC_ERROR_INVALID_ARGUMENT;
+        *result = norm2(x, size);
+        return CALC_SUCCESS;
+    }
+
+    template <typename T>
+    CalculatorError fma_into(AdvancedCalculatorHandle* handle, const T* a, const T* b, const T* c, T* out, size_t size) {
+        if (!handle || ((!a || !b || !c || !out) && size)) return CALC_ERROR_INVALID_ARGUMENT;
+        fused_multiply_add(a, b, c, out, size);
+        return CALC_SUCCESS;
+    }
+}
+
+CalculatorError advanced_calculator_dot_double(AdvancedCalculatorHandle* handle, const double* x, const double* y, size_t size, double* result) {
+    CALC_PROBE(size);
+    return dot_into(handle, x, y, size, result);
+}
+
+CalculatorError advanced_calculator_dot_float(AdvancedCalculatorHandle* handle, const float* x, const float* y, size_t size, float* result) {
+    CALC_PROBE(size);
+    return dot_into(handle, x, y, size, result);
+}
+
+CalculatorError advanced_calculator_axpy_double(AdvancedCalculatorHandle* handle, double a, const double* x, double* y, size_t size) {
+    CALC_PROBE(size);
+    return axpy_into(handle, a, x, y, size);
+}
+
+CalculatorError advanced_calculator_axpy_float(AdvancedCalculatorHandle* handle, float a, const float* x, float* y, size_t size) {
+    CALC_PROBE(size);
+    return axpy_into(handle, a, x, y, size);
+}
+
+CalculatorError advanced_calculator_scale_double(AdvancedCalculatorHandle* handle, double a, double* x, size_t size) {
+    CALC_PROBE(size);
+    return scale_in_place(handle, a, x, size);
+}
+
+CalculatorError advanced_calculator_scale_float(AdvancedCalculatorHandle* handle, float a, float* x, size_t size) {
+    CALC_PROBE(size);
+    return scale_in_place(handle, a, x, size);
+}
+
+CalculatorError advanced_calculator_norm_double(AdvancedCalculatorHandle* handle, const double* x, size_t size, double* result) {
+    CALC_PROBE(size);
+    return norm_into(handle, x, size, result);
+}
+
+CalculatorError advanced_calculator_norm_float(AdvancedCalculatorHandle* handle, const float* x, size_t size, float* result) {
+    CALC_PROBE(size);
+    return norm_into(handle, x, size, result);
+}
+
+CalculatorError advanced_calculator_fma_double(AdvancedCalculatorHandle* handle, const double* a, const double* b,
+                                               const double* c, double* out, size_t size) {
+    CALC_PROBE(size);
+    return fma_into(handle, a, b, c, out, size);
+}
+
+CalculatorError advanced_calculator_fma_float(AdvancedCalculatorHandle* handle, const float* a, const float* b,
+                                              const float* c, float* out, size_t size) {
+    CALC_PROBE(size);
+    return fma_into(handle, a, b, c, out, size);
+}
+
+namespace {
+    template <typename T>
+    CalculatorError matmul_into(AdvancedCalculatorHandle* handle, const T* a, const T* b, T* c,
+                                size_t m, size_t k, size_t n, unsigned threads) {
+        if (!handle || (m && n && (!c || (k && (!a || !b))))) return CALC_ERROR_INVALID_ARGUMENT;
+        // 打包缓冲区分配失败时返回 CALC_ERROR_OUT_OF_MEMORY
+        return run_checked([=] { gemm(m, n, k, a, k, b, n, c, n, threads); });
+    }
+}
+
+CalculatorError advanced_calculator_matmul_double(AdvancedCalculatorHandle* handle, const double* a, const double* b,
+                                                  double* c, size_t m, size_t k, size_t n, unsigned threads) {
+    CALC_PROBE(m * n);
+    return matmul_into(handle, a, b, c, m, k, n, threads);
+}
+
+CalculatorError advanced_calculator_matmul_float(AdvancedCalculatorHandle* handle, const float* a, const float* b,
+                                                 float* c, size_t m, size_t k, size_t n, unsigned threads) {
+    CALC_PROBE(m * n);
+    return matmul_into(handle, a, b, c, m, k, n, threads);
+}
+
+namespace {
+    template <typename T>
+    CalculatorError poly_eval_into(AdvancedCalculatorHandle* handle, const T* coeffs, size_t count,
+                                   const T* x, T* out, size_t size) {
+        if (!handle || (!coeffs && count) || ((!x || !out) && size)) return CALC_ERROR_INVALID_ARGUMENT;
+        poly_eval(coeffs, count, x, out, size);
+        return CALC_SUCCESS;
+    }
+}
+
+CalculatorError advanced_calculator_poly_eval_double(AdvancedCalculatorHandle* handle, const double* coeffs, size_t count,
+                                                     const double* x, double* out, size_t size) {
+    CALC_PROBE(size);
+    return poly_eval_into(handle, coeffs, count, x, out, size);
+}
+
+CalculatorError advanced_calculator_poly_eval_float(AdvancedCalculatorHandle* handle, const float* coeffs, size_t count,
+                                                    const float* x, float* out, size_t size) {
+    CALC_PROBE(size);
+    return poly_eval_into(handle, coeffs, count, x, out, size);
+}
+
+// 分组聚合
+struct GroupByResultHandle {
+    AccumulatorValueType type;   // 值类型，决定 sums / mins / maxs 的元素类型
+
+    explicit GroupByResultHandle(AccumulatorValueType t) : type(t) {}
+    virtual ~GroupByResultHandle() = default;
+    virtual size_t size() const = 0;
+    virtual const int32_t* keys() const = 0;
+    virtual const uint64_t* counts() const = 0;
+};
+
+namespace {
+    template <typename T>
+    struct TypedGroupByResultHandle : GroupByResultHandle {
+        GroupByResult<T> result;
+
+        TypedGroupByResultHandle()
+            : GroupByResultHandle(std::is_same<T, double>::value ? ACCUMULATOR_DOUBLE : ACCUMULATOR_INT32) {}
+
+        size_t size() const override { return result.size(); }
+        const int32_t* keys() const override { return result.keys.data(); }
+        const uint64_t* counts() const override { return result.counts.data(); }
+    };
+
+    template <typename T>
+    CalculatorError group_by_into(AdvancedCalculatorHandle* handle, const int32_t* keys, const T* values, size_t size,
+                                  unsigned threads, GroupByResultHandle** result) {
+        if (!handle || ((!keys || !values) && size) || !result) return CALC_ERROR_INVALID_ARGUMENT;
+        *result = nullptr;
+        return run_checked([=] {
+            std::unique_ptr<TypedGroupByResultHandle<T>> out(new TypedGroupByResultHandle<T>());
+            out->result = group_by(keys, values, size, threads);
+            *result = out.release();
+        });
+    }
+
+    template <typename T>
+    const GroupByResult<T>* typed_group_by_result(const GroupByResultHandle* result) {
+        AccumulatorValueType type = std::is_same<T, double>::value ? ACCUMULATOR_DOUBLE : ACCUMULATOR_INT32;
+        if (!result || result->type != type) return nullptr;
+        return &static_cast<const TypedGroupByResultHandle<T>*>(result)->result;
+    }
+}
+
+CalculatorError advanced_calculator_group_by_int32(AdvancedCalculatorHandle* handle, const int32_t* keys,
+                                                   const int32_t* values, size_t size, unsigned threads,
+                                                   GroupByResultHandle** result) {
+    CALC_PROBE(size);
+    return group_by_into(handle, keys, values, size, threads, result);
+}
+
+CalculatorError advanced_calculator_group_by_double(AdvancedCalculatorHandle* handle, const int32_t* keys,
+                                                    const double* values, size_t size, unsigned threads,
+                                                    GroupByResultHandle** result) {
+    CALC_PROBE(size);
+    return group_by_into(handle, keys, values, size, threads, result);
+}
+
+void group_by_result_destroy(GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    delete result;
+}
+
+size_t group_by_result_size(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    return result ? result->size() : 0;
+}
+
+const int32_t* group_by_result_keys(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    return result ? result->keys() : nullptr;
+}
+
+const uint64_t* group_by_result_counts(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    return result ? result->counts() : nullptr;
+}
+
+const int64_t* group_by_result_sums_int64(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    auto typed = typed_group_by_result<int32_t>(result);
+    return typed ? typed->sums.data() : nullptr;
+}
+
+const int32_t* group_by_result_mins_int32(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    auto typed = typed_group_by_result<int32_t>(result);
+    return typed ? typed->mins.data() : nullptr;
+}
+
+const int32_t* group_by_result_maxs_int32(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    auto typed = typed_group_by_result<int32_t>(result);
+    return typed ? typed->maxs.data() : nullptr;
+}
+
+const double* group_by_result_sums_double(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    auto typed = typed_group_by_result<double>(result);
+    return typed ? typed->sums.data() : nullptr;
+}
+
+const double* group_by_result_mins_double(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    auto typed = typed_group_by_result<double>(result);
+    return typed ? typed->mins.data() : nullptr;
+}
+
+const double* group_by_result_maxs_double(const GroupByResultHandle* result) {
+    CALC_PROBE(0);
+    auto typed = typed_group_by_result<double>(result);
+    return typed ? typed->maxs.data() : nullptr;
+}
+
+// 运行统计
+static_assert(CALC_LATENCY_BUCKETS == kLatencyBuckets, "CALC_LATENCY_BUCKETS must match kLatencyBuckets");
+
+int instrumentation_is_enabled(void) {
+    CALC_PROBE(0);
+    return instrumentation_enabled() ? 1 : 0;
+}
+
+size_t instrumentation_operation_count(void) {
+    CALC_PROBE(0);
+    return static_cast<size_t>(InstrumentedOperation::Count);
+}
+
+CalculatorError instrumentation_get_stats(size_t index, InstrumentationStats* stats) {
+    CALC_PROBE(0);
+    if (!stats || index >= instrumentation_operation_count()) return CALC_ERROR_INVALID_ARGUMENT;
+    auto op = static_cast<InstrumentedOperation>(index);
+    OperationStats totals = operation_stats(op);
+    stats->name = operation_name(op);
+    stats->calls = totals.calls;
+    stats->errors = totals.errors;
+    stats->bytes = totals.bytes;
+    stats->total_ns = totals.total_ns;
+    std::copy(totals.latency, totals.latency + kLatencyBuckets, stats->latency_counts);
+    return CALC_SUCCESS;
+}
+
+uint64_t instrumentation_latency_bucket_floor(size_t bucket) {
+    CALC_PROBE(0);
+    return latency_bucket_floor(bucket);
+}
+
+double instrumentation_latency_percentile(const InstrumentationStats* stats, double q) {
+    CALC_PROBE(0);
+    if (!stats) return 0.0;
+    OperationStats totals{};
+    std::copy(stats->latency_counts, stats->latency_counts + kLatencyBuckets, totals.latency);
+    return latency_percentile(totals, q);
+}
+
+uint64_t instrumentation_error_code_count(CalculatorError error) {
+    CALC_PROBE(0);
+    return error_code_count(error);
+}
+
+void instrumentation_reset(void) {
+    CALC_PROBE(0);
+    reset_instrumentation();
+}
+
+// 共享内存计算服务
+struct CalcServerHandle {
+    CalcServerHandle(const char* name, const CalcServerOptions& options) : server(name, options) {}
+    CalcServer server;
+};
+
+struct CalcClientHandle {
+    explicit CalcClientHandle(const char* name) : client(name) {}
+    CalcClient client;
+};
+
+CalculatorError calc_server_start(const char* name, const CalcServerConfig* config, CalcServerHandle** server) {
+    CALC_PROBE(0);
+    if (!name || !server) return CALC_ERROR_INVALID_ARGUMENT;
+    *server = nullptr;
+    CalcServerOptions options;
+    if (config) {
+        if (config->slots) options.slots = config->slots;
+        if (config->ring_capacity) options.ring_capacity = config->ring_capacity;
+        if (config->workers) options.workers = config->workers;
+        options.threads = config->threads;
+    }
+    return run_checked([=] { *server = new CalcServerHandle(name, options); });
+}
+
+void calc_server_stop(CalcServerHandle* server) {
+    CALC_PROBE(0);
+    delete server;
+}
+
+uint64_t calc_server_completed_count(const CalcServerHandle* server) {
+    CALC_PROBE(0);
+    return server ? server->server.completedCount() : 0;
+}
+
+CalculatorError calc_client_connect(const char* name, CalcClientHandle** client) {
+    CALC_PROBE(0);
+    if (!name || !client) return CALC_ERROR_INVALID_ARGUMENT;
+    *client = nullptr;
+    return run_checked([=] { *client = new CalcClientHandle(name); });
+}
+
+void calc_client_disconnect(CalcClientHandle* client) {
+    CALC_PROBE(0);
+    delete client;
+}
+
+CalculatorError calc_client_register_segment(CalcClientHandle* client, const char* name, const void* base,
+                                             size_t size, uint32_t* segment) {
+    CALC_PROBE(size);
+    if (!client || !name || !base || !segment) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *segment = client->client.registerSegment(name, base, size); });
+}
+
+CalculatorError calc_client_unregister_segment(CalcClientHandle* client, uint32_t segment) {
+    CALC_PROBE(0);
+    if (!client) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { client->client.unregisterSegment(segment); });
+}
+
+CalculatorError calc_client_operand(const CalcClientHandle* client, const void* ptr, size_t count,
+                                    size_t element_size, CalcShmOperand* operand) {
+    CALC_PROBE(count);
+    if (!client || !operand) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] { *operand = client->client.operand(ptr, count, element_size); });
+}
+
+CalculatorError calc_client_submit(CalcClientHandle* client, const CalcShmRequest* request, uint64_t* id) {
+    CALC_PROBE(0);
+    if (!client || !request) return CALC_ERROR_INVALID_ARGUMENT;
+    return run_checked([=] {
+        uint64_t submitted = client->client.submit(*request);
+        if (id) *id = submitted;
+    });
+}
+
+CalculatorError calc_client_wait(CalcClientHandle* client, int timeout_ms, CalcShmCompletion* completion) {
+    CALC_PROBE(0);
+    if (!client || !completion) return CALC_ERROR_INVALID_ARGUMENT;
+    bool done = false;
+    CalculatorError error = run_checked([&] { done = client->client.wait(*completion, timeout_ms); });
+    return error == CALC_SUCCESS && !done ? CALC_ERROR_TIMEOUT : error;
+}
+
+CalculatorError calc_client_call(CalcClientHandle* client, const CalcShmRequest* request,
+                                 CalcShmCompletion* completion) {
+    CALC_PROBE(0);
+    if (!client || !request) return CALC_ERROR_INVALID_ARGUMENT;
+    // call() 把非 OK 的状态转换为带对应信息的异常，再由 run_checked 映射为错误码
+    return run_checked([=] {
+        CalcShmCompletion done = client->client.call(*request);
+        if (completion) *completion = done;
+    });
+}
@@ -1,6 +1,10 @@
 #include "cpp_calculator/c_wrapper.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 void test_basic_calculator() {
     printf("=== Testing Basic Calculator C Wrapper ===\n");
@@ -59,6 +63,33 @@ void test_basic_calculator() {
         }
     }
 
+    // 测试历史批量导出：先查询大小，再一次性导出
+    size_t required = 0;
+    err = calculator_export_history(calc, 0, HISTORY_EXPORT_ALL, HISTORY_FORMAT_TEXT, NULL, 0, &required);
+    char* text = malloc(required + 1);
+    if (err == CALC_SUCCESS && text &&
+        calculator_export_history(calc, 0, HISTORY_EXPORT_ALL, HISTORY_FORMAT_TEXT,
+                                  text, required, &required) == CALC_SUCCESS) {
+        text[required] = '\0';
+        printf("Exported history (%zu bytes):\n%s", required, text);
+    }
+    free(text);
+
+    char small[4];
+    err = calculator_export_history(calc, 1, 2, HISTORY_FORMAT_BINARY, small, sizeof(small), &required);
+    printf("Binary export into small buffer: %s (needs %zu bytes)\n", calculator_error_to_string(err), required);
+
+    char binary[256];
+    err = calculator_export_history(calc, history_count - 1, 1, HISTORY_FORMAT_BINARY, binary, sizeof(binary), &required);
+    if (err == CALC_SUCCESS) {
+        uint32_t length;
+        memcpy(&length, binary, sizeof(length));
+        printf("Last entry (binary): %.*s\n", (int)length, binary + sizeof(length));
+    }
+
+    err = calculator_export_history(calc, history_count + 1, 1, HISTORY_FORMAT_TEXT, NULL, 0, &required);
+    printf("Export out of range: %s\n", calculator_error_to_string(err));
+
     // 清理
     calculator_destroy(calc);
     printf("\n");
@@ -156,12 +187,588 @@ void test_advanced_calculator() {
     printf("\n");
 }
 
+void test_file_operations() {
+    printf("=== Testing Mapped File Operations C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* adv_calc = advanced_calculator_create();
+    if (!adv_calc) {
+        printf("Failed to create advanced calculator\n");
+        return;
+    }
+
+    const char* in_path = "test_c_wrapper_in.bin";
+    const char* out_path = "test_c_wrapper_out.bin";
+    double values[] = {1.0, 2.0, 3.0, 4.0};
+    FILE* f = fopen(in_path, "wb");
+    fwrite(values, sizeof(double), 4, f);
+    fclose(f);
+
+    double result;
+    size_t count = 0;
+    CalculatorError err = advanced_calculator_sum_file_double(adv_calc, in_path, &result);
+    if (err == CALC_SUCCESS) {
+        printf("File sum: %.1f\n", result);
+    }
+
+    err = advanced_calculator_batch_add_file(adv_calc, in_path, out_path, 0.5, &count);
+    if (err == CALC_SUCCESS) {
+        advanced_calculator_max_file_double(adv_calc, out_path, &result);
+        printf("Batch add file: %zu values, max %.1f\n", count, result);
+    }
+
+    err = advanced_calculator_sum_file_double(adv_calc, "does_not_exist.bin", &result);
+    if (err != CALC_SUCCESS) {
+        printf("Missing file error: %s\n", calculator_error_to_string(err));
+    }
+
+    remove(in_path);
+    remove(out_path);
+    advanced_calculator_destroy(adv_calc);
+    printf("\n");
+}
+
+static void release_noop_array(struct ArrowArray* array) { array->release = NULL; }
+static void release_noop_schema(struct ArrowSchema* schema) { schema->release = NULL; }
+
+void test_arrow_columns() {
+    printf("=== Testing Arrow Column C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* adv_calc = advanced_calculator_create();
+    if (!adv_calc) {
+        printf("Failed to create advanced calculator\n");
+        return;
+    }
+
+    // 70 个 int32 元素，从第 3 个开始切片，偶数位置为空
+    int32_t values[73];
+    uint8_t validity[10] = {0};
+    for (int i = 0; i < 73; ++i) {
+        values[i] = i;
+        if (i % 2 == 1) validity[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+    const void* buffers[2] = {validity, values};
+
+    struct ArrowSchema schema = {"i", "col", NULL, ARROW_FLAG_NULLABLE, 0, NULL, NULL, release_noop_schema, NULL};
+    struct ArrowArray array = {70, -1, 3, 2, 0, buffers, NULL, NULL, release_noop_array, NULL};
+
+    double result;
+    size_t valid = 0;
+    if (advanced_calculator_sum_arrow(adv_calc, &array, &schema, &result) == CALC_SUCCESS &&
+        advanced_calculator_count_valid_arrow(adv_calc, &array, &schema, &valid) == CALC_SUCCESS) {
+        printf("Arrow sum (odd values 3..71): %.0f over %zu valid\n", result, valid);
+    }
+    if (advanced_calculator_max_arrow(adv_calc, &array, &schema, &result) == CALC_SUCCESS) {
+        printf("Arrow max: %.0f\n", result);
+    }
+    if (advanced_calculator_min_arrow(adv_calc, &array, &schema, &result) == CALC_SUCCESS) {
+        printf("Arrow min: %.0f\n", result);
+    }
+
+    double results[70];
+    uint8_t validity_out[9];
+    if (advanced_calculator_batch_add_arrow(adv_calc, &array, &schema, 0.5, results, validity_out) == CALC_SUCCESS) {
+        printf("Arrow batch add: [%.1f, %.1f, %.1f], validity[0]=0x%02X\n",
+               results[0], results[1], results[2], validity_out[0]);
+    }
+
+    // 全为 -inf 的 double 列：最大值是 -inf 本身，而不是 -DBL_MAX 哨兵
+    double infs[3] = {-1.0 / 0.0, -1.0 / 0.0, -1.0 / 0.0};
+    const void* inf_buffers[2] = {NULL, infs};
+    struct ArrowSchema inf_schema = {"g", "inf", NULL, 0, 0, NULL, NULL, release_noop_schema, NULL};
+    struct ArrowArray inf_array = {3, 0, 0, 2, 0, inf_buffers, NULL, NULL, release_noop_array, NULL};
+    if (advanced_calculator_max_arrow(adv_calc, &inf_array, &inf_schema, &result) == CALC_SUCCESS) {
+        printf("Arrow max of all -inf: %g\n", result);
+    }
+
+    // 130 个 double，每 3 个一个空值，空值位置放最大/最小值，NaN 被忽略；再按 float 稠密列检查
+    double mixed[130];
+    float dense[130];
+    uint8_t mixed_validity[17] = {0};
+    for (int i = 0; i < 130; ++i) {
+        mixed[i] = (i % 3 == 0) ? (i % 2 ? 1e9 : -1e9) : (double)(i - 60);
+        dense[i] = (float)(i - 60);
+        if (i % 3 != 0) mixed_validity[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+    mixed[100] = 0.0 / 0.0;
+    dense[100] = 0.0f / 0.0f;
+    const void* mixed_buffers[2] = {mixed_validity, mixed};
+    struct ArrowSchema mixed_schema = {"g", "mixed", NULL, ARROW_FLAG_NULLABLE, 0, NULL, NULL, release_noop_schema, NULL};
+    struct ArrowArray mixed_array = {130, -1, 0, 2, 0, mixed_buffers, NULL, NULL, release_noop_array, NULL};
+    double lo = 0.0, hi = 0.0;
+    if (advanced_calculator_min_arrow(adv_calc, &mixed_array, &mixed_schema, &lo) == CALC_SUCCESS &&
+        advanced_calculator_max_arrow(adv_calc, &mixed_array, &mixed_schema, &hi) == CALC_SUCCESS) {
+        printf("Arrow double min/max with nulls and NaN (expect -59/68): %g/%g\n", lo, hi);
+    }
+    const void* dense_buffers[2] = {NULL, dense};
+    struct ArrowSchema dense_schema = {"f", "dense", NULL, 0, 0, NULL, NULL, release_noop_schema, NULL};
+    struct ArrowArray dense_array = {130, 0, 0, 2, 0, dense_buffers, NULL, NULL, release_noop_array, NULL};
+    if (advanced_calculator_min_arrow(adv_calc, &dense_array, &dense_schema, &lo) == CALC_SUCCESS &&
+        advanced_calculator_max_arrow(adv_calc, &dense_array, &dense_schema, &hi) == CALC_SUCCESS) {
+        printf("Arrow float min/max with NaN (expect -60/69): %g/%g\n", lo, hi);
+    }
+
+    struct ArrowSchema bad_schema = schema;
+    bad_schema.format = "u";
+    CalculatorError err = advanced_calculator_sum_arrow(adv_calc, &array, &bad_schema, &result);
+    if (err != CALC_SUCCESS) {
+        printf("Unsupported format error: %s\n", calculator_error_to_string(err));
+    }
+
+    advanced_calculator_destroy(adv_calc);
+    printf("\n");
+}
+
+void test_accumulators() {
+    printf("=== Testing Streaming Accumulators C Wrapper ===\n");
+
+    AccumulatorHandle* sum = accumulator_create(ACCUMULATOR_SUM, ACCUMULATOR_INT32);
+    AccumulatorHandle* stats_a = accumulator_create(ACCUMULATOR_STATS, ACCUMULATOR_DOUBLE);
+    AccumulatorHandle* stats_b = accumulator_create(ACCUMULATOR_STATS, ACCUMULATOR_DOUBLE);
+    if (!sum || !stats_a || !stats_b) {
+        printf("Failed to create accumulators\n");
+        return;
+    }
+
+    int32_t chunk1[] = {10, 20, 5};
+    int32_t chunk2[] = {30, 15};
+    accumulator_update_int32(sum, chunk1, 3);
+    accumulator_update_int32(sum, chunk2, 2);
+
+    int64_t total;
+    if (accumulator_result_int64(sum, &total) == CALC_SUCCESS) {
+        printf("Chunked sum: %lld (%zu values)\n", (long long)total, accumulator_count(sum));
+    }
+
+    double part1[] = {1.0, 2.0, 3.0};
+    double part2[] = {4.0, 5.0};
+    accumulator_update_double(stats_a, part1, 3);
+    accumulator_update_double(stats_b, part2, 2);
+    accumulator_merge(stats_a, stats_b);
+
+    AccumulatorStats stats;
+    if (accumulator_get_stats(stats_a, &stats) == CALC_SUCCESS) {
+        printf("Merged stats: count=%zu sum=%.1f min=%.1f max=%.1f mean=%.2f variance=%.2f\n",
+               stats.count, stats.sum, stats.min, stats.max, stats.mean, stats.variance);
+    }
+
+    // 类型不匹配
+    CalculatorError err = accumulator_update_double(sum, part1, 3);
+    if (err != CALC_SUCCESS) {
+        printf("Type mismatch error: %s\n", calculator_error_to_string(err));
+    }
+
+    accumulator_reset(stats_b);
+    err = accumulator_get_stats(stats_b, &stats);
+    if (err != CALC_SUCCESS) {
+        printf("Empty accumulator error: %s\n", calculator_error_to_string(err));
+    }
+
+    accumulator_destroy(sum);
+    accumulator_destroy(stats_a);
+    accumulator_destroy(stats_b);
+    printf("\n");
+}
+
+void test_history_journal() {
+    printf("=== Testing History Journal C Wrapper ===\n");
+
+    CalculatorHandle* calc = calculator_create();
+    if (!calc) {
+        printf("Failed to create calculator\n");
+        return;
+    }
+
+    const char* path = "test_c_wrapper_history.journal";
+    remove(path);
+
+    double result;
+    CalculatorError err = calculator_open_journal(calc, path, JOURNAL_SYNC_BATCH);
+    printf("Open journal: %s\n", calculator_error_to_string(err));
+    calculator_add(calc, 1.0, 2.0, &result);
+    calculator_multiply(calc, 3.0, 4.0, &result);
+    err = calculator_flush_journal(calc);
+    printf("Flush journal: %s\n", calculator_error_to_string(err));
+    calculator_close_journal(calc);
+
+    FILE* f = fopen(path, "rb");
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        printf("Journal size: %ld bytes\n", ftell(f));
+        fclose(f);
+    }
+
+    err = calculator_flush_journal(calc);
+    printf("Flush without journal: %s\n", calculator_error_to_string(err));
+    err = calculator_open_journal(calc, "no_such_dir/history.journal", JOURNAL_SYNC_NONE);
+    printf("Open in missing directory: %s\n", calculator_error_to_string(err));
+
+    remove(path);
+    calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_scans() {
+    printf("=== Testing Prefix Scans and Sliding Windows C Wrapper ===\n");
+
+    int32_t data[] = {3, 1, 4, 1, 5, 9, 2, 6};
+    int64_t sums[8];
+    int32_t maxima[6];
+    int64_t window_sums[6];
+
+    if (prefix_sum_int32(data, 8, sums, PREFIX_SUM_EXCLUSIVE, 0) == CALC_SUCCESS) {
+        printf("Exclusive prefix sum:");
+        for (int i = 0; i < 8; ++i) printf(" %lld", (long long)sums[i]);
+        printf("\n");
+    }
+    if (window_sum_int32(data, 8, 3, window_sums, 0) == CALC_SUCCESS &&
+        window_max_int32(data, 8, 3, maxima, 0) == CALC_SUCCESS) {
+        printf("Window(3) sum/max:");
+        for (int i = 0; i < 6; ++i) printf(" %lld/%d", (long long)window_sums[i], maxima[i]);
+        printf("\n");
+    }
+
+    double values[] = {2.5, -1.0, 3.0, -4.5};
+    double running_min[4];
+    if (cumulative_min_double(values, 4, running_min, 1) == CALC_SUCCESS) {
+        printf("Cumulative min: %.1f %.1f %.1f %.1f\n", running_min[0], running_min[1], running_min[2], running_min[3]);
+    }
+
+    CalculatorError err = window_min_double(values, 4, 5, running_min, 0);
+    printf("Window larger than array: %s\n", calculator_error_to_string(err));
+    err = prefix_sum_double(NULL, 4, running_min, PREFIX_SUM_INCLUSIVE, 0);
+    printf("NULL input: %s\n", calculator_error_to_string(err));
+    printf("\n");
+}
+
+void test_selection() {
+    printf("=== Testing Selection and Ranking C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* calc = advanced_calculator_create();
+    int32_t data[] = {3, 1, 4, 1, 5, 9, 2, 6};
+    size_t index = 0, top[3], count = 0;
+    double median = 0.0;
+
+    if (advanced_calculator_argmin_int32(calc, data, 8, &index) == CALC_SUCCESS) {
+        printf("Argmin: %zu\n", index);
+    }
+    if (advanced_calculator_top_k_int32(calc, data, 8, 3, top, &count) == CALC_SUCCESS) {
+        printf("Top %zu indices:", count);
+        for (size_t i = 0; i < count; ++i) printf(" %zu", top[i]);
+        printf("\n");
+    }
+    if (advanced_calculator_median_int32(calc, data, 8, &median) == CALC_SUCCESS) {
+        printf("Median: %.1f\n", median);
+    }
+
+    double values[] = {2.5, -1.0, 3.0, -4.5};
+    double p75 = 0.0;
+    if (advanced_calculator_argmax_double(calc, values, 4, &index) == CALC_SUCCESS &&
+        advanced_calculator_percentile_double(calc, values, 4, 0.75, &p75) == CALC_SUCCESS) {
+        printf("Argmax: %zu, 75th percentile: %.3f\n", index, p75);
+    }
+
+    CalculatorError err = advanced_calculator_argmax_double(calc, values, 0, &index);
+    printf("Empty array: %s\n", calculator_error_to_string(err));
+    err = advanced_calculator_percentile_double(calc, values, 4, -0.1, &p75);
+    printf("Percentile out of range: %s\n", calculator_error_to_string(err));
+
+    advanced_calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_sort_and_histogram() {
+    printf("=== Testing Sorting and Histograms C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* calc = advanced_calculator_create();
+    int32_t data[] = {3, -1, 4, 1, -5, 9, 2, 6};
+    uint64_t counts[4];
+    size_t counted = 0;
+
+    if (advanced_calculator_sort_int32(calc, data, 8) == CALC_SUCCESS) {
+        printf("Sorted:");
+        for (int i = 0; i < 8; ++i) printf(" %d", data[i]);
+        printf("\n");
+    }
+    if (advanced_calculator_histogram_int32(calc, data, 8, 0.0, 8.0, 4, counts, &counted, 0) == CALC_SUCCESS) {
+        printf("Histogram [0, 8] in 4 bins: %llu %llu %llu %llu (%zu counted)\n",
+               (unsigned long long)counts[0], (unsigned long long)counts[1],
+               (unsigned long long)counts[2], (unsigned long long)counts[3], counted);
+    }
+
+    double values[] = {2.5, -1.0, 3.0, -4.5};
+    if (advanced_calculator_sort_double(calc, values, 4, 1) == CALC_SUCCESS) {
+        printf("Sorted doubles: %.1f %.1f %.1f %.1f\n", values[0], values[1], values[2], values[3]);
+    }
+
+    CalculatorError err = advanced_calculator_histogram_double(calc, values, 4, 1.0, 0.0, 4, counts, NULL, 0);
+    printf("Reversed histogram range: %s\n", calculator_error_to_string(err));
+    err = advanced_calculator_sort_float(calc, NULL, 3);
+    printf("NULL input: %s\n", calculator_error_to_string(err));
+
+    advanced_calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_group_by() {
+    printf("=== Testing Group-By C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* calc = advanced_calculator_create();
+    int32_t keys[] = {3, 1, 3, 2, 1, 3};
+    double values[] = {1.5, 2.0, -1.0, 4.0, 0.5, 2.5};
+    GroupByResultHandle* groups = NULL;
+
+    if (advanced_calculator_group_by_double(calc, keys, values, 6, 0, &groups) == CALC_SUCCESS) {
+        const int32_t* group_keys = group_by_result_keys(groups);
+        const double* sums = group_by_result_sums_double(groups);
+        const double* maxs = group_by_result_maxs_double(groups);
+        const uint64_t* counts = group_by_result_counts(groups);
+        for (size_t g = 0; g < group_by_result_size(groups); ++g) {
+            printf("Key %d: sum=%.1f max=%.1f count=%llu\n", group_keys[g], sums[g], maxs[g], (unsigned long long)counts[g]);
+        }
+        printf("int64 sums on double result: %s\n", group_by_result_sums_int64(groups) ? "non-NULL" : "NULL");
+        group_by_result_destroy(groups);
+    }
+
+    int32_t ints[] = {10, -20, 30, 40, 50, 60};
+    if (advanced_calculator_group_by_int32(calc, keys, ints, 6, 1, &groups) == CALC_SUCCESS) {
+        printf("Groups: %zu, sum of key %d: %lld\n", group_by_result_size(groups),
+               group_by_result_keys(groups)[0], (long long)group_by_result_sums_int64(groups)[0]);
+        group_by_result_destroy(groups);
+    }
+
+    CalculatorError err = advanced_calculator_group_by_double(calc, NULL, values, 6, 0, &groups);
+    printf("NULL keys: %s\n", calculator_error_to_string(err));
+
+    advanced_calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_blas() {
+    printf("=== Testing BLAS-1 C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* calc = advanced_calculator_create();
+    double x[] = {1.0, 2.0, 3.0, 4.0};
+    double y[] = {0.5, -1.0, 2.0, 1.0};
+    double out[4];
+    double result = 0.0;
+
+    if (advanced_calculator_dot_double(calc, x, y, 4, &result) == CALC_SUCCESS) {
+        printf("dot = %.2f\n", result);
+    }
+    if (advanced_calculator_axpy_double(calc, 0.5, x, y, 4) == CALC_SUCCESS) {
+        printf("axpy(0.5, x, y): %.2f %.2f %.2f %.2f\n", y[0], y[1], y[2], y[3]);
+    }
+    if (advanced_calculator_fma_double(calc, x, x, y, out, 4) == CALC_SUCCESS) {
+        printf("fma(x, x, y): %.2f %.2f %.2f %.2f\n", out[0], out[1], out[2], out[3]);
+    }
+
+    float v[] = {3.0f, 4.0f, 12.0f};
+    float norm = 0.0f;
+    advanced_calculator_scale_float(calc, 2.0f, v, 3);
+    if (advanced_calculator_norm_float(calc, v, 3, &norm) == CALC_SUCCESS) {
+        printf("norm(2 * [3, 4, 12]) = %.1f\n", norm);
+    }
+
+    CalculatorError err = advanced_calculator_dot_double(calc, NULL, y, 4, &result);
+    printf("NULL input: %s\n", calculator_error_to_string(err));
+
+    advanced_calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_matmul() {
+    printf("=== Testing Matrix Multiply C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* calc = advanced_calculator_create();
+    double a[] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    double b[] = {1.0, 0.0, 0.0, 1.0, 1.0, 1.0};
+    double c[4];
+    if (advanced_calculator_matmul_double(calc, a, b, c, 2, 3, 2, 0) == CALC_SUCCESS) {
+        printf("[[1,2,3],[4,5,6]] x [[1,0],[0,1],[1,1]] = [[%.0f,%.0f],[%.0f,%.0f]]\n", c[0], c[1], c[2], c[3]);
+    }
+
+    float af[] = {2.0f, 0.0f, 0.0f, 2.0f};
+    float bf[] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float cf[4];
+    if (advanced_calculator_matmul_float(calc, af, bf, cf, 2, 2, 2, 1) == CALC_SUCCESS) {
+        printf("2I x [[1,2],[3,4]] = [[%.0f,%.0f],[%.0f,%.0f]]\n", cf[0], cf[1], cf[2], cf[3]);
+    }
+
+    CalculatorError err = advanced_calculator_matmul_double(calc, a, NULL, c, 2, 3, 2, 0);
+    printf("NULL input: %s\n", calculator_error_to_string(err));
+
+    advanced_calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_poly_eval() {
+    printf("=== Testing Polynomial Evaluation C Wrapper ===\n");
+
+    AdvancedCalculatorHandle* calc = advanced_calculator_create();
+    // 1 - 2x + 3x^2
+    double coeffs[] = {1.0, -2.0, 3.0};
+    double x[] = {0.0, 1.0, 2.0, -1.0};
+    double out[4];
+    if (advanced_calculator_poly_eval_double(calc, coeffs, 3, x, out, 4) == CALC_SUCCESS) {
+        printf("1 - 2x + 3x^2 at 0, 1, 2, -1: %.1f %.1f %.1f %.1f\n", out[0], out[1], out[2], out[3]);
+    }
+
+    // x^3，原地计算
+    float cf[] = {0.0f, 0.0f, 0.0f, 1.0f};
+    float xf[] = {0.5f, 2.0f, -3.0f};
+    if (advanced_calculator_poly_eval_float(calc, cf, 4, xf, xf, 3) == CALC_SUCCESS) {
+        printf("x^3 in place: %.3f %.1f %.1f\n", xf[0], xf[1], xf[2]);
+    }
+
+    CalculatorError err = advanced_calculator_poly_eval_double(calc, NULL, 3, x, out, 4);
+    printf("NULL coefficients: %s\n", calculator_error_to_string(err));
+
+    advanced_calculator_destroy(calc);
+    printf("\n");
+}
+
+void test_instrumentation() {
+    printf("=== Testing Instrumentation C Wrapper ===\n");
+    printf("Instrumentation enabled: %s\n", instrumentation_is_enabled() ? "yes" : "no");
+    instrumentation_reset();
+
+    CalculatorHandle* calc = calculator_create();
+    double result;
+    for (int i = 0; i < 3; ++i) {
+        calculator_divide(calc, 10.0, 0.0, &result);
+    }
+    calculator_add(calc, 1.0, 2.0, &result);
+    calculator_destroy(calc);
+
+    // 数组运算由内核记录，经 C 接口调用同样计入
+    AdvancedCalculatorHandle* adv = advanced_calculator_create();
+    double xs[4] = {1.0, 3.0, 2.0, 0.5};
+    size_t index;
+    advanced_calculator_dot_double(adv, xs, xs, 4, &result);
+    advanced_calculator_argmax_double(adv, xs, 4, &index);
+    advanced_calculator_destroy(adv);
+
+    // 打印有记录的运算
+    InstrumentationStats stats;
+    for (size_t i = 0; i < instrumentation_operation_count(); ++i) {
+        if (instrumentation_get_stats(i, &stats) == CALC_SUCCESS && stats.calls) {
+            printf("%s: calls=%llu errors=%llu p50=%.0fns\n", stats.name, (unsigned long long)stats.calls,
+                   (unsigned long long)stats.errors, instrumentation_latency_percentile(&stats, 0.5));
+        }
+    }
+    printf("Division-by-zero error codes: %llu\n",
+           (unsigned long long)instrumentation_error_code_count(CALC_ERROR_DIVISION_BY_ZERO));
+    printf("Bucket 9 covers [%llu, %llu) ns\n", (unsigned long long)instrumentation_latency_bucket_floor(9),
+           (unsigned long long)instrumentation_latency_bucket_floor(10));
+    printf("Out-of-range index: %s\n",
+           calculator_error_to_string(instrumentation_get_stats(instrumentation_operation_count(), &stats)));
+    printf("\n");
+}
+
+void test_calc_server() {
+    printf("=== Testing Shared-Memory Calculation Server ===\n");
+
+    char server_name[64], data_name[64];
+    snprintf(server_name, sizeof(server_name), "/calc_c_server_%d", (int)getpid());
+    snprintf(data_name, sizeof(data_name), "/calc_c_server_%d_data", (int)getpid());
+
+    CalcServerConfig config = {4, 16, 1, 0};
+    CalcServerHandle* server = NULL;
+    CalculatorError err = calc_server_start(server_name, &config, &server);
+    printf("Start server: %s\n", calculator_error_to_string(err));
+    if (err != CALC_SUCCESS) return;
+
+    // 数据段：x = 1..8，y 用于 axpy 的结果
+    size_t n = 8;
+    size_t bytes = 2 * n * sizeof(double);
+    int fd = shm_open(data_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    double* x = NULL;
+    if (fd >= 0 && ftruncate(fd, (off_t)bytes) == 0) {
+        void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        x = p == MAP_FAILED ? NULL : (double*)p;
+    }
+    if (fd >= 0) close(fd);
+    if (!x) {
+        printf("Cannot create data segment\n\n");
+        shm_unlink(data_name);
+        calc_server_stop(server);
+        return;
+    }
+    double* y = x + n;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = (double)(i + 1);
+        y[i] = 1.0;
+    }
+
+    CalcClientHandle* client = NULL;
+    uint32_t segment = 0;
+    err = calc_client_connect(server_name, &client);
+    if (err == CALC_SUCCESS) err = calc_client_register_segment(client, data_name, x, bytes, &segment);
+    printf("Connect and register: %s (segment %u)\n", calculator_error_to_string(err), segment);
+
+    if (err == CALC_SUCCESS) {
+        CalcShmRequest request;
+        CalcShmCompletion done;
+        memset(&request, 0, sizeof(request));
+        request.op = CALC_SHM_OP_SUM;
+        request.dtype = CALC_SHM_DOUBLE;
+        calc_client_operand(client, x, n, sizeof(double), &request.args[0]);
+        err = calc_client_call(client, &request, &done);
+        printf("Sum of 1..8: %s, %g\n", calculator_error_to_string(err), done.value);
+
+        request.op = CALC_SHM_OP_AXPY;
+        request.scalar = 2.0;
+        calc_client_operand(client, y, n, sizeof(double), &request.args[1]);
+        uint64_t id = 0;
+        err = calc_client_submit(client, &request, &id);
+        if (err == CALC_SUCCESS) err = calc_client_wait(client, 1000, &done);
+        printf("Async axpy (id %llu): %s, y[7] = %g\n", (unsigned long long)done.id,
+               calculator_error_to_string(err), y[7]);
+
+        // 空输入、越界与无请求时的等待
+        request.op = CALC_SHM_OP_MIN;
+        request.args[0].count = 0;
+        printf("Min of empty array: %s\n", calculator_error_to_string(calc_client_call(client, &request, NULL)));
+        request.op = CALC_SHM_OP_NORM;
+        request.args[0].count = 3 * n;
+        printf("Out-of-range operand: %s\n", calculator_error_to_string(calc_client_call(client, &request, NULL)));
+        CalcShmOperand outside;
+        printf("Pointer outside segments: %s\n",
+               calculator_error_to_string(calc_client_operand(client, &n, 1, sizeof(n), &outside)));
+        printf("Wait with nothing pending: %s\n", calculator_error_to_string(calc_client_wait(client, 10, &done)));
+        printf("Unregister: %s\n", calculator_error_to_string(calc_client_unregister_segment(client, segment)));
+    }
+
+    printf("Requests completed: %llu\n", (unsigned long long)calc_server_completed_count(server));
+    calc_client_disconnect(client);
+    calc_server_stop(server);
+    CalcClientHandle* late = NULL;
+    printf("Connect after stop: %s\n", calculator_error_to_string(calc_client_connect(server_name, &late)));
+
+    munmap(x, bytes);
+    shm_unlink(data_name);
+    printf("\n");
+}
+
 int main() {
     printf("C++ Calculator C Wrapper Test\n");
     printf("=============================\n\n");
 
     test_basic_calculator();
     test_advanced_calculator();
+    test_file_operations();
+    test_history_journal();
+    test_accumulators();
+    test_arrow_columns();
+    test_scans();
+    test_selection();
+    test_sort_and_histogram();
+    test_group_by();
+    test_blas();
+    test_matmul();
+    test_poly_eval();
+    test_instrumentation();
+    test_calc_server();
 
     printf("All C wrapper tests completed successfully!\n");
     return 0;
@@ -1,7 +1,29 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <string>
 #include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/Accumulator.h"
+#include "cpp_calculator/HistoryJournal.h"
+#include "cpp_calculator/Scan.h"
+#include "cpp_calculator/Selection.h"
+#include "cpp_calculator/Sort.h"
+#include "cpp_calculator/GroupBy.h"
+#include "cpp_calculator/Blas.h"
+#include "cpp_calculator/Instrumentation.h"
+#include "cpp_calculator/CalcServer.h"
+#include "../src/Parallel.h"
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 void testBasicCalculator()
 {
@@ -34,6 +56,15 @@ void testBasicCalculator()
         {
             std::cout << "  " << entry << std::endl;
         }
+
+        // 批量导出：第一次只取大小，第二次写入
+        size_t required = calc.exportHistory(1, 2, HistoryFormat::Text, nullptr, 0);
+        std::string text(required, '\0');
+        calc.exportHistory(1, 2, HistoryFormat::Text, &text[0], text.size());
+        std::cout << "Exported entries 1-2 (" << required << " bytes):\n" << text;
+        std::cout << "Binary export size (all): "
+                  << calc.exportHistory(0, calc.getHistory().size(), HistoryFormat::Binary, nullptr, 0)
+                  << " bytes" << std::endl;
     }
     catch (const std::exception &e)
     {
@@ -138,6 +169,1087 @@ void testPolymorphism()
     std::cout << std::endl;
 }
 
+void testFileOperations()
+{
+    std::cout << "=== Testing Mapped File Operations ===" << std::endl;
+
+    AdvancedCalculator adv_calc;
+    const std::string int_path = "test_mapped_int32.bin";
+    const std::string in_path = "test_mapped_in.bin";
+    const std::string out_path = "test_mapped_out.bin";
+
+    try
+    {
+        std::vector<int32_t> ints = {7, -3, 42, 0, 15};
+        FILE *f = std::fopen(int_path.c_str(), "wb");
+        std::fwrite(ints.data(), sizeof(int32_t), ints.size(), f);
+        std::fclose(f);
+
+        std::cout << "Int file sum: " << adv_calc.sum_file_int32(int_path) << std::endl;
+        std::cout << "Int file max: " << adv_calc.max_file_int32(int_path) << std::endl;
+        std::cout << "Int file min: " << adv_calc.min_file_int32(int_path) << std::endl;
+
+        std::vector<double> values = {1.5, 2.5, 3.5};
+        f = std::fopen(in_path.c_str(), "wb");
+        std::fwrite(values.data(), sizeof(double), values.size(), f);
+        std::fclose(f);
+
+        std::cout << "Double file sum: " << adv_calc.sum_file_double(in_path) << std::endl;
+        size_t count = adv_calc.batch_add_file(in_path, out_path, 10.0);
+        std::cout << "Batch add file (" << count << " values): "
+                  << adv_calc.sum_file_double(out_path) << std::endl;
+
+        // 原地更新会在读取前截断输入，必须拒绝且不改动文件
+        try
+        {
+            adv_calc.batch_add_file(in_path, in_path, 1.0);
+            std::cout << "In-place batch add file was not rejected!" << std::endl;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << " (sum still "
+                      << adv_calc.sum_file_double(in_path) << ")" << std::endl;
+        }
+
+        try
+        {
+            adv_calc.sum_file_double("does_not_exist.bin");
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+    }
+
+    std::remove(int_path.c_str());
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+    std::cout << std::endl;
+}
+
+void testHistoryJournal()
+{
+    std::cout << "=== Testing History Journal ===" << std::endl;
+
+    const std::string path = "test_history.journal";
+    std::remove(path.c_str());
+
+    try
+    {
+        // 很小的环形缓冲区，覆盖回绕和生产者等待
+        JournalOptions options;
+        options.ring_bytes = 256;
+        options.sync = JournalSync::None;
+
+        Calculator calc;
+        calc.setJournal(std::make_shared<HistoryJournal>(path, options));
+        for (int i = 0; i < 1000; ++i)
+        {
+            calc.add(i, 0.5);
+        }
+        calc.getJournal()->flush();
+        std::cout << "Journal records: " << calc.getJournal()->recordCount()
+                  << ", producer stalls: " << calc.getJournal()->stallCount() << std::endl;
+        calc.setJournal(nullptr);
+
+        // 续写已有日志，并模拟末尾残留半条记录
+        {
+            HistoryJournal journal(path);
+            journal.append("appended entry");
+        }
+        FILE *f = std::fopen(path.c_str(), "ab");
+        std::fwrite("\x20\x00", 1, 2, f);
+        std::fclose(f);
+        {
+            HistoryJournal journal(path);
+            journal.append("after truncation");
+        }
+        // 预分配后未写完的记录：全零的尾部校验和不符，同样截掉
+        f = std::fopen(path.c_str(), "ab");
+        const char zeros[64] = {};
+        std::fwrite(zeros, 1, sizeof(zeros), f);
+        std::fclose(f);
+        {
+            HistoryJournal journal(path);
+            journal.append("after zero tail");
+        }
+
+        HistoryJournalReader reader(path);
+        JournalRecord record;
+        size_t count = 0;
+        bool matches = true;
+        while (reader.next(record))
+        {
+            if (count < calc.getHistory().size())
+            {
+                matches = matches && record.entry == calc.getHistory()[count];
+            }
+            ++count;
+        }
+        std::cout << "Records read back: " << count << " (history matches: "
+                  << (matches ? "yes" : "no") << ", last: " << record.entry << ")" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+    }
+
+    std::remove(path.c_str());
+    std::cout << std::endl;
+}
+
+void testAccumulators()
+{
+    std::cout << "=== Testing Streaming Accumulators ===" << std::endl;
+
+    try
+    {
+        // 分块输入
+        std::vector<int32_t> chunk1 = {10, 20, 5};
+        std::vector<int32_t> chunk2 = {30, 15};
+        SumAccumulator<int32_t> sum;
+        MaxAccumulator<int32_t> max;
+        sum.update(chunk1.data(), chunk1.size());
+        sum.update(chunk2.data(), chunk2.size());
+        max.update(chunk1.data(), chunk1.size());
+        max.update(chunk2.data(), chunk2.size());
+        std::cout << "Chunked int sum: " << sum.result() << " (" << sum.count() << " values)" << std::endl;
+        std::cout << "Chunked int max: " << max.result() << std::endl;
+
+        // 两个"线程"各自累加后合并
+        std::vector<double> part1 = {1.0, 2.0, 3.0};
+        std::vector<double> part2 = {4.0, 5.0};
+        StatsAccumulator<double> a, b;
+        a.update(part1.data(), part1.size());
+        b.update(part2.data(), part2.size());
+        a.merge(b);
+        std::cout << "Merged stats: count=" << a.count() << " sum=" << a.sum()
+                  << " min=" << a.min() << " max=" << a.max()
+                  << " mean=" << a.mean() << " variance=" << a.variance() << std::endl;
+
+        try
+        {
+            MinAccumulator<double> empty;
+            empty.result();
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// 与逐窗口直接计算的结果对比，返回是否一致
+template <typename T>
+bool checkScans(const std::vector<T> &data, size_t window, unsigned threads)
+{
+    using S = scan_sum_t<T>;
+    size_t n = data.size(), outputs = window_count(n, window);
+    std::vector<S> sums(n), excl(n), wsum(outputs);
+    std::vector<T> cmin(n), cmax(n), wmin(outputs), wmax(outputs);
+    prefix_sum(data.data(), n, sums.data(), ScanMode::Inclusive, threads);
+    prefix_sum(data.data(), n, excl.data(), ScanMode::Exclusive, threads);
+    cumulative_min(data.data(), n, cmin.data(), threads);
+    cumulative_max(data.data(), n, cmax.data(), threads);
+    window_sum(data.data(), n, window, wsum.data(), threads);
+    window_min(data.data(), n, window, wmin.data(), threads);
+    window_max(data.data(), n, window, wmax.data(), threads);
+
+    bool ok = true;
+    S running = 0;
+    T lo = data[0], hi = data[0];
+    for (size_t i = 0; i < n; ++i)
+    {
+        ok = ok && excl[i] == running;
+        running += data[i];
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+        ok = ok && sums[i] == running && cmin[i] == lo && cmax[i] == hi;
+    }
+    for (size_t i = 0; i < outputs; ++i)
+    {
+        S sum = 0;
+        for (size_t k = i; k < i + window; ++k)
+        {
+            sum += data[k];
+        }
+        ok = ok && wsum[i] == sum;
+        ok = ok && wmin[i] == *std::min_element(data.begin() + i, data.begin() + i + window);
+        ok = ok && wmax[i] == *std::max_element(data.begin() + i, data.begin() + i + window);
+    }
+    return ok;
+}
+
+bool testScans()
+{
+    std::cout << "=== Testing Prefix Scans and Sliding Windows ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        std::vector<double> prices = {3.0, 1.0, 4.0, 1.0, 5.0, 9.0, 2.0, 6.0};
+        std::vector<double> sums(prices.size()), mins(prices.size() - 2);
+        prefix_sum(prices.data(), prices.size(), sums.data());
+        window_min(prices.data(), prices.size(), 3, mins.data());
+        std::cout << "Prefix sum:";
+        for (double v : sums)
+            std::cout << " " << v;
+        std::cout << std::endl << "Window(3) min:";
+        for (double v : mins)
+            std::cout << " " << v;
+        std::cout << std::endl;
+
+        // 原地前缀和
+        prefix_sum(prices.data(), prices.size(), prices.data(), ScanMode::Exclusive);
+        std::cout << "In-place exclusive prefix sum last: " << prices.back() << std::endl;
+
+        // 整数值的 double 求和没有舍入误差，可以与顺序结果精确比较；
+        // 300000 个元素在 threads = 4 时走多线程分块路径
+        std::vector<int32_t> ints(300000);
+        std::vector<double> doubles(ints.size());
+        uint32_t state = 12345;
+        for (size_t i = 0; i < ints.size(); ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            ints[i] = static_cast<int32_t>(state);
+            doubles[i] = static_cast<double>(static_cast<int32_t>(state) >> 12);
+        }
+        std::vector<int32_t> small(ints.begin(), ints.begin() + 37);
+        bool small_ok = checkScans(small, 1, 1) && checkScans(small, 5, 1) && checkScans(small, 37, 1);
+        std::cout << "Small arrays match naive: " << (small_ok ? "yes" : "no") << std::endl;
+        bool large_ok = checkScans(ints, 7, 4) && checkScans(doubles, 100, 4) && checkScans(doubles, 1, 3);
+        std::cout << "Large arrays (4 threads) match naive: " << (large_ok ? "yes" : "no") << std::endl;
+        ok = small_ok && large_ok;
+
+        // 工作线程和调用线程上的块抛出异常：其余块照常完成，汇合后重新抛出，而不是 std::terminate
+        for (unsigned thrower : {0u, 2u})
+        {
+            std::vector<int> done(4, 0);
+            bool rethrown = false;
+            try
+            {
+                parallel::forEachBlock(400, 4, [&](unsigned t, size_t, size_t) {
+                    done[t] = 1;
+                    if (t == thrower)
+                        throw std::bad_alloc();
+                });
+            }
+            catch (const std::bad_alloc &)
+            {
+                rethrown = true;
+            }
+            bool block_ok = rethrown && done == std::vector<int>(4, 1);
+            std::cout << "Exception in block " << thrower << " rethrown after join: " << (block_ok ? "yes" : "no") << std::endl;
+            ok = ok && block_ok;
+        }
+
+        // 滑出窗口的 inf / 大数不能影响后面的窗口，结果也不能随线程划分变化
+        std::vector<double> inf_data = {std::numeric_limits<double>::infinity(), 1, 1, 1, 1, 1};
+        std::vector<double> big_data = {1e20, 1, 1, 1, 1};
+        std::vector<double> inf_sums(5), big_sums(4);
+        window_sum(inf_data.data(), inf_data.size(), 2, inf_sums.data(), 1);
+        window_sum(big_data.data(), big_data.size(), 2, big_sums.data(), 1);
+        bool exact_ok = std::isinf(inf_sums[0]) && big_sums[0] == 1e20;
+        for (size_t i = 1; i < inf_sums.size(); ++i)
+            exact_ok = exact_ok && inf_sums[i] == 2;
+        for (size_t i = 1; i < big_sums.size(); ++i)
+            exact_ok = exact_ok && big_sums[i] == 2;
+        std::vector<double> mixed(300000);
+        for (size_t i = 0; i < mixed.size(); ++i)
+            mixed[i] = i % 997 == 0 ? 1e20 : 0.1 * static_cast<double>(i % 13);
+        std::vector<double> one(mixed.size() - 9), many(mixed.size() - 9);
+        window_sum(mixed.data(), mixed.size(), 10, one.data(), 1);
+        window_sum(mixed.data(), mixed.size(), 10, many.data(), 4);
+        exact_ok = exact_ok && one == many;
+        std::cout << "Window sums with inf / 1e20 exact and thread-independent: " << (exact_ok ? "yes" : "no")
+                  << std::endl;
+        ok = ok && exact_ok;
+
+        try
+        {
+            std::vector<double> out(1);
+            window_sum(sums.data(), sums.size(), sums.size() + 1, out.data());
+            ok = false;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+// 与排序后的结果对比，返回是否一致
+template <typename T>
+bool checkSelection(const std::vector<T> &data, size_t k)
+{
+    std::vector<size_t> order(data.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return data[a] > data[b]; });
+
+    std::vector<T> sorted(data);
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = data.size();
+    double mid = (static_cast<double>(sorted[(n - 1) / 2]) + static_cast<double>(sorted[n / 2])) / 2.0;
+
+    std::vector<size_t> top = top_k(data.data(), n, k);
+    bool ok = top.size() == std::min(k, n) && std::equal(top.begin(), top.end(), order.begin());
+    ok = ok && argmax(data.data(), n) == order[0];
+    ok = ok && data[argmin(data.data(), n)] == sorted[0];
+    ok = ok && percentile(data.data(), n, 0.5) == mid;
+    ok = ok && percentile(data.data(), n, 0.0) == static_cast<double>(sorted[0]);
+    ok = ok && percentile(data.data(), n, 1.0) == static_cast<double>(sorted[n - 1]);
+    return ok;
+}
+
+bool testSelection()
+{
+    std::cout << "=== Testing Selection and Ranking ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        AdvancedCalculator calc;
+        std::vector<double> scores = {3.0, 1.0, 4.0, 1.0, 5.0, 9.0, 2.0, 6.0};
+        std::cout << "Argmax: " << calc.argmax(scores) << ", argmin: " << calc.argmin(scores) << std::endl;
+        std::cout << "Top 3 indices:";
+        for (size_t i : calc.top_k(scores, 3))
+            std::cout << " " << i;
+        std::cout << std::endl;
+        std::cout << "Median: " << calc.median(scores) << ", 90th percentile: " << calc.percentile(scores, 0.9) << std::endl;
+
+        // 大量重复值检验并列时的顺序；k 分别走堆和 nth_element 两条路径
+        std::vector<int32_t> ints(5000);
+        uint32_t state = 2024;
+        for (size_t i = 0; i < ints.size(); ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            ints[i] = static_cast<int32_t>(state >> 24) - 128;
+        }
+        std::vector<double> doubles(ints.begin(), ints.end());
+        bool match = checkSelection(ints, 10) && checkSelection(ints, 2000) && checkSelection(doubles, 1) &&
+                     checkSelection(doubles, 6000) && checkSelection(std::vector<int32_t>{7}, 3);
+        std::cout << "Selection matches sort: " << (match ? "yes" : "no") << std::endl;
+        ok = match;
+
+        try
+        {
+            calc.percentile(scores, 1.5);
+            ok = false;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+bool testSortAndHistogram()
+{
+    std::cout << "=== Testing Sorting and Histograms ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        AdvancedCalculator calc;
+        std::vector<int> values = {3, -1, 4, 1, -5, 9, 2, 6};
+        calc.sort(values);
+        std::cout << "Radix sorted:";
+        for (int v : values)
+            std::cout << " " << v;
+        std::cout << std::endl;
+
+        std::vector<uint64_t> counts = calc.histogram(values, 0.0, 10.0, 5);
+        std::cout << "Histogram [0, 10] in 5 bins:";
+        for (uint64_t c : counts)
+            std::cout << " " << c;
+        std::cout << std::endl;
+
+        // 300000 个元素在 threads = 4 时走多线程排序和归并路径；含 NaN 和 ±0
+        std::vector<int32_t> ints(300000);
+        std::vector<float> floats(ints.size());
+        std::vector<double> doubles(ints.size());
+        uint32_t state = 99;
+        for (size_t i = 0; i < ints.size(); ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            ints[i] = static_cast<int32_t>(state);
+            floats[i] = static_cast<float>(static_cast<int32_t>(state)) * 1e-3f;
+            doubles[i] = static_cast<double>(static_cast<int32_t>(state)) / 7.0;
+        }
+        doubles[10] = std::numeric_limits<double>::quiet_NaN();
+        floats[20] = -0.0f;
+        std::vector<int32_t> int_ref(ints);
+        std::vector<float> float_ref(floats);
+        std::vector<double> double_ref(doubles.begin(), doubles.end());
+        double_ref.erase(double_ref.begin() + 10);
+        std::sort(int_ref.begin(), int_ref.end());
+        std::sort(float_ref.begin(), float_ref.end());
+        std::sort(double_ref.begin(), double_ref.end());
+
+        radix_sort(ints.data(), ints.size());
+        radix_sort(floats.data(), floats.size());
+        parallel_sort(doubles.data(), doubles.size(), 4);
+        bool sorted_ok = ints == int_ref && floats == float_ref &&
+                         std::equal(double_ref.begin(), double_ref.end(), doubles.begin()) && std::isnan(doubles.back());
+        std::cout << "Sorts match std::sort: " << (sorted_ok ? "yes" : "no") << std::endl;
+
+        std::vector<uint64_t> bins(8);
+        size_t counted = histogram(doubles.data(), doubles.size(), -4e8, 4e8, bins.size(), bins.data(), 4);
+        uint64_t total = 0;
+        for (uint64_t c : bins)
+            total += c;
+        bool hist_ok = counted == total && counted == doubles.size() - 1 && counts == std::vector<uint64_t>{1, 2, 1, 1, 1};
+        std::cout << "Histogram counts consistent: " << (hist_ok ? "yes" : "no") << std::endl;
+        ok = sorted_ok && hist_ok;
+
+        try
+        {
+            calc.histogram(values, 1.0, 1.0, 4);
+            ok = false;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+// 与逐个键累加的结果对比，返回是否一致
+template <typename T>
+bool checkGroupBy(const std::vector<int32_t> &keys, const std::vector<T> &values, unsigned threads)
+{
+    GroupByResult<T> groups = group_by(keys.data(), values.data(), keys.size(), threads);
+    bool ok = std::is_sorted(groups.keys.begin(), groups.keys.end());
+    uint64_t total = 0;
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        typename GroupByResult<T>::sum_type sum = 0;
+        T lo = std::numeric_limits<T>::max(), hi = std::numeric_limits<T>::lowest();
+        uint64_t count = 0;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            if (keys[i] != groups.keys[g])
+                continue;
+            sum += values[i];
+            lo = std::min(lo, values[i]);
+            hi = std::max(hi, values[i]);
+            ++count;
+        }
+        ok = ok && groups.sums[g] == sum && groups.mins[g] == lo && groups.maxs[g] == hi && groups.counts[g] == count;
+        total += count;
+    }
+    return ok && total == keys.size();
+}
+
+bool testGroupBy()
+{
+    std::cout << "=== Testing Group-By Aggregation ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        AdvancedCalculator calc;
+        std::vector<int32_t> keys = {3, 1, 3, 2, 1, 3};
+        std::vector<double> values = {1.5, 2.0, -1.0, 4.0, 0.5, 2.5};
+        GroupByResult<double> groups = calc.group_by(keys, values);
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+            std::cout << "Key " << groups.keys[g] << ": sum=" << groups.sums[g] << " min=" << groups.mins[g]
+                      << " max=" << groups.maxs[g] << " count=" << groups.counts[g] << std::endl;
+        }
+
+        // 稠密键（小范围）与稀疏键（哈希表），threads = 4 时 300000 个元素走分区并行路径
+        std::vector<int32_t> dense(300000), sparse(dense.size()), ints(dense.size());
+        std::vector<double> doubles(dense.size());
+        uint32_t state = 7;
+        for (size_t i = 0; i < dense.size(); ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            dense[i] = static_cast<int32_t>(state >> 27) - 8;
+            sparse[i] = static_cast<int32_t>((state >> 20) * 2654435761u);
+            ints[i] = static_cast<int32_t>(state);
+            doubles[i] = static_cast<double>(static_cast<int32_t>(state) >> 8);
+        }
+        std::vector<int32_t> sparse_small(sparse.begin(), sparse.begin() + 3000);
+        std::vector<int32_t> ints_small(ints.begin(), ints.begin() + 3000);
+        bool match = checkGroupBy(dense, ints, 4) && checkGroupBy(dense, doubles, 1) &&
+                     checkGroupBy(sparse_small, ints_small, 1) &&
+                     group_by(sparse.data(), doubles.data(), sparse.size(), 4).counts ==
+                         group_by(sparse.data(), doubles.data(), sparse.size(), 1).counts;
+        std::cout << "Group-by matches naive: " << (match ? "yes" : "no") << std::endl;
+        ok = match;
+
+        try
+        {
+            calc.group_by(keys, std::vector<double>(2));
+            ok = false;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+bool testBlas()
+{
+    std::cout << "=== Testing BLAS-1 Operations ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        AdvancedCalculator calc;
+        std::vector<double> x = {1.0, 2.0, 3.0, 4.0, 5.0};
+        std::vector<double> y = {0.5, -1.0, 2.0, 0.0, 1.0};
+        std::cout << "dot = " << calc.dot(x, y) << ", norm = " << calc.norm(std::vector<double>{3.0, 4.0}) << std::endl;
+        calc.axpy(2.0, x, y);
+        std::cout << "axpy(2, x, y):";
+        for (double v : y)
+            std::cout << " " << v;
+        std::cout << std::endl;
+
+        // 与朴素循环比较：小整数乘积和部分和都精确，长度 1003 覆盖向量主循环和标量尾部
+        std::vector<double> a(1003), b(a.size()), c(a.size());
+        std::vector<float> af(a.size()), bf(a.size());
+        double dot = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            a[i] = static_cast<double>(static_cast<int>(i % 11) - 5);
+            b[i] = static_cast<double>(i % 4) * 0.25;
+            c[i] = static_cast<double>(i % 3);
+            af[i] = static_cast<float>(a[i]);
+            bf[i] = static_cast<float>(b[i]);
+            dot += a[i] * b[i];
+        }
+        std::vector<double> fused = calc.fma(a, b, c);
+        std::vector<float> scaled = af;
+        calc.scale(-0.5f, scaled);
+        bool match = calc.dot(a, b) == dot && calc.dot(af, bf) == static_cast<float>(dot);
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            match = match && fused[i] == a[i] * b[i] + c[i] && scaled[i] == -0.5f * af[i];
+        }
+        std::cout << "BLAS-1 matches naive: " << (match ? "yes" : "no") << std::endl;
+        ok = match;
+
+        try
+        {
+            calc.dot(x, std::vector<double>(2));
+            ok = false;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+// 与朴素三重循环比较：小整数数据使结果精确，和块大小无关
+template <typename T>
+bool matmulMatchesNaive(AdvancedCalculator &calc, size_t m, size_t k, size_t n, unsigned threads)
+{
+    std::vector<T> a(m * k), b(k * n);
+    for (size_t i = 0; i < a.size(); ++i)
+        a[i] = static_cast<T>(static_cast<int>(i % 9) - 4);
+    for (size_t i = 0; i < b.size(); ++i)
+        b[i] = static_cast<T>(static_cast<int>(i % 7) - 3);
+    std::vector<T> c = calc.matmul(a, b, m, k, n, threads);
+    for (size_t i = 0; i < m; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            T sum = 0;
+            for (size_t p = 0; p < k; ++p)
+                sum += a[i * k + p] * b[p * n + j];
+            if (c[i * n + j] != sum)
+                return false;
+        }
+    }
+    return c.size() == m * n;
+}
+
+bool testMatmul()
+{
+    std::cout << "=== Testing Matrix Multiply ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        AdvancedCalculator calc;
+        std::vector<double> a = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+        std::vector<double> b = {1.0, 0.0, 0.0, 1.0, 1.0, 1.0};
+        std::vector<double> c = calc.matmul(a, b, 2, 3, 2);
+        std::cout << "[[1,2,3],[4,5,6]] x [[1,0],[0,1],[1,1]] = [[" << c[0] << "," << c[1] << "],[" << c[2] << ","
+                  << c[3] << "]]" << std::endl;
+
+        // 覆盖三重循环路径、边缘小块、k 分段累加、B 按列分块和多线程切分
+        const size_t shapes[][4] = {{1, 1, 1, 1}, {4, 4, 4, 1}, {5, 3, 7, 1}, {13, 300, 17, 1}, {7, 3, 4100, 1},
+                                    {64, 64, 64, 0}, {301, 260, 299, 4}, {0, 5, 3, 1}, {3, 0, 5, 1}};
+        bool match = true;
+        for (const auto &s : shapes)
+        {
+            match = match && matmulMatchesNaive<double>(calc, s[0], s[1], s[2], static_cast<unsigned>(s[3]));
+            match = match && matmulMatchesNaive<float>(calc, s[0], s[1], s[2], static_cast<unsigned>(s[3]));
+        }
+        std::cout << "matmul matches naive: " << (match ? "yes" : "no") << std::endl;
+        ok = match;
+
+        try
+        {
+            calc.matmul(a, b, 3, 3, 2);
+            ok = false;
+        }
+        catch (const CalculatorException &e)
+        {
+            std::cout << "Exception caught: " << e.what() << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+bool testPolynomial()
+{
+    std::cout << "=== Testing Polynomial Evaluation ===" << std::endl;
+    bool ok = true;
+
+    try
+    {
+        AdvancedCalculator calc;
+        // 1 - 2x + 3x²
+        std::vector<double> p = calc.poly_eval(std::vector<double>{1.0, -2.0, 3.0}, std::vector<double>{0.0, 1.0, 2.0});
+        std::cout << "1 - 2x + 3x^2 at 0, 1, 2: " << p[0] << " " << p[1] << " " << p[2] << std::endl;
+
+        // 与逐项 Horner 比较：二进小数数据使结果精确；1000 个点覆盖向量主循环和标量尾部
+        std::vector<double> x(1000);
+        std::vector<float> xf(x.size());
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            x[i] = static_cast<double>(static_cast<int>(i % 9) - 4) * 0.5;
+            xf[i] = static_cast<float>(x[i]);
+        }
+        bool match = calc.poly_eval(std::vector<double>{}, x) == std::vector<double>(x.size(), 0.0);
+        for (size_t count = 1; count <= 11; ++count)
+        {
+            std::vector<double> c(count);
+            std::vector<float> cf(count);
+            for (size_t j = 0; j < count; ++j)
+            {
+                c[j] = static_cast<double>(static_cast<int>(j % 5) - 2);
+                cf[j] = static_cast<float>(c[j]);
+            }
+            std::vector<double> values = calc.poly_eval(c, x);
+            std::vector<float> valuesf = calc.poly_eval(cf, xf);
+            for (size_t i = 0; i < x.size(); ++i)
+            {
+                double expected = 0.0;
+                for (size_t j = count; j-- > 0;)
+                    expected = expected * x[i] + c[j];
+                match = match && values[i] == expected && valuesf[i] == static_cast<float>(expected);
+            }
+        }
+        std::cout << "poly_eval matches Horner: " << (match ? "yes" : "no") << std::endl;
+        ok = match;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+bool testInstrumentation()
+{
+    std::cout << "=== Testing Instrumentation ===" << std::endl;
+    bool ok = true;
+
+    // 分桶：每个桶的下界落在自己的桶里，桶宽不超过下界的 1/4
+    bool buckets = latency_bucket_floor(0) == 0 && latency_bucket_floor(4) == 4 && latency_bucket_floor(8) == 8;
+    for (size_t b = 4; b + 1 < kLatencyBuckets; ++b)
+    {
+        uint64_t lo = latency_bucket_floor(b);
+        uint64_t width = latency_bucket_floor(b + 1) - lo;
+        buckets = buckets && width > 0 && width * 4 <= lo;
+    }
+    OperationStats sample{};
+    sample.latency[10] = 99; // [12, 14) ns
+    sample.latency[36] = 1;  // [1024, 1280) ns
+    buckets = buckets && latency_percentile(sample, 0.5) == 13.0 && latency_percentile(sample, 1.0) == 1152.0 &&
+              latency_percentile(OperationStats{}, 0.5) == 0.0;
+    std::cout << "latency buckets: " << (buckets ? "ok" : "wrong") << std::endl;
+    ok = buckets;
+
+    std::cout << "instrumentation enabled: " << (instrumentation_enabled() ? "yes" : "no") << std::endl;
+    reset_instrumentation();
+    AdvancedCalculator calc;
+    calc.add(1.0, 2.0);
+    try
+    {
+        calc.divide(1.0, 0.0);
+    }
+    catch (const CalculatorException &)
+    {
+    }
+    // 已退出线程的计数同样保留
+    std::thread worker([] {
+        AdvancedCalculator local;
+        local.sum_array(std::vector<double>(100, 1.0));
+    });
+    worker.join();
+    calc.sum_array(std::vector<int>(10, 1));
+    // 直接调用自由函数内核（C 接口、Python 绑定走这条路径）同样计入
+    std::vector<double> xs(16, 2.0);
+    dot_product(xs.data(), xs.data(), xs.size());
+    calc.dot(xs, xs);
+    argmax(xs.data(), xs.size());
+
+    OperationStats divide = operation_stats(InstrumentedOperation::Divide);
+    OperationStats sum = operation_stats(InstrumentedOperation::SumArray);
+    uint64_t recorded = 0;
+    for (size_t b = 0; b < kLatencyBuckets; ++b)
+        recorded += sum.latency[b];
+    bool counts;
+    if (instrumentation_enabled())
+    {
+        counts = operation_stats(InstrumentedOperation::Add).calls == 1 && divide.calls == 1 && divide.errors == 1 &&
+                 sum.calls == 2 && sum.errors == 0 && sum.bytes == 100 * sizeof(double) + 10 * sizeof(int) &&
+                 recorded == 2 && operation_stats(InstrumentedOperation::Dot).calls == 2 &&
+                 operation_stats(InstrumentedOperation::Dot).bytes == 4 * xs.size() * sizeof(double) &&
+                 operation_stats(InstrumentedOperation::Argmax).calls == 1;
+        reset_instrumentation();
+        counts = counts && operation_stats(InstrumentedOperation::SumArray).calls == 0;
+    }
+    else
+    {
+        counts = divide.calls == 0 && sum.calls == 0 && recorded == 0 &&
+                 operation_stats(InstrumentedOperation::Dot).calls == 0;
+    }
+    std::cout << "operation counts: " << (counts ? "ok" : "wrong") << std::endl;
+    ok = ok && counts && std::string(operation_name(InstrumentedOperation::Matmul)) == "matmul" &&
+         operation_name(InstrumentedOperation::Count) == nullptr;
+
+    std::cout << std::endl;
+    return ok;
+}
+
+// 子进程：连接服务，对父进程写好的数据求点积，结果通过退出码返回
+static int calcServerChild(int ready_fd, const std::string &server, const std::string &data, size_t n)
+{
+    char byte = 0;
+    if (read(ready_fd, &byte, 1) != 1)
+        return 2;
+    try
+    {
+        SharedMemorySegment segment(data);
+        CalcClient client(server);
+        client.registerSegment(segment);
+        const double *x = segment.as<double>();
+        CalcShmRequest request{};
+        request.op = CALC_SHM_OP_DOT;
+        request.dtype = CALC_SHM_DOUBLE;
+        request.args[0] = client.operand(x, n, sizeof(double));
+        request.args[1] = client.operand(x + n, n, sizeof(double));
+        return client.call(request).value == static_cast<double>(n * (n - 1)) ? 0 : 1;
+    }
+    catch (const CalculatorException &)
+    {
+        return 3;
+    }
+}
+
+bool testCalcServer()
+{
+    std::cout << "=== Testing Shared-Memory Calculation Server ===" << std::endl;
+    bool ok = true;
+    const std::string server_name = "/calc_test_server_" + std::to_string(getpid());
+    const std::string data_name = server_name + "_data";
+    const size_t n = 1000;
+
+    // 先 fork 再启动服务线程，子进程中只有一个线程
+    int ready[2];
+    if (pipe(ready) != 0)
+        return false;
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(ready[1]);
+        _exit(calcServerChild(ready[0], server_name, data_name, n));
+    }
+    close(ready[0]);
+
+    try
+    {
+        // 段内依次为 x（0..n-1）、y（全 2）、out 和 n 个 int32
+        SharedMemorySegment data(data_name, 3 * n * sizeof(double) + n * sizeof(int32_t));
+        double *x = data.as<double>();
+        double *y = x + n;
+        double *out = y + n;
+        int32_t *ints = reinterpret_cast<int32_t *>(out + n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] = static_cast<double>(i);
+            y[i] = 2.0;
+            ints[i] = static_cast<int32_t>((i * 7919) % n) - 500;
+        }
+
+        CalcServerOptions options;
+        options.slots = 4;
+        options.workers = 2;
+        options.threads = 4; // 大请求在辅助线程上分块执行
+        CalcServer server(server_name, options);
+        CalcClient client(server_name);
+        client.registerSegment(data);
+        bool signalled = write(ready[1], "x", 1) == 1;
+        close(ready[1]);
+
+        CalcShmRequest request{};
+        request.op = CALC_SHM_OP_SUM;
+        request.dtype = CALC_SHM_DOUBLE;
+        request.args[0] = client.operand(x, n, sizeof(double));
+        bool results = client.call(request).value == n * (n - 1) / 2.0;
+
+        request.op = CALC_SHM_OP_MAX;
+        request.dtype = CALC_SHM_INT32;
+        request.args[0] = client.operand(ints, n, sizeof(int32_t));
+        results = results && client.call(request).int_value == 499;
+
+        request.op = CALC_SHM_OP_SORT;
+        client.call(request);
+        results = results && std::is_sorted(ints, ints + n) && ints[0] == -500;
+
+        request = CalcShmRequest{};
+        request.op = CALC_SHM_OP_AXPY;
+        request.dtype = CALC_SHM_DOUBLE;
+        request.scalar = 3.0;
+        request.args[0] = client.operand(x, n, sizeof(double));
+        request.args[1] = client.operand(out, n, sizeof(double));
+        std::fill(out, out + n, 1.0);
+        client.call(request);
+        results = results && out[0] == 1.0 && out[n - 1] == 3.0 * (n - 1) + 1.0;
+        std::cout << "sum / max / sort / axpy in shared memory: " << (results ? "ok" : "wrong") << std::endl;
+
+        // 一次提交多个请求，完成记录按提交顺序到达
+        request = CalcShmRequest{};
+        request.op = CALC_SHM_OP_DOT;
+        request.dtype = CALC_SHM_DOUBLE;
+        uint64_t first = 0;
+        for (size_t k = 1; k <= 8; ++k)
+        {
+            request.args[0] = client.operand(x, k, sizeof(double));
+            request.args[1] = client.operand(y, k, sizeof(double));
+            uint64_t id = client.submit(request);
+            first = first ? first : id;
+        }
+        bool pipelined = client.pending() == 8;
+        for (size_t k = 1; k <= 8; ++k)
+        {
+            CalcShmCompletion done;
+            pipelined = pipelined && client.wait(done, 1000) && done.id == first + k - 1 &&
+                        done.value == static_cast<double>(k * (k - 1));
+        }
+        CalcShmCompletion none;
+        pipelined = pipelined && client.pending() == 0 && !client.poll(none);
+        std::cout << "pipelined requests: " << (pipelined ? "ok" : "wrong") << std::endl;
+
+        // 越界和空输入由服务端拒绝，连接仍然可用；不在已注册段内的指针在客户端被拒绝
+        request.op = CALC_SHM_OP_NORM;
+        request.args[0] = client.operand(x, n, sizeof(double));
+        request.args[0].count = 4 * n;
+        uint64_t bad = client.submit(request);
+        request.op = CALC_SHM_OP_MIN;
+        request.args[0].count = 0;
+        client.submit(request);
+        CalcShmCompletion invalid, empty;
+        bool errors = client.wait(invalid) && client.wait(empty) && invalid.id == bad &&
+                      invalid.status == CALC_SHM_STATUS_INVALID && empty.status == CALC_SHM_STATUS_EMPTY;
+        try
+        {
+            double local = 0.0;
+            client.operand(&local, 1, sizeof(double));
+            errors = false;
+        }
+        catch (const CalculatorException &)
+        {
+        }
+        std::cout << "rejected requests: " << (errors ? "ok" : "wrong") << std::endl;
+
+        // 服务端只映射以 "<服务名>_" 开头的段：控制段本身和其它名字在打开之前就被拒绝
+        bool names = true;
+        for (const std::string &forbidden : {server_name, "/calc_test_other_" + std::to_string(getpid())})
+        {
+            try
+            {
+                client.registerSegment(forbidden, x, sizeof(double));
+                names = false;
+            }
+            catch (const CalculatorException &e)
+            {
+                names = names && std::string(e.what()).find("Invalid") != std::string::npos;
+            }
+        }
+        std::cout << "segment names outside the server prefix rejected: " << (names ? "ok" : "wrong") << std::endl;
+        errors = errors && names;
+
+        // 客户端注册后、提交前用 ftruncate 缩小段：服务端按当前大小拒绝请求
+        const std::string shrink_name = data_name + "_shrink";
+        SharedMemorySegment shrink(shrink_name, 1 << 16);
+        uint32_t shrink_index = client.registerSegment(shrink);
+        request = CalcShmRequest{};
+        request.op = CALC_SHM_OP_SUM;
+        request.dtype = CALC_SHM_DOUBLE;
+        request.args[0] = client.operand(shrink.data(), (1 << 16) / sizeof(double), sizeof(double));
+        int shrink_fd = shm_open(shrink_name.c_str(), O_RDWR, 0);
+        bool truncated = shrink_fd >= 0 && ftruncate(shrink_fd, 4096) == 0;
+        if (shrink_fd >= 0)
+            close(shrink_fd);
+        CalcShmCompletion shrunk;
+        client.submit(request);
+        truncated = truncated && client.wait(shrunk, 1000) && shrunk.status == CALC_SHM_STATUS_IO;
+        request.args[0].count = 4096 / sizeof(double);
+        truncated = truncated && client.call(request).value == 0.0;
+        client.unregisterSegment(shrink_index);
+        std::cout << "truncated segment rejected: " << (truncated ? "ok" : "wrong") << std::endl;
+
+        // 排序进行中把段截断为 0：辅助线程和分派线程上的 SIGBUS 都转为 CALC_SHM_STATUS_IO，服务继续运行
+        const std::string large_name = data_name + "_large";
+        const size_t large_count = size_t(1) << 23;
+        SharedMemorySegment large(large_name, large_count * sizeof(double));
+        double *descending = large.as<double>();
+        for (size_t i = 0; i < large_count; ++i)
+            descending[i] = static_cast<double>((i * 2654435761u) % large_count);
+        uint32_t large_index = client.registerSegment(large);
+        request = CalcShmRequest{};
+        request.op = CALC_SHM_OP_SORT;
+        request.dtype = CALC_SHM_DOUBLE;
+        request.args[0] = client.operand(descending, large_count, sizeof(double));
+        client.submit(request);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        int large_fd = shm_open(large_name.c_str(), O_RDWR, 0);
+        bool interrupted = large_fd >= 0 && ftruncate(large_fd, 0) == 0;
+        if (large_fd >= 0)
+            close(large_fd);
+        CalcShmCompletion aborted;
+        interrupted = interrupted && client.wait(aborted, 30000) && aborted.status == CALC_SHM_STATUS_IO;
+        client.unregisterSegment(large_index);
+        request = CalcShmRequest{};
+        request.op = CALC_SHM_OP_SUM;
+        request.dtype = CALC_SHM_DOUBLE;
+        request.args[0] = client.operand(x, n, sizeof(double));
+        interrupted = interrupted && client.call(request).value == n * (n - 1) / 2.0;
+        std::cout << "segment truncated during a request: " << (interrupted ? "ok" : "wrong") << std::endl;
+
+        // 环形队列容量过大时构造失败，而不是在取 2 的幂时溢出
+        bool capacity = false;
+        try
+        {
+            CalcServerOptions huge;
+            huge.ring_capacity = 3000000000u;
+            CalcServer oversized(server_name + "_huge", huge);
+        }
+        catch (const CalculatorException &e)
+        {
+            capacity = std::string(e.what()).find("ring capacity") != std::string::npos;
+        }
+        std::cout << "oversized ring rejected: " << (capacity ? "ok" : "wrong") << std::endl;
+        errors = errors && truncated && interrupted && capacity;
+
+        // 子进程通过自己的连接计算
+        int status = 0;
+        bool remote = signalled && waitpid(child, &status, 0) == child && WIFEXITED(status) &&
+                      WEXITSTATUS(status) == 0;
+        child = 0;
+        std::cout << "client in another process: " << (remote ? "ok" : "wrong") << std::endl;
+
+        // 停止后连接失败
+        server.stop();
+        bool stopped = false;
+        try
+        {
+            CalcClient late(server_name);
+        }
+        catch (const CalculatorException &e)
+        {
+            stopped = std::string(e.what()).find("not running") != std::string::npos;
+        }
+        std::cout << "server stopped: " << (stopped ? "ok" : "wrong") << std::endl;
+
+        ok = results && pipelined && errors && remote && stopped;
+    }
+    catch (const CalculatorException &e)
+    {
+        std::cout << "Unexpected error: " << e.what() << std::endl;
+        ok = false;
+    }
+    if (child > 0)
+    {
+        close(ready[1]);
+        waitpid(child, nullptr, 0);
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
 int main()
 {
     std::cout << "C++ Calculator Library Test" << std::endl;
@@ -147,6 +1259,58 @@ int main()
     testBasicCalculator();
     testAdvancedCalculator();
     testPolymorphism();
+    testFileOperations();
+    testHistoryJournal();
+    testAccumulators();
+    if (!testScans())
+    {
+        std::cout << "Scan tests FAILED" << std::endl;
+        return 1;
+    }
+    if (!testSelection())
+    {
+        std::cout << "Selection tests FAILED" << std::endl;
+        return 1;
+    }
+    if (!testSortAndHistogram())
+    {
+        std::cout << "Sort tests FAILED" << std::endl;
+        return 1;
+    }
+    if (!testGroupBy())
+    {
+        std::cout << "Group-by tests FAILED" << std::endl;
+        return 1;
+    }
+    if (!testBlas())
+    {
+        std::cout << "BLAS tests FAILED" << std::endl;
+        return 1;
+    }
+
+    if (!testMatmul())
+    {
+        std::cout << "Matrix multiply tests FAILED" << std::endl;
+        return 1;
+    }
+
+    if (!testPolynomial())
+    {
+        std::cout << "Polynomial tests FAILED" << std::endl;
+        return 1;
+    }
+
+    if (!testInstrumentation())
+    {
+        std::cout << "Instrumentation tests FAILED" << std::endl;
+        return 1;
+    }
+
+    if (!testCalcServer())
+    {
+        std::cout << "Calculation server tests FAILED" << std::endl;
+        return 1;
+    }
 
     std::cout << "All C++ calculator tests completed successfully!" << std::endl;
     return 0;
@@ -0,0 +1,81 @@
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/CalcServer.h"
+
+// 共享内存计算服务：运行到收到 SIGINT / SIGTERM 为止，退出时打印处理的请求数
+// 用法: calc_server [--workers N] [--threads N] [--slots N] [--ring N] [--spin-us N] <name>
+
+static bool parseUnsigned(const char *text, unsigned &value)
+{
+    char *end = nullptr;
+    unsigned long parsed = std::strtoul(text, &end, 10);
+    if (!*text || *end || parsed > 1000000)
+    {
+        return false;
+    }
+    value = static_cast<unsigned>(parsed);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    CalcServerOptions options;
+    const char *name = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        unsigned *target = nullptr;
+        if (std::strcmp(argv[i], "--workers") == 0)
+            target = &options.workers;
+        else if (std::strcmp(argv[i], "--threads") == 0)
+            target = &options.threads;
+        else if (std::strcmp(argv[i], "--slots") == 0)
+            target = &options.slots;
+        else if (std::strcmp(argv[i], "--ring") == 0)
+            target = &options.ring_capacity;
+        else if (std::strcmp(argv[i], "--spin-us") == 0)
+            target = &options.spin_us;
+        else
+            name = argv[i];
+
+        if (target && (++i == argc || !parseUnsigned(argv[i], *target)))
+        {
+            name = nullptr;
+            break;
+        }
+    }
+    if (!name)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [--workers N] [--threads N] [--slots N] [--ring N] [--spin-us N] <name>\n", argv[0]);
+        return 2;
+    }
+
+    // 在启动分派线程之前屏蔽信号，之后由主线程同步等待
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        CalcServer server(name, options);
+        std::fprintf(stderr, "calculation server '%s' running (pid %d)\n", server.name().c_str(), getpid());
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+        std::fprintf(stderr, "stopped: %llu requests completed\n",
+                     static_cast<unsigned long long>(server.completedCount()));
+    }
+    catch (const CalculatorException &e)
+    {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
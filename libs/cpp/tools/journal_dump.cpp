@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include "cpp_calculator/Calculator.h"
+#include "cpp_calculator/HistoryJournal.h"
+
+// 历史日志读取工具：逐条打印时间戳和历史内容，校验失败时返回非零
+// 用法: calc_journal_dump [--raw] <journal>
+//   --raw  时间戳输出为纳秒整数（便于脚本处理），默认为 UTC ISO 8601
+
+static void printTimestamp(int64_t timestamp_ns, bool raw)
+{
+    if (raw)
+    {
+        std::printf("%lld", static_cast<long long>(timestamp_ns));
+        return;
+    }
+
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000);
+    std::tm utc;
+    gmtime_r(&seconds, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::printf("%s.%09lldZ", buffer, static_cast<long long>(timestamp_ns % 1000000000));
+}
+
+int main(int argc, char **argv)
+{
+    bool raw = false;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--raw") == 0)
+        {
+            raw = true;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+    if (!path)
+    {
+        std::fprintf(stderr, "Usage: %s [--raw] <journal>\n", argv[0]);
+        return 2;
+    }
+
+    size_t count = 0;
+    try
+    {
+        HistoryJournalReader reader(path);
+        JournalRecord record;
+        while (reader.next(record))
+        {
+            printTimestamp(record.timestamp_ns, raw);
+            std::printf("\t%s\n", record.entry.c_str());
+            ++count;
+        }
+        if (reader.truncated())
+        {
+            std::fprintf(stderr, "warning: incomplete record at end of journal (offset %zu)\n",
+                         reader.validBytes());
+        }
+    }
+    catch (const CalculatorException &e)
+    {
+        std::fprintf(stderr, "error after %zu records: %s\n", count, e.what());
+        return 1;
+    }
+
+    std::fprintf(stderr, "%zu records\n", count);
+    return 0;
+}
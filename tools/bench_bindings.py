@@ -0,0 +1,438 @@
+#!/usr/bin/env python3
+"""
+Python 绑定调用开销基准：Cython（c_math / asm_math）、pybind11（cpp_calculator_py）、ctypes、CFFI
+
+同一运算用各种绑定方式调用，按输入类型（list / array.array / numpy）和元素个数比较每次调用的耗时：
+
+  scalar_add_int32   标量 int32 加法（libmath_ops 的 add_int / 汇编库的 asm_add），纯调用开销；
+                     Cython 分别测对象方法和模块函数（func）
+  scalar_getter      libcpp_calculator 的 get_last_result，pybind11 与 ctypes / CFFI 的同一函数对比
+  dot_f64            点积（结果为标量），list 输入包含转换成 C 数组的开销
+  fma_f64            a * b + c（每次调用新建结果数组）
+  add_int32          int32 数组加法：一次批量调用，对比逐元素调用标量函数的循环（loop）
+                     和 NumPy ufunc（c_math_ufuncs.add_int_sat）
+
+每个用例是一条语句，用 timeit 在同一个循环内执行（不额外包一层 Python 函数调用）；先校准循环次数，
+再重复测量取中位数。--save 保存为基线 JSON，--compare 与基线比较，中位数变慢超过 --threshold 时返回 1。
+
+用法:
+  python3 tools/bench_bindings.py                          # 运行全部用例
+  python3 tools/bench_bindings.py --filter 'dot_f64/.*/array' --sizes 64,4096
+  python3 tools/bench_bindings.py --save baseline.json
+  python3 tools/bench_bindings.py --compare baseline.json --threshold 0.1
+
+需要先构建项目（build/lib 下的共享库和 cpp_calculator_py 模块），并在 libs/c/bindings/python、
+libs/asm/bindings/python 中执行 python setup.py build_ext --inplace。缺少的绑定（包括未安装的 cffi / numpy）会被跳过
+"""
+
+import argparse
+import array
+import ctypes
+import datetime
+import gc
+import json
+import os
+import platform
+import re
+import statistics
+import subprocess
+import sys
+import timeit
+
+PROJECT_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+DEFAULT_SIZES = (1, 64, 4096, 262144)
+LOOP_MAX_SIZE = 4096  # 逐元素循环只测到这个大小
+
+CFFI_CDEF = """
+int32_t add_int(int32_t a, int32_t b);
+size_t add_int_array_sat(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+
+typedef struct CalculatorHandle CalculatorHandle;
+typedef struct AdvancedCalculatorHandle AdvancedCalculatorHandle;
+CalculatorHandle* calculator_create(void);
+double calculator_get_last_result(CalculatorHandle* handle);
+AdvancedCalculatorHandle* advanced_calculator_create(void);
+int advanced_calculator_dot_double(AdvancedCalculatorHandle* handle, const double* x, const double* y,
+                                   size_t size, double* result);
+int advanced_calculator_fma_double(AdvancedCalculatorHandle* handle, const double* a, const double* b,
+                                   const double* c, double* out, size_t size);
+"""
+
+
+class Case:
+    """一个基准用例：group/binding/input/size 唯一标识，stmt 在 namespace 中执行"""
+
+    def __init__(self, group, binding, kind, size, stmt, namespace):
+        self.group = group
+        self.binding = binding
+        self.kind = kind
+        self.size = size
+        self.stmt = stmt
+        self.namespace = namespace
+
+    @property
+    def id(self):
+        return f"{self.group}/{self.binding}/{self.kind}/{self.size}"
+
+
+# ---------------------------------------------------------------------------
+# 绑定的加载：每个函数返回模块 / 库对象，不可用时返回 None 和原因
+# ---------------------------------------------------------------------------
+
+def load_bindings(build_dir):
+    sys.path.insert(0, os.path.join(PROJECT_ROOT, 'libs', 'c', 'bindings', 'python'))
+    sys.path.insert(0, os.path.join(PROJECT_ROOT, 'libs', 'asm', 'bindings', 'python'))
+    sys.path.insert(0, os.path.join(build_dir, 'lib', 'python'))
+    lib_dir = os.path.join(build_dir, 'lib')
+
+    found, missing = {}, {}
+
+    def attempt(name, loader):
+        try:
+            found[name] = loader()
+        except Exception as e:  # noqa: BLE001 - 任何加载失败都只是跳过该绑定
+            missing[name] = f"{type(e).__name__}: {e}"
+
+    def cython_c():
+        import c_math
+        return c_math.CMathOps()
+
+    def cython_asm():
+        import asm_math
+        return asm_math.AsmMathOps()
+
+    def pybind():
+        import cpp_calculator_py
+        return cpp_calculator_py
+
+    def ctypes_libs():
+        c = ctypes.CDLL(os.path.join(lib_dir, 'libmath_ops.so'))
+        cpp = ctypes.CDLL(os.path.join(lib_dir, 'libcpp_calculator.so'))
+        c_i32, c_dbl, c_size = ctypes.c_int32, ctypes.c_double, ctypes.c_size_t
+        p_i32, p_dbl = ctypes.POINTER(c_i32), ctypes.POINTER(c_dbl)
+        c.add_int.argtypes, c.add_int.restype = [c_i32, c_i32], c_i32
+        c.add_int_array_sat.argtypes = [p_i32, p_i32, p_i32, c_size]
+        c.add_int_array_sat.restype = c_size
+        cpp.calculator_create.restype = ctypes.c_void_p
+        cpp.calculator_get_last_result.argtypes = [ctypes.c_void_p]
+        cpp.calculator_get_last_result.restype = c_dbl
+        cpp.advanced_calculator_create.restype = ctypes.c_void_p
+        cpp.advanced_calculator_dot_double.argtypes = [ctypes.c_void_p, p_dbl, p_dbl, c_size, p_dbl]
+        cpp.advanced_calculator_dot_double.restype = ctypes.c_int
+        cpp.advanced_calculator_fma_double.argtypes = [ctypes.c_void_p, p_dbl, p_dbl, p_dbl, p_dbl, c_size]
+        cpp.advanced_calculator_fma_double.restype = ctypes.c_int
+        return c, cpp
+
+    def cffi_libs():
+        import cffi
+        ffi = cffi.FFI()
+        ffi.cdef(CFFI_CDEF)
+        return (ffi, ffi.dlopen(os.path.join(lib_dir, 'libmath_ops.so')),
+                ffi.dlopen(os.path.join(lib_dir, 'libcpp_calculator.so')))
+
+    def numpy():
+        import numpy
+        return numpy
+
+    def ufuncs():
+        import c_math_ufuncs
+        return c_math_ufuncs
+
+    attempt('cython-c', cython_c)
+    attempt('cython-asm', cython_asm)
+    attempt('pybind11', pybind)
+    attempt('ctypes', ctypes_libs)
+    attempt('cffi', cffi_libs)
+    attempt('numpy', numpy)
+    if 'numpy' in found:
+        attempt('c-ufunc', ufuncs)
+    return found, missing
+
+
+# ---------------------------------------------------------------------------
+# 用例
+# ---------------------------------------------------------------------------
+
+def make_inputs(kind, size, typecode, np, salt):
+    """生成 size 个元素的输入：list / array.array / numpy 数组"""
+    if typecode == 'd':
+        values = [float((i * 7 + salt) % 13) * 0.5 for i in range(size)]
+    else:
+        values = [(i * 7 + salt) % 1000 - 500 for i in range(size)]
+    if kind == 'list':
+        return values
+    if kind == 'array':
+        return array.array(typecode, values)
+    return np.array(values, dtype=np.float64 if typecode == 'd' else np.int32)
+
+
+def build_cases(bindings, sizes):
+    cases = []
+    np = bindings.get('numpy')
+    kinds = ['list', 'array'] + (['numpy'] if np is not None else [])
+
+    # 标量：调用开销
+    # Cython：对象方法与模块函数（cpdef，没有的旧版本跳过）
+    for name in ('cython-c', 'cython-asm'):
+        if name not in bindings:
+            continue
+        ops = bindings[name]
+        cases.append(Case('scalar_add_int32', name, 'scalar', 1, 'add(3, 4)', {'add': ops.add}))
+        module = sys.modules[type(ops).__module__]
+        if hasattr(module, 'add'):
+            cases.append(Case('scalar_add_int32', f'{name}(func)', 'scalar', 1, 'add(3, 4)', {'add': module.add}))
+    if 'ctypes' in bindings:
+        c, cpp = bindings['ctypes']
+        cases.append(Case('scalar_add_int32', 'ctypes', 'scalar', 1, 'add(3, 4)', {'add': c.add_int}))
+        handle = cpp.calculator_create()
+        cases.append(Case('scalar_getter', 'ctypes', 'scalar', 1, 'get(h)',
+                          {'get': cpp.calculator_get_last_result, 'h': handle}))
+    if 'cffi' in bindings:
+        ffi, c, cpp = bindings['cffi']
+        cases.append(Case('scalar_add_int32', 'cffi', 'scalar', 1, 'add(3, 4)', {'add': c.add_int}))
+        cases.append(Case('scalar_getter', 'cffi', 'scalar', 1, 'get(h)',
+                          {'get': cpp.calculator_get_last_result, 'h': cpp.calculator_create()}))
+    if 'pybind11' in bindings:
+        calc = bindings['pybind11'].Calculator()
+        cases.append(Case('scalar_getter', 'pybind11', 'scalar', 1, 'get()', {'get': calc.get_last_result}))
+
+    for size in sizes:
+        for kind in kinds:
+            x = make_inputs(kind, size, 'd', np, 1)
+            y = make_inputs(kind, size, 'd', np, 2)
+            z = make_inputs(kind, size, 'd', np, 3)
+            a = make_inputs(kind, size, 'i', np, 1)
+            b = make_inputs(kind, size, 'i', np, 2)
+            as_list = kind == 'list'
+            ns = {'x': x, 'y': y, 'z': z, 'a': a, 'b': b, 'n': size, 'array': array.array}
+
+            # Cython 的类型化 memoryview 只接受缓冲区，list 需要先转换
+            if 'cython-asm' in bindings:
+                ops = bindings['cython-asm']
+                conv = "array('d', {})" if as_list else '{}'
+                conv_i = "array('i', {})" if as_list else '{}'
+                cases.append(Case('dot_f64', 'cython-asm', kind, size,
+                                  f"dot({conv.format('x')}, {conv.format('y')})", dict(ns, dot=ops.dot)))
+                cases.append(Case('fma_f64', 'cython-asm', kind, size,
+                                  f"fma({conv.format('x')}, {conv.format('y')}, {conv.format('z')})",
+                                  dict(ns, fma=ops.fma)))
+                cases.append(Case('add_int32', 'cython-asm', kind, size,
+                                  f"add({conv_i.format('a')}, {conv_i.format('b')}, saturate=True)",
+                                  dict(ns, add=ops.add_arrays)))
+            if 'cython-c' in bindings:
+                ops = bindings['cython-c']
+                conv_i = "array('i', {})" if as_list else '{}'
+                cases.append(Case('add_int32', 'cython-c', kind, size,
+                                  f"add({conv_i.format('a')}, {conv_i.format('b')}, saturate=True)",
+                                  dict(ns, add=ops.add_arrays)))
+                if as_list and size <= LOOP_MAX_SIZE:
+                    cases.append(Case('add_int32', 'cython-c(loop)', kind, size,
+                                      '[add(p, q) for p, q in zip(a, b)]',
+                                      dict(ns, add=getattr(sys.modules[type(ops).__module__], 'add_saturating',
+                                                           ops.add_saturating))))
+
+            # NumPy ufunc：只接受 numpy 数组（list 会先被 numpy 转换成 int64，找不到 int32 循环）
+            if 'c-ufunc' in bindings and kind == 'numpy':
+                cases.append(Case('add_int32', 'c-ufunc', kind, size, 'add(a, b)',
+                                  dict(ns, add=bindings['c-ufunc'].add_int_sat)))
+
+            # pybind11：list 和缓冲区走同一个入口
+            if 'pybind11' in bindings:
+                mod = bindings['pybind11']
+                cases.append(Case('dot_f64', 'pybind11', kind, size, 'dot(x, y)', dict(ns, dot=mod.dot_double)))
+                cases.append(Case('fma_f64', 'pybind11', kind, size, 'fma(x, y, z)', dict(ns, fma=mod.fma_double)))
+
+            # ctypes：list 用 (c_double * n)(*x) 拷贝，缓冲区用 from_buffer 零拷贝
+            if 'ctypes' in bindings:
+                c, cpp = bindings['ctypes']
+                dbl_n, i32_n = ctypes.c_double * size, ctypes.c_int32 * size
+                ctx = dict(ns, D=dbl_n, I=i32_n, h=cpp.advanced_calculator_create(), r=ctypes.c_double(),
+                           byref=ctypes.byref, dot=cpp.advanced_calculator_dot_double,
+                           fma=cpp.advanced_calculator_fma_double, add=c.add_int_array_sat)
+                wrap = 'D(*{})' if as_list else 'D.from_buffer({})'
+                wrap_i = 'I(*{})' if as_list else 'I.from_buffer({})'
+                cases.append(Case('dot_f64', 'ctypes', kind, size,
+                                  f"dot(h, {wrap.format('x')}, {wrap.format('y')}, n, byref(r)); r.value", ctx))
+                cases.append(Case('fma_f64', 'ctypes', kind, size,
+                                  f"out = D(); fma(h, {wrap.format('x')}, {wrap.format('y')}, {wrap.format('z')}, out, n)",
+                                  ctx))
+                cases.append(Case('add_int32', 'ctypes', kind, size,
+                                  f"out = I(); add({wrap_i.format('a')}, {wrap_i.format('b')}, out, n)", ctx))
+                if as_list and size <= LOOP_MAX_SIZE:
+                    cases.append(Case('add_int32', 'ctypes(loop)', kind, size,
+                                      '[add(p, q) for p, q in zip(a, b)]', dict(ns, add=c.add_int)))
+
+            # CFFI（ABI 模式）：list 用 ffi.new 拷贝，缓冲区用 ffi.from_buffer 零拷贝
+            if 'cffi' in bindings:
+                ffi, c, cpp = bindings['cffi']
+                ctx = dict(ns, ffi=ffi, h=cpp.advanced_calculator_create(), r=ffi.new('double *'),
+                           dot=cpp.advanced_calculator_dot_double, fma=cpp.advanced_calculator_fma_double,
+                           add=c.add_int_array_sat)
+                wrap = "ffi.new('double[]', {})" if as_list else "ffi.from_buffer('double[]', {})"
+                wrap_i = "ffi.new('int32_t[]', {})" if as_list else "ffi.from_buffer('int32_t[]', {})"
+                cases.append(Case('dot_f64', 'cffi', kind, size,
+                                  f"dot(h, {wrap.format('x')}, {wrap.format('y')}, n, r); r[0]", ctx))
+                cases.append(Case('fma_f64', 'cffi', kind, size,
+                                  f"out = ffi.new('double[]', n); "
+                                  f"fma(h, {wrap.format('x')}, {wrap.format('y')}, {wrap.format('z')}, out, n)", ctx))
+                cases.append(Case('add_int32', 'cffi', kind, size,
+                                  f"out = ffi.new('int32_t[]', n); add({wrap_i.format('a')}, {wrap_i.format('b')}, out, n)",
+                                  ctx))
+                if as_list and size <= LOOP_MAX_SIZE:
+                    cases.append(Case('add_int32', 'cffi(loop)', kind, size,
+                                      '[add(p, q) for p, q in zip(a, b)]', dict(ns, add=c.add_int)))
+
+    # 按组输出，组内按大小、输入类型排列，便于横向比较各绑定
+    groups = list(dict.fromkeys(case.group for case in cases))
+    return sorted(cases, key=lambda case: (groups.index(case.group), case.size, kinds.index(case.kind)
+                                           if case.kind in kinds else -1))
+
+
+# ---------------------------------------------------------------------------
+# 测量
+# ---------------------------------------------------------------------------
+
+def measure(case, repeat, min_time):
+    """返回每次重复测得的单次调用耗时（ns）"""
+    timer = timeit.Timer(case.stmt, globals=case.namespace)
+    # 校准：循环次数翻倍直到一次测量不少于 min_time 秒
+    loops = 1
+    while True:
+        elapsed = timer.timeit(loops)
+        if elapsed >= min_time:
+            break
+        loops *= 2 if elapsed <= 0 else max(2, min(10, int(min_time / elapsed) + 1))
+    gc_was_enabled = gc.isenabled()
+    gc.disable()
+    try:
+        runs = [timer.timeit(loops) / loops * 1e9 for _ in range(repeat)]
+    finally:
+        if gc_was_enabled:
+            gc.enable()
+    return loops, runs
+
+
+def summarize(runs):
+    median = statistics.median(runs)
+    spread = statistics.stdev(runs) / median if len(runs) > 1 and median > 0 else 0.0
+    return {'median_ns': median, 'min_ns': min(runs), 'rel_stdev': spread, 'runs_ns': runs}
+
+
+def format_ns(ns):
+    if ns >= 1e6:
+        return f"{ns / 1e6:.2f} ms"
+    if ns >= 1e3:
+        return f"{ns / 1e3:.2f} us"
+    return f"{ns:.0f} ns"
+
+
+def metadata(missing):
+    info = {
+        'date': datetime.datetime.now().isoformat(timespec='seconds'),
+        'python': f"{platform.python_implementation()} {platform.python_version()}",
+        'platform': platform.platform(),
+        'machine': platform.machine(),
+        'skipped_bindings': missing,
+    }
+    try:
+        with open('/proc/cpuinfo') as f:
+            model = re.search(r'^model name\s*:\s*(.*)$', f.read(), re.M)
+        if model:
+            info['cpu'] = model.group(1)
+    except OSError:
+        pass
+    try:
+        info['commit'] = subprocess.run(['git', '-C', PROJECT_ROOT, 'rev-parse', '--short', 'HEAD'],
+                                        capture_output=True, text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        pass
+    return info
+
+
+def compare(results, baseline, threshold):
+    """打印与基线的对比，返回变慢超过阈值的用例数"""
+    base = baseline.get('results', {})
+    common = [case_id for case_id in results if case_id in base]
+    regressions = 0
+    print(f"\n与基线比较（{baseline.get('metadata', {}).get('date', '?')}，"
+          f"commit {baseline.get('metadata', {}).get('commit', '?')}），阈值 {threshold:.0%}:")
+    for case_id in common:
+        old, new = base[case_id]['median_ns'], results[case_id]['median_ns']
+        ratio = new / old if old > 0 else float('inf')
+        # 变化在两次测量各自的波动范围内时不算回归
+        noise = base[case_id].get('rel_stdev', 0.0) + results[case_id].get('rel_stdev', 0.0)
+        if ratio > 1 + max(threshold, noise):
+            mark, regressions = 'SLOWER', regressions + 1
+        elif ratio < 1 - max(threshold, noise):
+            mark = 'faster'
+        else:
+            mark = ''
+        print(f"  {case_id:<48} {format_ns(old):>10} -> {format_ns(new):>10}  x{ratio:5.2f} {mark}")
+    not_run = len(set(base) - set(results))
+    if not_run:
+        print(f"  （基线中另有 {not_run} 个用例本次未运行）")
+    print(f"{regressions} 个用例变慢超过阈值" if regressions else "没有变慢超过阈值的用例")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Python binding call-overhead benchmarks")
+    parser.add_argument('--build-dir', default=os.path.join(PROJECT_ROOT, 'build'),
+                        help="CMake build directory (default: build)")
+    parser.add_argument('--sizes', default=','.join(map(str, DEFAULT_SIZES)),
+                        help="comma-separated element counts for array benchmarks")
+    parser.add_argument('--filter', help="only run cases whose id (group/binding/input/size) matches this regex")
+    parser.add_argument('--repeat', type=int, default=7, help="measurements per case (default: 7)")
+    parser.add_argument('--min-time', type=float, default=0.05,
+                        help="minimum seconds per measurement (default: 0.05)")
+    parser.add_argument('--list', action='store_true', help="list the cases and exit")
+    parser.add_argument('--save', metavar='JSON', help="write results as a baseline file")
+    parser.add_argument('--compare', metavar='JSON', help="compare against a baseline file; exit 1 on regressions")
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help="relative slowdown counted as a regression (default: 0.10)")
+    args = parser.parse_args()
+
+    sizes = [int(s) for s in args.sizes.split(',') if s]
+    bindings, missing = load_bindings(os.path.abspath(args.build_dir))
+    for name, reason in missing.items():
+        print(f"跳过 {name}: {reason}", file=sys.stderr)
+
+    cases = build_cases(bindings, sizes)
+    if args.filter:
+        pattern = re.compile(args.filter)
+        cases = [case for case in cases if pattern.search(case.id)]
+    if args.list:
+        for case in cases:
+            print(case.id)
+        return 0
+    if not cases:
+        print("没有可运行的用例", file=sys.stderr)
+        return 1
+
+    results = {}
+    group = None
+    for case in cases:
+        if case.group != group:
+            group = case.group
+            print(f"\n{group}")
+        loops, runs = measure(case, args.repeat, args.min_time)
+        results[case.id] = summarize(runs)
+        stats = results[case.id]
+        per_element = f"{stats['median_ns'] / case.size:8.2f} ns/elem" if case.size > 1 else ''
+        print(f"  {case.binding:<16} {case.kind:<7} {case.size:>8}  {format_ns(stats['median_ns']):>10}"
+              f" ±{stats['rel_stdev']:5.1%}  {per_element}")
+        sys.stdout.flush()
+
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump({'metadata': metadata(missing), 'results': results}, f, indent=1)
+        print(f"\n结果已保存到 {args.save}")
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+        return 1 if compare(results, baseline, args.threshold) else 0
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,94 @@
+#!/bin/bash
+
+# 使用库中的 USDT 探针（provider cpp_calculator / math_ops，见 cmake/BuildOptions.cmake 的 ENABLE_USDT）
+#
+# 每个探针有两个参数：arg0 = 函数名（const char*），arg1 = 元素个数；
+# op_entry 在函数入口触发，op_return 在函数返回（C++ 中包括异常退出）时触发。
+#
+# 用法:
+#   tools/calc_probes.sh list  [LIB_DIR]                 列出库中的探针
+#   tools/calc_probes.sh trace [LIB_DIR] [-p PID | -c CMD] 用 bpftrace 按函数汇总调用次数、元素个数和延迟直方图，Ctrl-C 结束
+#   tools/calc_probes.sh perf  [LIB_DIR] -- CMD [ARGS...]  用 perf record 记录全部探针事件，之后 perf script 查看
+#
+# LIB_DIR 默认为 build/lib（含 libcpp_calculator.so 和 libmath_ops.so）。trace / perf 通常需要 root 权限
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MODE="${1:-}"
+case "$MODE" in
+    list | trace | perf) shift ;;
+    *)
+        sed -n '3,13p' "$0" | sed 's/^# \{0,1\}//'
+        exit 1
+        ;;
+esac
+
+LIB_DIR="$SCRIPT_DIR/../build/lib"
+if [ $# -gt 0 ] && [ "$1" != "--" ] && [ "${1#-}" = "$1" ]; then
+    LIB_DIR="$1"
+    shift
+fi
+for lib in libcpp_calculator.so libmath_ops.so; do
+    if [ ! -f "$LIB_DIR/$lib" ]; then
+        echo "$LIB_DIR/$lib not found; build the project or pass LIB_DIR" >&2
+        exit 1
+    fi
+done
+CPP_LIB="$(realpath "$LIB_DIR/libcpp_calculator.so")"
+C_LIB="$(realpath "$LIB_DIR/libmath_ops.so")"
+
+case "$MODE" in
+    list)
+        # readelf 不需要权限，也不需要 bpftrace / perf
+        for lib in "$CPP_LIB" "$C_LIB"; do
+            echo "$lib:"
+            readelf -n "$lib" | awk '/Provider:/ { p = $2 } /Name:/ { print "  " p ":" $2 }' | sort | uniq -c
+        done
+        ;;
+    trace)
+        exec bpftrace "$@" -e "
+usdt:$CPP_LIB:cpp_calculator:op_entry,
+usdt:$C_LIB:math_ops:op_entry
+{
+    @start[tid, arg0] = nsecs;
+}
+
+usdt:$CPP_LIB:cpp_calculator:op_return,
+usdt:$C_LIB:math_ops:op_return
+/@start[tid, arg0]/
+{
+    \$op = str(arg0);
+    @calls[\$op] = count();
+    @elements[\$op] = sum(arg1);
+    @size[\$op] = hist(arg1);
+    @latency_ns[\$op] = hist(nsecs - @start[tid, arg0]);
+    delete(@start[tid, arg0]);
+}
+
+END
+{
+    clear(@start);
+}"
+        ;;
+    perf)
+        [ "${1:-}" = "--" ] && shift
+        if [ $# -eq 0 ]; then
+            echo "usage: $0 perf [LIB_DIR] -- CMD [ARGS...]" >&2
+            exit 1
+        fi
+        # perf 从 build-id 缓存中发现 SDT 事件，perf probe 把它们注册为 uprobe 事件
+        events=()
+        for lib in "$CPP_LIB" "$C_LIB"; do
+            perf buildid-cache --add "$lib"
+        done
+        for provider in cpp_calculator math_ops; do
+            for probe in op_entry op_return; do
+                perf probe --quiet --add "sdt_$provider:$probe" 2>/dev/null || true
+                events+=(-e "sdt_$provider:$probe")
+            done
+        done
+        perf record "${events[@]}" -- "$@"
+        echo "probe events recorded; view with: perf script -F comm,tid,time,event,trace"
+        ;;
+esac